@@ -89,8 +89,85 @@
 #include <string.h>
 #include <stdio.h>
 
+/**
+ * Compiles and runs one of the batch tools in the src folder (like the simulator) instead of the game.
+ * Everything after the name of the tool gets passed on to it.
+ * 
+ * @param   {char *}  sTool   The name of the tool; its source is src/<sTool>.c.
+ * @param   {char *}  sFlags  Extra flags for gcc.
+ * @param   {int}     argc    The arg count of main().
+ * @param   {char **} argv    The args of main().
+ * @return  {int}             Whatever the tool returned.
+*/
+int runTool(char *sTool, char *sFlags, int argc, char *argv[]) {
+  char sCommand[2048];
+  int dLength = 0;
+
+  // These go to stderr so they don't get mixed into the output of tools that talk over stdout (like the bot)
+  fprintf(stderr, "\nCompiling %s...\n", sTool);
+
+  #ifdef _WIN32
+    sprintf(sCommand, "gcc src\\%s.c -o build\\%s.win.exe -std=c99 -Wall %s 2> build\\logs\\.log.txt", sTool, sTool, sFlags);
+  #else
+    sprintf(sCommand, "gcc src/%s.c -o build/%s.unix.o -std=c99 -Wall %s 2> build/logs/.log.txt", sTool, sTool, sFlags);
+  #endif
+
+  if(system(sCommand)) {
+    fprintf(stderr, "Hmmm, something went wrong...\n");
+    fprintf(stderr, "Check out the log file in the build folder for more info.\n");
+    return 1;
+  }
+
+  fprintf(stderr, "Running %s...\n", sTool);
+
+  // Pass the rest of the args along
+  #ifdef _WIN32
+    dLength = sprintf(sCommand, "build\\%s.win.exe", sTool);
+  #else
+    dLength = sprintf(sCommand, "./build/%s.unix.o", sTool);
+  #endif
+
+  for(int i = 2; i < argc && dLength + strlen(argv[i]) + 4 < sizeof(sCommand); i++)
+    dLength += sprintf(sCommand + dLength, " \"%s\"", argv[i]);
+
+  return system(sCommand);
+}
+
 int main(int argc, char *argv[]) {
 
+/**
+ * #######################
+ * ###  GENERATE STEP  ###
+ * #######################
+*/
+
+  // Everything includes the product table, so it gets generated from the data file before anything is compiled
+  // The tool only gets the name of the program as its args, since the rest of ours aren't meant for it
+  if(runTool("catalogue", "", 1, argv)) {
+    fprintf(stderr, "Couldn't generate the catalogue from src/game/game.catalogue.csv.\n");
+    return 1;
+  }
+
+  // The economy simulator is its own program; it needs threads and optimizations
+  if(argc > 1 && !strcmp(argv[1], "sim"))
+    return runTool("sim", "-O2 -pthread -DUTILS_THREADS", argc, argv);
+
+  // So is the planner
+  if(argc > 1 && !strcmp(argv[1], "plan"))
+    return runTool("plan", "-O2", argc, argv);
+
+  // And the bot protocol for the minified game
+  if(argc > 1 && !strcmp(argv[1], "bot"))
+    return runTool("bot", "-O2", argc, argv);
+
+  // And the latency benchmark, which runs the game we built last time
+  if(argc > 1 && !strcmp(argv[1], "latency"))
+    return runTool("latency", "-O2", argc, argv);
+
+  // And the microbenchmarks
+  if(argc > 1 && !strcmp(argv[1], "bench"))
+    return runTool("bench", "-O2", argc, argv);
+
   // I KNOW system is bad, but I'm not really a hacker trying to run a malicious program on your device, right (or am I? OwO)
   // Although at some point it messed up my program build, and it broke during the dev process ://
   // Don't worry, it works now :DD
@@ -157,6 +234,14 @@ int main(int argc, char *argv[]) {
     } else if(!strcmp(argv[1], "full")) {
       args = "full na";
       
+    // Full mode, but the crops grow on their own
+    } else if(!strcmp(argv[1], "realtime")) {
+      args = "realtime na";
+      
+    // Full mode, picking up from the last save
+    } else if(!strcmp(argv[1], "continue")) {
+      args = "continue na";
+      
     // Default mode of the game
     } else {
       args = "default na";
@@ -176,12 +261,14 @@ int main(int argc, char *argv[]) {
   if(bCompiled) {
 
     // Run the game itself
-    char execCommand[128];
+    // Debug mode can also be told how many days to skip ahead
+    char execCommand[160];
+    int dDays = argc > 3 && !strncmp(args, "debug", 5) ? atoi(argv[3]) : 0;
     #ifdef _WIN32
-      sprintf(execCommand, "%%windir%%\\SysNative\\conhost.exe build\\game.win.exe %s", args);
+      sprintf(execCommand, "%%windir%%\\SysNative\\conhost.exe build\\game.win.exe %s %d", args, dDays);
       system(execCommand);
     #else
-      sprintf(execCommand, "./build/game.unix.o %s", args);
+      sprintf(execCommand, "./build/game.unix.o %s %d", args, dDays);
       system(execCommand);
     #endif
   }
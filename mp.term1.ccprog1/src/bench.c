@@ -0,0 +1,113 @@
+/**
+ * The microbenchmark suite for the utilities and the rendering of Harvest Sun.
+ * It times the functions that run on every frame (see bench/bench.cases.h) and reports the median and the MAD
+ * (median absolute deviation) in nanoseconds per op (see bench/bench.runner.h).
+ *
+ * Build (main.c does this for you with "./main bench"):
+ *    gcc src/bench.c -o build/bench.unix.o -std=c99 -Wall -O2
+ *
+ * Usage:
+ *    build/bench.unix.o [-n samples] [-t ms per sample] [-f filter] [-o save to] [-c compare with] [-w width] [-h height]
+ *
+ *    -f only runs the cases with that text in their name, -o saves the results as a baseline,
+ *    and -c compares the results with a baseline saved earlier.
+ *
+ * The console is pinned to a fixed size so the numbers don't depend on the terminal, and stdout is sent to the
+ * null device since UtilsUI_print() writes whole frames to it. That's why the table goes to stderr instead.
+*/
+
+// We need clock_gettime() from POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/utils.io.h"
+#include "utils/utils.mem.h"
+
+#include "game/game.assets.h"
+#include "game/game.catalogue.h"
+#include "game/game.manager.h"
+
+#include "bench/bench.cases.h"
+#include "bench/bench.runner.h"
+
+#define BENCH_DEFAULT_SAMPLES 31
+#define BENCH_DEFAULT_TARGET 5
+#define BENCH_DEFAULT_WIDTH 130
+#define BENCH_DEFAULT_HEIGHT 40
+
+#ifdef _WIN32
+#define BENCH_NULL_DEVICE "NUL"
+#else
+#define BENCH_NULL_DEVICE "/dev/null"
+#endif
+
+int main(int argc, char *argv[]) {
+  static struct BenchRunner runner;
+  static struct BenchCases cases;
+  static struct GameAssets assets;
+  static struct GameCatalogue catalogue;
+  static struct Game game;
+
+  int dSamples = BENCH_DEFAULT_SAMPLES;
+  int dTarget = BENCH_DEFAULT_TARGET;
+  int dWidth = BENCH_DEFAULT_WIDTH;
+  int dHeight = BENCH_DEFAULT_HEIGHT;
+  char *sFilter = NULL;
+  char *sSavePath = NULL;
+  char *sComparePath = NULL;
+
+  // Read the args
+  for(int i = 1; i + 1 < argc; i += 2) {
+    if(!strcmp(argv[i], "-n")) dSamples = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-t")) dTarget = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-f")) sFilter = argv[i + 1];
+    else if(!strcmp(argv[i], "-o")) sSavePath = argv[i + 1];
+    else if(!strcmp(argv[i], "-c")) sComparePath = argv[i + 1];
+    else if(!strcmp(argv[i], "-w")) dWidth = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-h")) dHeight = atoi(argv[i + 1]);
+    else {
+      fprintf(stderr, "Unknown option %s.\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if(dTarget < 1) dTarget = 1;
+  if(dWidth < GAME_MIN_WIDTH) dWidth = GAME_MIN_WIDTH;
+  if(dHeight < GAME_MIN_HEIGHT) dHeight = GAME_MIN_HEIGHT;
+
+  // The frames have to go somewhere
+  if(freopen(BENCH_NULL_DEVICE, "w", stdout) == NULL) {
+    fprintf(stderr, "Couldn't open %s.\n", BENCH_NULL_DEVICE);
+    return 1;
+  }
+
+  UtilsMem_init();
+  UtilsIO_fixSize(dWidth, dHeight);
+
+  // A game in debug mode, sitting in the farm, is what the header and footer cases look at
+  GameAssets_init(&assets);
+  GameCatalogue_init(&catalogue);
+  Game_init(&game, &assets, &catalogue);
+  Game_conf(&game, "debug", "farm", NULL);
+
+  BenchRunner_init(&runner, dSamples, dTarget / 1000.0, sFilter);
+  BenchCases_init(&cases, &runner, &game, &catalogue);
+
+  if(sComparePath != NULL && !BenchRunner_load(&runner, sComparePath)) {
+    fprintf(stderr, "Couldn't read the baseline at %s.\n", sComparePath);
+    return 1;
+  }
+
+  fprintf(stderr, "%d samples of at least %d ms per case, console pinned to %dx%d\n\n", runner.dSamples, dTarget, dWidth, dHeight);
+  BenchRunner_run(&runner, stderr, sComparePath != NULL);
+
+  if(sSavePath != NULL && !BenchRunner_save(&runner, sSavePath)) {
+    fprintf(stderr, "Couldn't write the baseline to %s.\n", sSavePath);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,416 @@
+/**
+ * The cases of the microbenchmark suite.
+ * Each one wraps a function the game calls on (almost) every frame, set up the same way the game would set it up.
+ * The ops free whatever they allocate, so running a case for a long time doesn't change what it measures.
+*/
+
+#ifndef BENCH_CASES_
+#define BENCH_CASES_
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../utils/utils.mem.h"
+#include "../utils/utils.selector.h"
+#include "../utils/utils.text.h"
+#include "../utils/utils.ui.h"
+
+#include "../game/game.catalogue.h"
+#include "../game/game.manager.h"
+
+#include "../game/objects/game.obj.farm.h"
+#include "../game/objects/game.obj.player.h"
+
+#include "bench.runner.h"
+
+#define BENCH_FARM_SIZES 3
+#define BENCH_GRID_MODES 3
+#define BENCH_SPARSE_SIZES 2
+
+// So the ops that need the player never run out of anything
+#define BENCH_PLENTY (1 << 30)
+
+/**
+ * What to redraw before each call to Farm_displayGrid().
+*/
+enum BenchGridMode {
+  BENCH_GRID_CACHED,        // Nothing; the last grid is reused
+  BENCH_GRID_CELL,          // One plot changed
+  BENCH_GRID_ALL,           // Every plot changed
+};
+
+/**
+ * Everything the cases work on.
+ * It lives as long as the runner does, since the cases only keep pointers into it.
+*/
+struct BenchCases {
+  struct GameCatalogue *CATALOGUE;
+
+  // UtilsText_paddedText()
+  enum UtilsText_Alignment eAlignmentArray[3];
+
+  // UtilsUI_centerXY()
+  struct UtilsText centerText;
+
+  // UtilsUI_print()
+  struct UtilsText *pFrameText;
+
+  // UtilsSelector_getOptionFormatted() and UtilsSelector_increment()
+  struct UtilsSelector *pMenuSelector;
+  struct UtilsSelector *pSparseSelectorArray[BENCH_SPARSE_SIZES];
+
+  // Farm_displayGrid()
+  struct BenchGrid {
+    struct Farm *pFarm;
+    enum BenchGridMode eMode;
+    int dCell;
+  } gridArray[BENCH_FARM_SIZES * BENCH_GRID_MODES];
+
+  // Farm_processQueue()
+  struct BenchQueue {
+    struct Farm *pFarm;
+    struct Player *pPlayer;
+    struct GameCatalogue *CATALOGUE;
+    enum FarmAction eAction;
+    int dTime;
+  } queueArray[4];
+
+  // Game_makeHeader() and Game_makeFooter()
+  struct Game *pGame;
+};
+
+/**
+ * ################
+ * ###  SET UP  ###
+ * ################
+*/
+
+/**
+ * Fills a farm the same way debug mode does: a mix of every plot state, crop and amount of water.
+ *
+ * @param   {struct Farm *}           pFarm       The farm.
+ * @param   {struct GameCatalogue *}  pCatalogue  The crops.
+*/
+void BenchCases_fillFarm(struct Farm *pFarm, struct GameCatalogue *pCatalogue) {
+  for(int i = 0; i < pFarm->dSize; i++) {
+    struct Product *pProduct = Product_create(i % (pCatalogue->dSize - 1) + 1, pCatalogue, 0);
+
+    pProduct->dWaterAmt = (i % 2) ? (i % pProduct->dWaterReq) : pProduct->dWaterReq;
+    pFarm->pPlotArray[i]->eState = i % 3;
+    pFarm->pPlotArray[i]->pProduct = pProduct;
+  }
+
+  Farm_touch(pFarm);
+}
+
+/**
+ * Puts every plot of the farm into the state an action needs, and queues all of them for it.
+ * This is the part of a Farm_processQueue() case that doesn't get timed.
+ *
+ * @param   {struct BenchQueue *}   this  The case.
+*/
+void BenchCases_prepareQueue(struct BenchQueue *this) {
+  struct Farm *pFarm = this->pFarm;
+  enum PlotState eState =
+    this->eAction == FARM_TILL ? PLOT_UNTILLED :
+    this->eAction == FARM_SOW ? PLOT_TILLED : PLOT_SOWN;
+
+  for(int i = 0; i < pFarm->dSize; i++) {
+    struct Plot *pPlot = pFarm->pPlotArray[i];
+
+    if(pPlot->eState != eState) {
+      if(pPlot->eState == PLOT_SOWN)
+        Plot_harvest(pPlot);
+
+      pPlot->eState = eState == PLOT_SOWN ? PLOT_TILLED : eState;
+
+      if(eState == PLOT_SOWN)
+        Plot_sow(pPlot, Product_create(i % (this->CATALOGUE->dSize - 1) + 1, this->CATALOGUE, this->dTime));
+    }
+
+    pFarm->bSelectionQueue[i] = 1;
+  }
+
+  // The player can afford anything
+  this->pPlayer->dEnergy = BENCH_PLENTY;
+  this->pPlayer->pSeedStockArray[PRODUCT_BANANA]->dAmount = BENCH_PLENTY;
+
+  Farm_startSelecting(pFarm);
+  Farm_setCurrentAction(pFarm, this->eAction);
+  Farm_setCurrentCrop(pFarm, PRODUCT_BANANA);
+
+  // A new day every time so the crops can always take water
+  this->dTime++;
+}
+
+/**
+ * Makes a frame that fills the console.
+ *
+ * @return  {struct UtilsText *}  The frame.
+*/
+struct UtilsText *BenchCases_makeFrame() {
+  struct UtilsText *pText = UtilsText_create();
+
+  UtilsText_addPatternLines(pText, 1, "_");
+  UtilsText_addPatternLines(pText, 1, ":=");
+
+  while(UtilsText_getLines(pText) < UtilsIO_getHeight() - 2)
+    UtilsText_addPaddedText(pText, "The quick brown fox jumps over the lazy farmer.", " ", UTILS_TEXT_CENTER_ALIGN);
+
+  UtilsText_addPatternLines(pText, 1, "'-");
+  UtilsText_addPatternLines(pText, 1, "_");
+
+  return pText;
+}
+
+/**
+ * ###############
+ * ###  CASES  ###
+ * ###############
+*/
+
+double BenchCases_paddedText(void *pData, long dOps) {
+  enum UtilsText_Alignment eAlignment = *(enum UtilsText_Alignment *) pData;
+  double fStart = BenchRunner_getTime();
+
+  while(dOps--)
+    UtilsMem_free(UtilsText_paddedText("----[ DEBUG MODE ]--[ Day:    1 ]--[ Gold:   50 ]----", "-=", eAlignment));
+
+  return BenchRunner_getTime() - fStart;
+}
+
+double BenchCases_centerXY(void *pData, long dOps) {
+  struct UtilsText *pText = pData;
+  double fStart = BenchRunner_getTime();
+
+  while(dOps--) {
+    int dPadding;
+
+    // The lines get replaced by centered copies, so they're put back every time
+    pText->dLength = 10;
+    for(int i = 0; i < 10; i++)
+      pText->sTextArray[i] = "Where do you want to go?";
+
+    UtilsUI_centerXY(pText);
+
+    // Only the centered lines were allocated; the padding is all literals
+    dPadding = (UtilsText_getLines(pText) - 10) / 2;
+    for(int i = 0; i < 10; i++)
+      UtilsMem_free(pText->sTextArray[dPadding + i]);
+  }
+
+  return BenchRunner_getTime() - fStart;
+}
+
+double BenchCases_print(void *pData, long dOps) {
+  struct UtilsText *pText = pData;
+  double fStart = BenchRunner_getTime();
+
+  while(dOps--)
+    UtilsUI_print(pText);
+
+  return BenchRunner_getTime() - fStart;
+}
+
+double BenchCases_getOptionFormatted(void *pData, long dOps) {
+  struct UtilsSelector *pSelector = pData;
+  double fStart = BenchRunner_getTime();
+
+  for(long i = 0; i < dOps; i++)
+    UtilsSelector_getOptionFormatted(pSelector, i % UtilsSelector_getLength(pSelector));
+
+  return BenchRunner_getTime() - fStart;
+}
+
+double BenchCases_increment(void *pData, long dOps) {
+  struct UtilsSelector *pSelector = pData;
+  double fStart = BenchRunner_getTime();
+
+  while(dOps--)
+    UtilsSelector_increment(pSelector);
+
+  return BenchRunner_getTime() - fStart;
+}
+
+double BenchCases_displayGrid(void *pData, long dOps) {
+  struct BenchGrid *this = pData;
+  double fStart = BenchRunner_getTime();
+
+  while(dOps--) {
+    if(this->eMode == BENCH_GRID_CELL) {
+      Farm_markDirty(this->pFarm, this->dCell);
+      this->dCell = (this->dCell + 1) % this->pFarm->dSize;
+    } else if(this->eMode == BENCH_GRID_ALL) {
+      Farm_touch(this->pFarm);
+    }
+
+    Farm_displayGrid(this->pFarm, 0);
+  }
+
+  return BenchRunner_getTime() - fStart;
+}
+
+double BenchCases_processQueue(void *pData, long dOps) {
+  struct BenchQueue *this = pData;
+  double fTotal = 0;
+
+  // Only the call itself is timed; putting the plots back isn't
+  while(dOps--) {
+    double fStart;
+
+    BenchCases_prepareQueue(this);
+
+    fStart = BenchRunner_getTime();
+    Farm_processQueue(this->pFarm, this->pPlayer, this->CATALOGUE, this->dTime);
+    fTotal += BenchRunner_getTime() - fStart;
+  }
+
+  return fTotal;
+}
+
+double BenchCases_makeHeader(void *pData, long dOps) {
+  struct Game *pGame = pData;
+  double fStart = BenchRunner_getTime();
+
+  while(dOps--)
+    Game_makeHeader(pGame);
+
+  return BenchRunner_getTime() - fStart;
+}
+
+double BenchCases_makeHeaderRebuilt(void *pData, long dOps) {
+  struct Game *pGame = pData;
+  double fStart = BenchRunner_getTime();
+
+  // Renaming the player is the cheapest way to change what the header shows
+  while(dOps--) {
+    Player_setName(pGame->pPlayer, "DEBUG MODE");
+    Game_makeHeader(pGame);
+  }
+
+  return BenchRunner_getTime() - fStart;
+}
+
+double BenchCases_makeFooter(void *pData, long dOps) {
+  struct Game *pGame = pData;
+  double fStart = BenchRunner_getTime();
+
+  while(dOps--)
+    Game_makeFooter(pGame);
+
+  return BenchRunner_getTime() - fStart;
+}
+
+double BenchCases_makeFooterRebuilt(void *pData, long dOps) {
+  struct Game *pGame = pData;
+  double fStart = BenchRunner_getTime();
+
+  while(dOps--) {
+    Farm_touch(pGame->pFarm);
+    Game_makeFooter(pGame);
+  }
+
+  return BenchRunner_getTime() - fStart;
+}
+
+/**
+ * ######################
+ * ###  REGISTRATION  ###
+ * ######################
+*/
+
+/**
+ * Sets up everything the cases need and adds them to the runner.
+ * Note that UtilsIO_fixSize() should have been called before this, since the frames are built for the console size.
+ *
+ * @param   {struct BenchCases *}   this        Where to keep what the cases work on.
+ * @param   {struct BenchRunner *}  pRunner     The runner.
+ * @param   {struct Game *}         pGame       A game in debug mode, sitting in the farm.
+ * @param   {struct GameCatalogue *}  pCatalogue  The crops.
+*/
+void BenchCases_init(struct BenchCases *this, struct BenchRunner *pRunner, struct Game *pGame, struct GameCatalogue *pCatalogue) {
+  int dFarmSizeArray[BENCH_FARM_SIZES][2] = { { 3, 2 }, { GAME_FARM_WIDTH, GAME_FARM_HEIGHT }, { FARM_MAX_WIDTH, FARM_MAX_HEIGHT } };
+  char *sGridModeArray[BENCH_GRID_MODES] = { "cached", "one cell", "all cells" };
+  char *sActionArray[4] = { "till", "sow", "water", "harvest" };
+  int dSparseArray[BENCH_SPARSE_SIZES] = { 8, 64 };
+  char sName[BENCH_MAX_NAME];
+
+  this->CATALOGUE = pCatalogue;
+  this->pGame = pGame;
+
+  // UtilsText_paddedText() for each alignment
+  this->eAlignmentArray[0] = UTILS_TEXT_LEFT_ALIGN;
+  this->eAlignmentArray[1] = UTILS_TEXT_CENTER_ALIGN;
+  this->eAlignmentArray[2] = UTILS_TEXT_RIGHT_ALIGN;
+
+  BenchRunner_add(pRunner, "paddedText/left", BenchCases_paddedText, &this->eAlignmentArray[0]);
+  BenchRunner_add(pRunner, "paddedText/center", BenchCases_paddedText, &this->eAlignmentArray[1]);
+  BenchRunner_add(pRunner, "paddedText/right", BenchCases_paddedText, &this->eAlignmentArray[2]);
+
+  // Centering a menu and printing a whole frame
+  UtilsText_init(&this->centerText);
+  this->pFrameText = BenchCases_makeFrame();
+
+  BenchRunner_add(pRunner, "centerXY/10 lines", BenchCases_centerXY, &this->centerText);
+  BenchRunner_add(pRunner, "print/full frame", BenchCases_print, this->pFrameText);
+
+  // The selectors; the menu one looks like the one in the game
+  this->pMenuSelector = UtilsSelector_create(0, "  [ ]  %s   ", "  -=> [x]  %s       ", "  [-]  %s   ");
+  UtilsSelector_addOption(this->pMenuSelector, "go to home", 0);
+  UtilsSelector_addOption(this->pMenuSelector, "go to farm", 1);
+  UtilsSelector_addOption(this->pMenuSelector, "visit shop", 2);
+
+  BenchRunner_add(pRunner, "getOptionFormatted/menu", BenchCases_getOptionFormatted, this->pMenuSelector);
+
+  // Looped selectors where only two options can be picked, so every increment skips over the rest
+  for(int i = 0; i < BENCH_SPARSE_SIZES; i++) {
+    this->pSparseSelectorArray[i] = UtilsSelector_create(1, "%s", "%s", "%s");
+
+    for(int j = 0; j < dSparseArray[i]; j++) {
+      UtilsSelector_addOption(this->pSparseSelectorArray[i], "option", j);
+      UtilsSelector_setOptionAvailability(this->pSparseSelectorArray[i], j, j == 0 || j == dSparseArray[i] / 2);
+    }
+
+    snprintf(sName, BENCH_MAX_NAME, "increment/2 of %d available", dSparseArray[i]);
+    BenchRunner_add(pRunner, sName, BenchCases_increment, this->pSparseSelectorArray[i]);
+  }
+
+  // The farm grid at a few sizes, redrawing nothing, one plot or everything
+  for(int i = 0; i < BENCH_FARM_SIZES; i++) {
+    struct Farm *pFarm = Farm_create(dFarmSizeArray[i][0], dFarmSizeArray[i][1], pCatalogue);
+    BenchCases_fillFarm(pFarm, pCatalogue);
+
+    for(int j = 0; j < BENCH_GRID_MODES; j++) {
+      struct BenchGrid *pGrid = &this->gridArray[i * BENCH_GRID_MODES + j];
+
+      pGrid->pFarm = pFarm;
+      pGrid->eMode = j;
+      pGrid->dCell = 0;
+
+      snprintf(sName, BENCH_MAX_NAME, "displayGrid/%dx%d %s", pFarm->dWidth, pFarm->dHeight, sGridModeArray[j]);
+      BenchRunner_add(pRunner, sName, BenchCases_displayGrid, pGrid);
+    }
+  }
+
+  // Every action on every plot of a farm as big as the one in the game
+  for(int i = 0; i < 4; i++) {
+    struct BenchQueue *pQueue = &this->queueArray[i];
+
+    pQueue->pFarm = Farm_create(GAME_FARM_WIDTH, GAME_FARM_HEIGHT, pCatalogue);
+    pQueue->pPlayer = Player_create(GAME_PLAYER_GOLD, GAME_PLAYER_ENERGY, GAME_PLAYER_ENERGY, pCatalogue);
+    pQueue->CATALOGUE = pCatalogue;
+    pQueue->eAction = (enum FarmAction) (FARM_TILL + i);
+    pQueue->dTime = 0;
+
+    snprintf(sName, BENCH_MAX_NAME, "processQueue/%s %d plots", sActionArray[i], pQueue->pFarm->dSize);
+    BenchRunner_add(pRunner, sName, BenchCases_processQueue, pQueue);
+  }
+
+  // The header and footer of the game, reused and rebuilt
+  BenchRunner_add(pRunner, "makeHeader/cached", BenchCases_makeHeader, pGame);
+  BenchRunner_add(pRunner, "makeHeader/rebuilt", BenchCases_makeHeaderRebuilt, pGame);
+  BenchRunner_add(pRunner, "makeFooter/cached", BenchCases_makeFooter, pGame);
+  BenchRunner_add(pRunner, "makeFooter/rebuilt", BenchCases_makeFooterRebuilt, pGame);
+}
+
+#endif
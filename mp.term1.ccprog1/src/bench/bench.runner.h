@@ -0,0 +1,295 @@
+/**
+ * Times the cases of the microbenchmark suite and does the statistics.
+ * Every case is run in samples of many ops; the number of ops per sample is doubled until a sample takes long enough
+ * to be worth timing, and one whole sample is thrown away first so the caches (and the allocator) are warm.
+ * We report the median and the median absolute deviation (MAD) of the samples instead of the mean and the
+ * standard deviation, since one sample that got interrupted by the OS would drag those all over the place.
+*/
+
+#ifndef BENCH_RUNNER_
+#define BENCH_RUNNER_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../utils/utils.mem.h"
+
+#define BENCH_MAX_CASES 64
+#define BENCH_MAX_SAMPLES 255
+#define BENCH_MAX_NAME 48
+
+// A case is only said to have changed if it moved by more than this many MADs, and by more than this fraction
+#define BENCH_NOISE_MADS 3.0
+#define BENCH_NOISE_FLOOR 0.02
+
+/**
+ * A single thing to time.
+ * fRun does the op dOps times and returns how many seconds of that should be counted.
+ * Most cases just time the whole loop, but some have to undo what the op did in between, and those only count the op.
+*/
+struct BenchCase {
+  char sName[BENCH_MAX_NAME];
+  double (*fRun)(void *pData, long dOps);
+  void *pData;
+
+  // The results, in nanoseconds per op
+  double fMedian;
+  double fMAD;
+  long dOps;              // Per sample
+
+  // From the baseline file, if there was one (negative if not)
+  double fBaseMedian;
+  double fBaseMAD;
+};
+
+/**
+ * The list of cases and how to run them.
+*/
+struct BenchRunner {
+  struct BenchCase caseArray[BENCH_MAX_CASES];
+  int dCases;
+
+  int dSamples;
+  double fTarget;         // How long a sample should take, in seconds
+  char *sFilter;          // Only cases whose name has this in it get run (NULL for all)
+};
+
+/**
+ * Returns the time in seconds.
+ *
+ * @return  {double}  A monotonic timestamp.
+*/
+double BenchRunner_getTime() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Returns the absolute value of a double.
+ * It's here so we don't have to link the math library for one function.
+ *
+ * @param   {double}  fValue  The number.
+ * @return  {double}          Its absolute value.
+*/
+double BenchRunner_abs(double fValue) {
+  return fValue < 0 ? -fValue : fValue;
+}
+
+/**
+ * Initializes the runner.
+ *
+ * @param   {struct BenchRunner *}  this      The runner.
+ * @param   {int}                   dSamples  How many samples to take of every case.
+ * @param   {double}                fTarget   How long a sample should take, in seconds.
+ * @param   {char *}                sFilter   Which cases to run (NULL for all).
+*/
+void BenchRunner_init(struct BenchRunner *this, int dSamples, double fTarget, char *sFilter) {
+  if(dSamples < 3) dSamples = 3;
+  if(dSamples > BENCH_MAX_SAMPLES) dSamples = BENCH_MAX_SAMPLES;
+
+  this->dCases = 0;
+  this->dSamples = dSamples;
+  this->fTarget = fTarget;
+  this->sFilter = sFilter;
+}
+
+/**
+ * Adds a case to the list.
+ * Cases that don't match the filter are left out right away.
+ *
+ * @param   {struct BenchRunner *}  this    The runner.
+ * @param   {char *}                sName   What to call the case.
+ * @param   {double (*)()}          fRun    Runs the op a number of times (see struct BenchCase).
+ * @param   {void *}                pData   Whatever fRun needs.
+*/
+void BenchRunner_add(struct BenchRunner *this, char *sName, double (*fRun)(void *pData, long dOps), void *pData) {
+  struct BenchCase *pCase = &this->caseArray[this->dCases];
+
+  if(this->dCases >= BENCH_MAX_CASES || (this->sFilter != NULL && strstr(sName, this->sFilter) == NULL))
+    return;
+
+  snprintf(pCase->sName, BENCH_MAX_NAME, "%s", sName);
+  pCase->fRun = fRun;
+  pCase->pData = pData;
+  pCase->fBaseMedian = -1;
+  pCase->fBaseMAD = -1;
+
+  this->dCases++;
+}
+
+/**
+ * Compares two doubles for qsort().
+ *
+ * @param   {const void *}  pFirst    The first double.
+ * @param   {const void *}  pSecond   The second double.
+ * @return  {int}                     Which one comes first.
+*/
+int BenchRunner_compare(const void *pFirst, const void *pSecond) {
+  double fFirst = *(const double *) pFirst;
+  double fSecond = *(const double *) pSecond;
+
+  return (fFirst > fSecond) - (fFirst < fSecond);
+}
+
+/**
+ * Returns the median of some numbers.
+ * The numbers get sorted along the way.
+ *
+ * @param   {double *}  fArray  The numbers.
+ * @param   {int}       dCount  How many there are.
+ * @return  {double}            Their median.
+*/
+double BenchRunner_getMedian(double *fArray, int dCount) {
+  qsort(fArray, dCount, sizeof(double), BenchRunner_compare);
+
+  return dCount % 2 ? fArray[dCount / 2] : (fArray[dCount / 2 - 1] + fArray[dCount / 2]) / 2;
+}
+
+/**
+ * Times a case.
+ *
+ * @param   {struct BenchRunner *}  this    The runner.
+ * @param   {struct BenchCase *}    pCase   The case.
+*/
+void BenchRunner_measure(struct BenchRunner *this, struct BenchCase *pCase) {
+  double fSampleArray[BENCH_MAX_SAMPLES];
+  long dOps = 1;
+
+  // Find out how many ops make a sample long enough
+  while(pCase->fRun(pCase->pData, dOps) < this->fTarget && dOps < (1L << 40))
+    dOps *= 2;
+
+  // That was the warm up too, but one more sample at the final size doesn't hurt
+  pCase->fRun(pCase->pData, dOps);
+
+  for(int i = 0; i < this->dSamples; i++)
+    fSampleArray[i] = pCase->fRun(pCase->pData, dOps) * 1e9 / dOps;
+
+  pCase->fMedian = BenchRunner_getMedian(fSampleArray, this->dSamples);
+
+  for(int i = 0; i < this->dSamples; i++)
+    fSampleArray[i] = BenchRunner_abs(fSampleArray[i] - pCase->fMedian);
+
+  pCase->fMAD = BenchRunner_getMedian(fSampleArray, this->dSamples);
+  pCase->dOps = dOps;
+}
+
+/**
+ * Reads a baseline saved by BenchRunner_save() and attaches it to the cases with the same names.
+ *
+ * @param   {struct BenchRunner *}  this    The runner.
+ * @param   {char *}                sPath   The baseline file.
+ * @return  {int}                           Whether or not the file could be read.
+*/
+int BenchRunner_load(struct BenchRunner *this, char *sPath) {
+  FILE *pFile = fopen(sPath, "r");
+  char sLine[256];
+
+  if(pFile == NULL)
+    return 0;
+
+  // Every line is the name, a tab, then the median and the MAD
+  while(fgets(sLine, sizeof(sLine), pFile) != NULL) {
+    char *sTab = strchr(sLine, '\t');
+    double fMedian, fMAD;
+
+    if(sTab == NULL || sscanf(sTab + 1, "%lf %lf", &fMedian, &fMAD) != 2)
+      continue;
+
+    *sTab = 0;
+
+    for(int i = 0; i < this->dCases; i++) {
+      if(!strcmp(this->caseArray[i].sName, sLine)) {
+        this->caseArray[i].fBaseMedian = fMedian;
+        this->caseArray[i].fBaseMAD = fMAD;
+      }
+    }
+  }
+
+  fclose(pFile);
+
+  return 1;
+}
+
+/**
+ * Writes the results so a later run can compare itself against them.
+ *
+ * @param   {struct BenchRunner *}  this    The runner.
+ * @param   {char *}                sPath   Where to write them.
+ * @return  {int}                           Whether or not the file could be written.
+*/
+int BenchRunner_save(struct BenchRunner *this, char *sPath) {
+  FILE *pFile = fopen(sPath, "w");
+
+  if(pFile == NULL)
+    return 0;
+
+  for(int i = 0; i < this->dCases; i++)
+    fprintf(pFile, "%s\t%.3f %.3f\n", this->caseArray[i].sName, this->caseArray[i].fMedian, this->caseArray[i].fMAD);
+
+  fclose(pFile);
+
+  return 1;
+}
+
+/**
+ * Says whether a case got faster or slower than its baseline, or whether the difference is just noise.
+ *
+ * @param   {struct BenchCase *}  pCase   The case.
+ * @return  {char *}                      What happened.
+*/
+char *BenchRunner_getVerdict(struct BenchCase *pCase) {
+  double fDelta = pCase->fMedian - pCase->fBaseMedian;
+  double fNoise = BENCH_NOISE_MADS * (pCase->fMAD > pCase->fBaseMAD ? pCase->fMAD : pCase->fBaseMAD);
+
+  if(BenchRunner_abs(fDelta) <= fNoise || BenchRunner_abs(fDelta) <= BENCH_NOISE_FLOOR * pCase->fBaseMedian)
+    return "~";
+
+  return fDelta < 0 ? "faster" : "slower";
+}
+
+/**
+ * Prints the result of a case.
+ *
+ * @param   {struct BenchCase *}  pCase   The case.
+ * @param   {FILE *}              pFile   Where to print it.
+*/
+void BenchRunner_print(struct BenchCase *pCase, FILE *pFile) {
+  fprintf(pFile, "%-40s %12.1f %10.1f %6.1f%% %12ld",
+    pCase->sName, pCase->fMedian, pCase->fMAD, pCase->fMedian > 0 ? pCase->fMAD * 100 / pCase->fMedian : 0, pCase->dOps);
+
+  if(pCase->fBaseMedian > 0)
+    fprintf(pFile, " %12.1f %+7.1f%%  %s", pCase->fBaseMedian,
+      (pCase->fMedian - pCase->fBaseMedian) * 100 / pCase->fBaseMedian, BenchRunner_getVerdict(pCase));
+
+  fprintf(pFile, "\n");
+}
+
+/**
+ * Times every case, printing each one as soon as it's done.
+ *
+ * @param   {struct BenchRunner *}  this    The runner.
+ * @param   {FILE *}                pFile   Where to print the results.
+ * @param   {int}                   bBase   Whether or not there's a baseline to show.
+*/
+void BenchRunner_run(struct BenchRunner *this, FILE *pFile, int bBase) {
+  fprintf(pFile, "%-40s %12s %10s %7s %12s", "case", "ns/op", "MAD", "MAD%", "ops/sample");
+
+  if(bBase)
+    fprintf(pFile, " %12s %8s  %s", "base ns/op", "delta", "verdict");
+
+  fprintf(pFile, "\n");
+
+  for(int i = 0; i < this->dCases; i++) {
+    BenchRunner_measure(this, &this->caseArray[i]);
+    BenchRunner_print(&this->caseArray[i], pFile);
+    fflush(pFile);
+  }
+}
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * Lets programs play the minified version of Harvest Sun over stdin and stdout.
+ * Commands go in one per line, and exactly one response comes back per command, in the same order:
+ *
+ *    till <plots>            sow <crop> <plots>        water [crop]        harvest [crop]
+ *    buy <crop> <amount>     sell <crop> <amount>      sleep [nights]
+ *    look                    reset                     quit
+ *
+ * Crops are given by their code (B, C, M). A response is either "ok" followed by the fields that changed
+ * (like "ok energy=27 tilled=3"), or "err" followed by the reason, which is the same message the game would've shown.
+ * look answers with every field, and blank lines and lines starting with # are skipped without a response.
+ *
+ * A bot doesn't have to wait for a response before sending the next command. We read whatever has arrived,
+ * answer all of it into one buffer, and only write that out when we run out of complete lines, so a pipelined
+ * bot gets its responses in big chunks instead of one write(2) per line.
+ *
+ * Build (main.c does this for you with "./main bot"):
+ *    gcc src/bot.c -o build/bot.unix.o -std=c99 -Wall -O2
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define BOT_READ _read
+#else
+#include <unistd.h>
+#define BOT_READ read
+#endif
+
+#include "utils/utils.mem.h"
+#include "utils/utils.string.h"
+
+#include "game/game.catalogue.h"
+
+#include "bot/bot.session.h"
+
+#define BOT_BUFFER_SIZE (1 << 16)
+
+/**
+ * Where the commands come in.
+*/
+struct BotInput {
+  char sBuffer[BOT_BUFFER_SIZE + 1];
+  int dStart;         // The first character we haven't used
+  int dEnd;           // One past the last character we've read
+};
+
+/**
+ * Gets the next line out of what has been read so far, without waiting for more.
+ *
+ * @param   {struct BotInput *}   this  The input.
+ * @return  {char *}                    The line (without the newline), or NULL if there isn't a complete one yet.
+*/
+char *BotInput_nextLine(struct BotInput *this) {
+  char *sNewline = memchr(this->sBuffer + this->dStart, '\n', this->dEnd - this->dStart);
+  char *sLine = this->sBuffer + this->dStart;
+
+  if(sNewline == NULL)
+    return NULL;
+
+  *sNewline = 0;
+  this->dStart = sNewline - this->sBuffer + 1;
+
+  return sLine;
+}
+
+/**
+ * Waits for more input.
+ * Whatever's left of an incomplete line gets moved to the front first.
+ *
+ * @param   {struct BotInput *}   this  The input.
+ * @return  {int}                       How much was read; 0 at the end of the input.
+*/
+int BotInput_fill(struct BotInput *this) {
+  int dRead;
+
+  memmove(this->sBuffer, this->sBuffer + this->dStart, this->dEnd - this->dStart);
+  this->dEnd -= this->dStart;
+  this->dStart = 0;
+
+  // A line that doesn't fit is just cut in two
+  if(this->dEnd == BOT_BUFFER_SIZE) {
+    this->sBuffer[this->dEnd++] = '\n';
+    return 1;
+  }
+
+  dRead = BOT_READ(0, this->sBuffer + this->dEnd, BOT_BUFFER_SIZE - this->dEnd);
+
+  if(dRead <= 0) {
+
+    // The last line doesn't need a newline
+    if(this->dEnd) {
+      this->sBuffer[this->dEnd++] = '\n';
+      return 1;
+    }
+
+    return 0;
+  }
+
+  this->dEnd += dRead;
+
+  return dRead;
+}
+
+int main(int argc, char *argv[]) {
+  static struct BotInput input;
+  struct GameCatalogue catalogue;
+  struct BotSession session;
+  struct UtilsString *pResponse;
+  struct UtilsString *pOutput;
+  int bIsRunning = 1;
+
+  UtilsMem_init();
+  GameCatalogue_init(&catalogue);
+  BotSession_init(&session, &catalogue);
+
+  pResponse = UtilsString_create();
+  pOutput = UtilsString_create();
+  UtilsString_reserve(pOutput, BOT_BUFFER_SIZE);
+
+  while(bIsRunning) {
+    char *sLine;
+
+    // Answer everything that's already here
+    while(bIsRunning && (sLine = BotInput_nextLine(&input)) != NULL) {
+      while(*sLine == ' ' || *sLine == '\t')
+        sLine++;
+
+      if(!*sLine || *sLine == '\r' || *sLine == '#')
+        continue;
+
+      bIsRunning = BotSession_run(&session, sLine, pResponse);
+
+      if(bIsRunning) {
+        UtilsString_append(pOutput, UtilsString_getText(pResponse));
+        UtilsString_appendChar(pOutput, '\n');
+      }
+    }
+
+    // Only write when we'd otherwise have to wait
+    fwrite(UtilsString_getText(pOutput), sizeof(char), UtilsString_getLength(pOutput), stdout);
+    fflush(stdout);
+    UtilsString_clear(pOutput);
+
+    if(bIsRunning && !BotInput_fill(&input))
+      bIsRunning = 0;
+  }
+
+  UtilsString_kill(pResponse);
+  UtilsString_kill(pOutput);
+  BotSession_exit(&session);
+
+  return 0;
+}
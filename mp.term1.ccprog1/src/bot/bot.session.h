@@ -0,0 +1,391 @@
+/**
+ * A single game of the minified version, played through text commands instead of keystrokes.
+ * Every command is turned into the keys a person would have typed and fed to GameMini_IO(), so a bot goes through
+ * exactly the same checks and messages as someone playing the default mode. Nothing is ever drawn.
+ *
+ * After every command we compare the state with what it was before and only report what changed.
+*/
+
+#ifndef BOT_SESSION
+#define BOT_SESSION
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "../game/game.catalogue.h"
+#include "../game/game.manager.min.h"
+
+#include "../utils/utils.key.h"
+#include "../utils/utils.string.h"
+
+#define BOT_MAX_ARGS 4
+
+/**
+ * Everything a bot can see about the game.
+*/
+struct BotState {
+  int dDay;
+  int dStarved;
+  int dEnergy;
+  int dGold;
+  int bIsDead;
+
+  int dUntilled;
+  int dTilled;
+
+  int dSeedArray[CATALOGUE_SIZE];
+  int dCropArray[CATALOGUE_SIZE];
+  int dSownArray[CATALOGUE_SIZE];     // How many plots of each crop there are
+  int dWaterArray[CATALOGUE_SIZE];    // How much water they've had
+};
+
+/**
+ * The session.
+*/
+struct BotSession {
+  struct GameMini game;
+  struct GameCatalogue *CATALOGUE;
+
+  // What the last command saw before it ran
+  struct BotState before;
+
+  // The game clears its message on every key, so we hang on to the last one it gave
+  char sFeedback[UTILS_KEY_MAX_INPUT];
+};
+
+/**
+ * ##############################
+ * ###  SESSION CONSTRUCTION  ###
+ * ##############################
+*/
+
+/**
+ * Starts a new game.
+ *
+ * @param   {struct BotSession *}     this        The session.
+ * @param   {struct GameCatalogue *}  pCatalogue  The crops of the game.
+*/
+void BotSession_init(struct BotSession *this, struct GameCatalogue *pCatalogue) {
+  this->CATALOGUE = pCatalogue;
+
+  GameMini_init(&this->game, pCatalogue);
+}
+
+/**
+ * Cleans up the game.
+ *
+ * @param   {struct BotSession *}   this  The session.
+*/
+void BotSession_exit(struct BotSession *this) {
+  GameMini_exit(&this->game);
+}
+
+/**
+ * #######################
+ * ###  SESSION STATE  ###
+ * #######################
+*/
+
+/**
+ * Copies everything a bot can see out of the game.
+ *
+ * @param   {struct BotSession *}   this    The session.
+ * @param   {struct BotState *}     pState  Where to put it.
+*/
+void BotSession_getState(struct BotSession *this, struct BotState *pState) {
+  struct GameMini *pGame = &this->game;
+
+  pState->dDay = Player_getTime(pGame->pPlayer);
+  pState->dStarved = pGame->pPlayer->dDaysStarved;
+  pState->dEnergy = Player_getEnergy(pGame->pPlayer);
+  pState->dGold = Player_getGold(pGame->pPlayer);
+  pState->bIsDead = pGame->bIsGameOver;
+
+  pState->dUntilled = Farm_canTill(pGame->pFarm);
+  pState->dTilled = Farm_canSow(pGame->pFarm);
+
+  for(int i = 1; i < this->CATALOGUE->dSize; i++) {
+    pState->dSeedArray[i] = Stock_getAmount(Player_getSeedStock(pGame->pPlayer, i));
+    pState->dCropArray[i] = Stock_getAmount(Player_getCropStock(pGame->pPlayer, i));
+    pState->dSownArray[i] = pGame->bCropSownStatesArray[i];
+    pState->dWaterArray[i] = pGame->dCropWaterStatesArray[i];
+  }
+}
+
+/**
+ * Writes one field of the state, but only if it's different from before (or if there's no before).
+ *
+ * @param   {struct UtilsString *}  pOutput   Where to write it.
+ * @param   {char *}                sName     The name of the field.
+ * @param   {char}                  cCode     The crop the field is about (or 0).
+ * @param   {int *}                 pBefore   The old value, or NULL to always write it.
+ * @param   {int}                   dAfter    The new value.
+*/
+void BotSession_writeField(struct UtilsString *pOutput, char *sName, char cCode, int *pBefore, int dAfter) {
+  if(pBefore != NULL && *pBefore == dAfter)
+    return;
+
+  if(cCode)
+    UtilsString_appendFormat(pOutput, " %s.%c=%d", sName, cCode, dAfter);
+  else
+    UtilsString_appendFormat(pOutput, " %s=%d", sName, dAfter);
+}
+
+/**
+ * Writes the fields that changed from one state to another.
+ *
+ * @param   {struct BotSession *}   this      The session.
+ * @param   {struct UtilsString *}  pOutput   Where to write them.
+ * @param   {struct BotState *}     pBefore   The old state, or NULL to write every field.
+ * @param   {struct BotState *}     pAfter    The new state.
+ * @return  {int}                             How many fields were written.
+*/
+int BotSession_writeDelta(struct BotSession *this, struct UtilsString *pOutput, struct BotState *pBefore, struct BotState *pAfter) {
+  int dLength = UtilsString_getLength(pOutput);
+  int bAll = pBefore == NULL;
+  int dFields = 0;
+
+  // Saves us from writing pBefore == NULL ? NULL : &pBefore->... every time
+  if(bAll)
+    pBefore = pAfter;
+
+  BotSession_writeField(pOutput, "day", 0, bAll ? NULL : &pBefore->dDay, pAfter->dDay);
+  BotSession_writeField(pOutput, "starved", 0, bAll ? NULL : &pBefore->dStarved, pAfter->dStarved);
+  BotSession_writeField(pOutput, "energy", 0, bAll ? NULL : &pBefore->dEnergy, pAfter->dEnergy);
+  BotSession_writeField(pOutput, "gold", 0, bAll ? NULL : &pBefore->dGold, pAfter->dGold);
+  BotSession_writeField(pOutput, "untilled", 0, bAll ? NULL : &pBefore->dUntilled, pAfter->dUntilled);
+  BotSession_writeField(pOutput, "tilled", 0, bAll ? NULL : &pBefore->dTilled, pAfter->dTilled);
+
+  for(int i = 1; i < this->CATALOGUE->dSize; i++) {
+    char cCode = this->CATALOGUE->cProductCodeArray[i];
+
+    BotSession_writeField(pOutput, "seeds", cCode, bAll ? NULL : &pBefore->dSeedArray[i], pAfter->dSeedArray[i]);
+    BotSession_writeField(pOutput, "crops", cCode, bAll ? NULL : &pBefore->dCropArray[i], pAfter->dCropArray[i]);
+    BotSession_writeField(pOutput, "sown", cCode, bAll ? NULL : &pBefore->dSownArray[i], pAfter->dSownArray[i]);
+    BotSession_writeField(pOutput, "water", cCode, bAll ? NULL : &pBefore->dWaterArray[i], pAfter->dWaterArray[i]);
+  }
+
+  BotSession_writeField(pOutput, "dead", 0, bAll ? NULL : &pBefore->bIsDead, pAfter->bIsDead);
+
+  // Every field starts with a space
+  for(int i = dLength; i < UtilsString_getLength(pOutput); i++)
+    dFields += UtilsString_getText(pOutput)[i] == ' ';
+
+  return dFields;
+}
+
+/**
+ * ##########################
+ * ###  SESSION COMMANDS  ###
+ * ##########################
+*/
+
+/**
+ * Types a bunch of keys into the game, the same way UtilsKey_inputPoll() would have.
+ *
+ * @param   {struct BotSession *}   this    The session.
+ * @param   {char *}                sKeys   The keys (uppercase, like UtilsKey_uppercaseChar() gives them).
+*/
+void BotSession_type(struct BotSession *this, char *sKeys) {
+  for(int i = 0; sKeys[i]; i++) {
+    GameMini_IO(sKeys[i], &this->game);
+
+    if(strlen(this->game.sFeedbackString))
+      strcpy(this->sFeedback, this->game.sFeedbackString);
+  }
+}
+
+/**
+ * Puts the game back at the menu, whatever it was in the middle of.
+ * A person would've backed out with [G] a few times; commands that failed halfway can leave the game expecting a number though,
+ * so we just reset everything directly.
+ *
+ * @param   {struct BotSession *}   this  The session.
+*/
+void BotSession_settle(struct BotSession *this) {
+  struct GameMini *pGame = &this->game;
+
+  pGame->eGameState = GAME_MENU;
+  pGame->ePlayState = PLAY_SELECTING;
+
+  Farm_setCurrentAction(pGame->pFarm, FARM_NULL);
+  Farm_setCurrentCrop(pGame->pFarm, PRODUCT_NULL);
+  Shop_setCurrentAction(pGame->pShop, SHOP_NULL);
+  Shop_setCurrentCrop(pGame->pShop, PRODUCT_NULL);
+
+  strcpy(pGame->sCurrentInput, "");
+}
+
+/**
+ * Finds the crop with a given code.
+ *
+ * @param   {struct BotSession *}   this    The session.
+ * @param   {char *}                sCode   The code (either case).
+ * @return  {int}                           The crop, or -1 if there isn't one.
+*/
+int BotSession_findCrop(struct BotSession *this, char *sCode) {
+  if(sCode == NULL || strlen(sCode) != 1)
+    return -1;
+
+  enum ProductType eCrop = GameCatalogue_findCode(toupper(sCode[0]));
+
+  return eCrop != PRODUCT_NULL ? eCrop : -1;
+}
+
+/**
+ * Checks that an argument is a whole number the game would accept.
+ *
+ * @param   {char *}  sNumber   The argument.
+ * @return  {int}               Whether or not it is.
+*/
+int BotSession_isNumber(char *sNumber) {
+  if(sNumber == NULL || !strlen(sNumber) || strlen(sNumber) >= UTILS_KEY_MAX_DIGITS)
+    return 0;
+
+  for(int i = 0; sNumber[i]; i++)
+    if(!UtilsKey_isNum(sNumber[i]))
+      return 0;
+
+  return 1;
+}
+
+/**
+ * Waters or harvests every crop it can, one crop type after another, like someone going down the list.
+ *
+ * @param   {struct BotSession *}   this      The session.
+ * @param   {char}                  cAction   'W' or 'H'.
+*/
+void BotSession_doEveryCrop(struct BotSession *this, char cAction) {
+  char sKeys[4] = { 'F', cAction, 0, 0 };
+
+  for(int i = 1; i < this->CATALOGUE->dSize; i++) {
+    if(this->game.bCropSownStatesArray[i]) {
+      sKeys[2] = this->CATALOGUE->cProductCodeArray[i];
+
+      BotSession_type(this, sKeys);
+      BotSession_settle(this);
+    }
+  }
+}
+
+/**
+ * Runs a single command and writes the response line (without the newline).
+ * The response is "ok" and the fields that changed, or "err" and why nothing happened.
+ *
+ * @param   {struct BotSession *}   this      The session.
+ * @param   {char *}                sLine     The command; it gets chopped up.
+ * @param   {struct UtilsString *}  pOutput   Where the response goes (anything in it is cleared first).
+ * @return  {int}                             0 if the bot asked to quit, 1 otherwise.
+*/
+int BotSession_run(struct BotSession *this, char *sLine, struct UtilsString *pOutput) {
+  struct GameMini *pGame = &this->game;
+  struct BotState after;
+  char *sArgArray[BOT_MAX_ARGS] = { NULL };
+  char sKeys[UTILS_KEY_MAX_DIGITS + 8];
+  char *sError = NULL;
+  int dArgs = 0;
+  int dCrop;
+
+  // Split the line into words
+  for(char *sWord = strtok(sLine, " \t\r"); sWord != NULL && dArgs < BOT_MAX_ARGS; sWord = strtok(NULL, " \t\r"))
+    sArgArray[dArgs++] = sWord;
+
+  UtilsString_clear(pOutput);
+
+  if(!dArgs) {
+    UtilsString_append(pOutput, "err empty command");
+    return 1;
+  }
+
+  if(!strcmp(sArgArray[0], "quit"))
+    return 0;
+
+  // Everything, not just what changed
+  if(!strcmp(sArgArray[0], "look")) {
+    BotSession_getState(this, &after);
+    UtilsString_append(pOutput, "ok");
+    BotSession_writeDelta(this, pOutput, NULL, &after);
+    return 1;
+  }
+
+  // A brand new game
+  if(!strcmp(sArgArray[0], "reset")) {
+    GameMini_exit(pGame);
+    GameMini_init(pGame, this->CATALOGUE);
+    BotSession_getState(this, &after);
+    UtilsString_append(pOutput, "ok");
+    BotSession_writeDelta(this, pOutput, NULL, &after);
+    return 1;
+  }
+
+  if(pGame->bIsGameOver) {
+    UtilsString_append(pOutput, "err The game is over; send reset to play again.");
+    return 1;
+  }
+
+  BotSession_getState(this, &this->before);
+  strcpy(this->sFeedback, "");
+  dCrop = BotSession_findCrop(this, sArgArray[1]);
+
+  // Turn the command into keys
+  if(!strcmp(sArgArray[0], "till")) {
+    if(BotSession_isNumber(sArgArray[1])) {
+      sprintf(sKeys, "FT%s\n", sArgArray[1]);
+      BotSession_type(this, sKeys);
+    } else sError = "usage: till <plots>";
+
+  } else if(!strcmp(sArgArray[0], "sow")) {
+    if(dCrop > 0 && BotSession_isNumber(sArgArray[2])) {
+      sprintf(sKeys, "FS%c%s\n", this->CATALOGUE->cProductCodeArray[dCrop], sArgArray[2]);
+      BotSession_type(this, sKeys);
+    } else sError = "usage: sow <crop> <plots>";
+
+  } else if(!strcmp(sArgArray[0], "water") || !strcmp(sArgArray[0], "harvest")) {
+    char cAction = sArgArray[0][0] == 'w' ? 'W' : 'H';
+
+    if(sArgArray[1] == NULL) {
+      BotSession_doEveryCrop(this, cAction);
+    } else if(dCrop > 0) {
+      sprintf(sKeys, "F%c%c", cAction, this->CATALOGUE->cProductCodeArray[dCrop]);
+      BotSession_type(this, sKeys);
+    } else sError = cAction == 'W' ? "usage: water [crop]" : "usage: harvest [crop]";
+
+  } else if(!strcmp(sArgArray[0], "buy") || !strcmp(sArgArray[0], "sell")) {
+    if(dCrop > 0 && BotSession_isNumber(sArgArray[2])) {
+      sprintf(sKeys, "S%c%c%s\n", sArgArray[0][0] == 'b' ? 'B' : 'S', this->CATALOGUE->cProductCodeArray[dCrop], sArgArray[2]);
+      BotSession_type(this, sKeys);
+    } else sError = sArgArray[0][0] == 'b' ? "usage: buy <crop> <amount>" : "usage: sell <crop> <amount>";
+
+  // Going home shows a screen you have to get past with any key
+  } else if(!strcmp(sArgArray[0], "sleep")) {
+    int dNights = sArgArray[1] == NULL ? 1 : atoi(sArgArray[1]);
+
+    if(dNights > 0 && (sArgArray[1] == NULL || BotSession_isNumber(sArgArray[1]))) {
+      for(int i = 0; i < dNights && !pGame->bIsGameOver; i++)
+        BotSession_type(this, "H\n");
+    } else sError = "usage: sleep [nights]";
+
+  } else sError = "unknown command";
+
+  BotSession_settle(this);
+
+  if(sError != NULL) {
+    UtilsString_appendFormat(pOutput, "err %s", sError);
+    return 1;
+  }
+
+  // Commands that didn't change anything failed; the game says why
+  BotSession_getState(this, &after);
+  UtilsString_append(pOutput, "ok");
+
+  if(!BotSession_writeDelta(this, pOutput, &this->before, &after)) {
+    UtilsString_clear(pOutput);
+    UtilsString_appendFormat(pOutput, "err %s", strlen(this->sFeedback) ? this->sFeedback : "nothing happened");
+  }
+
+  return 1;
+}
+
+#endif
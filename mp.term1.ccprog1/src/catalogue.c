@@ -0,0 +1,351 @@
+/**
+ * The generator for the product table of Harvest Sun.
+ * It reads the products from a data file (see game/game.catalogue.csv) and writes them out as a header of constant
+ * initializers (game/game.catalogue.table.h), so the catalogue ends up in read-only memory and nothing has to fill it in
+ * when the game starts. Adding a crop is just adding a line to the data file.
+ *
+ * It also finds a perfect hash for the product codes: a multiplier that sends every code to its own slot of a small
+ * power-of-two table, so looking up a code is a multiply, a shift and one compare (see GameCatalogue_findCode()).
+ *
+ * Build (main.c does this for you before it compiles anything else):
+ *    gcc src/catalogue.c -o build/catalogue.unix.o -std=c99 -Wall
+ *
+ * Usage:
+ *    build/catalogue.unix.o [-i data file] [-o header]
+*/
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CATALOGUE_DEFAULT_INPUT "src/game/game.catalogue.csv"
+#define CATALOGUE_DEFAULT_OUTPUT "src/game/game.catalogue.table.h"
+
+// The game picks a crop with a single keypress (the minified game, the bot's key sequences), so every product
+// needs a key of its own: one of the 26 uppercase letters or 10 digits
+#define CATALOGUE_MAX_PRODUCTS 36
+#define CATALOGUE_MAX_NAME 32
+#define CATALOGUE_MAX_HASH_BITS 8
+#define CATALOGUE_HASH_TRIES 100000
+
+/**
+ * Everything the data file says about a product.
+*/
+struct CatalogueProduct {
+  char cCode;
+  char sName[CATALOGUE_MAX_NAME];
+  int dCostToBuy;
+  int dCostToSell;
+  int dWaterReq;
+};
+
+/**
+ * The products read so far, plus the hash we found for them.
+*/
+struct Catalogue {
+  struct CatalogueProduct productArray[CATALOGUE_MAX_PRODUCTS + 1];
+  int dSize;                  // Includes the null product at index 0, like CATALOGUE_SIZE does
+
+  uint32_t dHashMult;
+  int dHashBits;
+  unsigned char dSlotArray[1 << CATALOGUE_MAX_HASH_BITS];
+};
+
+/**
+ * Strips the spaces around a piece of a line, in place.
+ *
+ * @param   {char *}  sText   The text to trim.
+ * @return  {char *}          Where the trimmed text starts.
+*/
+char *Catalogue_trim(char *sText) {
+  char *sEnd = sText + strlen(sText);
+
+  while(isspace((unsigned char) *sText)) sText++;
+  while(sEnd > sText && isspace((unsigned char) sEnd[-1])) *--sEnd = 0;
+
+  return sText;
+}
+
+/**
+ * Reads the data file.
+ * The first line that's off gets reported with its line number and stops the whole thing, since a half-built table is worse than none.
+ *
+ * @param   {struct Catalogue *}  this    The catalogue to fill.
+ * @param   {char *}              sPath   The data file.
+ * @return  {int}                         Whether or not the file was fine.
+*/
+int Catalogue_read(struct Catalogue *this, char *sPath) {
+  FILE *pFile = fopen(sPath, "r");
+  char sLine[256];
+  int dLine = 0;
+  int bOkay = 1;
+
+  if(pFile == NULL) {
+    fprintf(stderr, "Couldn't open %s.\n", sPath);
+    return 0;
+  }
+
+  // The null product
+  memset(&this->productArray[0], 0, sizeof(struct CatalogueProduct));
+  this->dSize = 1;
+
+  while(bOkay && fgets(sLine, sizeof(sLine), pFile) != NULL) {
+    struct CatalogueProduct *pProduct = &this->productArray[this->dSize];
+    char *sFieldArray[5];
+    char *sText = Catalogue_trim(sLine);
+    int dFields = 0;
+
+    dLine++;
+
+    // Comments and blank lines
+    if(!*sText || *sText == '#')
+      continue;
+
+    for(char *sField = strtok(sText, ","); sField != NULL && dFields < 5; sField = strtok(NULL, ","))
+      sFieldArray[dFields++] = Catalogue_trim(sField);
+
+    if(dFields != 5 || strtok(NULL, ",") != NULL) {
+      fprintf(stderr, "%s:%d: expected code, name, buying price, selling price, water requirement.\n", sPath, dLine);
+      bOkay = 0;
+      break;
+    }
+
+    if(this->dSize > CATALOGUE_MAX_PRODUCTS) {
+      fprintf(stderr, "%s:%d: there can't be more than %d products, one for each letter and digit.\n", sPath, dLine, CATALOGUE_MAX_PRODUCTS);
+      bOkay = 0;
+      break;
+    }
+
+    // The game uppercases every key, so a lowercase code could never be typed
+    if(strlen(sFieldArray[0]) != 1 || !(isupper((unsigned char) sFieldArray[0][0]) || isdigit((unsigned char) sFieldArray[0][0]))) {
+      fprintf(stderr, "%s:%d: the code has to be a single uppercase letter or digit.\n", sPath, dLine);
+      bOkay = 0;
+      break;
+    }
+
+    // The name becomes part of an enum value, so it has to be a valid identifier too
+    int bName = *sFieldArray[1] && strlen(sFieldArray[1]) < CATALOGUE_MAX_NAME && isalpha((unsigned char) *sFieldArray[1]);
+    for(char *c = sFieldArray[1]; *c; c++)
+      bName = bName && (isalnum((unsigned char) *c) || *c == '_');
+
+    if(!bName) {
+      fprintf(stderr, "%s:%d: the name has to be a word of at most %d letters, digits or underscores.\n", sPath, dLine, CATALOGUE_MAX_NAME - 1);
+      bOkay = 0;
+      break;
+    }
+
+    pProduct->cCode = sFieldArray[0][0];
+    snprintf(pProduct->sName, CATALOGUE_MAX_NAME, "%s", sFieldArray[1]);
+    pProduct->dCostToBuy = atoi(sFieldArray[2]);
+    pProduct->dCostToSell = atoi(sFieldArray[3]);
+    pProduct->dWaterReq = atoi(sFieldArray[4]);
+
+    if(pProduct->dCostToBuy < 1 || pProduct->dCostToSell < 1 || pProduct->dWaterReq < 1) {
+      fprintf(stderr, "%s:%d: the prices and the water requirement have to be positive.\n", sPath, dLine);
+      bOkay = 0;
+      break;
+    }
+
+    // Two products can't share a code or a name (names that only differ in case would give the same enum value)
+    for(int i = 1; i < this->dSize && bOkay; i++) {
+      char *sOther = this->productArray[i].sName;
+      char *sName = pProduct->sName;
+
+      while(*sName && tolower((unsigned char) *sName) == tolower((unsigned char) *sOther)) sName++, sOther++;
+
+      if(this->productArray[i].cCode == pProduct->cCode || *sName == *sOther) {
+        fprintf(stderr, "%s:%d: %s clashes with %s.\n", sPath, dLine, pProduct->sName, this->productArray[i].sName);
+        bOkay = 0;
+      }
+    }
+
+    this->dSize++;
+  }
+
+  fclose(pFile);
+
+  if(!bOkay)
+    return 0;
+
+  if(this->dSize < 2) {
+    fprintf(stderr, "%s has no products in it.\n", sPath);
+    return 0;
+  }
+
+  return 1;
+}
+
+/**
+ * Looks for a perfect hash of the codes: slot = (code * mult) >> (32 - bits), with no two codes in the same slot.
+ * We start with the smallest table that could fit every code and only make it bigger when no multiplier works.
+ * The multipliers come from a fixed sequence, so the same data file always gives the same header.
+ *
+ * @param   {struct Catalogue *}  this  The catalogue.
+ * @return  {int}                       Whether or not a hash was found.
+*/
+int Catalogue_hash(struct Catalogue *this) {
+
+  // At least two slots, since shifting by all 32 bits (for a table of one) isn't allowed in C
+  int dBits = 1;
+
+  while((1 << dBits) < this->dSize - 1)
+    dBits++;
+
+  for(; dBits <= CATALOGUE_MAX_HASH_BITS; dBits++) {
+    uint32_t dSeed = 0x9E3779B9u;
+
+    for(int dTry = 0; dTry < CATALOGUE_HASH_TRIES; dTry++) {
+      uint32_t dMult = dSeed | 1;
+      int bPerfect = 1;
+
+      memset(this->dSlotArray, 0, sizeof(this->dSlotArray));
+
+      for(int i = 1; i < this->dSize && bPerfect; i++) {
+        uint32_t dSlot = ((uint32_t) (unsigned char) this->productArray[i].cCode * dMult) >> (32 - dBits);
+
+        if(this->dSlotArray[dSlot]) bPerfect = 0;
+        else this->dSlotArray[dSlot] = i;
+      }
+
+      if(bPerfect) {
+        this->dHashMult = dMult;
+        this->dHashBits = dBits;
+        return 1;
+      }
+
+      // Xorshift to the next multiplier
+      dSeed ^= dSeed << 13;
+      dSeed ^= dSeed >> 17;
+      dSeed ^= dSeed << 5;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Writes one column of the table as an initializer macro.
+ *
+ * @param   {struct Catalogue *}  this      The catalogue.
+ * @param   {FILE *}              pFile     The header.
+ * @param   {char *}              sMacro    The name of the macro.
+ * @param   {int}                 dColumn   Which column: 0 for the codes, 1 for the names, then the three numbers.
+*/
+void Catalogue_writeColumn(struct Catalogue *this, FILE *pFile, char *sMacro, int dColumn) {
+  fprintf(pFile, "#define %s { \\\n", sMacro);
+
+  for(int i = 0; i < this->dSize; i++) {
+    struct CatalogueProduct *pProduct = &this->productArray[i];
+
+    fprintf(pFile, "  ");
+
+    if(!i) fprintf(pFile, dColumn == 1 ? "NULL" : "0");
+    else if(dColumn == 0) fprintf(pFile, "'%c'", pProduct->cCode);
+    else if(dColumn == 1) fprintf(pFile, "\"%s\"", pProduct->sName);
+    else fprintf(pFile, "%d", dColumn == 2 ? pProduct->dCostToBuy : dColumn == 3 ? pProduct->dCostToSell : pProduct->dWaterReq);
+
+    fprintf(pFile, "%s \\\n", i + 1 < this->dSize ? "," : "");
+  }
+
+  fprintf(pFile, "}\n\n");
+}
+
+/**
+ * Writes the header.
+ *
+ * @param   {struct Catalogue *}  this    The catalogue.
+ * @param   {char *}              sPath   Where to write it.
+ * @param   {char *}              sInput  The data file it came from (for the comment at the top).
+ * @return  {int}                         Whether or not the header could be written.
+*/
+int Catalogue_write(struct Catalogue *this, char *sPath, char *sInput) {
+  FILE *pFile = fopen(sPath, "w");
+
+  if(pFile == NULL) {
+    fprintf(stderr, "Couldn't write %s.\n", sPath);
+    return 0;
+  }
+
+  fprintf(pFile, "/**\n");
+  fprintf(pFile, " * The product table of the game, generated by src/catalogue.c from %s.\n", sInput);
+  fprintf(pFile, " * Don't edit this by hand; change the data file and build again instead.\n");
+  fprintf(pFile, "*/\n\n");
+  fprintf(pFile, "#ifndef GAME_CATALOGUE_TABLE_\n");
+  fprintf(pFile, "#define GAME_CATALOGUE_TABLE_\n\n");
+
+  fprintf(pFile, "// Number of the types of crops we have in the game (including the null value)\n");
+  fprintf(pFile, "#define CATALOGUE_SIZE %d\n\n", this->dSize);
+
+  fprintf(pFile, "/**\n");
+  fprintf(pFile, " * An enum that stores all the different types of products in the game.\n");
+  fprintf(pFile, "*/\n");
+  fprintf(pFile, "enum ProductType { \n");
+  fprintf(pFile, "  PRODUCT_NULL,\n");
+
+  for(int i = 1; i < this->dSize; i++) {
+    fprintf(pFile, "  PRODUCT_");
+
+    for(char *c = this->productArray[i].sName; *c; c++)
+      fputc(toupper((unsigned char) *c), pFile);
+
+    fprintf(pFile, ",\n");
+  }
+
+  fprintf(pFile, "};\n\n");
+
+  fprintf(pFile, "// The columns of the data file, in the order of the enum\n");
+  Catalogue_writeColumn(this, pFile, "GAME_CATALOGUE_CODES", 0);
+  Catalogue_writeColumn(this, pFile, "GAME_CATALOGUE_NAMES", 1);
+  Catalogue_writeColumn(this, pFile, "GAME_CATALOGUE_COSTS_TO_BUY", 2);
+  Catalogue_writeColumn(this, pFile, "GAME_CATALOGUE_COSTS_TO_SELL", 3);
+  Catalogue_writeColumn(this, pFile, "GAME_CATALOGUE_WATER_REQS", 4);
+
+  fprintf(pFile, "// The perfect hash of the codes: slot = (code * mult) >> (32 - bits), and every slot holds a product (or null)\n");
+  fprintf(pFile, "#define GAME_CATALOGUE_HASH_MULT 0x%08Xu\n", (unsigned) this->dHashMult);
+  fprintf(pFile, "#define GAME_CATALOGUE_HASH_BITS %d\n", this->dHashBits);
+  fprintf(pFile, "#define GAME_CATALOGUE_HASH_SLOTS {");
+
+  for(int i = 0; i < 1 << this->dHashBits; i++)
+    fprintf(pFile, "%s%d", i ? ", " : " ", this->dSlotArray[i]);
+
+  fprintf(pFile, " }\n\n");
+  fprintf(pFile, "#endif\n");
+
+  fclose(pFile);
+
+  return 1;
+}
+
+int main(int argc, char *argv[]) {
+  static struct Catalogue catalogue;
+
+  char *sInput = CATALOGUE_DEFAULT_INPUT;
+  char *sOutput = CATALOGUE_DEFAULT_OUTPUT;
+
+  // Read the args
+  for(int i = 1; i + 1 < argc; i += 2) {
+    if(!strcmp(argv[i], "-i")) sInput = argv[i + 1];
+    else if(!strcmp(argv[i], "-o")) sOutput = argv[i + 1];
+    else {
+      fprintf(stderr, "Unknown option %s.\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if(!Catalogue_read(&catalogue, sInput))
+    return 1;
+
+  if(!Catalogue_hash(&catalogue)) {
+    fprintf(stderr, "Couldn't find a perfect hash for the codes in %s.\n", sInput);
+    return 1;
+  }
+
+  if(!Catalogue_write(&catalogue, sOutput, sInput))
+    return 1;
+
+  fprintf(stderr, "%d products, codes hashed into %d slots.\n", catalogue.dSize - 1, 1 << catalogue.dHashBits);
+
+  return 0;
+}
@@ -3,7 +3,11 @@
  * The main function here receives the parameters passed to the entry point of the program.
 */
 
+// We need fileno() and fsync() from POSIX (the journal syncs its file)
+#define _POSIX_C_SOURCE 200809L
+
 #include "utils/utils.io.h"
+#include "utils/utils.mem.h"
 
 #include "game/game.manager.h"
 #include "game/game.manager.min.h"
@@ -13,6 +17,10 @@
 
 int main(int argc, char *argv[]) {
 
+  // Keeps track of everything we allocate so we can dump a report at exit
+  // The report ends up in build/logs/.mem.txt
+  UtilsMem_init();
+
   // This is necessary for cross-platform compatibility (Windows + Unix)
   // Coding this was rather tedious: console behavior is just handled quite differently by both
   // I use Ubuntu so it was kinda necessary
@@ -23,14 +31,13 @@ int main(int argc, char *argv[]) {
   struct GameAssets assets;
   GameAssets_init(&assets);
 
-  // Game catalogue
-  struct GameCatalogue catalogue;
-  GameCatalogue_init(&catalogue);
+  // Game catalogue (it's generated from a data file, so there's nothing to set up)
+  struct GameCatalogue *pCatalogue = GameCatalogue_get();
 
   // Create game
   struct Game game;
-  Game_init(&game, &assets, &catalogue);
-  Game_conf(&game, argv[1], argv[2]);
+  Game_init(&game, &assets, pCatalogue);
+  Game_conf(&game, argv[1], argv[2], argc > 3 ? argv[3] : NULL);
   Game_exec(&game);
 
   // Also needed for the program to work across platforms (Windows + Unix)
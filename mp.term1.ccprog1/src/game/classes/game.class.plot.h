@@ -11,6 +11,8 @@
 #include <stdlib.h>
 
 #include "../game.catalogue.h"
+#include "../../utils/utils.mem.h"
+#include "../../utils/utils.pool.h"
 #include "../enums/game.enum.farm.h"
 #include "game.class.product.h"
 
@@ -23,6 +25,9 @@ struct Plot {
   struct Product *pProduct;
 };
 
+// The farm makes all of its plots at once, and the tools make a farm for every game they play
+UTILS_POOL_DEFINE(Plot, struct Plot, UTILS_MEM_PLOT, 64)
+
 /**
  * ###########################
  * ###  PLOT CONSTRUCTION  ###
@@ -37,7 +42,7 @@ struct Plot {
 struct Plot *Plot_new() {
   struct Plot *pPlot;
 
-  pPlot = calloc(1, sizeof(*pPlot));
+  pPlot = Plot_poolAlloc();
 
   if(pPlot == NULL)
     return NULL;
@@ -47,11 +52,15 @@ struct Plot *Plot_new() {
 
 /**
  * Frees memory from a destroyed instance.
+ * If there's still a crop on the plot, it gets destroyed too.
  * 
  * @param   {struct Plot *}   this  The instance to be destroyed.
 */
 void Plot_kill(struct Plot *this) {
-  free(this);
+  if(this->eState == PLOT_SOWN)
+    Product_kill(this->pProduct);
+
+  Plot_poolFree(this);
 }
 
 /**
@@ -16,6 +16,8 @@
 
 // We need the catalogue
 #include "../game.catalogue.h"
+#include "../../utils/utils.mem.h"
+#include "../../utils/utils.pool.h"
 
 /**
  * Defines a product class, primarily for crops.
@@ -25,6 +27,9 @@ struct Product {
   enum ProductType eType;
   char *sProductCode;
   char *sProductName;
+
+  // Where the product code is kept (sProductCode points here, so there's one less thing to allocate per sow)
+  char sProductCodeBuffer[2];
   
   int dCostToBuy;
   int dCostToSell;
@@ -33,8 +38,13 @@ struct Product {
   int dWaterAmt;
   int dTimePlanted;
   int dLastWatered;
+
+  int bIsWilting;     // Only ever set in real-time mode
 };
 
+// Products are made on every sow and killed on every harvest, so they come from a pool
+UTILS_POOL_DEFINE(Product, struct Product, UTILS_MEM_PRODUCT, 64)
+
 /**
  * ##############################
  * ###  PRODUCT CONSTRUCTION  ###
@@ -49,7 +59,7 @@ struct Product {
 struct Product *Product_new() {
   struct Product *pProduct;
   
-  pProduct = calloc(1, sizeof(*pProduct));
+  pProduct = Product_poolAlloc();
   
   // In case it wasn't able to allocate or not enough memory present
   if(pProduct == NULL)
@@ -60,11 +70,12 @@ struct Product *Product_new() {
 
 /**
  * Frees memory for a destroyed instance of Product.
+ * The product code lives inside the instance, so it goes with it.
  * 
  * @param   {struct Product *}  this  The instance to be destroyed.
 */
 void Product_kill(struct Product *this) {
-  free(this);
+  Product_poolFree(this);
 }
 
 /**
@@ -82,8 +93,9 @@ void Product_kill(struct Product *this) {
 */
 void Product_init(struct Product *this, enum ProductType eType, char cProductCode, char *sProductName, int dCostToBuy, int dCostToSell, int dWaterReq, int dWaterAmt, int dTimePlanted) {
   this->eType = eType;
-  this->sProductCode = calloc(1, sizeof(char));
+  this->sProductCode = this->sProductCodeBuffer;
   this->sProductCode[0] = cProductCode;
+  this->sProductCode[1] = 0;
   this->sProductName = sProductName;
   
   this->dCostToBuy = dCostToBuy;
@@ -94,6 +106,7 @@ void Product_init(struct Product *this, enum ProductType eType, char cProductCod
   
   this->dTimePlanted = dTimePlanted;
   this->dLastWatered = -1;
+  this->bIsWilting = 0;
 }
 
 /**
@@ -197,6 +210,38 @@ int Product_getLastWatered(struct Product *this) {
   return this->dLastWatered;
 }
 
+/**
+ * A function that returns whether or not the crop has gone too long without water.
+ * 
+ * @param   {struct Product *}  this  The product instance to be read.
+ * @return  {int}                     Whether or not the crop is wilting.
+*/
+int Product_isWilting(struct Product *this) {
+  return this->bIsWilting;
+}
+
+/**
+ * Marks the crop as wilting.
+ * Watering it again takes care of that.
+ * 
+ * @param   {struct Product *}  this  The product instance to be modified.
+*/
+void Product_setWilting(struct Product *this) {
+  this->bIsWilting = 1;
+}
+
+/**
+ * Lets the crop be watered again today, as if the last time it got water was yesterday.
+ * This is what real-time mode does when a crop is ready for more water before the day is over.
+ * 
+ * @param   {struct Product *}  this    The product instance to be modified.
+ * @param   {int}               dTime   The current day.
+*/
+void Product_setThirsty(struct Product *this, int dTime) {
+  if(this->dLastWatered >= dTime)
+    this->dLastWatered = dTime - 1;
+}
+
 /**
  * #########################
  * ###  PRODUCT METHODS  ###
@@ -219,6 +264,7 @@ int Product_water(struct Product *this, int dTime) {
     if(this->dWaterAmt < this->dWaterReq) {
       this->dLastWatered = dTime;
       this->dWaterAmt++;
+      this->bIsWilting = 0;
 
       return 1;
     }
@@ -227,4 +273,30 @@ int Product_water(struct Product *this, int dTime) {
   return 0;
 }
 
+/**
+ * Waters the crop once a day for a number of days, starting today, without doing it one day at a time.
+ * The crop ends up exactly where calling Product_water() on each of those days would have left it.
+ * 
+ * @param   {struct Product *}  this    The instance to be watered.
+ * @param   {int}               dTime   The current day.
+ * @param   {int}               dDays   How many days in a row to water it.
+ * @return  {int}                       How many times it actually got watered.
+*/
+int Product_fastForward(struct Product *this, int dTime, int dDays) {
+  int dFirst = this->dLastWatered < dTime ? dTime : this->dLastWatered + 1;
+  int dTimes = dTime + dDays - dFirst;
+
+  // Can't over water plants here either
+  if(dTimes > this->dWaterReq - this->dWaterAmt)
+    dTimes = this->dWaterReq - this->dWaterAmt;
+
+  if(dTimes <= 0)
+    return 0;
+
+  this->dWaterAmt += dTimes;
+  this->dLastWatered = dFirst + dTimes - 1;
+
+  return dTimes;
+}
+
 #endif
@@ -12,6 +12,8 @@
 
 // We need the catalogue
 #include "../game.catalogue.h"
+#include "../../utils/utils.mem.h"
+#include "../../utils/utils.pool.h"
 
 /**
  * Defines a stock class, primarily for fruits.
@@ -31,6 +33,9 @@ struct Stock {
   int dAmount;
 };
 
+// Every player and shop makes two of these per crop, and the tools make a player for every game they play
+UTILS_POOL_DEFINE(Stock, struct Stock, UTILS_MEM_STOCK, 64)
+
 /**
  * ############################
  * ###  STOCK CONSTRUCTION  ###
@@ -45,7 +50,7 @@ struct Stock {
 struct Stock *Stock_new() {
   struct Stock *pStock;
   
-  pStock = calloc(1, sizeof(*pStock));
+  pStock = Stock_poolAlloc();
   
   // In case it wasn't able to allocate or not enough memory present
   if(pStock == NULL)
@@ -60,7 +65,7 @@ struct Stock *Stock_new() {
  * @param   {struct Stock *}  this  The instance to be destroyed.
 */
 void Stock_kill(struct Stock *this) {
-  free(this);
+  Stock_poolFree(this);
 }
 
 /**
@@ -40,4 +40,13 @@ enum DialogState {
   DIALOG_EASTER,
 };
 
+/**
+ * The things that can happen to a crop on its own in real-time mode.
+*/
+enum RealtimeEvent {
+  REALTIME_READY,
+  REALTIME_WILTING,
+  REALTIME_DEAD,
+};
+
 #endif
\ No newline at end of file
@@ -26,7 +26,7 @@
 #define SCENE_FARM_SELECT_TEXT_LENGTH 12
 #define SCENE_SHOP_SELECT_TEXT_LENGTH 6
 #define GUIDE_TEXT_LENGTH 12
-#define CONTROLS_TEXT_LENGTH 5
+#define CONTROLS_TEXT_LENGTH 7
 #define AUTHOR_TEXT_LENGTH 4
 #define DIVIDER_TEXT_LENGTH 1
 
@@ -353,6 +353,8 @@ void GameAssets_init(struct GameAssets *this) {
   this->CONTROLS_TEXT[2] = "[W], [A], [S], [D]    -=>     Used for selecting items in a grid layout. ";
   this->CONTROLS_TEXT[3] = "[X], [C]              -=>     Toggle options present in a selection.     ";
   this->CONTROLS_TEXT[4] = "[Enter]               -=>     Finalize an action / select an option.     ";
+  this->CONTROLS_TEXT[5] = "[/]                   -=>     Search a list of products by name or code. ";
+  this->CONTROLS_TEXT[6] = "[U], [R]              -=>     Undo / redo the last farm or shop action.  ";
 
   //
   // About the author
@@ -1,24 +1,16 @@
 /**
  * A catalogue of the different products within the game.
+ * The products themselves live in game.catalogue.csv; src/catalogue.c turns that into game.catalogue.table.h,
+ * which gives us CATALOGUE_SIZE, the ProductType enum, the columns of the table and the hash of the product codes.
 */
 
 #ifndef GAME_CATALOGUE
 #define GAME_CATALOGUE
 
-// Number of the types of crops we have in the game (including the null value)
-#define CATALOGUE_SIZE 4
+#include <stddef.h>
+#include <stdint.h>
 
-/**
- * An enum that stores all the different types of products in the game.
- * Note that I have decided to omit the other crop for the sake of following the course specs.
-*/
-enum ProductType { 
-  PRODUCT_NULL,
-  // PRODUCT_APPLE,
-  PRODUCT_BANANA, 
-  PRODUCT_CORN, 
-  PRODUCT_MANGO, 
-};
+#include "game.catalogue.table.h"
 
 /**
  * Stores the different information we need about the crops.
@@ -37,38 +29,57 @@ struct GameCatalogue {
   int dSize;
 };
 
+/**
+ * The catalogue as the data file has it.
+ * It's const, so it sits in read-only memory and there's nothing to fill in at startup.
+*/
+static const struct GameCatalogue GAME_CATALOGUE_DATA = {
+  GAME_CATALOGUE_CODES,
+  GAME_CATALOGUE_NAMES,
+  GAME_CATALOGUE_COSTS_TO_BUY,
+  GAME_CATALOGUE_COSTS_TO_SELL,
+  GAME_CATALOGUE_WATER_REQS,
+  CATALOGUE_SIZE,
+};
+
+// The slots of the perfect hash of the product codes (see GameCatalogue_findCode())
+static const unsigned char GAME_CATALOGUE_HASH_SLOT_ARRAY[1 << GAME_CATALOGUE_HASH_BITS] = GAME_CATALOGUE_HASH_SLOTS;
+
 /**
  * A function that initializes the information in the catalogue.
- * 
+ * Only needed when you want a copy you can change (the simulator tweaks the prices, for instance);
+ * otherwise just use GameCatalogue_get().
+ *
  * @param   {struct GameCatalogue *}  this  The catalogue.
 */
 void GameCatalogue_init(struct GameCatalogue *this) {
-  
-  // this->cProductCodeArray[PRODUCT_APPLE] = 'A';
-  // this->sProductNameArray[PRODUCT_APPLE] = "apple";
-  // this->dProductCostToBuyArray[PRODUCT_APPLE] = 6;
-  // this->dProductCostToSellArray[PRODUCT_APPLE] = 9;
-  // this->dProductWaterReqArray[PRODUCT_APPLE] = 7;
-  
-  this->cProductCodeArray[PRODUCT_BANANA] = 'B';
-  this->sProductNameArray[PRODUCT_BANANA] = "banana";
-  this->dProductCostToBuyArray[PRODUCT_BANANA] = 3;
-  this->dProductCostToSellArray[PRODUCT_BANANA] = 4;
-  this->dProductWaterReqArray[PRODUCT_BANANA] = 4;
+  *this = GAME_CATALOGUE_DATA;
+}
 
-  this->cProductCodeArray[PRODUCT_CORN] = 'C';
-  this->sProductNameArray[PRODUCT_CORN] = "corn";
-  this->dProductCostToBuyArray[PRODUCT_CORN] = 5;
-  this->dProductCostToSellArray[PRODUCT_CORN] = 7;
-  this->dProductWaterReqArray[PRODUCT_CORN] = 6;
+/**
+ * Returns the catalogue in read-only memory.
+ * The pointer isn't const so it can go wherever a catalogue goes, but writing through it will crash the game.
+ *
+ * @return  {struct GameCatalogue *}  The catalogue.
+*/
+struct GameCatalogue *GameCatalogue_get() {
+  return (struct GameCatalogue *) &GAME_CATALOGUE_DATA;
+}
 
-  this->cProductCodeArray[PRODUCT_MANGO] = 'M';
-  this->sProductNameArray[PRODUCT_MANGO] = "mango";
-  this->dProductCostToBuyArray[PRODUCT_MANGO] = 7;
-  this->dProductCostToSellArray[PRODUCT_MANGO] = 10;
-  this->dProductWaterReqArray[PRODUCT_MANGO] = 8;
+/**
+ * Returns the product with the given code, or the null product if there isn't one.
+ * The generated hash sends every code to its own slot, so this is one multiply, one shift and one compare;
+ * when the code is a constant, the compiler can fold the whole thing away.
+ *
+ * @param   {char}              cCode   The code of the product (uppercase, like the keys the game reads).
+ * @return  {enum ProductType}          The product with that code.
+*/
+enum ProductType GameCatalogue_findCode(char cCode) {
+  uint32_t dSlot = ((uint32_t) (unsigned char) cCode * GAME_CATALOGUE_HASH_MULT) >> (32 - GAME_CATALOGUE_HASH_BITS);
+  enum ProductType eType = GAME_CATALOGUE_HASH_SLOT_ARRAY[dSlot];
 
-  this->dSize = CATALOGUE_SIZE;
+  // Anything that isn't a code still lands in some slot, so check that it's the right one
+  return cCode && GAME_CATALOGUE_DATA.cProductCodeArray[eType] == cCode ? eType : PRODUCT_NULL;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,63 @@
+/**
+ * The product table of the game, generated by src/catalogue.c from src/game/game.catalogue.csv.
+ * Don't edit this by hand; change the data file and build again instead.
+*/
+
+#ifndef GAME_CATALOGUE_TABLE_
+#define GAME_CATALOGUE_TABLE_
+
+// Number of the types of crops we have in the game (including the null value)
+#define CATALOGUE_SIZE 4
+
+/**
+ * An enum that stores all the different types of products in the game.
+*/
+enum ProductType { 
+  PRODUCT_NULL,
+  PRODUCT_BANANA,
+  PRODUCT_CORN,
+  PRODUCT_MANGO,
+};
+
+// The columns of the data file, in the order of the enum
+#define GAME_CATALOGUE_CODES { \
+  0, \
+  'B', \
+  'C', \
+  'M' \
+}
+
+#define GAME_CATALOGUE_NAMES { \
+  NULL, \
+  "banana", \
+  "corn", \
+  "mango" \
+}
+
+#define GAME_CATALOGUE_COSTS_TO_BUY { \
+  0, \
+  3, \
+  5, \
+  7 \
+}
+
+#define GAME_CATALOGUE_COSTS_TO_SELL { \
+  0, \
+  4, \
+  7, \
+  10 \
+}
+
+#define GAME_CATALOGUE_WATER_REQS { \
+  0, \
+  4, \
+  6, \
+  8 \
+}
+
+// The perfect hash of the codes: slot = (code * mult) >> (32 - bits), and every slot holds a product (or null)
+#define GAME_CATALOGUE_HASH_MULT 0x9E3779B9u
+#define GAME_CATALOGUE_HASH_BITS 2
+#define GAME_CATALOGUE_HASH_SLOTS { 0, 2, 3, 1 }
+
+#endif
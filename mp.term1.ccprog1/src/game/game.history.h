@@ -0,0 +1,460 @@
+/**
+ * Undo and redo for the full game.
+ * Every farm action, purchase, sale and night of sleep becomes a delta: the numbers it changed (gold, energy, the
+ * day, the stocks) as differences, and the plots it changed as before and after records (the same ones a save has,
+ * see game.save.h). Undoing subtracts the differences and puts the before records back; redoing adds them and puts
+ * the after records back, so either one only touches what the action touched.
+ *
+ * The deltas are found by comparing the game against a copy of it from after the last action. A farm action only
+ * compares the plots that were in its queue, and the other actions don't change any plots at all.
+ * The deltas sit back to back in one buffer, and only the last GAME_HISTORY_DEPTH of them are kept.
+ *
+ * Undoing past a save isn't allowed: the journal (see game.journal.h) plays back undos on top of the save, and the
+ * save doesn't know what came before it. Since the game saves every time the player sleeps, sleeping can only be
+ * undone in debug mode, which never saves.
+*/
+
+#ifndef GAME_HISTORY
+#define GAME_HISTORY
+
+#include <stdint.h>
+#include <string.h>
+
+#include "game.catalogue.h"
+#include "game.save.h"
+
+#include "objects/game.obj.player.h"
+#include "objects/game.obj.farm.h"
+#include "objects/game.obj.shop.h"
+
+#include "../utils/utils.mem.h"
+#include "../utils/utils.panel.h"
+
+// How many actions can be undone in a row
+#define GAME_HISTORY_DEPTH 64
+
+// The numbers an action can change: the five of the player, then the seeds, the crops and the shop stock of every product
+#define GAME_HISTORY_PLAYER_COUNTERS 5
+#define GAME_HISTORY_COUNTERS (GAME_HISTORY_PLAYER_COUNTERS + 3 * CATALOGUE_SIZE)
+
+/**
+ * The start of a delta; the counters come right after it, then the plots.
+ * Every record below is a multiple of four bytes long, so they can be read straight out of the buffer.
+*/
+struct GameHistoryHeader {
+  uint16_t dCounters;
+  uint16_t dPlots;
+};
+
+/**
+ * A number that changed.
+*/
+struct GameHistoryCounter {
+  uint16_t dIndex;
+  uint16_t dUnused;
+  int32_t dChange;
+};
+
+/**
+ * A plot that changed.
+*/
+struct GameHistoryPlot {
+  uint16_t dIndex;
+  uint16_t dUnused;
+  struct GameSavePlot before;
+  struct GameSavePlot after;
+};
+
+/**
+ * Keeps the deltas and the copy of the game they're found with.
+*/
+struct GameHistory {
+
+  // What's being kept track of (the game makes new ones on a game over)
+  struct Player *pPlayer;
+  struct Farm *pFarm;
+  struct Shop *pShop;
+  struct GameCatalogue *pCatalogue;
+
+  // The game as of the last action
+  int32_t dCounterArray[GAME_HISTORY_COUNTERS];
+  struct GameSavePlot plotArray[FARM_MAX_WIDTH * FARM_MAX_HEIGHT];
+
+  // The deltas, and where each of them starts (the one after the last says where the next one goes)
+  unsigned char *pDeltaArray;
+  size_t dCapacity;
+  size_t dOffsetArray[GAME_HISTORY_DEPTH + 1];
+
+  // How many deltas there are, and how many of them are done (the rest can be redone)
+  int dCount;
+  int dCursor;
+};
+
+/**
+ * ##############################
+ * ###  HISTORY CONSTRUCTION  ###
+ * ##############################
+*/
+
+/**
+ * Allocates memory for an instance of the GameHistory class.
+ *
+ * @return  {struct GameHistory *}  A pointer to the created instance.
+*/
+struct GameHistory *GameHistory_new() {
+  struct GameHistory *pGameHistory;
+
+  pGameHistory = UtilsMem_calloc(UTILS_MEM_GAME, 1, sizeof(*pGameHistory));
+
+  if(pGameHistory == NULL)
+    return NULL;
+
+  return pGameHistory;
+}
+
+/**
+ * Initializes the instance.
+ * Nothing gets kept track of until GameHistory_attach() is called.
+ *
+ * @param   {struct GameHistory *}  this  The instance to be initialized.
+*/
+void GameHistory_init(struct GameHistory *this) {
+  this->pPlayer = NULL;
+  this->pFarm = NULL;
+  this->pShop = NULL;
+  this->pCatalogue = NULL;
+
+  this->pDeltaArray = NULL;
+  this->dCapacity = 0;
+  this->dOffsetArray[0] = 0;
+
+  this->dCount = 0;
+  this->dCursor = 0;
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @return  {struct GameHistory *}  The created instance.
+*/
+struct GameHistory *GameHistory_create() {
+  struct GameHistory *pGameHistory = GameHistory_new();
+  GameHistory_init(pGameHistory);
+
+  return pGameHistory;
+}
+
+/**
+ * #########################
+ * ###  HISTORY HELPERS  ###
+ * #########################
+*/
+
+/**
+ * Returns where one of the numbers an action can change lives.
+ *
+ * @param   {struct GameHistory *}  this    The instance.
+ * @param   {int}                   dIndex  Which number (see GAME_HISTORY_COUNTERS).
+ * @return  {int *}                         The number.
+*/
+int *GameHistory_getCounter(struct GameHistory *this, int dIndex) {
+  switch(dIndex) {
+    case 0: return &this->pPlayer->dTime;
+    case 1: return &this->pPlayer->dDaysStarved;
+    case 2: return &this->pPlayer->bIsStarving;
+    case 3: return &this->pPlayer->dGold;
+    case 4: return &this->pPlayer->dEnergy;
+  }
+
+  dIndex -= GAME_HISTORY_PLAYER_COUNTERS;
+
+  if(dIndex < CATALOGUE_SIZE)
+    return &this->pPlayer->pSeedStockArray[dIndex]->dAmount;
+
+  dIndex -= CATALOGUE_SIZE;
+
+  if(dIndex < CATALOGUE_SIZE)
+    return &this->pPlayer->pCropStockArray[dIndex]->dAmount;
+
+  return &this->pShop->pStockArray[dIndex - CATALOGUE_SIZE]->dAmount;
+}
+
+/**
+ * Makes the copy of the game match the game.
+ *
+ * @param   {struct GameHistory *}  this  The instance.
+*/
+void GameHistory_sync(struct GameHistory *this) {
+  for(int i = 0; i < GAME_HISTORY_COUNTERS; i++)
+    this->dCounterArray[i] = *GameHistory_getCounter(this, i);
+
+  for(int i = 0; i < this->pFarm->dSize; i++)
+    GameSave_packPlot(&this->plotArray[i], this->pFarm->pPlotArray[i]);
+}
+
+/**
+ * Makes sure the buffer can hold the given number of bytes.
+ *
+ * @param   {struct GameHistory *}  this    The instance.
+ * @param   {size_t}                dSize   How many bytes it has to hold.
+ * @return  {int}                           Whether or not there's enough room.
+*/
+int GameHistory_reserve(struct GameHistory *this, size_t dSize) {
+  size_t dCapacity = this->dCapacity ? this->dCapacity : 1024;
+  unsigned char *pDeltaArray;
+
+  if(dSize <= this->dCapacity)
+    return 1;
+
+  while(dCapacity < dSize)
+    dCapacity *= 2;
+
+  pDeltaArray = UtilsMem_realloc(UTILS_MEM_GAME, this->pDeltaArray, dCapacity);
+
+  if(pDeltaArray == NULL)
+    return 0;
+
+  this->pDeltaArray = pDeltaArray;
+  this->dCapacity = dCapacity;
+  return 1;
+}
+
+/**
+ * Forgets the oldest delta to make room for a new one.
+ *
+ * @param   {struct GameHistory *}  this  The instance.
+*/
+void GameHistory_dropOldest(struct GameHistory *this) {
+  size_t dDropped = this->dOffsetArray[1];
+
+  memmove(this->pDeltaArray, this->pDeltaArray + dDropped, this->dOffsetArray[this->dCount] - dDropped);
+
+  for(int i = 0; i < this->dCount; i++)
+    this->dOffsetArray[i] = this->dOffsetArray[i + 1] - dDropped;
+
+  this->dCount--;
+  this->dCursor--;
+}
+
+/**
+ * Undoes or redoes a delta.
+ *
+ * @param   {struct GameHistory *}  this    The instance.
+ * @param   {int}                   dDelta  Which delta.
+ * @param   {int}                   dSign   -1 to undo it, 1 to redo it.
+*/
+void GameHistory_apply(struct GameHistory *this, int dDelta, int dSign) {
+  unsigned char *pCursor = this->pDeltaArray + this->dOffsetArray[dDelta];
+  struct GameHistoryHeader *pHeader = (struct GameHistoryHeader *) pCursor;
+  struct GameHistoryCounter *pCounter = (struct GameHistoryCounter *) (pHeader + 1);
+  struct GameHistoryPlot *pPlot = (struct GameHistoryPlot *) (pCounter + pHeader->dCounters);
+
+  for(int i = 0; i < pHeader->dCounters; i++, pCounter++) {
+    *GameHistory_getCounter(this, pCounter->dIndex) += dSign * pCounter->dChange;
+    this->dCounterArray[pCounter->dIndex] += dSign * pCounter->dChange;
+  }
+
+  for(int i = 0; i < pHeader->dPlots; i++, pPlot++) {
+    struct GameSavePlot *pRecord = dSign < 0 ? &pPlot->before : &pPlot->after;
+
+    GameSave_unpackPlot(pRecord, this->pFarm->pPlotArray[pPlot->dIndex], this->pCatalogue);
+    this->plotArray[pPlot->dIndex] = *pRecord;
+    Farm_markDirty(this->pFarm, pPlot->dIndex);
+  }
+
+  // The player and the shop don't know which of their numbers changed, so they get redrawn either way
+  this->pPlayer->dVersion = UtilsPanel_nextVersion();
+  this->pShop->dVersion = UtilsPanel_nextVersion();
+}
+
+/**
+ * #########################
+ * ###  HISTORY METHODS  ###
+ * #########################
+*/
+
+/**
+ * Starts keeping track of a game (the game makes new objects on a game over); nothing before this can be undone.
+ *
+ * @param   {struct GameHistory *}    this        The instance.
+ * @param   {struct Player *}         pPlayer     The player.
+ * @param   {struct Farm *}           pFarm       The farm.
+ * @param   {struct Shop *}           pShop       The shop.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue.
+*/
+void GameHistory_attach(struct GameHistory *this, struct Player *pPlayer, struct Farm *pFarm, struct Shop *pShop, struct GameCatalogue *pCatalogue) {
+  this->pPlayer = pPlayer;
+  this->pFarm = pFarm;
+  this->pShop = pShop;
+  this->pCatalogue = pCatalogue;
+
+  this->dCount = 0;
+  this->dCursor = 0;
+
+  GameHistory_sync(this);
+}
+
+/**
+ * Forgets every delta, so nothing before now can be undone.
+ *
+ * @param   {struct GameHistory *}  this  The instance.
+*/
+void GameHistory_clear(struct GameHistory *this) {
+  this->dCount = 0;
+  this->dCursor = 0;
+}
+
+/**
+ * Turns whatever changed since the last action into a delta.
+ * Anything that was undone can't be redone after this (unless nothing changed).
+ *
+ * @param   {struct GameHistory *}  this            The instance.
+ * @param   {int *}                 bPlotArray      Which plots the action could have changed (NULL for none).
+ * @return  {int}                                   Whether or not anything changed.
+*/
+int GameHistory_record(struct GameHistory *this, int *bPlotArray) {
+  size_t dStart = this->dOffsetArray[this->dCount];
+  size_t dLength = sizeof(struct GameHistoryHeader);
+  struct GameHistoryHeader *pHeader;
+  struct GameHistoryCounter *pCounter;
+  struct GameHistoryPlot *pPlot;
+  struct GameSavePlot plot;
+
+  // The new delta is put together after all the others, where it can't clobber the ones that could be redone
+  if(!GameHistory_reserve(this, dStart + dLength +
+    GAME_HISTORY_COUNTERS * sizeof(*pCounter) +
+    (bPlotArray != NULL ? this->pFarm->dSize : 0) * sizeof(*pPlot))) {
+    GameHistory_sync(this);
+    GameHistory_clear(this);
+    return 0;
+  }
+
+  pHeader = (struct GameHistoryHeader *) (this->pDeltaArray + dStart);
+  pCounter = (struct GameHistoryCounter *) (pHeader + 1);
+  pHeader->dCounters = 0;
+  pHeader->dPlots = 0;
+
+  for(int i = 0; i < GAME_HISTORY_COUNTERS; i++) {
+    int dValue = *GameHistory_getCounter(this, i);
+
+    if(dValue != this->dCounterArray[i]) {
+      pCounter->dIndex = i;
+      pCounter->dUnused = 0;
+      pCounter->dChange = dValue - this->dCounterArray[i];
+      this->dCounterArray[i] = dValue;
+
+      pCounter++;
+      pHeader->dCounters++;
+    }
+  }
+
+  pPlot = (struct GameHistoryPlot *) pCounter;
+
+  for(int i = 0; bPlotArray != NULL && i < this->pFarm->dSize; i++) {
+    if(!bPlotArray[i])
+      continue;
+
+    GameSave_packPlot(&plot, this->pFarm->pPlotArray[i]);
+
+    if(memcmp(&plot, &this->plotArray[i], sizeof(plot))) {
+      pPlot->dIndex = i;
+      pPlot->dUnused = 0;
+      pPlot->before = this->plotArray[i];
+      pPlot->after = plot;
+      this->plotArray[i] = plot;
+
+      pPlot++;
+      pHeader->dPlots++;
+    }
+  }
+
+  if(!pHeader->dCounters && !pHeader->dPlots)
+    return 0;
+
+  dLength = (unsigned char *) pPlot - (unsigned char *) pHeader;
+
+  // Whatever was undone is gone for good now
+  this->dCount = this->dCursor;
+
+  if(this->dCount == GAME_HISTORY_DEPTH)
+    GameHistory_dropOldest(this);
+
+  memmove(this->pDeltaArray + this->dOffsetArray[this->dCount], pHeader, dLength);
+
+  this->dCount++;
+  this->dCursor = this->dCount;
+  this->dOffsetArray[this->dCount] = this->dOffsetArray[this->dCount - 1] + dLength;
+
+  return 1;
+}
+
+/**
+ * Undoes the last action that hasn't been undone yet.
+ *
+ * @param   {struct GameHistory *}  this  The instance.
+ * @return  {int}                         Whether or not there was anything to undo.
+*/
+int GameHistory_undo(struct GameHistory *this) {
+  if(!this->dCursor)
+    return 0;
+
+  GameHistory_apply(this, --this->dCursor, -1);
+  return 1;
+}
+
+/**
+ * Redoes the last action that was undone.
+ *
+ * @param   {struct GameHistory *}  this  The instance.
+ * @return  {int}                         Whether or not there was anything to redo.
+*/
+int GameHistory_redo(struct GameHistory *this) {
+  if(this->dCursor == this->dCount)
+    return 0;
+
+  GameHistory_apply(this, this->dCursor++, 1);
+  return 1;
+}
+
+/**
+ * Records a farm action; the farm calls this before it clears the queue.
+ *
+ * @param   {void *}          pData   The instance.
+ * @param   {struct Farm *}   pFarm   The farm.
+*/
+void GameHistory_onQueue(void *pData, struct Farm *pFarm) {
+  GameHistory_record(pData, pFarm->bSelectionQueue);
+}
+
+/**
+ * Records a purchase or a sale; the shop calls this.
+ *
+ * @param   {void *}              pData         The instance.
+ * @param   {enum ShopAction}     eAction       Whether it was bought or sold.
+ * @param   {enum ProductType}    eProductType  What was bought or sold.
+ * @param   {int}                 dAmount       How many.
+*/
+void GameHistory_onTrade(void *pData, enum ShopAction eAction, enum ProductType eProductType, int dAmount) {
+  GameHistory_record(pData, NULL);
+}
+
+/**
+ * Records a night of sleep.
+ *
+ * @param   {struct GameHistory *}  this  The instance.
+*/
+void GameHistory_onSleep(struct GameHistory *this) {
+  GameHistory_record(this, NULL);
+}
+
+/**
+ * Destroys the instance.
+ *
+ * @param   {struct GameHistory *}  this  The instance to be destroyed.
+*/
+void GameHistory_kill(struct GameHistory *this) {
+  UtilsMem_free(this->pDeltaArray);
+  UtilsMem_free(this);
+}
+
+#endif
@@ -0,0 +1,726 @@
+/**
+ * The action journal of the full game.
+ * A save (see game.save.h) only happens when the player sleeps or leaves to the menu, so anything done in between
+ * would be lost if the game got killed. To fix that, every action that changes the game (naming the player,
+ * a farm action, a purchase or sale, going to sleep, undoing or redoing one of those) is added to the end of a
+ * journal file as it happens.
+ * On startup, the save plus whatever the journal has after it gives back the exact game.
+ *
+ * Each record is a handful of varints (seven bits per byte, the top bit says another byte follows), so an action
+ * costs a few bytes at the end of a file instead of a whole save. Each record is put together in a buffer and handed
+ * to the OS in one write, so a game that crashes or gets killed loses nothing. Making sure the OS has put them on the
+ * disk (fsync()) is much slower, so that's only done every few records, and on every save and on exit; a power cut
+ * can cost at most the last GAME_JOURNAL_GROUP - 1 actions.
+ *
+ * The records are numbered, and a save knows how many of them it includes. Once a save is known to be on the disk,
+ * the records it includes get cut off the front of the journal, so the file never grows past a day or so of actions.
+ * Real-time mode doesn't keep a journal: its crops change with the clock, so the records couldn't be played back.
+*/
+
+#ifndef GAME_JOURNAL
+#define GAME_JOURNAL
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "game.catalogue.h"
+#include "game.save.h"
+#include "game.history.h"
+
+#include "objects/game.obj.player.h"
+#include "objects/game.obj.farm.h"
+#include "objects/game.obj.shop.h"
+
+#include "enums/game.enum.farm.h"
+#include "enums/game.enum.shop.h"
+
+#include "../utils/utils.mem.h"
+
+// Where the journal goes (next to the save)
+#define GAME_JOURNAL_PATH "build/.journal.bin"
+
+// Bump the version whenever the records change
+#define GAME_JOURNAL_MAGIC "HSJL"
+#define GAME_JOURNAL_VERSION 2
+
+// How many records can be written before they have to be synced
+#define GAME_JOURNAL_GROUP 8
+
+// The longest a record can be: a tag, three fields and a varint for each plot (none of them take more than five bytes)
+#define GAME_JOURNAL_RECORD_MAX (5 * (4 + FARM_MAX_WIDTH * FARM_MAX_HEIGHT))
+
+/**
+ * The kinds of records.
+*/
+enum GameJournalRecord {
+  JOURNAL_NULL,
+  JOURNAL_NAME,       // The length of the name, then the name
+  JOURNAL_FARM,       // The action, the crop, the number of plots, then the gaps between the indices of the plots
+  JOURNAL_TRADE,      // The action, the crop, then the amount
+  JOURNAL_SLEEP,      // Nothing else
+  JOURNAL_UNDO,       // Nothing else
+  JOURNAL_REDO,       // Nothing else
+};
+
+/**
+ * A record once it's been read.
+*/
+struct GameJournalEntry {
+  enum GameJournalRecord eRecord;
+  unsigned int eAction;
+  unsigned int eProductType;
+  unsigned int dAmount;
+
+  char sName[PLAYER_NAME_MAX_LEN + 1];
+  int bQueueArray[FARM_MAX_WIDTH * FARM_MAX_HEIGHT];
+};
+
+/**
+ * Keeps the journal file open for appending.
+*/
+struct GameJournal {
+  char *sPath;
+  FILE *pFile;
+
+  // The number of the first record in the file, and of the next one to be written
+  unsigned int dStartSeq;
+  unsigned int dSeq;
+
+  // Records that haven't been synced yet
+  int dPending;
+
+  // Identifies the catalogue the records were made with (see GameSave_hash())
+  uint32_t dCatalogueHash;
+
+  // Where the records are put together
+  unsigned char pRecordArray[GAME_JOURNAL_RECORD_MAX];
+};
+
+/**
+ * ##############################
+ * ###  JOURNAL CONSTRUCTION  ###
+ * ##############################
+*/
+
+/**
+ * Allocates memory for an instance of the GameJournal class.
+ *
+ * @return  {struct GameJournal *}  A pointer to the created instance.
+*/
+struct GameJournal *GameJournal_new() {
+  struct GameJournal *pGameJournal;
+
+  pGameJournal = UtilsMem_calloc(UTILS_MEM_GAME, 1, sizeof(*pGameJournal));
+
+  if(pGameJournal == NULL)
+    return NULL;
+
+  return pGameJournal;
+}
+
+/**
+ * Initializes the instance.
+ * Nothing gets opened until GameJournal_recover() or GameJournal_reset() says where the journal starts.
+ *
+ * @param   {struct GameJournal *}    this        The instance to be initialized.
+ * @param   {char *}                  sPath       Where the journal goes.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue the records refer to.
+*/
+void GameJournal_init(struct GameJournal *this, char *sPath, struct GameCatalogue *pCatalogue) {
+  this->sPath = sPath;
+  this->pFile = NULL;
+  this->dStartSeq = 0;
+  this->dSeq = 0;
+  this->dPending = 0;
+  this->dCatalogueHash = GameSave_hash(pCatalogue->cProductCodeArray, pCatalogue->dSize);
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @param   {char *}                  sPath       Where the journal goes.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue the records refer to.
+ * @return  {struct GameJournal *}                The created instance.
+*/
+struct GameJournal *GameJournal_create(char *sPath, struct GameCatalogue *pCatalogue) {
+  struct GameJournal *pGameJournal = GameJournal_new();
+  GameJournal_init(pGameJournal, sPath, pCatalogue);
+
+  return pGameJournal;
+}
+
+/**
+ * ################################
+ * ###  JOURNAL VARINT HELPERS  ###
+ * ################################
+*/
+
+/**
+ * Writes a varint.
+ *
+ * @param   {unsigned char *}   pBuffer   Where it goes (at least five bytes).
+ * @param   {unsigned int}      dValue    The number.
+ * @return  {int}                         How many bytes it took.
+*/
+int GameJournal_putVarint(unsigned char *pBuffer, unsigned int dValue) {
+  int dLength = 0;
+
+  while(dValue >= 0x80) {
+    pBuffer[dLength++] = (dValue & 0x7F) | 0x80;
+    dValue >>= 7;
+  }
+
+  pBuffer[dLength++] = dValue;
+  return dLength;
+}
+
+/**
+ * Reads a varint and moves the cursor past it.
+ *
+ * @param   {unsigned char **}  ppCursor  Where to read from.
+ * @param   {unsigned char *}   pEnd      Where the data ends.
+ * @param   {unsigned int *}    pValue    Where the number goes.
+ * @return  {int}                         Whether or not there was a whole varint there.
+*/
+int GameJournal_getVarint(unsigned char **ppCursor, unsigned char *pEnd, unsigned int *pValue) {
+  unsigned int dValue = 0;
+
+  // An int never needs more than five bytes
+  for(int i = 0; i < 5 && *ppCursor < pEnd; i++) {
+    unsigned char cByte = *(*ppCursor)++;
+    dValue |= (unsigned int) (cByte & 0x7F) << (7 * i);
+
+    if(!(cByte & 0x80)) {
+      *pValue = dValue;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * ##############################
+ * ###  JOURNAL FILE HELPERS  ###
+ * ##############################
+*/
+
+/**
+ * Reads the whole journal file.
+ *
+ * @param   {char *}              sPath     Where the journal is.
+ * @param   {size_t *}            pSize     Where the size of the file goes.
+ * @return  {unsigned char *}               The contents of the file (free them), or NULL if there's no file.
+*/
+unsigned char *GameJournal_readFile(char *sPath, size_t *pSize) {
+  FILE *pFile = fopen(sPath, "rb");
+  unsigned char *pData = NULL;
+  size_t dCapacity = 0;
+
+  *pSize = 0;
+
+  if(pFile == NULL)
+    return NULL;
+
+  // The file is small, but we don't know how small
+  do {
+    dCapacity = dCapacity ? dCapacity * 2 : 4096;
+    pData = UtilsMem_realloc(UTILS_MEM_GAME, pData, dCapacity);
+    *pSize += fread(pData + *pSize, 1, dCapacity - *pSize, pFile);
+  } while(*pSize == dCapacity);
+
+  fclose(pFile);
+  return pData;
+}
+
+/**
+ * Reads the header of the journal.
+ *
+ * @param   {struct GameJournal *}  this        The instance.
+ * @param   {unsigned char **}      ppCursor    The start of the file; moved past the header.
+ * @param   {unsigned char *}       pEnd        Where the file ends.
+ * @param   {unsigned int *}        pStartSeq   Where the number of the first record goes.
+ * @return  {int}                               Whether or not the header is one we can use.
+*/
+int GameJournal_readHeader(struct GameJournal *this, unsigned char **ppCursor, unsigned char *pEnd, unsigned int *pStartSeq) {
+  unsigned int dVersion, dCatalogueHash;
+
+  if(pEnd - *ppCursor < 4 || memcmp(*ppCursor, GAME_JOURNAL_MAGIC, 4))
+    return 0;
+
+  *ppCursor += 4;
+
+  return
+    GameJournal_getVarint(ppCursor, pEnd, &dVersion) && dVersion == GAME_JOURNAL_VERSION &&
+    GameJournal_getVarint(ppCursor, pEnd, &dCatalogueHash) && dCatalogueHash == this->dCatalogueHash &&
+    GameJournal_getVarint(ppCursor, pEnd, pStartSeq);
+}
+
+/**
+ * Reads a record and moves the cursor past it.
+ * This only checks that the record is whole and that its numbers could mean something; GameJournal_replay()
+ * checks them against the actual game.
+ *
+ * @param   {unsigned char **}          ppCursor  Where the record starts.
+ * @param   {unsigned char *}           pEnd      Where the file ends.
+ * @param   {struct GameJournalEntry *} pEntry    Where the record goes.
+ * @return  {int}                                 Whether or not there was a whole record there.
+*/
+int GameJournal_readRecord(unsigned char **ppCursor, unsigned char *pEnd, struct GameJournalEntry *pEntry) {
+  unsigned int eRecord, dLength, dGap;
+  int dIndex = -1;
+
+  if(!GameJournal_getVarint(ppCursor, pEnd, &eRecord))
+    return 0;
+
+  pEntry->eRecord = eRecord;
+
+  switch(eRecord) {
+    case JOURNAL_NAME:
+      if(!GameJournal_getVarint(ppCursor, pEnd, &dLength) || dLength > PLAYER_NAME_MAX_LEN || pEnd - *ppCursor < dLength)
+        return 0;
+
+      memcpy(pEntry->sName, *ppCursor, dLength);
+      pEntry->sName[dLength] = 0;
+      *ppCursor += dLength;
+      return 1;
+
+    case JOURNAL_FARM:
+      if(!GameJournal_getVarint(ppCursor, pEnd, &pEntry->eAction) ||
+        !GameJournal_getVarint(ppCursor, pEnd, &pEntry->eProductType) ||
+        !GameJournal_getVarint(ppCursor, pEnd, &pEntry->dAmount) ||
+        pEntry->dAmount > FARM_MAX_WIDTH * FARM_MAX_HEIGHT)
+        return 0;
+
+      memset(pEntry->bQueueArray, 0, sizeof(pEntry->bQueueArray));
+
+      // The first gap is from -1, so every gap is at least one
+      for(int i = 0; i < pEntry->dAmount; i++) {
+        if(!GameJournal_getVarint(ppCursor, pEnd, &dGap) || !dGap || dGap > FARM_MAX_WIDTH * FARM_MAX_HEIGHT - 1 - dIndex)
+          return 0;
+
+        dIndex += dGap;
+        pEntry->bQueueArray[dIndex] = 1;
+      }
+      return 1;
+
+    case JOURNAL_TRADE:
+      return
+        GameJournal_getVarint(ppCursor, pEnd, &pEntry->eAction) &&
+        GameJournal_getVarint(ppCursor, pEnd, &pEntry->eProductType) &&
+        GameJournal_getVarint(ppCursor, pEnd, &pEntry->dAmount);
+
+    case JOURNAL_SLEEP:
+    case JOURNAL_UNDO:
+    case JOURNAL_REDO:
+      return 1;
+
+    default: return 0;
+  }
+}
+
+/**
+ * Does what a record says, the same way the game did it the first time.
+ *
+ * @param   {struct GameJournalEntry *} pEntry      The record.
+ * @param   {struct Player *}           pPlayer     The player.
+ * @param   {struct Farm *}             pFarm       The farm.
+ * @param   {struct Shop *}             pShop       The shop.
+ * @param   {struct GameCatalogue *}    pCatalogue  The catalogue.
+ * @param   {struct GameHistory *}      pHistory    The undo history (already listening to the farm and the shop).
+ * @return  {int}                                   Whether or not it worked like it did the first time.
+*/
+int GameJournal_replay(struct GameJournalEntry *pEntry, struct Player *pPlayer, struct Farm *pFarm, struct Shop *pShop, struct GameCatalogue *pCatalogue, struct GameHistory *pHistory) {
+  int bOkay = 0;
+
+  switch(pEntry->eRecord) {
+    case JOURNAL_NAME:
+      Player_setName(pPlayer, pEntry->sName);
+      return 1;
+
+    case JOURNAL_FARM:
+      if(pEntry->eAction < FARM_TILL || pEntry->eAction > FARM_HARVEST || pEntry->eProductType >= pCatalogue->dSize)
+        return 0;
+
+      // Queue the plots just like the player did, then process the queue
+      for(int i = 0; i < FARM_MAX_WIDTH * FARM_MAX_HEIGHT; i++) {
+        if(pEntry->bQueueArray[i] && i >= pFarm->dSize)
+          return 0;
+
+        if(i < pFarm->dSize)
+          pFarm->bSelectionQueue[i] = pEntry->bQueueArray[i];
+      }
+
+      pFarm->eCurrentAction = pEntry->eAction;
+      pFarm->eCurrentCrop = pEntry->eProductType;
+      bOkay = Farm_processQueue(pFarm, pPlayer, pCatalogue, Player_getTime(pPlayer));
+
+      Farm_setCurrentAction(pFarm, FARM_NULL);
+      Farm_setCurrentCrop(pFarm, PRODUCT_NULL);
+      return bOkay;
+
+    case JOURNAL_TRADE:
+      if(pEntry->eProductType >= pCatalogue->dSize || pEntry->dAmount > 1000000000)
+        return 0;
+
+      // The shop works on its current product, so pick that one for a moment
+      enum ProductType eCurrentCrop = pShop->eCurrentCrop;
+      pShop->eCurrentCrop = pEntry->eProductType;
+
+      if(pEntry->eAction == SHOP_BUY) {
+        bOkay = Player_buyCrop(pPlayer, pEntry->eProductType, pEntry->dAmount, Shop_getCurrentBuyCost(pShop, pEntry->dAmount));
+        if(bOkay) Shop_buyCurrentProduct(pShop, pEntry->dAmount);
+      }
+
+      if(pEntry->eAction == SHOP_SELL) {
+        bOkay = Player_sellCrop(pPlayer, pEntry->eProductType, pEntry->dAmount, Shop_getCurrentSellCost(pShop, pEntry->dAmount));
+        if(bOkay) Shop_sellCurrentProduct(pShop, pEntry->dAmount);
+      }
+
+      pShop->eCurrentCrop = eCurrentCrop;
+      return bOkay;
+
+    case JOURNAL_SLEEP:
+      Player_goHome(pPlayer);
+      GameHistory_onSleep(pHistory);
+
+      // A game over throws the journal away, so a sleep in the journal never ends the game
+      return !Player_isDead(pPlayer);
+
+    // The history was rebuilt by the records before this one, so it has the same thing to undo or redo
+    case JOURNAL_UNDO:
+      return GameHistory_undo(pHistory);
+
+    case JOURNAL_REDO:
+      return GameHistory_redo(pHistory);
+
+    default: return 0;
+  }
+}
+
+/**
+ * Replaces the journal file with a header and the given records, then opens it for appending.
+ * Like the save, it goes to a temporary file first so the old journal is there until the new one is whole.
+ *
+ * @param   {struct GameJournal *}  this        The instance.
+ * @param   {unsigned int}          dStartSeq   The number of the first record.
+ * @param   {unsigned char *}       pRecords    The records to keep (can be NULL).
+ * @param   {size_t}                dSize       How many bytes of records there are.
+ * @return  {int}                               Whether or not the journal could be opened.
+*/
+int GameJournal_rewrite(struct GameJournal *this, unsigned int dStartSeq, unsigned char *pRecords, size_t dSize) {
+  unsigned char pHeaderArray[4 + 3 * 5];
+  char sTempPath[256];
+  int dLength = 4;
+  int bOkay;
+
+  if(this->pFile != NULL)
+    fclose(this->pFile);
+
+  memcpy(pHeaderArray, GAME_JOURNAL_MAGIC, 4);
+  dLength += GameJournal_putVarint(pHeaderArray + dLength, GAME_JOURNAL_VERSION);
+  dLength += GameJournal_putVarint(pHeaderArray + dLength, this->dCatalogueHash);
+  dLength += GameJournal_putVarint(pHeaderArray + dLength, dStartSeq);
+
+  snprintf(sTempPath, sizeof(sTempPath), "%s.tmp", this->sPath);
+
+  FILE *pFile = fopen(sTempPath, "wb");
+  bOkay = pFile != NULL;
+
+  if(bOkay) {
+    bOkay = fwrite(pHeaderArray, 1, dLength, pFile) == dLength;
+    bOkay = bOkay && (!dSize || fwrite(pRecords, 1, dSize, pFile) == dSize);
+    bOkay = !fclose(pFile) && bOkay;
+  }
+
+  #ifdef _WIN32
+    if(bOkay) remove(this->sPath);
+  #endif
+
+  if(bOkay)
+    bOkay = !rename(sTempPath, this->sPath);
+
+  this->pFile = bOkay ? fopen(this->sPath, "ab") : NULL;
+  this->dStartSeq = dStartSeq;
+  this->dPending = 0;
+
+  return this->pFile != NULL;
+}
+
+/**
+ * #########################
+ * ###  JOURNAL METHODS  ###
+ * #########################
+*/
+
+/**
+ * Makes sure the records written so far are on the disk.
+ *
+ * @param   {struct GameJournal *}  this  The instance.
+*/
+void GameJournal_commit(struct GameJournal *this) {
+  if(this->pFile == NULL || !this->dPending)
+    return;
+
+  fflush(this->pFile);
+
+  #ifdef _WIN32
+    _commit(_fileno(this->pFile));
+  #else
+    fsync(fileno(this->pFile));
+  #endif
+
+  this->dPending = 0;
+}
+
+/**
+ * Adds the record in the buffer of the instance to the journal.
+ *
+ * @param   {struct GameJournal *}  this      The instance.
+ * @param   {int}                   dLength   How long the record is.
+*/
+void GameJournal_append(struct GameJournal *this, int dLength) {
+  if(this->pFile == NULL)
+    return;
+
+  fwrite(this->pRecordArray, 1, dLength, this->pFile);
+  fflush(this->pFile);
+  this->dSeq++;
+
+  // Group commit
+  if(++this->dPending >= GAME_JOURNAL_GROUP)
+    GameJournal_commit(this);
+}
+
+/**
+ * Writes down the name of the player.
+ *
+ * @param   {struct GameJournal *}  this    The instance.
+ * @param   {char *}                sName   The name.
+*/
+void GameJournal_logName(struct GameJournal *this, char *sName) {
+  int dName = strlen(sName) < PLAYER_NAME_MAX_LEN ? strlen(sName) : PLAYER_NAME_MAX_LEN;
+  int dLength = 0;
+
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, JOURNAL_NAME);
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, dName);
+  memcpy(this->pRecordArray + dLength, sName, dName);
+
+  GameJournal_append(this, dLength + dName);
+}
+
+/**
+ * Writes down that the player went to sleep.
+ *
+ * @param   {struct GameJournal *}  this    The instance.
+*/
+void GameJournal_logSleep(struct GameJournal *this) {
+  GameJournal_append(this, GameJournal_putVarint(this->pRecordArray, JOURNAL_SLEEP));
+}
+
+/**
+ * Writes down that the last action was undone.
+ *
+ * @param   {struct GameJournal *}  this    The instance.
+*/
+void GameJournal_logUndo(struct GameJournal *this) {
+  GameJournal_append(this, GameJournal_putVarint(this->pRecordArray, JOURNAL_UNDO));
+}
+
+/**
+ * Writes down that the last action undone was redone.
+ *
+ * @param   {struct GameJournal *}  this    The instance.
+*/
+void GameJournal_logRedo(struct GameJournal *this) {
+  GameJournal_append(this, GameJournal_putVarint(this->pRecordArray, JOURNAL_REDO));
+}
+
+/**
+ * Writes down a farm action; the farm calls this before it clears the queue.
+ *
+ * @param   {void *}          pData   The instance.
+ * @param   {struct Farm *}   pFarm   The farm.
+*/
+void GameJournal_onQueue(void *pData, struct Farm *pFarm) {
+  struct GameJournal *this = pData;
+  int dLength = 0, dLast = -1;
+
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, JOURNAL_FARM);
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, pFarm->eCurrentAction);
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, pFarm->eCurrentCrop);
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, Farm_getQueueLength(pFarm));
+
+  for(int i = 0; i < pFarm->dSize; i++)
+    if(pFarm->bSelectionQueue[i]) {
+      dLength += GameJournal_putVarint(this->pRecordArray + dLength, i - dLast);
+      dLast = i;
+    }
+
+  GameJournal_append(this, dLength);
+}
+
+/**
+ * Writes down a purchase or a sale; the shop calls this.
+ *
+ * @param   {void *}              pData         The instance.
+ * @param   {enum ShopAction}     eAction       Whether it was bought or sold.
+ * @param   {enum ProductType}    eProductType  What was bought or sold.
+ * @param   {int}                 dAmount       How many.
+*/
+void GameJournal_onTrade(void *pData, enum ShopAction eAction, enum ProductType eProductType, int dAmount) {
+  struct GameJournal *this = pData;
+  int dLength = 0;
+
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, JOURNAL_TRADE);
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, eAction);
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, eProductType);
+  dLength += GameJournal_putVarint(this->pRecordArray + dLength, dAmount);
+
+  GameJournal_append(this, dLength);
+}
+
+/**
+ * Returns how many actions the game has had.
+ *
+ * @param   {struct GameJournal *}  this  The instance.
+ * @return  {unsigned int}                The number of the next record.
+*/
+unsigned int GameJournal_getSeq(struct GameJournal *this) {
+  return this->dSeq;
+}
+
+/**
+ * Starts an empty journal for a new game.
+ *
+ * @param   {struct GameJournal *}  this  The instance.
+*/
+void GameJournal_reset(struct GameJournal *this) {
+  GameJournal_rewrite(this, 0, NULL, 0);
+  this->dSeq = 0;
+}
+
+/**
+ * Plays back the records the save doesn't include, then keeps only those in the journal.
+ * A record that's cut off (the game got killed while writing it) or that doesn't work out ends the playback;
+ * it and everything after it are dropped. Nothing gets written down while the records are played back, since
+ * the journal isn't open yet.
+ *
+ * @param   {struct GameJournal *}      this        The instance.
+ * @param   {unsigned int}              dSaveSeq    How many records the save includes (0 without a save).
+ * @param   {struct Player *}           pPlayer     The player (as it was loaded from the save).
+ * @param   {struct Farm *}             pFarm       The farm.
+ * @param   {struct Shop *}             pShop       The shop.
+ * @param   {struct GameCatalogue *}    pCatalogue  The catalogue.
+ * @param   {struct GameHistory *}      pHistory    The undo history (already listening to the farm and the shop).
+ * @return  {int}                                   How many records were played back.
+*/
+int GameJournal_recover(struct GameJournal *this, unsigned int dSaveSeq, struct Player *pPlayer, struct Farm *pFarm, struct Shop *pShop, struct GameCatalogue *pCatalogue, struct GameHistory *pHistory) {
+  struct GameJournalEntry *pEntry = UtilsMem_calloc(UTILS_MEM_GAME, 1, sizeof(*pEntry));
+  size_t dSize;
+  unsigned char *pData = GameJournal_readFile(this->sPath, &dSize);
+  unsigned char *pCursor = pData, *pEnd = pData + dSize;
+  unsigned char *pKeep = NULL;
+  unsigned int dSeq;
+  int dReplayed = 0;
+
+  // A journal that starts after the save leaves a hole we can't fill
+  if(pData != NULL && GameJournal_readHeader(this, &pCursor, pEnd, &dSeq) && dSeq <= dSaveSeq) {
+    pKeep = pCursor;
+
+    while(pCursor < pEnd) {
+      unsigned char *pRecord = pCursor;
+
+      if(!GameJournal_readRecord(&pCursor, pEnd, pEntry)) {
+        pCursor = pRecord;
+        break;
+      }
+
+      // The save already has this one
+      if(dSeq < dSaveSeq) {
+        pKeep = pCursor;
+        dSeq++;
+        continue;
+      }
+
+      if(!GameJournal_replay(pEntry, pPlayer, pFarm, pShop, pCatalogue, pHistory)) {
+        pCursor = pRecord;
+        break;
+      }
+
+      dSeq++;
+      dReplayed++;
+    }
+  }
+
+  // Whatever didn't make it is dropped, so new records don't end up after garbage
+  if(pKeep != NULL && dSeq >= dSaveSeq)
+    GameJournal_rewrite(this, dSaveSeq, pKeep, pCursor - pKeep);
+  else
+    GameJournal_rewrite(this, dSaveSeq, NULL, 0);
+
+  this->dSeq = dSaveSeq + dReplayed;
+
+  UtilsMem_free(pData);
+  UtilsMem_free(pEntry);
+
+  return dReplayed;
+}
+
+/**
+ * Cuts the records a save includes off the front of the journal.
+ * Only call this with a save that's definitely on the disk.
+ *
+ * @param   {struct GameJournal *}  this      The instance.
+ * @param   {unsigned int}          dSaveSeq  How many records the save includes.
+*/
+void GameJournal_trim(struct GameJournal *this, unsigned int dSaveSeq) {
+  struct GameJournalEntry *pEntry;
+  unsigned char *pData, *pCursor, *pEnd;
+  unsigned int dSeq;
+  size_t dSize;
+
+  if(this->pFile == NULL || dSaveSeq <= this->dStartSeq || dSaveSeq > this->dSeq)
+    return;
+
+  GameJournal_commit(this);
+
+  pEntry = UtilsMem_calloc(UTILS_MEM_GAME, 1, sizeof(*pEntry));
+  pData = GameJournal_readFile(this->sPath, &dSize);
+  pCursor = pData;
+  pEnd = pData + dSize;
+
+  // Skip to the first record the save doesn't have
+  if(pData != NULL && GameJournal_readHeader(this, &pCursor, pEnd, &dSeq)) {
+    while(dSeq < dSaveSeq && GameJournal_readRecord(&pCursor, pEnd, pEntry))
+      dSeq++;
+
+    if(dSeq == dSaveSeq)
+      GameJournal_rewrite(this, dSaveSeq, pCursor, pEnd - pCursor);
+  }
+
+  UtilsMem_free(pData);
+  UtilsMem_free(pEntry);
+}
+
+/**
+ * Syncs whatever's left and destroys the instance.
+ *
+ * @param   {struct GameJournal *}  this  The instance to be destroyed.
+*/
+void GameJournal_kill(struct GameJournal *this) {
+  GameJournal_commit(this);
+
+  if(this->pFile != NULL)
+    fclose(this->pFile);
+
+  UtilsMem_free(this);
+}
+
+#endif
@@ -13,6 +13,10 @@
 #include "game.assets.h"
 #include "game.catalogue.h"
 #include "game.manager.min.h"
+#include "game.realtime.h"
+#include "game.save.h"
+#include "game.journal.h"
+#include "game.history.h"
 
 #include "objects/game.obj.player.h"
 #include "objects/game.obj.farm.h"
@@ -25,6 +29,10 @@
 #include "enums/game.enum.state.h"
 
 #include "../utils/utils.key.h"
+#include "../utils/utils.layout.h"
+#include "../utils/utils.mem.h"
+#include "../utils/utils.panel.h"
+#include "../utils/utils.string.h"
 #include "../utils/utils.ui.h"
 #include "../utils/utils.text.h"
 #include "../utils/utils.selector.h"
@@ -82,11 +90,33 @@ struct Game {
   struct UtilsText *pHeaderText;
   struct UtilsText *pFooterText;
 
+  // The header and footer are only rebuilt when something they show changes
+  struct UtilsPanel *pHeaderPanel;
+  struct UtilsPanel *pFooterPanel;
+
+  // Cached layouts of the screens that only change when the console is resized
+  struct UtilsLayout *pMenuLayout;
+  struct UtilsLayout *pGuideLayout;
+  struct UtilsLayout *pControlsLayout;
+  struct UtilsLayout *pAuthorLayout;
+
   // Game objects
   struct Player *pPlayer;
   struct Farm *pFarm;
   struct Shop *pShop;
 
+  // Only there in real-time mode
+  struct GameRealtime *pRealtime;
+
+  // Only there in full and real-time mode (debug mode shouldn't write over a real save)
+  struct GameSave *pSave;
+
+  // Only there in full mode (real-time crops change with the clock, so there's nothing to play back)
+  struct GameJournal *pJournal;
+
+  // Only there in full and debug mode (the clock changes the crops in real-time mode, so there'd be nothing to undo to)
+  struct GameHistory *pHistory;
+
   // Function lists
   void (**pUIFuncArray)(char cInput, struct Game *this);
   void (**pIOFuncArray)(char cInput, struct Game *this);
@@ -152,7 +182,7 @@ void Game_init(struct Game *this, struct GameAssets *pAssets, struct GameCatalog
   this->dMode = 1;
   this->dDialogueIndex = 0;
 
-  this->sCurrentIntInput = calloc(UTILS_KEY_MAX_DIGITS, sizeof(char));
+  this->sCurrentIntInput = UtilsMem_calloc(UTILS_MEM_GAME, UTILS_KEY_MAX_DIGITS, sizeof(char));
   this->sInputWarning = UtilsUI_createBuffer();
 
   // Dialog box
@@ -180,10 +210,10 @@ void Game_init(struct Game *this, struct GameAssets *pAssets, struct GameCatalog
   void (*pPlayMember) (struct Game* this);
   void (*pHandlerMember) (struct Game* this);
 
-  this->pUIFuncArray = calloc(6, sizeof(pUIAndIOMember));
-  this->pIOFuncArray = calloc(6, sizeof(pUIAndIOMember));
-  this->pPlayFuncArray = calloc(3, sizeof(pPlayMember));
-  this->pHandlerFuncArray = calloc(5, sizeof(pHandlerMember));
+  this->pUIFuncArray = UtilsMem_calloc(UTILS_MEM_GAME, 6, sizeof(pUIAndIOMember));
+  this->pIOFuncArray = UtilsMem_calloc(UTILS_MEM_GAME, 6, sizeof(pUIAndIOMember));
+  this->pPlayFuncArray = UtilsMem_calloc(UTILS_MEM_GAME, 3, sizeof(pPlayMember));
+  this->pHandlerFuncArray = UtilsMem_calloc(UTILS_MEM_GAME, 5, sizeof(pHandlerMember));
 
   this->pUIFuncArray[GAME_MENU] = &Game_menuUI;
   this->pUIFuncArray[GAME_PLAY] = &Game_playUI;
@@ -258,6 +288,16 @@ void Game_init(struct Game *this, struct GameAssets *pAssets, struct GameCatalog
   this->pDialogSelector = pDialogSelector;
   this->pCatalogueSelector = pCatalogueSelector;
 
+  // Same goes for the header and footer
+  this->pHeaderPanel = UtilsPanel_create();
+  this->pFooterPanel = UtilsPanel_create();
+
+  // These get built on the first frame of each screen
+  this->pMenuLayout = UtilsLayout_create();
+  this->pGuideLayout = UtilsLayout_create();
+  this->pControlsLayout = UtilsLayout_create();
+  this->pAuthorLayout = UtilsLayout_create();
+
   // Define the game objects
   struct Player *pPlayer = 
     Player_create(
@@ -280,6 +320,10 @@ void Game_init(struct Game *this, struct GameAssets *pAssets, struct GameCatalog
   this->pPlayer = pPlayer;
   this->pFarm = pFarm;
   this->pShop = pShop;
+  this->pRealtime = NULL;
+  this->pSave = NULL;
+  this->pJournal = NULL;
+  this->pHistory = NULL;
 }
 
 /**
@@ -298,16 +342,96 @@ int Game_isDialogueDone(struct Game *this) {
   return this->dDialogueIndex >= this->ASSETS->DIALOGUE_TEXT_LEN;
 }
 
+/**
+ * Passes a farm action on to the journal and the undo history.
+ * 
+ * @param   {void *}          pData   The game object.
+ * @param   {struct Farm *}   pFarm   The farm.
+*/
+void Game_onQueue(void *pData, struct Farm *pFarm) {
+  struct Game *this = pData;
+
+  if(this->pJournal != NULL)
+    GameJournal_onQueue(this->pJournal, pFarm);
+
+  if(this->pHistory != NULL)
+    GameHistory_onQueue(this->pHistory, pFarm);
+}
+
+/**
+ * Passes a purchase or a sale on to the journal and the undo history.
+ * 
+ * @param   {void *}              pData         The game object.
+ * @param   {enum ShopAction}     eAction       Whether it was bought or sold.
+ * @param   {enum ProductType}    eProductType  What was bought or sold.
+ * @param   {int}                 dAmount       How many.
+*/
+void Game_onTrade(void *pData, enum ShopAction eAction, enum ProductType eProductType, int dAmount) {
+  struct Game *this = pData;
+
+  if(this->pJournal != NULL)
+    GameJournal_onTrade(this->pJournal, eAction, eProductType, dAmount);
+
+  if(this->pHistory != NULL)
+    GameHistory_onTrade(this->pHistory, eAction, eProductType, dAmount);
+}
+
+/**
+ * Starts listening to the current farm and shop (the game makes new ones on a game over).
+ * The undo history starts over from here.
+ * 
+ * @param   {struct Game *}   this  The game object.
+*/
+void Game_listen(struct Game *this) {
+  Farm_setQueueListener(this->pFarm, &Game_onQueue, this);
+  Shop_setListener(this->pShop, &Game_onTrade, this);
+
+  if(this->pHistory != NULL)
+    GameHistory_attach(this->pHistory, this->pPlayer, this->pFarm, this->pShop, this->CATALOGUE);
+}
+
+/**
+ * Saves the game in the background (if it keeps a save).
+ * The journal is synced first, and whatever the last finished save already has gets cut off the front of it.
+ * Nothing before a save can be undone, since a continued game wouldn't have it (see game.history.h).
+ * 
+ * @param   {struct Game *}   this  The game object.
+*/
+void Game_autosave(struct Game *this) {
+  if(this->pSave == NULL)
+    return;
+
+  if(this->pHistory != NULL)
+    GameHistory_clear(this->pHistory);
+
+  if(this->pJournal != NULL) {
+    GameSave_reap(this->pSave, 0);
+    GameJournal_commit(this->pJournal);
+    GameJournal_trim(this->pJournal, this->pSave->dSavedSeq);
+    this->pSave->dSeq = GameJournal_getSeq(this->pJournal);
+  }
+
+  GameSave_autosave(this->pSave, this->pPlayer, this->pFarm, this->pShop, this->CATALOGUE);
+}
+
 /**
  * Creates the header for the in-game UI.
+ * The header belongs to its panel, and the last one is reused if the player hasn't changed.
  * 
  * @param   {struct Game*}  this  The game object.
 */
 void Game_makeHeader(struct Game *this) {
+  int dStampArray[] = { Player_getVersion(this->pPlayer), UtilsIO_getWidth() };
+
+  // Nothing in the header has changed
+  if(UtilsPanel_isFresh(this->pHeaderPanel, dStampArray, 2)) {
+    this->pHeaderText = UtilsPanel_getText(this->pHeaderPanel);
+    return;
+  }
 
   // Create the header string
-  char *sHeaderString = UtilsUI_createBuffer();
-  sprintf(sHeaderString, "----[ %s ]--[ Day: %4d ]--[ Days Starved: %4d ]--[ Energy: %4d ]--[ Gold: %4d ]----",
+  struct UtilsString *pHeaderString = UtilsString_create();
+  UtilsString_appendFormat(pHeaderString, "----[ %s ]--[ Day: %4d ]--[ Days Starved: %4d ]--[ Energy: %4d ]--[ Gold: %4d ]----",
     this->pPlayer->sName,
     this->pPlayer->dTime + 1,
     this->pPlayer->dDaysStarved,
@@ -319,25 +443,38 @@ void Game_makeHeader(struct Game *this) {
   UtilsText_addNewLines(this->pHeaderText, 1);
   UtilsText_addPatternLines(this->pHeaderText, 1, "_");
   UtilsText_addPatternLines(this->pHeaderText, 1, ":=");
-  UtilsText_addText(this->pHeaderText, UtilsText_paddedText(sHeaderString, "-", UTILS_TEXT_LEFT_ALIGN));
-  free(sHeaderString);
-}
+  UtilsText_addPaddedText(this->pHeaderText, UtilsString_getText(pHeaderString), "-", UTILS_TEXT_LEFT_ALIGN);
+  UtilsString_kill(pHeaderString);
 
-/**
- * Frees the header memory block.
- * 
- * @param   {struct Game *}   this  The game object.
-*/
-void Game_killHeader(struct Game *this) {
-  UtilsText_kill(this->pHeaderText);
+  UtilsPanel_store(this->pHeaderPanel, this->pHeaderText, dStampArray, 2);
 }
 
 /**
  * Creates the footer for the in-game UI.
+ * Like the header, it belongs to its panel and is only rebuilt when something it shows changes.
  * 
  * @param   {struct Game*}  this  The game object.
 */
 void Game_makeFooter(struct Game *this) {
+  int dStampArray[] = { 
+    this->eGameState, 
+    this->ePlayState, 
+    this->dDialogueIndex,
+    UtilsSelector_getVersion(this->pPlaySelector),
+    UtilsSelector_getVersion(this->pCatalogueSelector),
+    Player_getVersion(this->pPlayer),
+    Farm_getVersion(this->pFarm),
+    UtilsSelector_getVersion(this->pFarm->pFarmSelector),
+    Shop_getVersion(this->pShop),
+    UtilsSelector_getVersion(this->pShop->pShopSelector),
+    UtilsIO_getWidth()
+  };
+
+  // Nothing in the footer has changed
+  if(UtilsPanel_isFresh(this->pFooterPanel, dStampArray, 11)) {
+    this->pFooterText = UtilsPanel_getText(this->pFooterPanel);
+    return;
+  }
 
   // Create the footer
   this->pFooterText = UtilsText_create();
@@ -345,8 +482,8 @@ void Game_makeFooter(struct Game *this) {
 
   // Copyright mark
   if(this->eGameState == GAME_MENU) {
-    UtilsText_addText(this->pFooterText, UtilsText_paddedText(
-      "[ Mo David @2023 ]    ", " ", UTILS_TEXT_RIGHT_ALIGN));
+    UtilsText_addPaddedText(this->pFooterText, 
+      "[ Mo David @2023 ]    ", " ", UTILS_TEXT_RIGHT_ALIGN);
     UtilsText_addNewLines(this->pFooterText, 1);
   
   // If not in menu
@@ -364,10 +501,10 @@ void Game_makeFooter(struct Game *this) {
         this->ASSETS->DIALOGUE_TEXT[this->dDialogueIndex]);
 
       // Create dialogue in the footer
-      UtilsText_addText(this->pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+      UtilsText_addPaddedText(this->pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
       UtilsText_addNewLines(this->pFooterText, 2);
-      UtilsText_addText(this->pFooterText, UtilsText_paddedText(
-        "-=-{ [SPACE BAR] to continue; [Z] to skip tutorial; [Q] to exit to main menu. }-=-=", "-=", UTILS_TEXT_RIGHT_ALIGN));
+      UtilsText_addPaddedText(this->pFooterText, 
+        "-=-{ [SPACE BAR] to continue; [Z] to skip tutorial; [Q] to exit to main menu. }-=-=", "-=", UTILS_TEXT_RIGHT_ALIGN);
     
     // The footer displays additional information on selections 
     // It can also provide tips and what not
@@ -380,11 +517,11 @@ void Game_makeFooter(struct Game *this) {
           sprintf(sFooterString, this->sFooterFrontTemplate,
             UtilsSelector_getCurrentOption(this->pPlaySelector), 
             this->ASSETS->SCENE_SELECT_TEXT[UtilsSelector_getCurrentIndex(this->pPlaySelector) * 2]);
-          UtilsText_addText(this->pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+          UtilsText_addPaddedText(this->pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
           
           sprintf(sFooterString, this->sFooterBlankFrontTemplate,
             this->ASSETS->SCENE_SELECT_TEXT[UtilsSelector_getCurrentIndex(this->pPlaySelector) * 2 + 1]);
-          UtilsText_addText(this->pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));          
+          UtilsText_addPaddedText(this->pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);          
           UtilsText_addNewLines(this->pFooterText, 1);
           break;
         
@@ -393,14 +530,14 @@ void Game_makeFooter(struct Game *this) {
           
           sprintf(sFooterString, this->sFooterFrontTemplate,
             "home", this->ASSETS->SCENE_HOME_MESSAGE_TEXT[0]);
-          UtilsText_addText(this->pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+          UtilsText_addPaddedText(this->pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
           
           if(!Player_isStarving(this->pPlayer))
             sprintf(sFooterString, this->sFooterBlankFrontTemplate, this->ASSETS->SCENE_HOME_MESSAGE_TEXT[1]);
           else 
             sprintf(sFooterString, this->sFooterBlankFrontTemplate, this->ASSETS->SCENE_HOME_MESSAGE_TEXT[2]);
               
-          UtilsText_addText(this->pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+          UtilsText_addPaddedText(this->pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
           UtilsText_addNewLines(this->pFooterText, 1);
           break;
 
@@ -425,21 +562,14 @@ void Game_makeFooter(struct Game *this) {
           break;
       }
 
-      UtilsText_addText(this->pFooterText, UtilsText_paddedText(
-        "-=-{ [I] to view inventory; [H] to view controls; [Q] to exit to main menu. }-=-=", "-=", UTILS_TEXT_RIGHT_ALIGN));
+      UtilsText_addPaddedText(this->pFooterText, 
+        "-=-{ [I] to view inventory; [H] to view controls; [Q] to exit to main menu. }-=-=", "-=", UTILS_TEXT_RIGHT_ALIGN);
     }
   }
 
-  free(sFooterString);
-}
+  UtilsMem_free(sFooterString);
 
-/**
- * Frees the header memory block.
- * 
- * @param   {struct Game *}   this  The game object.
-*/
-void Game_killFooter(struct Game *this) {
-  UtilsText_kill(this->pFooterText);
+  UtilsPanel_store(this->pFooterPanel, this->pFooterText, dStampArray, 11);
 }
 
 /**
@@ -456,35 +586,42 @@ void Game_killFooter(struct Game *this) {
  * @param   {struct Game *}   this    The game object.
 */
 void Game_menuUI(char cInput, struct Game *this) {
-  this->pScreenText = UtilsText_create();
-  Game_makeFooter(this);
 
-  // Title
-  UtilsText_addBlock(this->pScreenText, this->ASSETS->TITLE_SPRITE, this->ASSETS->TITLE_SPRITE_LEN);
-  UtilsText_addNewLines(this->pScreenText, 3);
+  // The title and everything around it only have to be centered again when the console is resized
+  if(!UtilsLayout_isFresh(this->pMenuLayout)) {
+    this->pScreenText = UtilsText_create();
+    Game_makeFooter(this);
 
-  // Selector
-  for(int i = 0; i < UtilsSelector_getLength(this->pMenuSelector); i++)
-    UtilsText_addText(this->pScreenText, UtilsSelector_getOptionFormatted(this->pMenuSelector, i));
-  UtilsText_addNewLines(this->pScreenText, 3);
+    // Title
+    UtilsText_addBlock(this->pScreenText, this->ASSETS->TITLE_SPRITE, this->ASSETS->TITLE_SPRITE_LEN);
+    UtilsText_addNewLines(this->pScreenText, 3);
 
-  UtilsText_addText(this->pScreenText, this->ASSETS->DIVIDER_TEXT[0]);
-  UtilsText_addNewLines(this->pScreenText, 2);
+    // Selector (its lines get filled in below)
+    UtilsLayout_markSlot(this->pMenuLayout, this->pScreenText);
+    UtilsText_addNewLines(this->pScreenText, UtilsSelector_getLength(this->pMenuSelector));
+    UtilsText_addNewLines(this->pScreenText, 3);
 
-  UtilsText_addText(this->pScreenText, "[Enter] to choose an option");
-  UtilsText_addText(this->pScreenText, "[X] and [C] to change selection");
-  
-  // Formatting
-  this->pScreenText = UtilsUI_centerXY(this->pScreenText);
-  UtilsUI_footer(this->pScreenText, this->pFooterText);
+    UtilsText_addText(this->pScreenText, this->ASSETS->DIVIDER_TEXT[0]);
+    UtilsText_addNewLines(this->pScreenText, 2);
+
+    UtilsText_addText(this->pScreenText, "[Enter] to choose an option");
+    UtilsText_addText(this->pScreenText, "[X] and [C] to change selection");
+    
+    // Formatting
+    UtilsLayout_build(this->pMenuLayout, this->pScreenText, this->pFooterText);
+
+    // Garbage collection!
+    UtilsText_kill(this->pScreenText);
+  }
+
+  // The selector is the only thing that changes between keystrokes
+  for(int i = 0; i < UtilsSelector_getLength(this->pMenuSelector); i++) {
+    UtilsLayout_setSlotLine(this->pMenuLayout, i, UtilsSelector_getOptionFormatted(this->pMenuSelector, i));
+  }
 
   // Print final text
   UtilsIO_clear();
-  UtilsUI_print(this->pScreenText);
-
-  // Garbage collection!
-  UtilsText_kill(this->pScreenText);
-  Game_killFooter(this);
+  UtilsUI_print(UtilsLayout_getText(this->pMenuLayout));
 }
 
 /**
@@ -597,8 +734,6 @@ void Game_playUI(char cInput, struct Game *this) {
 
   // Garbage collection!
   UtilsText_kill(this->pScreenText);
-  Game_killHeader(this);
-  Game_killFooter(this);
 
 }
 
@@ -609,26 +744,30 @@ void Game_playUI(char cInput, struct Game *this) {
  * @param   {struct Game *}   this    The game object.
 */
 void Game_guideUI(char cInput, struct Game *this) {
-  this->pScreenText = UtilsText_create();
-  
-  // Content
-  UtilsText_addNewLines(this->pScreenText, 2);
-  UtilsText_addBlock(this->pScreenText, this->ASSETS->GUIDE_TEXT, this->ASSETS->GUIDE_TEXT_LEN);
-  UtilsText_addNewLines(this->pScreenText, 3);
-  UtilsText_addText(this->pScreenText, this->ASSETS->DIVIDER_TEXT[0]);
-  UtilsText_addNewLines(this->pScreenText, 2);
-  UtilsText_addText(this->pScreenText, "You can check an outline of key controls in the \"keys\" section");
-  UtilsText_addText(this->pScreenText, "[Q] to return to the menu");
 
-  // Formatting
-  this->pScreenText = UtilsUI_centerXY(this->pScreenText);
+  // Nothing on this page changes unless the console is resized
+  if(!UtilsLayout_isFresh(this->pGuideLayout)) {
+    this->pScreenText = UtilsText_create();
+    
+    // Content
+    UtilsText_addNewLines(this->pScreenText, 2);
+    UtilsText_addBlock(this->pScreenText, this->ASSETS->GUIDE_TEXT, this->ASSETS->GUIDE_TEXT_LEN);
+    UtilsText_addNewLines(this->pScreenText, 3);
+    UtilsText_addText(this->pScreenText, this->ASSETS->DIVIDER_TEXT[0]);
+    UtilsText_addNewLines(this->pScreenText, 2);
+    UtilsText_addText(this->pScreenText, "You can check an outline of key controls in the \"keys\" section");
+    UtilsText_addText(this->pScreenText, "[Q] to return to the menu");
+
+    // Formatting
+    UtilsLayout_build(this->pGuideLayout, this->pScreenText, NULL);
+
+    // Garbage collection!
+    UtilsText_kill(this->pScreenText);
+  }
   
   // Print final text
   UtilsIO_clear();
-  UtilsUI_print(this->pScreenText);
-
-  // Garbage collection!
-  UtilsText_kill(this->pScreenText);
+  UtilsUI_print(UtilsLayout_getText(this->pGuideLayout));
 }
 
 /**
@@ -638,27 +777,31 @@ void Game_guideUI(char cInput, struct Game *this) {
  * @param   {struct Game *}   this    The game object.
 */
 void Game_controlsUI(char cInput, struct Game *this) {
-  this->pScreenText = UtilsText_create();
-  
-  // Content
-  UtilsText_addBlock(this->pScreenText, this->ASSETS->CONTROLS_SPRITE, this->ASSETS->CONTROLS_SPRITE_LEN);
-  UtilsText_addNewLines(this->pScreenText, 1);
-  UtilsText_addBlock(this->pScreenText, this->ASSETS->CONTROLS_TEXT, this->ASSETS->CONTROLS_TEXT_LEN);
-  UtilsText_addNewLines(this->pScreenText, 2);
-  UtilsText_addText(this->pScreenText, this->ASSETS->DIVIDER_TEXT[0]);
-  UtilsText_addNewLines(this->pScreenText, 2);
-  UtilsText_addText(this->pScreenText, "The controls will be explained in more detail as you play.");
-  UtilsText_addText(this->pScreenText, "[Q] to return to the menu");
 
-  // Formatting
-  this->pScreenText = UtilsUI_centerXY(this->pScreenText);
+  // Nothing on this page changes unless the console is resized
+  if(!UtilsLayout_isFresh(this->pControlsLayout)) {
+    this->pScreenText = UtilsText_create();
+    
+    // Content
+    UtilsText_addBlock(this->pScreenText, this->ASSETS->CONTROLS_SPRITE, this->ASSETS->CONTROLS_SPRITE_LEN);
+    UtilsText_addNewLines(this->pScreenText, 1);
+    UtilsText_addBlock(this->pScreenText, this->ASSETS->CONTROLS_TEXT, this->ASSETS->CONTROLS_TEXT_LEN);
+    UtilsText_addNewLines(this->pScreenText, 2);
+    UtilsText_addText(this->pScreenText, this->ASSETS->DIVIDER_TEXT[0]);
+    UtilsText_addNewLines(this->pScreenText, 2);
+    UtilsText_addText(this->pScreenText, "The controls will be explained in more detail as you play.");
+    UtilsText_addText(this->pScreenText, "[Q] to return to the menu");
+
+    // Formatting
+    UtilsLayout_build(this->pControlsLayout, this->pScreenText, NULL);
+
+    // Garbage collection!
+    UtilsText_kill(this->pScreenText);
+  }
   
   // Print final text
   UtilsIO_clear();
-  UtilsUI_print(this->pScreenText);
-
-  // Garbage collection!
-  UtilsText_kill(this->pScreenText);
+  UtilsUI_print(UtilsLayout_getText(this->pControlsLayout));
 }
 
 /**
@@ -668,28 +811,32 @@ void Game_controlsUI(char cInput, struct Game *this) {
  * @param   {struct Game *}   this    The game object.
 */
 void Game_authorUI(char cInput, struct Game *this) {
-  this->pScreenText = UtilsText_create();
-  
-  // Content
-  UtilsText_addNewLines(this->pScreenText, 4);
-  UtilsText_addBlock(this->pScreenText, this->ASSETS->AUTHOR_SPRITE, this->ASSETS->AUTHOR_SPRITE_LEN);
-  UtilsText_addNewLines(this->pScreenText, 2);
-  UtilsText_addBlock(this->pScreenText, this->ASSETS->AUTHOR_TEXT, this->ASSETS->AUTHOR_TEXT_LEN);
-  UtilsText_addNewLines(this->pScreenText, 3);
-  UtilsText_addText(this->pScreenText, this->ASSETS->DIVIDER_TEXT[0]);
-  UtilsText_addNewLines(this->pScreenText, 2);
-  UtilsText_addText(this->pScreenText, "Check the code for additional credits and links");
-  UtilsText_addText(this->pScreenText, "[Q] to return to the menu");
 
-  // Formatting
-  this->pScreenText = UtilsUI_centerXY(this->pScreenText);
+  // Nothing on this page changes unless the console is resized
+  if(!UtilsLayout_isFresh(this->pAuthorLayout)) {
+    this->pScreenText = UtilsText_create();
+    
+    // Content
+    UtilsText_addNewLines(this->pScreenText, 4);
+    UtilsText_addBlock(this->pScreenText, this->ASSETS->AUTHOR_SPRITE, this->ASSETS->AUTHOR_SPRITE_LEN);
+    UtilsText_addNewLines(this->pScreenText, 2);
+    UtilsText_addBlock(this->pScreenText, this->ASSETS->AUTHOR_TEXT, this->ASSETS->AUTHOR_TEXT_LEN);
+    UtilsText_addNewLines(this->pScreenText, 3);
+    UtilsText_addText(this->pScreenText, this->ASSETS->DIVIDER_TEXT[0]);
+    UtilsText_addNewLines(this->pScreenText, 2);
+    UtilsText_addText(this->pScreenText, "Check the code for additional credits and links");
+    UtilsText_addText(this->pScreenText, "[Q] to return to the menu");
+
+    // Formatting
+    UtilsLayout_build(this->pAuthorLayout, this->pScreenText, NULL);
+
+    // Garbage collection!
+    UtilsText_kill(this->pScreenText);
+  }
   
   // Print final text
   UtilsIO_clear();
-  UtilsUI_print(this->pScreenText);
-
-  // Garbage collection!
-  UtilsText_kill(this->pScreenText);
+  UtilsUI_print(UtilsLayout_getText(this->pAuthorLayout));
 }
 
 /**
@@ -828,6 +975,9 @@ void Game_playStartIO(char *sInput, struct Game *this) {
   } else {
     strcpy(this->sInputWarning, "");
     this->bFirst = 0;
+
+    if(this->pJournal != NULL)
+      GameJournal_logName(this->pJournal, sInput);
   }
 }
 
@@ -879,6 +1029,10 @@ void Game_playIO(char cInput, struct Game *this) {
       break;
   }
 
+  // The letters are part of the query while a search is being typed
+  if(Shop_isSearching(this->pShop) || Farm_isSearching(this->pFarm))
+    return;
+
   if(cInput == 'Q') {
     this->eDialogState = DIALOG_PAUSED;
     strcpy(this->sDialogMessage, "Are you sure you want to exit to the main menu?");
@@ -890,6 +1044,14 @@ void Game_playIO(char cInput, struct Game *this) {
   if(cInput == 'I')
     this->eDialogState = DIALOG_INVENTORY;
 
+  // Not while plots are being picked, since whether they can be picked depends on what's on them
+  if(this->pHistory != NULL && !Farm_isSelecting(this->pFarm)) {
+    if(cInput == 'U' && GameHistory_undo(this->pHistory) && this->pJournal != NULL)
+      GameJournal_logUndo(this->pJournal);
+
+    if(cInput == 'R' && GameHistory_redo(this->pHistory) && this->pJournal != NULL)
+      GameJournal_logRedo(this->pJournal);
+  }
 }
 
 /**
@@ -954,13 +1116,29 @@ void Game_playHome(struct Game *this) {
   this->ePlayState = PLAY_HOME;
   Player_goHome(this->pPlayer);
 
+  if(this->pHistory != NULL)
+    GameHistory_onSleep(this->pHistory);
+
+  // Save every morning, unless there's no game left to save
+  if(this->pSave != NULL) {
+    if(Player_isDead(this->pPlayer)) {
+      GameSave_erase(this->pSave);
+      if(this->pJournal != NULL) GameJournal_reset(this->pJournal);
+    } else {
+      if(this->pJournal != NULL) GameJournal_logSleep(this->pJournal);
+      Game_autosave(this);
+    }
+  }
+
   // If game over
   if(Player_isDead(this->pPlayer)) {
     this->eDialogState = DIALOG_GAMEOVER;
     strcpy(this->sDialogMessage, "You starved for three consecutive days!");
 
     // Copy name so we don't have to ask for it again
-    char* sName = Player_getName(this->pPlayer);
+    // (the old player takes its name with it when it's killed)
+    char sName[PLAYER_NAME_MAX_LEN + 1];
+    strcpy(sName, Player_getName(this->pPlayer));
 
     // Reset the game objects
     Player_kill(this->pPlayer);
@@ -991,6 +1169,17 @@ void Game_playHome(struct Game *this) {
     this->pFarm = pFarm;
     this->pShop = pShop;
 
+    // The clock has to follow the new farm
+    if(this->pRealtime != NULL)
+      GameRealtime_attach(this->pRealtime, pFarm, pPlayer);
+
+    // So do the journal (which starts the new game with the name) and the undo history
+    if(this->pHistory != NULL)
+      Game_listen(this);
+
+    if(this->pJournal != NULL)
+      GameJournal_logName(this->pJournal, sName);
+
     // Go to menu after the dialog box
     this->ePlayState = PLAY_SELECTING;
     this->eGameState = GAME_MENU;
@@ -1066,8 +1255,12 @@ void Game_play(struct Game *this) {
           this->pIOFuncArray[GAME_DIALOG], this, " ");
 
         // Exit to menu if user presses enter and selects "Okay"
-        if(UtilsSelector_getCurrentValue(this->pDialogSelector)) 
+        // (and save, since they might quit from there)
+        if(UtilsSelector_getCurrentValue(this->pDialogSelector)) {
           this->eGameState = GAME_MENU;
+
+          Game_autosave(this);
+        }
         break;
 
       case DIALOG_HELP:
@@ -1150,8 +1343,8 @@ void Game_author(struct Game *this) {
 void Game_consoleWarning(struct Game *this) {
 
   // Generate warning text
-  char *sCurConSize = calloc(32, sizeof(char));
-  char *sMinConSize = calloc(32, sizeof(char));
+  char *sCurConSize = UtilsMem_calloc(UTILS_MEM_GAME, 32, sizeof(char));
+  char *sMinConSize = UtilsMem_calloc(UTILS_MEM_GAME, 32, sizeof(char));
 
   this->pScreenText = UtilsText_create();
   UtilsText_addBlock(this->pScreenText, this->ASSETS->WARNING_SPRITE, this->ASSETS->WARNING_SPRITE_LEN);
@@ -1170,8 +1363,8 @@ void Game_consoleWarning(struct Game *this) {
   UtilsUI_print(this->pScreenText);
 
   // Garbage collection
-  free(sCurConSize);
-  free(sMinConSize);
+  UtilsMem_free(sCurConSize);
+  UtilsMem_free(sMinConSize);
   UtilsText_kill(this->pScreenText);
   
   // Press enter to continue
@@ -1182,10 +1375,11 @@ void Game_consoleWarning(struct Game *this) {
  * Configures the running mode of the game.
  * 
  * @param   {struct Game *}   this    The game object.
- * @param   {char *}          sMode   Let's the game run in the default, debug, or minimal mode.
+ * @param   {char *}          sMode   Let's the game run in the default, debug, full or real-time mode, or continue the saved game.
  * @param   {char *}          sScene  Specifies the scene to start on for debug mode.
+ * @param   {char *}          sDays   How many days to skip ahead in debug mode (can be NULL).
 */
-void Game_conf(struct Game *this, char *sMode, char *sScene) {
+void Game_conf(struct Game *this, char *sMode, char *sScene, char *sDays) {
 
   int dMode = 0;
 
@@ -1193,6 +1387,8 @@ void Game_conf(struct Game *this, char *sMode, char *sScene) {
   if(!strcmp(sMode, "default")) dMode = 0;
   if(!strcmp(sMode, "debug")) dMode = 1;
   if(!strcmp(sMode, "full")) dMode = 2;
+  if(!strcmp(sMode, "realtime")) dMode = 2;
+  if(!strcmp(sMode, "continue")) dMode = 2;
 
   // Change game scene
   if(!strcmp(sScene, "play")) this->ePlayState = PLAY_SELECTING;
@@ -1238,6 +1434,11 @@ void Game_conf(struct Game *this, char *sMode, char *sScene) {
         this->pFarm->pPlotArray[i]->eState = i % 3;
         this->pFarm->pPlotArray[i]->pProduct = p;
       }
+
+      // Skip ahead a few days, watering everything if we can
+      if(sDays != NULL && atoi(sDays) > 0)
+        if(!Farm_fastForward(this->pFarm, this->pPlayer, atoi(sDays), 1))
+          Farm_fastForward(this->pFarm, this->pPlayer, atoi(sDays), 0);
       break;
 
     // Full mode
@@ -1248,6 +1449,49 @@ void Game_conf(struct Game *this, char *sMode, char *sScene) {
       this->eGameState = GAME_MENU; 
       break;
   }
+
+  // Crops grow on their own in real-time mode, so the input loops have to keep an eye on the clock
+  if(!strcmp(sMode, "realtime")) {
+    this->pRealtime = GameRealtime_create(this->pFarm, this->pPlayer);
+    UtilsKey_setTicker(&GameRealtime_tick, this->pRealtime, GAME_REALTIME_TICK_MILLIS);
+  }
+
+  // Undo works on whatever the game starts with (the farm debug mode makes, or the loaded save below)
+  if(dMode && this->pRealtime == NULL) {
+    this->pHistory = GameHistory_create();
+    Game_listen(this);
+  }
+
+  // The full game keeps a save (and outside of real-time mode, a journal of everything done since)
+  if(dMode == 2) {
+    int bContinued = 0;
+
+    this->pSave = GameSave_create(GAME_SAVE_PATH);
+
+    if(this->pRealtime == NULL)
+      this->pJournal = GameJournal_create(GAME_JOURNAL_PATH, this->CATALOGUE);
+
+    // Continuing picks up where the last save left off, then plays back whatever happened after it
+    if(!strcmp(sMode, "continue")) {
+      bContinued = GameSave_load(this->pSave, this->pPlayer, this->pFarm, this->pShop, this->CATALOGUE);
+      Game_listen(this);
+      bContinued += GameJournal_recover(this->pJournal, this->pSave->dSeq, this->pPlayer, this->pFarm, this->pShop, this->CATALOGUE, this->pHistory);
+
+    // A new game replaces the old one right away, so the journal never gets played back onto the wrong save
+    } else {
+      GameSave_erase(this->pSave);
+
+      if(this->pJournal != NULL)
+        GameJournal_reset(this->pJournal);
+      else
+        remove(GAME_JOURNAL_PATH);
+    }
+
+    if(bContinued) {
+      this->bFirst = 0;
+      this->dDialogueIndex = this->ASSETS->DIALOGUE_TEXT_LEN;
+    }
+  }
 }
 
 /**
@@ -1275,6 +1519,19 @@ void Game_execFull(struct Game *this) {
     } 
   } while(this->eGameState != GAME_QUIT);
 
+  // Make sure the last save and the journal made it to the disk
+  if(this->pJournal != NULL) {
+    GameJournal_commit(this->pJournal);
+    this->pSave->dSeq = GameJournal_getSeq(this->pJournal);
+    GameJournal_kill(this->pJournal);
+  }
+
+  if(this->pSave != NULL)
+    GameSave_kill(this->pSave, this->pPlayer, this->pFarm, this->pShop, this->CATALOGUE);
+
+  if(this->pHistory != NULL)
+    GameHistory_kill(this->pHistory);
+
   printf("\x1b[38;5;255m");
   printf("\x1b[48;5;232m");
 
@@ -20,6 +20,7 @@
 #include "../utils/utils.ui.h"
 #include "../utils/utils.io.h"
 #include "../utils/utils.key.h"
+#include "../utils/utils.mem.h"
 
 #define GAME_MINI_MIN_WIDTH 80
 #define GAME_MINI_MIN_HEIGHT 32
@@ -63,6 +64,10 @@ struct GameMini {
   int bCropSownStatesArray[CATALOGUE_SIZE];
   int dCropLastWateredArray[CATALOGUE_SIZE];
   int dCropWaterStatesArray[CATALOGUE_SIZE];
+
+  // The feedback messages shout the names, so we make the uppercase versions once instead of on every keystroke
+  char *sCropNameArray[CATALOGUE_SIZE];
+  char *sActionNameArray[6];
 };
 
 /**
@@ -79,6 +84,7 @@ void GameMini_init(struct GameMini *this, struct GameCatalogue *pCatalogue) {
     this->bCropSownStatesArray[i] = 0;
     this->dCropLastWateredArray[i] = -1;
     this->dCropWaterStatesArray[i] = 0;
+    this->sCropNameArray[i] = 0 < i && i < pCatalogue->dSize ? UtilsUI_toUpper(pCatalogue->sProductNameArray[i]) : NULL;
   }
 
   // Game objects
@@ -103,6 +109,9 @@ void GameMini_init(struct GameMini *this, struct GameCatalogue *pCatalogue) {
   this->pFarm = pFarm;
   this->pShop = pShop;
 
+  for(int i = 0; i < 6; i++)
+    this->sActionNameArray[i] = UtilsUI_toUpper(pFarm->sPresentActionNameArray[i]);
+
   // Game state and parameters
   this->ePlayState = PLAY_SELECTING;
   this->eGameState = GAME_MENU;
@@ -110,8 +119,8 @@ void GameMini_init(struct GameMini *this, struct GameCatalogue *pCatalogue) {
 
   // IO objects
   this->dIntInput = 0;
-  this->sCurrentInput = calloc(UTILS_KEY_MAX_INPUT, sizeof(char));
-  this->sFeedbackString = calloc(UTILS_KEY_MAX_INPUT, sizeof(char));
+  this->sCurrentInput = UtilsMem_calloc(UTILS_MEM_GAME, UTILS_KEY_MAX_INPUT, sizeof(char));
+  this->sFeedbackString = UtilsMem_calloc(UTILS_MEM_GAME, UTILS_KEY_MAX_INPUT, sizeof(char));
   
   // UI objects
   this->sLiner =   "###############################################################";
@@ -124,6 +133,30 @@ void GameMini_init(struct GameMini *this, struct GameCatalogue *pCatalogue) {
   this->pFooterText = pFooterText;
 }
 
+/**
+ * Frees everything the minified version of the game made.
+ * The game itself never needs this since it only ever plays once, but the bot does (see src/bot.c).
+ * 
+ * @param   {struct GameMini *}   this  The mini game object.
+*/
+void GameMini_exit(struct GameMini *this) {
+  Player_kill(this->pPlayer);
+  Farm_kill(this->pFarm);
+  Shop_kill(this->pShop);
+
+  UtilsMem_free(this->sCurrentInput);
+  UtilsMem_free(this->sFeedbackString);
+
+  UtilsText_kill(this->pScreenText);
+  UtilsText_kill(this->pFooterText);
+
+  for(int i = 0; i < CATALOGUE_SIZE; i++)
+    UtilsMem_free(this->sCropNameArray[i]);
+
+  for(int i = 0; i < 6; i++)
+    UtilsMem_free(this->sActionNameArray[i]);
+}
+
 /**
  * Creates the footer for the entire game.
  * 
@@ -285,7 +318,7 @@ void GameMini_UI(char cInput, struct GameMini *this) {
 
                 // Player is gonna sow some seeds.
                 case FARM_SOW:
-                  strcpy(sProductName, UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[Farm_getCurrentCrop(this->pFarm)]));
+                  strcpy(sProductName, this->sCropNameArray[Farm_getCurrentCrop(this->pFarm)]);
                   sprintf(sActionName, "You are about to (SOW) some plots with (%s) seeds.", sProductName);
                   sprintf(sActionInfo, "There are (%d) (TILLED) plots; you have (%d) (%s) seeds.", 
                     Farm_canSow(this->pFarm), Stock_getAmount(this->pPlayer->pSeedStockArray[Farm_getCurrentCrop(this->pFarm)]), sProductName);
@@ -361,7 +394,7 @@ void GameMini_UI(char cInput, struct GameMini *this) {
                 dCostAmount = UtilsKey_stringToInt(this->sCurrentInput) * this->CATALOGUE->dProductCostToSellArray[Shop_getCurrentCrop(this->pShop)];
 
               sprintf(sActionInput,   "No. of (%s) crops for (%s): %-*.*s", 
-                UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[Shop_getCurrentCrop(this->pShop)]),
+                this->sCropNameArray[Shop_getCurrentCrop(this->pShop)],
                 UtilsUI_toUpper(this->pShop->sPresentActionNameArray[Shop_getCurrentAction(this->pShop)]),
                 UTILS_KEY_MAX_DIGITS, UTILS_KEY_MAX_DIGITS, strlen(this->sCurrentInput) ? this->sCurrentInput : "________");
               
@@ -497,41 +530,40 @@ void GameMini_IO(char cInput, struct GameMini *this) {
                 if(cInput == 'G') Farm_setCurrentAction(this->pFarm, FARM_NULL);
                 
                 int dSelected = -1;
-                for(int i = 1; i < this->CATALOGUE->dSize; i++) {
+                enum ProductType eCrop = GameCatalogue_findCode(cInput);
 
-                  char *sProductName = UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[i]);
-                  if(cInput == this->CATALOGUE->cProductCodeArray[i]) {
-                    
-                    // When selecting seeds for sowing
-                    if(Farm_getCurrentAction(this->pFarm) == FARM_SOW) {
-                      if(Stock_getAmount(this->pPlayer->pSeedStockArray[i])) {  
-                        if(!this->bCropSownStatesArray[i]) {
-                          dSelected = i;
-                        } else sprintf(this->sFeedbackString, "The farm already has (%s) seeds planted on it.", sProductName);
-                      } else sprintf(this->sFeedbackString, "You do not have (%s) seeds.", sProductName);
-
-                    // When selecting crops for watering
-                    } else if(Farm_getCurrentAction(this->pFarm) == FARM_WATER) {
-                      if(this->bCropSownStatesArray[i]) {
-                        if(this->dCropLastWateredArray[i] < Player_getTime(this->pPlayer)) {
-                          if(this->dCropWaterStatesArray[i] < this->CATALOGUE->dProductWaterReqArray[i]) {
-                            if(Player_getEnergy(this->pPlayer) >= this->bCropSownStatesArray[i]) {
-                              dSelected = i;
-                            } else sprintf(this->sFeedbackString, "You don't have enough energy to water your (%s) crops.", sProductName);
-                          } else sprintf(this->sFeedbackString, "Your (%s) crops have been fully watered.", sProductName);  
-                        } else sprintf(this->sFeedbackString, "Your (%s) crops were just watered today.", sProductName);  
-                      } else sprintf(this->sFeedbackString, "The farm does not have crops of type (%s) on it.", sProductName);
-                    
-                    // When selecting crops for harvesting
-                    } else if(Farm_getCurrentAction(this->pFarm) == FARM_HARVEST) {
-                      if(this->bCropSownStatesArray[i]) {
-                        if(this->dCropWaterStatesArray[i] >= this->CATALOGUE->dProductWaterReqArray[i]) {
-                          if(Player_getEnergy(this->pPlayer) >= this->bCropSownStatesArray[i]) {
-                            dSelected = i;
-                          } else sprintf(this->sFeedbackString, "You don't have enoug energy to harvest your (%s) crops.", sProductName);
-                        } else sprintf(this->sFeedbackString, "Your (%s) crops have not been fully watered.", sProductName);  
-                      } else sprintf(this->sFeedbackString, "The farm does not have crops of type (%s) on it.", sProductName);
-                    }
+                if(eCrop != PRODUCT_NULL) {
+                  char *sProductName = this->sCropNameArray[eCrop];
+                  
+                  // When selecting seeds for sowing
+                  if(Farm_getCurrentAction(this->pFarm) == FARM_SOW) {
+                    if(Stock_getAmount(this->pPlayer->pSeedStockArray[eCrop])) {  
+                      if(!this->bCropSownStatesArray[eCrop]) {
+                        dSelected = eCrop;
+                      } else sprintf(this->sFeedbackString, "The farm already has (%s) seeds planted on it.", sProductName);
+                    } else sprintf(this->sFeedbackString, "You do not have (%s) seeds.", sProductName);
+
+                  // When selecting crops for watering
+                  } else if(Farm_getCurrentAction(this->pFarm) == FARM_WATER) {
+                    if(this->bCropSownStatesArray[eCrop]) {
+                      if(this->dCropLastWateredArray[eCrop] < Player_getTime(this->pPlayer)) {
+                        if(this->dCropWaterStatesArray[eCrop] < this->CATALOGUE->dProductWaterReqArray[eCrop]) {
+                          if(Player_getEnergy(this->pPlayer) >= this->bCropSownStatesArray[eCrop]) {
+                            dSelected = eCrop;
+                          } else sprintf(this->sFeedbackString, "You don't have enough energy to water your (%s) crops.", sProductName);
+                        } else sprintf(this->sFeedbackString, "Your (%s) crops have been fully watered.", sProductName);  
+                      } else sprintf(this->sFeedbackString, "Your (%s) crops were just watered today.", sProductName);  
+                    } else sprintf(this->sFeedbackString, "The farm does not have crops of type (%s) on it.", sProductName);
+                  
+                  // When selecting crops for harvesting
+                  } else if(Farm_getCurrentAction(this->pFarm) == FARM_HARVEST) {
+                    if(this->bCropSownStatesArray[eCrop]) {
+                      if(this->dCropWaterStatesArray[eCrop] >= this->CATALOGUE->dProductWaterReqArray[eCrop]) {
+                        if(Player_getEnergy(this->pPlayer) >= this->bCropSownStatesArray[eCrop]) {
+                          dSelected = eCrop;
+                        } else sprintf(this->sFeedbackString, "You don't have enoug energy to harvest your (%s) crops.", sProductName);
+                      } else sprintf(this->sFeedbackString, "Your (%s) crops have not been fully watered.", sProductName);  
+                    } else sprintf(this->sFeedbackString, "The farm does not have crops of type (%s) on it.", sProductName);
                   }
                 }
 
@@ -565,12 +597,12 @@ void GameMini_IO(char cInput, struct GameMini *this) {
                             if(this->dCropWaterStatesArray[Farm_getCurrentCrop(this->pFarm)] < 
                               this->CATALOGUE->dProductWaterReqArray[Farm_getCurrentCrop(this->pFarm)])
                               sprintf(this->sFeedbackString, "Your (%s) crops are now (%d/%d) from becoming harvestable.",
-                                UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[Farm_getCurrentCrop(this->pFarm)]),
+                                this->sCropNameArray[Farm_getCurrentCrop(this->pFarm)],
                                 this->dCropWaterStatesArray[Farm_getCurrentCrop(this->pFarm)],
                                 this->CATALOGUE->dProductWaterReqArray[Farm_getCurrentCrop(this->pFarm)]);
                             else 
                               sprintf(this->sFeedbackString, "Your (%s) crops are now fully watered! You can harvest them now.",
-                                UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[Farm_getCurrentCrop(this->pFarm)]));
+                                this->sCropNameArray[Farm_getCurrentCrop(this->pFarm)]);
                             break;
                           
                           case FARM_HARVEST: 
@@ -584,7 +616,7 @@ void GameMini_IO(char cInput, struct GameMini *this) {
 
                             sprintf(this->sFeedbackString, "You now have (%d) (%s) crops in your inventory.",
                               Stock_getAmount(Player_getCropStock(this->pPlayer, Farm_getCurrentCrop(this->pFarm))),
-                              UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[Farm_getCurrentCrop(this->pFarm)]));
+                              this->sCropNameArray[Farm_getCurrentCrop(this->pFarm)]);
                             break;
 
                           default: break;
@@ -637,7 +669,7 @@ void GameMini_IO(char cInput, struct GameMini *this) {
                             Player_updateSeedStock(this->pPlayer, Farm_getCurrentCrop(this->pFarm), -dActionablePlots);
                             this->bCropSownStatesArray[Farm_getCurrentCrop(this->pFarm)] = dActionablePlots; 
                             sprintf(this->sFeedbackString, "You've just (SOWN) a total of (%d) plots with (%s) seeds.", dActionablePlots,
-                              UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[Farm_getCurrentCrop(this->pFarm)]));
+                              this->sCropNameArray[Farm_getCurrentCrop(this->pFarm)]);
                             break;
 
                           default: break;
@@ -652,10 +684,10 @@ void GameMini_IO(char cInput, struct GameMini *this) {
                     } else {
                       if(Farm_getCurrentAction(this->pFarm) != FARM_SOW) {
                         sprintf(this->sFeedbackString, "The number exceeds the number of plots available for (%s).", 
-                          UtilsUI_toUpper(this->pFarm->sPresentActionNameArray[Farm_getCurrentAction(this->pFarm)]));
+                          this->sActionNameArray[Farm_getCurrentAction(this->pFarm)]);
                       } else {
                         sprintf(this->sFeedbackString, "The number exceeds the number of plots or seeds available for (%s).", 
-                          UtilsUI_toUpper(this->pFarm->sPresentActionNameArray[Farm_getCurrentAction(this->pFarm)]));
+                          this->sActionNameArray[Farm_getCurrentAction(this->pFarm)]);
                       }
                     }
 
@@ -699,19 +731,19 @@ void GameMini_IO(char cInput, struct GameMini *this) {
             if(Shop_getCurrentCrop(this->pShop) == PRODUCT_NULL) {
               if(cInput == 'G') Shop_setCurrentAction(this->pShop, FARM_NULL);
               
-              for(int i = 1; i < this->CATALOGUE->dSize; i++) {
-                if(cInput == this->CATALOGUE->cProductCodeArray[i]) {
-                  char *sProductName = UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[i]);
+              enum ProductType eCrop = GameCatalogue_findCode(cInput);
 
-                  if(Shop_getCurrentAction(this->pShop) == SHOP_BUY) {
-                    if(Player_getGold(this->pPlayer) >= this->CATALOGUE->dProductCostToBuyArray[i]) Shop_setCurrentCrop(this->pShop, i);
-                    else sprintf(this->sFeedbackString, "You do not have enough gold to buy a (%s) seed.", sProductName);
-                  }
+              if(eCrop != PRODUCT_NULL) {
+                char *sProductName = this->sCropNameArray[eCrop];
 
-                  if(Shop_getCurrentAction(this->pShop) == SHOP_SELL) {
-                    if(Stock_getAmount(Player_getCropStock(this->pPlayer, i))) Shop_setCurrentCrop(this->pShop, i);
-                    else sprintf(this->sFeedbackString, "You do not have (%s) crops of to sell.", sProductName);
-                  }
+                if(Shop_getCurrentAction(this->pShop) == SHOP_BUY) {
+                  if(Player_getGold(this->pPlayer) >= this->CATALOGUE->dProductCostToBuyArray[eCrop]) Shop_setCurrentCrop(this->pShop, eCrop);
+                  else sprintf(this->sFeedbackString, "You do not have enough gold to buy a (%s) seed.", sProductName);
+                }
+
+                if(Shop_getCurrentAction(this->pShop) == SHOP_SELL) {
+                  if(Stock_getAmount(Player_getCropStock(this->pPlayer, eCrop))) Shop_setCurrentCrop(this->pShop, eCrop);
+                  else sprintf(this->sFeedbackString, "You do not have (%s) crops of to sell.", sProductName);
                 }
               }
 
@@ -730,7 +762,7 @@ void GameMini_IO(char cInput, struct GameMini *this) {
                     Player_updateSeedStock(this->pPlayer, Shop_getCurrentCrop(this->pShop), this->dIntInput);
 
                     sprintf(this->sFeedbackString, "You just (BOUGHT) a total of (%d) (%s) seeds.", this->dIntInput,
-                      UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[Shop_getCurrentCrop(this->pShop)]));
+                      this->sCropNameArray[Shop_getCurrentCrop(this->pShop)]);
                     
                     Shop_setCurrentAction(this->pShop, SHOP_NULL);
                   } else strcpy(this->sFeedbackString, "You do not have enough gold to make that purchase.");
@@ -742,7 +774,7 @@ void GameMini_IO(char cInput, struct GameMini *this) {
                     Player_updateCropStock(this->pPlayer, Shop_getCurrentCrop(this->pShop), -this->dIntInput);
 
                     sprintf(this->sFeedbackString, "You just (SOLD) (%d) (%s) crops for (%d).", this->dIntInput,
-                      UtilsUI_toUpper(this->CATALOGUE->sProductNameArray[Shop_getCurrentCrop(this->pShop)]),
+                      this->sCropNameArray[Shop_getCurrentCrop(this->pShop)],
                       Shop_getCurrentSellCost(this->pShop, this->dIntInput));
                     
                     Shop_setCurrentAction(this->pShop, SHOP_NULL);
@@ -770,8 +802,7 @@ void GameMini_IO(char cInput, struct GameMini *this) {
 
   // Append the character to the input string for parsing later on.
   if(UtilsKey_isAlpha(cInput) || UtilsKey_isNum(cInput) || UtilsKey_isBackspace(cInput, "")) {
-    char *sInput = calloc(1, sizeof(char));
-    sprintf(sInput, "%c", cInput);
+    char sInput[2] = { cInput, 0 };
 
     if(!UtilsKey_isReturn(cInput, "")) {
       
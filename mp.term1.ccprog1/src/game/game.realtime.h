@@ -0,0 +1,254 @@
+/**
+ * Real-time mode.
+ * Normally crops only change when the player does something; here they also change as (wall-clock) time passes.
+ * A watered crop can take water again after a while instead of having to wait for the next day,
+ * but a crop that goes too long without water starts wilting, and after that it dies.
+ * 
+ * Every plot has at most one timer of each kind waiting on a timer wheel (see utils.wheel.h),
+ * so a tick only ever touches the plots something actually happened to, and only those get drawn again.
+*/
+
+#ifndef GAME_REALTIME
+#define GAME_REALTIME
+
+#include <time.h>
+
+#include "objects/game.obj.farm.h"
+#include "objects/game.obj.player.h"
+
+#include "classes/game.class.plot.h"
+#include "classes/game.class.product.h"
+
+#include "enums/game.enum.farm.h"
+#include "enums/game.enum.state.h"
+
+#include "../utils/utils.mem.h"
+#include "../utils/utils.wheel.h"
+
+// All of these are in seconds
+#define GAME_REALTIME_GROW_TIME 20      // How long after watering a crop can take water again
+#define GAME_REALTIME_WILT_TIME 45      // How long a thirsty crop lasts before it starts wilting
+#define GAME_REALTIME_DEATH_TIME 90     // How long a thirsty crop lasts before it dies
+
+// How often the input loops check the clock, in milliseconds
+#define GAME_REALTIME_TICK_MILLIS 250
+
+/**
+ * Keeps track of the timers of every plot.
+*/
+struct GameRealtime {
+  struct UtilsWheel *pWheel;
+  struct Farm *pFarm;
+  struct Player *pPlayer;
+
+  // When the clock started; the wheel counts seconds from here
+  time_t dStart;
+
+  // The handles of the timers of each plot, one per event (or -1)
+  int dTimerArray[FARM_MAX_WIDTH * FARM_MAX_HEIGHT][3];
+};
+
+/**
+ * ###############################
+ * ###  REALTIME CONSTRUCTION  ###
+ * ###############################
+*/
+
+/**
+ * Allocates memory for an instance of the GameRealtime class.
+ * 
+ * @return  {struct GameRealtime *}   A pointer to the created instance.
+*/
+struct GameRealtime *GameRealtime_new() {
+  struct GameRealtime *pGameRealtime;
+
+  pGameRealtime = UtilsMem_calloc(UTILS_MEM_GAME, 1, sizeof(*pGameRealtime));
+
+  if(pGameRealtime == NULL)
+    return NULL;
+
+  return pGameRealtime;
+}
+
+/**
+ * Listens to what the player does on the farm.
+ * Declared here because GameRealtime_attach() needs it.
+*/
+void GameRealtime_onPlot(void *pData, int dIndex, enum FarmAction eAction);
+
+/**
+ * Starts keeping time for a farm and a player.
+ * Anything that was scheduled for the previous ones is forgotten (the game makes new ones on a game over).
+ * 
+ * @param   {struct GameRealtime *}   this      The instance.
+ * @param   {struct Farm *}           pFarm     The farm whose crops grow.
+ * @param   {struct Player *}         pPlayer   The player (we need the day from it).
+*/
+void GameRealtime_attach(struct GameRealtime *this, struct Farm *pFarm, struct Player *pPlayer) {
+  UtilsWheel_clear(this->pWheel);
+
+  for(int i = 0; i < FARM_MAX_WIDTH * FARM_MAX_HEIGHT; i++)
+    for(int j = 0; j < 3; j++)
+      this->dTimerArray[i][j] = -1;
+
+  this->pFarm = pFarm;
+  this->pPlayer = pPlayer;
+  this->dStart = time(NULL) - UtilsWheel_getNow(this->pWheel);
+
+  Farm_setListener(pFarm, &GameRealtime_onPlot, this);
+}
+
+/**
+ * Initializes the instance.
+ * 
+ * @param   {struct GameRealtime *}   this      The instance to be initialized.
+ * @param   {struct Farm *}           pFarm     The farm whose crops grow.
+ * @param   {struct Player *}         pPlayer   The player.
+*/
+void GameRealtime_init(struct GameRealtime *this, struct Farm *pFarm, struct Player *pPlayer) {
+  this->pWheel = UtilsWheel_create(3 * FARM_MAX_WIDTH * FARM_MAX_HEIGHT);
+
+  GameRealtime_attach(this, pFarm, pPlayer);
+}
+
+/**
+ * Creates an initialized instance of the class.
+ * 
+ * @param   {struct Farm *}           pFarm     The farm whose crops grow.
+ * @param   {struct Player *}         pPlayer   The player.
+ * @return  {struct GameRealtime *}             The created instance.
+*/
+struct GameRealtime *GameRealtime_create(struct Farm *pFarm, struct Player *pPlayer) {
+  struct GameRealtime *pGameRealtime = GameRealtime_new();
+  GameRealtime_init(pGameRealtime, pFarm, pPlayer);
+
+  return pGameRealtime;
+}
+
+/**
+ * Destroys a specified instance.
+ * 
+ * @param   {struct GameRealtime *}   this  The instance to be destroyed.
+*/
+void GameRealtime_kill(struct GameRealtime *this) {
+  Farm_setListener(this->pFarm, NULL, NULL);
+  UtilsWheel_kill(this->pWheel);
+  UtilsMem_free(this);
+}
+
+/**
+ * ##########################
+ * ###  REALTIME METHODS  ###
+ * ##########################
+*/
+
+/**
+ * Cancels whatever was going to happen to a plot.
+ * 
+ * @param   {struct GameRealtime *}   this    The instance.
+ * @param   {int}                     dIndex  The index of the plot.
+*/
+void GameRealtime_cancel(struct GameRealtime *this, int dIndex) {
+  for(int i = 0; i < 3; i++) {
+    UtilsWheel_cancel(this->pWheel, this->dTimerArray[dIndex][i]);
+    this->dTimerArray[dIndex][i] = -1;
+  }
+}
+
+/**
+ * Schedules something to happen to a plot.
+ * 
+ * @param   {struct GameRealtime *}   this    The instance.
+ * @param   {int}                     dIndex  The index of the plot.
+ * @param   {enum RealtimeEvent}      eEvent  What's going to happen.
+ * @param   {int}                     dDelay  In how many seconds.
+*/
+void GameRealtime_schedule(struct GameRealtime *this, int dIndex, enum RealtimeEvent eEvent, int dDelay) {
+  this->dTimerArray[dIndex][eEvent] = UtilsWheel_schedule(this->pWheel, dDelay, dIndex, eEvent);
+}
+
+/**
+ * Keeps the timers of a plot in line with what the player just did to it.
+ * Every action starts the plot over, so we just cancel everything and schedule whatever applies now.
+ * 
+ * @param   {void *}            pData     The instance.
+ * @param   {int}               dIndex    The index of the plot.
+ * @param   {enum FarmAction}   eAction   What the player did.
+*/
+void GameRealtime_onPlot(void *pData, int dIndex, enum FarmAction eAction) {
+  struct GameRealtime *this = pData;
+  struct Plot *pPlot = this->pFarm->pPlotArray[dIndex];
+
+  GameRealtime_cancel(this, dIndex);
+
+  switch(eAction) {
+
+    // A new seed is thirsty right away
+    case FARM_SOW:
+      GameRealtime_schedule(this, dIndex, REALTIME_WILTING, GAME_REALTIME_WILT_TIME);
+      GameRealtime_schedule(this, dIndex, REALTIME_DEAD, GAME_REALTIME_DEATH_TIME);
+      break;
+
+    // Fully grown crops just wait to be harvested
+    case FARM_WATER:
+      if(Plot_getProductState(pPlot) < 2) {
+        GameRealtime_schedule(this, dIndex, REALTIME_READY, GAME_REALTIME_GROW_TIME);
+        GameRealtime_schedule(this, dIndex, REALTIME_WILTING, GAME_REALTIME_GROW_TIME + GAME_REALTIME_WILT_TIME);
+        GameRealtime_schedule(this, dIndex, REALTIME_DEAD, GAME_REALTIME_GROW_TIME + GAME_REALTIME_DEATH_TIME);
+      }
+      break;
+
+    default: break;
+  }
+}
+
+/**
+ * Does whatever a timer that went off was for.
+ * 
+ * @param   {void *}    pData     The instance.
+ * @param   {int}       dIndex    The index of the plot.
+ * @param   {int}       dEvent    What happens to it.
+*/
+void GameRealtime_fire(void *pData, int dIndex, int dEvent) {
+  struct GameRealtime *this = pData;
+  struct Plot *pPlot = this->pFarm->pPlotArray[dIndex];
+
+  // That timer's gone now
+  this->dTimerArray[dIndex][dEvent] = -1;
+
+  if(Plot_getState(pPlot) != PLOT_SOWN)
+    return;
+
+  switch(dEvent) {
+    case REALTIME_READY:
+      Product_setThirsty(pPlot->pProduct, Player_getTime(this->pPlayer));
+      break;
+
+    case REALTIME_WILTING:
+      Product_setWilting(pPlot->pProduct);
+      break;
+
+    // The crop withers away; nothing goes into the inventory
+    case REALTIME_DEAD:
+      GameRealtime_cancel(this, dIndex);
+      Plot_harvest(pPlot);
+      break;
+  }
+
+  Farm_markDirty(this->pFarm, dIndex);
+}
+
+/**
+ * Moves the clock up to the current time.
+ * Meant to be called every now and then by the input loops (see UtilsKey_setTicker()).
+ * 
+ * @param   {void *}    pData   The instance.
+ * @return  {int}               Whether or not anything happened to the farm.
+*/
+int GameRealtime_tick(void *pData) {
+  struct GameRealtime *this = pData;
+
+  return UtilsWheel_advance(this->pWheel, time(NULL) - this->dStart, &GameRealtime_fire, this) > 0;
+}
+
+#endif
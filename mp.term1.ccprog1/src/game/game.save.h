@@ -0,0 +1,600 @@
+/**
+ * Saving and loading the full game.
+ * A save is one small binary file: a header, then the player, the shop stock and the plots, all fixed-size records
+ * with fixed-width numbers. Loading maps the file into memory and reads the records straight out of it, so the only
+ * "parsing" we do is checking the header.
+ *
+ * The game autosaves every time the player goes to sleep (and when they exit to the main menu).
+ * On Unix the save is written by a forked copy of the game: fork() gives it a copy-on-write snapshot of everything,
+ * so the game can go right back to reading keys while the copy writes the file and exits.
+ * Windows doesn't have fork(), but the file is only a few kilobytes, so we just write it there and then.
+*/
+
+#ifndef GAME_SAVE
+#define GAME_SAVE
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <stdlib.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#include "game.catalogue.h"
+
+#include "objects/game.obj.player.h"
+#include "objects/game.obj.farm.h"
+#include "objects/game.obj.shop.h"
+
+#include "classes/game.class.plot.h"
+#include "classes/game.class.product.h"
+#include "classes/game.class.stock.h"
+
+#include "enums/game.enum.farm.h"
+
+#include "../utils/utils.mem.h"
+#include "../utils/utils.panel.h"
+
+// Where the save goes (relative to the root of the project, like the memory report)
+#define GAME_SAVE_PATH "build/.save.bin"
+
+// Bump the version whenever one of the records below changes
+// The numbers are written in the byte order of the machine; a save from a machine with the other order fails the version check
+#define GAME_SAVE_MAGIC "HSUN"
+#define GAME_SAVE_VERSION 2
+
+/**
+ * The start of the file.
+ * Anything that would make the records mean something else (a different catalogue or farm size) is checked here.
+*/
+struct GameSaveHeader {
+  char sMagic[4];
+  uint16_t dVersion;
+  uint16_t dCatalogueSize;
+  uint32_t dCatalogueHash;        // Of the product codes, so reordering the data file invalidates old saves
+  uint16_t dFarmWidth;
+  uint16_t dFarmHeight;
+  uint32_t dSize;                 // Of the whole file
+  uint32_t dChecksum;             // Of everything after the header
+  uint32_t dJournalSeq;           // How many journalled actions the save includes (see game.journal.h)
+};
+
+/**
+ * The player and their inventory.
+*/
+struct GameSavePlayer {
+  char sName[PLAYER_NAME_MAX_LEN];
+  int32_t dTime;
+  int32_t dDaysStarved;
+  int32_t bIsStarving;
+  int32_t dGold;
+  int32_t dEnergy;
+  int32_t dDefaultEnergy;
+  int32_t dBreakfastCost;
+  int32_t dSeedAmountArray[CATALOGUE_SIZE];
+  int32_t dCropAmountArray[CATALOGUE_SIZE];
+};
+
+/**
+ * How much of each product the shop has left.
+*/
+struct GameSaveShop {
+  int32_t dStockAmountArray[CATALOGUE_SIZE];
+};
+
+/**
+ * A single plot and the crop on it.
+ * The prices and water requirement of the crop aren't here since the catalogue has them.
+*/
+struct GameSavePlot {
+  uint8_t eState;
+  uint8_t eType;
+  uint8_t bIsWilting;
+  uint8_t dUnused;
+  int32_t dWaterAmt;
+  int32_t dTimePlanted;
+  int32_t dLastWatered;
+};
+
+/**
+ * The whole file, as big as it can get.
+ * Only as many plots as the farm has get written, so a save is usually a lot smaller than this.
+*/
+struct GameSaveImage {
+  struct GameSaveHeader header;
+  struct GameSavePlayer player;
+  struct GameSaveShop shop;
+  struct GameSavePlot plotArray[FARM_MAX_WIDTH * FARM_MAX_HEIGHT];
+};
+
+/**
+ * Keeps track of the autosaves.
+*/
+struct GameSave {
+  char *sPath;
+
+  // The forked copy that's writing the last autosave (0 if there isn't one)
+  int dWriter;
+
+  // Something wasn't saved because a writer was still busy
+  int bIsDirty;
+
+  // How many journalled actions the game had when it was saved (or loaded), when the writer started,
+  // and when the last save that's definitely on the disk was made
+  unsigned int dSeq;
+  unsigned int dWriterSeq;
+  unsigned int dSavedSeq;
+};
+
+/**
+ * ###########################
+ * ###  SAVE CONSTRUCTION  ###
+ * ###########################
+*/
+
+/**
+ * Allocates memory for an instance of the GameSave class.
+ *
+ * @return  {struct GameSave *}   A pointer to the created instance.
+*/
+struct GameSave *GameSave_new() {
+  struct GameSave *pGameSave;
+
+  pGameSave = UtilsMem_calloc(UTILS_MEM_GAME, 1, sizeof(*pGameSave));
+
+  if(pGameSave == NULL)
+    return NULL;
+
+  return pGameSave;
+}
+
+/**
+ * Initializes the instance.
+ *
+ * @param   {struct GameSave *}   this    The instance to be initialized.
+ * @param   {char *}              sPath   Where the save goes.
+*/
+void GameSave_init(struct GameSave *this, char *sPath) {
+  this->sPath = sPath;
+  this->dWriter = 0;
+  this->bIsDirty = 0;
+  this->dSeq = 0;
+  this->dWriterSeq = 0;
+  this->dSavedSeq = 0;
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @param   {char *}              sPath   Where the save goes.
+ * @return  {struct GameSave *}           The created instance.
+*/
+struct GameSave *GameSave_create(char *sPath) {
+  struct GameSave *pGameSave = GameSave_new();
+  GameSave_init(pGameSave, sPath);
+
+  return pGameSave;
+}
+
+/**
+ * ###########################
+ * ###  SAVE FILE HELPERS  ###
+ * ###########################
+*/
+
+/**
+ * A quick hash (FNV-1a) for the checksum and the catalogue check.
+ *
+ * @param   {void *}    pData   The bytes.
+ * @param   {size_t}    dSize   How many there are.
+ * @return  {uint32_t}          The hash.
+*/
+uint32_t GameSave_hash(void *pData, size_t dSize) {
+  unsigned char *pByte = pData;
+  uint32_t dHash = 2166136261u;
+
+  for(size_t i = 0; i < dSize; i++) {
+    dHash ^= pByte[i];
+    dHash *= 16777619u;
+  }
+
+  return dHash;
+}
+
+/**
+ * Returns how big a save of a farm of the given size is.
+ *
+ * @param   {int}     dPlots  How many plots the farm has.
+ * @return  {size_t}          The size of the file.
+*/
+size_t GameSave_getSize(int dPlots) {
+  return offsetof(struct GameSaveImage, plotArray) + dPlots * sizeof(struct GameSavePlot);
+}
+
+/**
+ * Copies a plot and the crop on it into a record.
+ * Everything the plot doesn't use is zeroed, so two records of the same plot can be compared byte for byte.
+ *
+ * @param   {struct GameSavePlot *}   pSavePlot   Where the record goes.
+ * @param   {struct Plot *}           pPlot       The plot.
+*/
+void GameSave_packPlot(struct GameSavePlot *pSavePlot, struct Plot *pPlot) {
+  memset(pSavePlot, 0, sizeof(*pSavePlot));
+  pSavePlot->eState = pPlot->eState;
+
+  if(pPlot->eState == PLOT_SOWN) {
+    pSavePlot->eType = pPlot->pProduct->eType;
+    pSavePlot->bIsWilting = pPlot->pProduct->bIsWilting;
+    pSavePlot->dWaterAmt = pPlot->pProduct->dWaterAmt;
+    pSavePlot->dTimePlanted = pPlot->pProduct->dTimePlanted;
+    pSavePlot->dLastWatered = pPlot->pProduct->dLastWatered;
+  }
+}
+
+/**
+ * Puts a plot back the way a record has it (whatever was growing on it before goes away).
+ * The record has to have been checked already; see GameSave_apply().
+ *
+ * @param   {struct GameSavePlot *}   pSavePlot   The record.
+ * @param   {struct Plot *}           pPlot       The plot.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue.
+*/
+void GameSave_unpackPlot(struct GameSavePlot *pSavePlot, struct Plot *pPlot, struct GameCatalogue *pCatalogue) {
+  if(pPlot->eState == PLOT_SOWN)
+    Product_kill(pPlot->pProduct);
+
+  pPlot->eState = pSavePlot->eState;
+  pPlot->pProduct = NULL;
+
+  if(pPlot->eState == PLOT_SOWN) {
+    struct Product *pProduct = Product_create(pSavePlot->eType, pCatalogue, pSavePlot->dTimePlanted);
+
+    pProduct->dWaterAmt = pSavePlot->dWaterAmt;
+    pProduct->dLastWatered = pSavePlot->dLastWatered;
+    pProduct->bIsWilting = pSavePlot->bIsWilting;
+    pPlot->pProduct = pProduct;
+  }
+}
+
+/**
+ * Copies the game objects into the records of a save.
+ *
+ * @param   {struct GameSaveImage *}  pImage      Where the records go.
+ * @param   {unsigned int}            dSeq        How many journalled actions the game has had.
+ * @param   {struct Player *}         pPlayer     The player.
+ * @param   {struct Farm *}           pFarm       The farm.
+ * @param   {struct Shop *}           pShop       The shop.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue.
+ * @return  {size_t}                              How many bytes of the image make up the file.
+*/
+size_t GameSave_snapshot(struct GameSaveImage *pImage, unsigned int dSeq, struct Player *pPlayer, struct Farm *pFarm, struct Shop *pShop, struct GameCatalogue *pCatalogue) {
+  struct GameSaveHeader *pHeader = &pImage->header;
+  struct GameSavePlayer *pSavePlayer = &pImage->player;
+  size_t dSize = GameSave_getSize(pFarm->dSize);
+
+  memset(pImage, 0, dSize);
+
+  // The player
+  for(int i = 0; i < PLAYER_NAME_MAX_LEN && pPlayer->sName[i]; i++)
+    pSavePlayer->sName[i] = pPlayer->sName[i];
+
+  pSavePlayer->dTime = pPlayer->dTime;
+  pSavePlayer->dDaysStarved = pPlayer->dDaysStarved;
+  pSavePlayer->bIsStarving = pPlayer->bIsStarving;
+  pSavePlayer->dGold = pPlayer->dGold;
+  pSavePlayer->dEnergy = pPlayer->dEnergy;
+  pSavePlayer->dDefaultEnergy = pPlayer->dDefaultEnergy;
+  pSavePlayer->dBreakfastCost = pPlayer->dBreakfastCost;
+
+  // The stocks
+  for(int i = 0; i < pCatalogue->dSize; i++) {
+    pSavePlayer->dSeedAmountArray[i] = pPlayer->pSeedStockArray[i]->dAmount;
+    pSavePlayer->dCropAmountArray[i] = pPlayer->pCropStockArray[i]->dAmount;
+    pImage->shop.dStockAmountArray[i] = pShop->pStockArray[i]->dAmount;
+  }
+
+  // The plots
+  for(int i = 0; i < pFarm->dSize; i++)
+    GameSave_packPlot(&pImage->plotArray[i], pFarm->pPlotArray[i]);
+
+  // The header goes last since it has the checksum
+  memcpy(pHeader->sMagic, GAME_SAVE_MAGIC, 4);
+  pHeader->dVersion = GAME_SAVE_VERSION;
+  pHeader->dCatalogueSize = pCatalogue->dSize;
+  pHeader->dCatalogueHash = GameSave_hash(pCatalogue->cProductCodeArray, pCatalogue->dSize);
+  pHeader->dFarmWidth = pFarm->dWidth;
+  pHeader->dFarmHeight = pFarm->dHeight;
+  pHeader->dSize = dSize;
+  pHeader->dJournalSeq = dSeq;
+  pHeader->dChecksum = GameSave_hash((char *) pImage + sizeof(*pHeader), dSize - sizeof(*pHeader));
+
+  return dSize;
+}
+
+/**
+ * Writes a save of the game objects to a file.
+ * It goes to a temporary file first and then replaces the old save, so a save that gets cut off halfway never
+ * clobbers a good one.
+ *
+ * @param   {struct GameSave *}       this        The instance (it knows where the save goes).
+ * @param   {struct Player *}         pPlayer     The player.
+ * @param   {struct Farm *}           pFarm       The farm.
+ * @param   {struct Shop *}           pShop       The shop.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue.
+ * @return  {int}                                 Whether or not the save was written.
+*/
+int GameSave_write(struct GameSave *this, struct Player *pPlayer, struct Farm *pFarm, struct Shop *pShop, struct GameCatalogue *pCatalogue) {
+  struct GameSaveImage image;
+  char sTempPath[256];
+  size_t dSize = GameSave_snapshot(&image, this->dSeq, pPlayer, pFarm, pShop, pCatalogue);
+
+  snprintf(sTempPath, sizeof(sTempPath), "%s.tmp", this->sPath);
+
+  FILE *pFile = fopen(sTempPath, "wb");
+
+  if(pFile == NULL)
+    return 0;
+
+  // fclose() flushes, so it can fail too
+  int bOkay = fwrite(&image, 1, dSize, pFile) == dSize;
+  bOkay = !fclose(pFile) && bOkay;
+
+  // Windows won't rename onto a file that exists
+  #ifdef _WIN32
+    if(bOkay) remove(this->sPath);
+  #endif
+
+  if(!bOkay || rename(sTempPath, this->sPath)) {
+    remove(sTempPath);
+    return 0;
+  }
+
+  return 1;
+}
+
+/**
+ * Checks a save and, if it's okay, copies it into the game objects.
+ * Everything is checked before anything is touched, so a bad save leaves the game the way it was.
+ *
+ * @param   {struct GameSave *}       this        The instance (it gets the journal position of the save).
+ * @param   {void *}                  pData       The contents of the file.
+ * @param   {size_t}                  dSize       The size of the file.
+ * @param   {struct Player *}         pPlayer     The player.
+ * @param   {struct Farm *}           pFarm       The farm.
+ * @param   {struct Shop *}           pShop       The shop.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue.
+ * @return  {int}                                 Whether or not the save was loaded.
+*/
+int GameSave_apply(struct GameSave *this, void *pData, size_t dSize, struct Player *pPlayer, struct Farm *pFarm, struct Shop *pShop, struct GameCatalogue *pCatalogue) {
+  struct GameSaveImage *pImage = pData;
+  struct GameSaveHeader *pHeader = &pImage->header;
+  struct GameSavePlayer *pSavePlayer = &pImage->player;
+  char sName[PLAYER_NAME_MAX_LEN + 1];
+
+  // Is it even ours
+  if(dSize < sizeof(*pHeader) || memcmp(pHeader->sMagic, GAME_SAVE_MAGIC, 4) || pHeader->dVersion != GAME_SAVE_VERSION)
+    return 0;
+
+  // Was it made for this game
+  if(pHeader->dCatalogueSize != pCatalogue->dSize ||
+    pHeader->dCatalogueHash != GameSave_hash(pCatalogue->cProductCodeArray, pCatalogue->dSize) ||
+    pHeader->dFarmWidth != pFarm->dWidth ||
+    pHeader->dFarmHeight != pFarm->dHeight)
+    return 0;
+
+  // Is all of it there
+  if(pHeader->dSize != dSize || dSize != GameSave_getSize(pFarm->dSize) ||
+    pHeader->dChecksum != GameSave_hash((char *) pImage + sizeof(*pHeader), dSize - sizeof(*pHeader)))
+    return 0;
+
+  // Do the plots make sense
+  for(int i = 0; i < pFarm->dSize; i++) {
+    struct GameSavePlot *pSavePlot = &pImage->plotArray[i];
+
+    if(pSavePlot->eState > PLOT_SOWN)
+      return 0;
+
+    if(pSavePlot->eState == PLOT_SOWN && (pSavePlot->eType == PRODUCT_NULL || pSavePlot->eType >= pCatalogue->dSize))
+      return 0;
+  }
+
+  // The player
+  memcpy(sName, pSavePlayer->sName, PLAYER_NAME_MAX_LEN);
+  sName[PLAYER_NAME_MAX_LEN] = 0;
+  Player_setName(pPlayer, sName);
+
+  pPlayer->dTime = pSavePlayer->dTime;
+  pPlayer->dDaysStarved = pSavePlayer->dDaysStarved;
+  pPlayer->bIsStarving = pSavePlayer->bIsStarving;
+  pPlayer->dGold = pSavePlayer->dGold;
+  pPlayer->dEnergy = pSavePlayer->dEnergy;
+  pPlayer->dDefaultEnergy = pSavePlayer->dDefaultEnergy;
+  pPlayer->dBreakfastCost = pSavePlayer->dBreakfastCost;
+  pPlayer->dVersion = UtilsPanel_nextVersion();
+
+  // The stocks
+  for(int i = 0; i < pCatalogue->dSize; i++) {
+    pPlayer->pSeedStockArray[i]->dAmount = pSavePlayer->dSeedAmountArray[i];
+    pPlayer->pCropStockArray[i]->dAmount = pSavePlayer->dCropAmountArray[i];
+    pShop->pStockArray[i]->dAmount = pImage->shop.dStockAmountArray[i];
+  }
+
+  pShop->dVersion = UtilsPanel_nextVersion();
+
+  // The plots
+  for(int i = 0; i < pFarm->dSize; i++)
+    GameSave_unpackPlot(&pImage->plotArray[i], pFarm->pPlotArray[i], pCatalogue);
+
+  Farm_touch(pFarm);
+
+  this->dSeq = pHeader->dJournalSeq;
+  this->dSavedSeq = pHeader->dJournalSeq;
+
+  return 1;
+}
+
+/**
+ * ######################
+ * ###  SAVE METHODS  ###
+ * ######################
+*/
+
+/**
+ * Loads the save into the game objects.
+ * On Unix the file is mapped into memory and read in place; Windows gets a plain read into a buffer.
+ *
+ * @param   {struct GameSave *}       this        The instance.
+ * @param   {struct Player *}         pPlayer     The player.
+ * @param   {struct Farm *}           pFarm       The farm.
+ * @param   {struct Shop *}           pShop       The shop.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue.
+ * @return  {int}                                 Whether or not there was a good save to load.
+*/
+int GameSave_load(struct GameSave *this, struct Player *pPlayer, struct Farm *pFarm, struct Shop *pShop, struct GameCatalogue *pCatalogue) {
+  int bOkay = 0;
+
+  #ifdef _WIN32
+    FILE *pFile = fopen(this->sPath, "rb");
+    struct GameSaveImage *pImage = UtilsMem_calloc(UTILS_MEM_GAME, 1, sizeof(*pImage));
+
+    if(pFile != NULL && pImage != NULL) {
+      size_t dSize = fread(pImage, 1, sizeof(*pImage), pFile);
+      bOkay = GameSave_apply(this, pImage, dSize, pPlayer, pFarm, pShop, pCatalogue);
+    }
+
+    if(pFile != NULL)
+      fclose(pFile);
+
+    UtilsMem_free(pImage);
+  #else
+    struct stat fileStat;
+    int dFile = open(this->sPath, O_RDONLY);
+
+    if(dFile < 0)
+      return 0;
+
+    if(!fstat(dFile, &fileStat) && fileStat.st_size > 0 && fileStat.st_size <= (off_t) sizeof(struct GameSaveImage)) {
+      void *pData = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, dFile, 0);
+
+      if(pData != MAP_FAILED) {
+        bOkay = GameSave_apply(this, pData, fileStat.st_size, pPlayer, pFarm, pShop, pCatalogue);
+        munmap(pData, fileStat.st_size);
+      }
+    }
+
+    close(dFile);
+  #endif
+
+  return bOkay;
+}
+
+/**
+ * Checks on the writer of the last autosave.
+ *
+ * @param   {struct GameSave *}   this    The instance.
+ * @param   {int}                 bWait   Whether to wait for it to finish instead of just checking.
+ * @return  {int}                         Whether or not a writer is still busy.
+*/
+int GameSave_reap(struct GameSave *this, int bWait) {
+  #ifndef _WIN32
+    int dStatus;
+
+    if(this->dWriter > 0) {
+      pid_t dDone = waitpid(this->dWriter, &dStatus, bWait ? 0 : WNOHANG);
+
+      // Done (or gone); a writer that failed leaves the old save, so the next one has to try again
+      if(dDone != 0) {
+        if(dDone < 0 || !WIFEXITED(dStatus) || WEXITSTATUS(dStatus))
+          this->bIsDirty = 1;
+        else
+          this->dSavedSeq = this->dWriterSeq;
+
+        this->dWriter = 0;
+      }
+    }
+  #endif
+
+  return this->dWriter > 0;
+}
+
+/**
+ * Saves the game without making the player wait for it.
+ * If the last autosave is somehow still being written, this one is skipped; GameSave_kill() catches up.
+ *
+ * @param   {struct GameSave *}       this        The instance.
+ * @param   {struct Player *}         pPlayer     The player.
+ * @param   {struct Farm *}           pFarm       The farm.
+ * @param   {struct Shop *}           pShop       The shop.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue.
+*/
+void GameSave_autosave(struct GameSave *this, struct Player *pPlayer, struct Farm *pFarm, struct Shop *pShop, struct GameCatalogue *pCatalogue) {
+  if(GameSave_reap(this, 0)) {
+    this->bIsDirty = 1;
+    return;
+  }
+
+  this->bIsDirty = 0;
+
+  #ifndef _WIN32
+    pid_t dWriter = fork();
+
+    // The copy writes the file and leaves; _exit() skips the exit handlers (and the memory report) of the game
+    if(dWriter == 0)
+      _exit(GameSave_write(this, pPlayer, pFarm, pShop, pCatalogue) ? 0 : 1);
+
+    if(dWriter > 0) {
+      this->dWriter = dWriter;
+      this->dWriterSeq = this->dSeq;
+      return;
+    }
+  #endif
+
+  // No fork(), or it didn't work
+  if(GameSave_write(this, pPlayer, pFarm, pShop, pCatalogue))
+    this->dSavedSeq = this->dSeq;
+  else
+    this->bIsDirty = 1;
+}
+
+/**
+ * Throws the save away (after a game over, for instance).
+ *
+ * @param   {struct GameSave *}   this  The instance.
+*/
+void GameSave_erase(struct GameSave *this) {
+  GameSave_reap(this, 1);
+  remove(this->sPath);
+
+  this->bIsDirty = 0;
+  this->dSeq = 0;
+  this->dSavedSeq = 0;
+}
+
+/**
+ * Waits for the last autosave, writes whatever it missed, and destroys the instance.
+ *
+ * @param   {struct GameSave *}       this        The instance to be destroyed.
+ * @param   {struct Player *}         pPlayer     The player.
+ * @param   {struct Farm *}           pFarm       The farm.
+ * @param   {struct Shop *}           pShop       The shop.
+ * @param   {struct GameCatalogue *}  pCatalogue  The catalogue.
+*/
+void GameSave_kill(struct GameSave *this, struct Player *pPlayer, struct Farm *pFarm, struct Shop *pShop, struct GameCatalogue *pCatalogue) {
+  GameSave_reap(this, 1);
+
+  if(this->bIsDirty)
+    GameSave_write(this, pPlayer, pFarm, pShop, pCatalogue);
+
+  UtilsMem_free(this);
+}
+
+#endif
@@ -11,6 +11,10 @@
 #define GAME_OBJ_FARM
 
 #include "../../utils/utils.key.h"
+#include "../../utils/utils.mem.h"
+#include "../../utils/utils.panel.h"
+#include "../../utils/utils.search.h"
+#include "../../utils/utils.string.h"
 #include "../../utils/utils.text.h"
 #include "../../utils/utils.selector.h"
 #include "../../utils/utils.ui.h"
@@ -26,6 +30,9 @@
 #define FARM_MAX_WIDTH 16
 #define FARM_MAX_HEIGHT 16
 
+// The most seed types the sow prompt shows at once; longer catalogues scroll
+#define FARM_SOW_ROWS 8
+
 /**
  * The farm object stores information about the plots and their states.
  * The farm is represented by a grid of plots.
@@ -51,6 +58,29 @@ struct Farm {
   struct UtilsSelector *pFarmSelector;
   struct Plot *pPlotArray[FARM_MAX_WIDTH * FARM_MAX_HEIGHT];
   struct GameCatalogue *pCatalogue;
+
+  // Changes whenever the plots, the cursor or the current action change
+  int dVersion;
+
+  // The last grid we drew
+  struct UtilsPanel *pGridPanel;
+
+  // What each plot looks like on the grid; only the dirty ones get drawn again
+  char sCellArray[FARM_MAX_WIDTH * FARM_MAX_HEIGHT][3][6];
+  int bDirtyArray[FARM_MAX_WIDTH * FARM_MAX_HEIGHT];
+  int dCellTime;
+
+  // Gets told about every plot an action was done on (real-time mode needs this)
+  void (*fOnPlot)(void *pData, int dIndex, enum FarmAction eAction);
+  void *pOnPlotData;
+
+  // Gets told about every queue that was processed without a problem (the journal needs this)
+  void (*fOnQueue)(void *pData, struct Farm *pFarm);
+  void *pOnQueueData;
+
+  // Type-ahead search over the seed names and codes, and the version of it the selector was last filtered with
+  struct UtilsSearch *pSearch;
+  int dSearchVersion;
 };
 
 /**
@@ -67,7 +97,7 @@ struct Farm {
 struct Farm *Farm_new() {
   struct Farm *pFarm;
 
-  pFarm = calloc(1, sizeof(*pFarm));
+  pFarm = UtilsMem_calloc(UTILS_MEM_FARM, 1, sizeof(*pFarm));
 
   if(pFarm == NULL)
     return NULL;
@@ -139,6 +169,29 @@ void Farm_init(struct Farm *this, int dWidth, int dHeight, struct GameCatalogue
   UtilsSelector_addOption(pFarmSelector, "do nothing    ", FARM_NULL);
 
   this->pFarmSelector = pFarmSelector;
+
+  this->dVersion = UtilsPanel_nextVersion();
+  this->pGridPanel = UtilsPanel_create();
+
+  for(int i = 0; i < this->dSize; i++)
+    this->bDirtyArray[i] = 1;
+
+  this->dCellTime = -1;
+  this->fOnPlot = NULL;
+  this->pOnPlotData = NULL;
+
+  // Index the seeds by name and by code (null product and the "go back" option excluded)
+  this->pSearch = UtilsSearch_create();
+  this->dSearchVersion = -1;
+
+  for(int i = 1; i < pCatalogue->dSize; i++) {
+    char sCode[2] = { pCatalogue->cProductCodeArray[i], 0 };
+
+    UtilsSearch_add(this->pSearch, pCatalogue->sProductNameArray[i], i);
+    UtilsSearch_add(this->pSearch, sCode, i);
+  }
+
+  UtilsSearch_build(this->pSearch);
 }
 
 /**
@@ -158,12 +211,19 @@ struct Farm *Farm_create(int dWidth, int dHeight, struct GameCatalogue *pCatalog
 }
 
 /**
- * Destroys a farm object.
+ * Destroys a farm object along with its plots (and whatever's growing on them).
  * 
  * @param   {struct Farm *}   A pointer to the object to be destroyed.
 */
 void Farm_kill(struct Farm *this) {
-  free(this);
+  for(int i = 0; i < this->dSize; i++)
+    Plot_kill(this->pPlotArray[i]);
+
+  UtilsSelector_kill(this->pFarmSelector);
+  UtilsMem_free(this->sWarningText);
+  UtilsPanel_kill(this->pGridPanel);
+  UtilsSearch_kill(this->pSearch);
+  UtilsMem_free(this);
 }
 
 /**
@@ -172,6 +232,89 @@ void Farm_kill(struct Farm *this) {
  * ##################################
 */
 
+/**
+ * Returns the version of the farm.
+ * It changes every time something that shows up on the farm grid changes.
+ * 
+ * @param   {struct Farm *}     this  The farm object.
+ * @return  {int}                     The current version of the farm.
+*/
+int Farm_getVersion(struct Farm *this) {
+  return this->dVersion;
+}
+
+/**
+ * Says that a single plot looks different now.
+ * Only that plot gets drawn again the next time the grid is displayed.
+ * 
+ * @param   {struct Farm *}     this    The farm object.
+ * @param   {int}               dIndex  The index of the plot.
+*/
+void Farm_markDirty(struct Farm *this, int dIndex) {
+  if(dIndex >= 0 && dIndex < this->dSize)
+    this->bDirtyArray[dIndex] = 1;
+
+  this->dVersion = UtilsPanel_nextVersion();
+}
+
+/**
+ * Says that the plot under the selector looks different now.
+ * 
+ * @param   {struct Farm *}     this  The farm object.
+*/
+void Farm_markSelectorDirty(struct Farm *this) {
+  Farm_markDirty(this, this->dSelectorY * this->dWidth + this->dSelectorX);
+}
+
+/**
+ * Says that any of the plots might look different now.
+ * 
+ * @param   {struct Farm *}     this  The farm object.
+*/
+void Farm_touch(struct Farm *this) {
+  for(int i = 0; i < this->dSize; i++)
+    this->bDirtyArray[i] = 1;
+
+  this->dVersion = UtilsPanel_nextVersion();
+}
+
+/**
+ * Sets the function that gets called for every plot an action is done on.
+ * 
+ * @param   {struct Farm *}                           this      The farm object.
+ * @param   {void (*)(void *, int, enum FarmAction)}  fOnPlot   The function, or NULL for none.
+ * @param   {void *}                                  pData     Passed to the function.
+*/
+void Farm_setListener(struct Farm *this, void (*fOnPlot)(void *pData, int dIndex, enum FarmAction eAction), void *pData) {
+  this->fOnPlot = fOnPlot;
+  this->pOnPlotData = pData;
+}
+
+/**
+ * Sets the function that gets called whenever a queue was processed without a problem.
+ * It gets called before the queue is cleared, so it can still see which plots were in it.
+ * 
+ * @param   {struct Farm *}                   this      The farm object.
+ * @param   {void (*)(void *, struct Farm *)} fOnQueue  The function, or NULL for none.
+ * @param   {void *}                          pData     Passed to the function.
+*/
+void Farm_setQueueListener(struct Farm *this, void (*fOnQueue)(void *pData, struct Farm *pFarm), void *pData) {
+  this->fOnQueue = fOnQueue;
+  this->pOnQueueData = pData;
+}
+
+/**
+ * Lets the listener know that an action was done on a plot.
+ * 
+ * @param   {struct Farm *}       this      The farm object.
+ * @param   {int}                 dIndex    The index of the plot.
+ * @param   {enum FarmAction}     eAction   What was done.
+*/
+void Farm_notify(struct Farm *this, int dIndex, enum FarmAction eAction) {
+  if(this->fOnPlot != NULL)
+    (*this->fOnPlot)(this->pOnPlotData, dIndex, eAction);
+}
+
 /**
  * Returns the x coordinate of the selector.
  * 
@@ -230,6 +373,31 @@ enum FarmAction Farm_getCurrentAction(struct Farm *this) {
 */
 void Farm_setCurrentAction(struct Farm *this, enum FarmAction eFarmAction) {
   this->eCurrentAction = eFarmAction;
+  this->dVersion = UtilsPanel_nextVersion();
+
+  // Every visit to the seed list starts without a search, and the shop might have touched the selector in between
+  UtilsSearch_clear(this->pSearch);
+  this->dSearchVersion = -1;
+}
+
+/**
+ * Returns whether or not the keys are being typed into the seed search.
+ * 
+ * @param   {struct Farm *}   this  The farm object.
+ * @return  {int}                   Whether or not the user is typing a search.
+*/
+int Farm_isSearching(struct Farm *this) {
+  return UtilsSearch_isTyping(this->pSearch);
+}
+
+/**
+ * Returns whether or not plots are being picked for an action.
+ * 
+ * @param   {struct Farm *}   this  The farm object.
+ * @return  {int}                   Whether or not the user is in the middle of a selection.
+*/
+int Farm_isSelecting(struct Farm *this) {
+  return this->bIsSelecting;
 }
 
 /**
@@ -250,6 +418,7 @@ enum ProductType Farm_getCurrentCrop(struct Farm *this) {
 */
 void Farm_setCurrentCrop(struct Farm *this, enum ProductType eProductType) {
   this->eCurrentCrop = eProductType;
+  this->dVersion = UtilsPanel_nextVersion();
 }
 
 /**
@@ -368,9 +537,12 @@ void Farm_till(struct Farm *this, int dPlots) {
     for(int i = 0; i < this->dSize && dPlots > 0; i++) {
       if(Plot_getState(this->pPlotArray[i]) == PLOT_UNTILLED) {
         Plot_till(this->pPlotArray[i]);
+        Farm_notify(this, i, FARM_TILL);
         dPlots--;
       }
     }
+
+    Farm_touch(this);
   } 
 }
 
@@ -390,9 +562,12 @@ void Farm_sow(struct Farm *this, int dPlots, struct GameCatalogue *pCatalogue, i
         struct Product *pProduct = Product_create(this->eCurrentCrop, pCatalogue, dTime);
 
         Plot_sow(this->pPlotArray[i], pProduct);
+        Farm_notify(this, i, FARM_SOW);
         dPlots--;
       }
     }
+
+    Farm_touch(this);
   } 
 }
 
@@ -407,10 +582,14 @@ void Farm_water(struct Farm *this, int dTime) {
     if(Plot_getState(this->pPlotArray[i]) == PLOT_SOWN && 
       Plot_getProductType(this->pPlotArray[i]) == this->eCurrentCrop) {
       
-      if(Plot_getProductLastWatered(this->pPlotArray[i]) < dTime)
+      if(Plot_getProductLastWatered(this->pPlotArray[i]) < dTime) {
         Plot_water(this->pPlotArray[i], dTime);
+        Farm_notify(this, i, FARM_WATER);
+      }
     }
   } 
+
+  Farm_touch(this);
 }
 
 /**
@@ -423,10 +602,57 @@ void Farm_harvest(struct Farm *this) {
     if(Plot_getState(this->pPlotArray[i]) == PLOT_SOWN && 
       Plot_getProductType(this->pPlotArray[i]) == this->eCurrentCrop) {
 
-      if(Plot_getProductState(this->pPlotArray[i]) == 2)
+      if(Plot_getProductState(this->pPlotArray[i]) == 2) {
         Plot_harvest(this->pPlotArray[i]);
+        Farm_notify(this, i, FARM_HARVEST);
+      }
     }
   }
+
+  Farm_touch(this);
+}
+
+/**
+ * Skips ahead a number of days, going home every night.
+ * Crops only grow when they're watered, so if nobody waters them they stay exactly as they are and only the player changes.
+ * With bWater, every crop that still needs water gets watered every day, the same as selecting all of them each morning.
+ * That only works out the same as doing it day by day if the player has the energy to water all of them every day;
+ * if they don't, nothing is changed and the caller has to step through the days instead.
+ * 
+ * @param   {struct Farm *}     this      The farm object.
+ * @param   {struct Player *}   pPlayer   The player.
+ * @param   {int}               dDays     How many days to skip.
+ * @param   {int}               bWater    Whether or not to water everything every day.
+ * @return  {int}                         Whether or not the days were skipped.
+*/
+int Farm_fastForward(struct Farm *this, struct Player *pPlayer, int dDays, int bWater) {
+  int dTime = Player_getTime(pPlayer);
+  int dGrowing = 0;
+
+  if(dDays <= 0)
+    return 1;
+
+  if(bWater) {
+    for(int i = 0; i < this->dSize; i++)
+      if(Plot_getState(this->pPlotArray[i]) == PLOT_SOWN)
+        if(Plot_getProductState(this->pPlotArray[i]) < 2)
+          dGrowing++;
+
+    // Not enough energy to water everything, so what gets watered depends on the order
+    if(Farm_canWater(this, dTime) > Player_getEnergy(pPlayer) ||
+      dGrowing > pPlayer->dDefaultEnergy)
+      return 0;
+
+    for(int i = 0; i < this->dSize; i++)
+      if(Plot_getState(this->pPlotArray[i]) == PLOT_SOWN)
+        Product_fastForward(this->pPlotArray[i]->pProduct, dTime, dDays);
+
+    Farm_touch(this);
+  }
+
+  Player_fastForward(pPlayer, dDays);
+
+  return 1;
 }
 
 /**
@@ -443,6 +669,7 @@ void Farm_harvest(struct Farm *this) {
 void Farm_startSelecting(struct Farm *this) {
   this->dModifiedPlots = 0;
   this->bIsSelecting = 1;
+  Farm_markSelectorDirty(this);
 }
 
 /**
@@ -458,6 +685,7 @@ void Farm_stopSelecting(struct Farm *this) {
       this->dModifiedPlots++;
 
   this->bIsSelecting = 0;
+  Farm_markSelectorDirty(this);
 }
 
 /**
@@ -466,8 +694,11 @@ void Farm_stopSelecting(struct Farm *this) {
  * @param   {struct Farm *this}   The farm object we're modifying.
 */
 void Farm_incrementX(struct Farm *this) {
-  if(this->bIsSelecting) 
+  if(this->bIsSelecting) {
+    Farm_markSelectorDirty(this);
     this->dSelectorX = (this->dSelectorX + 1) % this->dWidth;
+    Farm_markSelectorDirty(this);
+  }
 }
 
 /**
@@ -476,8 +707,11 @@ void Farm_incrementX(struct Farm *this) {
  * @param   {struct Farm *this}   The farm object we're modifying.
 */
 void Farm_decrementX(struct Farm *this) {
-  if(this->bIsSelecting)
+  if(this->bIsSelecting) {
+    Farm_markSelectorDirty(this);
     this->dSelectorX = (this->dSelectorX - 1 + this->dWidth) % this->dWidth;
+    Farm_markSelectorDirty(this);
+  }
 }
 
 /**
@@ -486,8 +720,11 @@ void Farm_decrementX(struct Farm *this) {
  * @param   {struct Farm *this}   The farm object we're modifying.
 */
 void Farm_incrementY(struct Farm *this) {
-  if(this->bIsSelecting)
+  if(this->bIsSelecting) {
+    Farm_markSelectorDirty(this);
     this->dSelectorY = (this->dSelectorY + 1) % this->dHeight;
+    Farm_markSelectorDirty(this);
+  }
 }
 
 /**
@@ -496,8 +733,28 @@ void Farm_incrementY(struct Farm *this) {
  * @param   {struct Farm *this}   The farm object we're modifying.
 */
 void Farm_decrementY(struct Farm *this) {
-  if(this->bIsSelecting)
+  if(this->bIsSelecting) {
+    Farm_markSelectorDirty(this);
     this->dSelectorY = (this->dSelectorY - 1 + this->dHeight) % this->dHeight;
+    Farm_markSelectorDirty(this);
+  }
+}
+
+/**
+ * Puts the selector on a specific plot.
+ * The game only ever moves the selector one step at a time, but the simulator needs to jump around.
+ * 
+ * @param   {struct Farm *this}   The farm object we're modifying.
+ * @param   {int}   dX            The column of the plot.
+ * @param   {int}   dY            The row of the plot.
+*/
+void Farm_moveSelector(struct Farm *this, int dX, int dY) {
+  if(this->bIsSelecting) {
+    Farm_markSelectorDirty(this);
+    this->dSelectorX = (dX % this->dWidth + this->dWidth) % this->dWidth;
+    this->dSelectorY = (dY % this->dHeight + this->dHeight) % this->dHeight;
+    Farm_markSelectorDirty(this);
+  }
 }
 
 /**
@@ -556,6 +813,8 @@ void Farm_queueSelected(struct Farm *this, int dTime) {
 
       default: break;
     }
+
+    Farm_markDirty(this, dIndex);
   }
 }
 
@@ -567,8 +826,10 @@ void Farm_queueSelected(struct Farm *this, int dTime) {
 void Farm_unqueueSelected(struct Farm *this) {
   int dIndex = this->dSelectorY * this->dWidth + this->dSelectorX;
 
-  if(this->bIsSelecting)
+  if(this->bIsSelecting) {
     this->bSelectionQueue[dIndex] = 0;
+    Farm_markDirty(this, dIndex);
+  }
 }
 
 /**
@@ -596,6 +857,8 @@ void Farm_toggleSelected(struct Farm *this, int dTime) {
 void Farm_clearQueue(struct Farm *this) {
   for(int i = 0; i < this->dSize; i++)
     this->bSelectionQueue[i] = 0;
+
+  Farm_touch(this);
 }
 
 /**
@@ -617,8 +880,10 @@ int Farm_processQueue(struct Farm *this, struct Player *pPlayer, struct GameCata
     case FARM_TILL:
       if(Player_tillPlots(pPlayer, Farm_getQueueLength(this))) {
         for(int i = 0; i < this->dSize; i++)
-          if(this->bSelectionQueue[i]) 
-            Plot_till(this->pPlotArray[i]);   
+          if(this->bSelectionQueue[i]) {
+            Plot_till(this->pPlotArray[i]);
+            Farm_notify(this, i, FARM_TILL);
+          }
 
       // The player did not have enough energy to till the plots
       } else {
@@ -632,8 +897,10 @@ int Farm_processQueue(struct Farm *this, struct Player *pPlayer, struct GameCata
     case FARM_SOW:
       if(Player_sowSeeds(pPlayer, this->eCurrentCrop, Farm_getQueueLength(this))) {
         for(int i = 0; i < this->dSize; i++)
-          if(this->bSelectionQueue[i]) 
+          if(this->bSelectionQueue[i]) {
             Plot_sow(this->pPlotArray[i], Product_create(this->eCurrentCrop, pCatalogue, dTime));
+            Farm_notify(this, i, FARM_SOW);
+          }
       
       // The player did not have enough seeds or energy to sow those plots.
       } else {
@@ -646,8 +913,10 @@ int Farm_processQueue(struct Farm *this, struct Player *pPlayer, struct GameCata
     case FARM_WATER:
       if(Player_waterCrops(pPlayer, Farm_getQueueLength(this))) {
         for(int i = 0; i < this->dSize; i++)
-          if(this->bSelectionQueue[i]) 
+          if(this->bSelectionQueue[i]) {
             Plot_water(this->pPlotArray[i], dTime);
+            Farm_notify(this, i, FARM_WATER);
+          }
       
       // The player did not have enough energy to water those plots.
       } else {
@@ -665,6 +934,7 @@ int Farm_processQueue(struct Farm *this, struct Player *pPlayer, struct GameCata
           if(this->bSelectionQueue[i]) {
             Player_harvestACrop(pPlayer, this->pPlotArray[i]->pProduct->eType);
             Plot_harvest(this->pPlotArray[i]);
+            Farm_notify(this, i, FARM_HARVEST);
           }
       } else {
         bSuccess = 0;
@@ -675,221 +945,233 @@ int Farm_processQueue(struct Farm *this, struct Player *pPlayer, struct GameCata
     default: break;
   }
 
+  // Only actions that changed something are worth telling anyone about
+  if(bSuccess && this->fOnQueue != NULL)
+    (*this->fOnQueue)(this->pOnQueueData, this);
+
   // Stop selection process
   Farm_stopSelecting(this);
   Farm_clearQueue(this);
 
   this->dModifiedPlots *= bSuccess;
+  Farm_touch(this);
   return bSuccess;
 }
 
+/**
+ * Decides which seeds can be picked for sowing: the ones the search finds that the player has in stock.
+ * Only the seeds the search finds are looked at; see Shop_filterCatalogue(), which does the same thing for the shop.
+ * 
+ * @param   {struct Farm *}           this                  The farm object.
+ * @param   {struct Player *}         pPlayer               The player whose seeds we're checking.
+ * @param   {struct UtilsSelector *}  pCatalogueSelector    A selector for all the game products.
+ * @param   {struct GameCatalogue *}  pCatalogue            A list of all the products available in the game.
+*/
+void Farm_filterCatalogue(struct Farm *this, struct Player *pPlayer, struct UtilsSelector *pCatalogueSelector, struct GameCatalogue *pCatalogue) {
+  
+  // Setting each option directly (instead of disabling everything first) keeps its version from changing every frame
+  if(this->dSearchVersion != UtilsSearch_getVersion(this->pSearch)) {
+    UtilsSelector_setAllAvailability(pCatalogueSelector, 0);
+    this->dSearchVersion = UtilsSearch_getVersion(this->pSearch);
+  }
+
+  for(int i = 0; i < UtilsSearch_getCount(this->pSearch); i++) {
+    int dProduct = UtilsSearch_getResult(this->pSearch, i);
+
+    UtilsSelector_setOptionAvailability(pCatalogueSelector, dProduct, Stock_getAmount(Player_getSeedStock(pPlayer, dProduct)) > 0);
+  }
+
+  UtilsSelector_setOptionAvailability(pCatalogueSelector, 0, 0);
+  UtilsSelector_setOptionAvailability(pCatalogueSelector, pCatalogue->dSize, 1);
+  UtilsSelector_setFirstAvailable(pCatalogueSelector);
+}
+
 /**
  * #######################
  * ###  FARM UI AND IO ###
  * #######################
 */
 
+/**
+ * A helper function that draws a single plot of the grid into the cell cache.
+ * Every cell is 3 lines of 5 characters.
+ * 
+ * @param   {struct Farm *}       this    The farm object.
+ * @param   {int}                 dIndex  The index of the plot.
+ * @param   {int}                 dTime   When the farm is being displayed.
+*/
+void Farm_drawCell(struct Farm *this, int dIndex, int dTime) {
+  char (*sCell)[6] = this->sCellArray[dIndex];
+  struct Plot *pPlot = this->pPlotArray[dIndex];
+  char *sProductCode = pPlot->eState == PLOT_SOWN ? Plot_getProductCode(pPlot) : "";
+
+  // Yes this is necessary!! for an awesome UI
+  // PS I know this could've been coded in a much more concise manner, BUT
+  // I wanted to be able to visualize the plot icons in the code itself.
+  
+  // If the plot is selected while selection is enabled
+  if(dIndex == this->dSelectorY * this->dWidth + this->dSelectorX && this->bIsSelecting) {
+    strcpy(sCell[0], "`. .`");
+    strcpy(sCell[2], "`___`");
+
+    // The selector is alread on a selected plot
+    if(this->bSelectionQueue[dIndex])
+      strcpy(sCell[1], " .0. ");
+
+    // No plant on it
+    else if(pPlot->eState != PLOT_SOWN)
+      strcpy(sCell[1], " .'. ");
+
+    // There's a plant on it
+    else
+      sprintf(sCell[1], " .%s. ", sProductCode);
+
+  // If the plot is queued for an action.
+  } else if(this->bSelectionQueue[dIndex]) {
+    strcpy(sCell[1], " (0) ");
+    
+    // If there's no plant on the plot
+    if(pPlot->eState != PLOT_SOWN) {
+      strcpy(sCell[0], "     ");
+      strcpy(sCell[2], "_____");
+
+    // There is a plant on the plot; a $ means it's queued for harvest
+    } else {
+      sprintf(sCell[0], "%s   %s", sProductCode, Plot_getProductState(pPlot) == 2 ? "$" : " ");
+      sprintf(sCell[2], "____%s", sProductCode);
+    }
+
+  // If there's a plant on the plot
+  } else if(pPlot->eState == PLOT_SOWN) {
+    int dProductLastWatered = Plot_getProductLastWatered(pPlot);
+    char *sMark = Product_isWilting(pPlot->pProduct) ? "~" : (dProductLastWatered < dTime ? " " : "!");
+
+    // Print different stuff for different growth stages
+    switch(Plot_getProductState(pPlot)) {
+      
+      // The crop has yet to grow much
+      case 0:
+        sprintf(sCell[0], "%s   %s", sProductCode, sMark);
+        strcpy(sCell[1], " _._ ");
+        break;
+
+      // The plant is halfway from being ready to harvest
+      case 1:
+        sprintf(sCell[0], "%s , %s", sProductCode, sMark);
+        strcpy(sCell[1], " _|_ ");
+        break;
+
+      // The crop is ready to harvest
+      default:
+        sprintf(sCell[0], "%s # $", sProductCode);
+        strcpy(sCell[1], " _|_ ");
+        break;
+    }
+
+    sprintf(sCell[2], "____%s", sProductCode);
+
+  // The plot is not tilled
+  } else if(pPlot->eState == PLOT_UNTILLED) {
+    strcpy(sCell[0], "     ");
+    strcpy(sCell[1], "     ");
+    strcpy(sCell[2], "____'");
+
+  // The plot is tilled
+  } else {
+    strcpy(sCell[0], "'    ");
+    strcpy(sCell[1], " ^^^ ");
+    strcpy(sCell[2], "____'");
+  }
+}
+
 /**
  * A helper function that creates a text array that represents the farm grid.
  * 
+ * The grid is only put together again when the farm (or the day) changes; otherwise we get the last one.
+ * Even then, only the plots that were marked dirty get drawn again.
+ * 
  * @param   {struct Farm *}       this    The farm object.
  * @param   {int}                 dTime   When the farm is being displayed.
- * @return  {struct UtilsText *}          An output representing the grid UI of the farm. 
+ * @return  {struct UtilsText *}          An output representing the grid UI of the farm (it belongs to the farm; don't free it). 
 */
 struct UtilsText *Farm_displayGrid(struct Farm *this, int dTime) {
+  int dStampArray[] = { this->dVersion, dTime, UtilsIO_getWidth() };
+
+  if(UtilsPanel_isFresh(this->pGridPanel, dStampArray, 3))
+    return UtilsPanel_getText(this->pGridPanel);
+
   struct UtilsText *pOutput = UtilsText_create();
   int dWidth = this->dWidth;
   int dHeight = this->dHeight;
 
+  // The watered marks depend on the day, so a new day means every crop might look different
+  if(this->dCellTime != dTime) {
+    for(int i = 0; i < this->dSize; i++)
+      this->bDirtyArray[i] = 1;
+
+    this->dCellTime = dTime;
+  }
+
+  for(int i = 0; i < this->dSize; i++) {
+    if(this->bDirtyArray[i]) {
+      Farm_drawCell(this, i, dTime);
+      this->bDirtyArray[i] = 0;
+    }
+  }
+
+  // Every row is built in this one builder; UtilsText_addText() copies it anyway
+  struct UtilsString *pRow = UtilsString_create();
+  UtilsString_reserve(pRow, 6 * dWidth + 11);
+
   // Generate the entire grid
   for(int i = 0; i < dHeight; i++) {
-    char *sRow;
 
     // Top lines of text
     if(!i) {
 
       // Selector utility
-      char *sTopRow1 = calloc(6 * dWidth + 11, sizeof(char));
       for(int j = 0; j < dWidth; j++) 
         if(this->dSelectorX == j && this->bIsSelecting) 
-          strcat(sTopRow1, "   v  ");
+          UtilsString_append(pRow, "   v  ");
         else 
-          strcat(sTopRow1, "      ");
+          UtilsString_append(pRow, "      ");
 
-      strcat(sTopRow1, " ");  
-      UtilsText_addText(pOutput, sTopRow1);
+      UtilsString_appendChar(pRow, ' ');  
+      UtilsText_addText(pOutput, UtilsString_getText(pRow));
+      UtilsString_clear(pRow);
 
       // Top row
-      char *sTopRow2 = calloc(6 * dWidth + 1, sizeof(char));
-      for(int j = 0; j < dWidth; j++) 
-        strcat(sTopRow2, "._____");
-      
-      strcat(sTopRow2, "."); 
-      UtilsText_addText(pOutput, sTopRow2);
+      UtilsString_appendPattern(pRow, "._____", dWidth);
+      UtilsString_appendChar(pRow, '.'); 
+      UtilsText_addText(pOutput, UtilsString_getText(pRow));
     }
 
-    // Generate the row
+    // Generate the row out of the cells
     for(int j = 0; j < 3; j++) {
-      sRow = calloc(6 * dWidth + 11, sizeof(char));
+      UtilsString_clear(pRow);
 
       for(int k = 0; k < dWidth; k++) {
-        int dIndex = i * dWidth + k;
-
         if(!k) {
           if(this->dSelectorY == i && !(j - 1) && this->bIsSelecting) 
-            strcat(sRow, ">  |");
+            UtilsString_append(pRow, ">  |");
           else 
-            strcat(sRow, "   |");
+            UtilsString_append(pRow, "   |");
         
         } else {
-          strcat(sRow, "|");
+          UtilsString_append(pRow, "|");
         }
 
-        // Yes this is necessary!! for an awesome UI
-        // Looks like a "switch case" hell tho,,
-        // There's too much nesting...
-        // PS I know this could've been coded in a much more concise manner, BUT
-        // I wanted to be able to visualize the plot icons in the code itself.
-        
-        // If the plot is selected while selection is enabled
-        if(k == this->dSelectorX && i == this->dSelectorY && this->bIsSelecting) {
-          
-          // The selector is alread on a selected plot
-          if(this->bSelectionQueue[dIndex]) {
-            switch(j) {
-              case 0: strcat(sRow, "`. .`"); break;
-              case 1: strcat(sRow, " .0. "); break;
-              case 2: strcat(sRow, "`___`"); break;
-            }
-
-          // The selector is on an unselected plot
-          } else {
-
-            // No plant on it
-            if(this->pPlotArray[dIndex]->eState != PLOT_SOWN) {
-              switch(j) {
-                case 0: strcat(sRow, "`. .`"); break;
-                case 1: strcat(sRow, " .'. "); break;
-                case 2: strcat(sRow, "`___`"); break;
-              }
-            
-            // There's a plant on it
-            } else {
-              char *sProductCode = Plot_getProductCode(this->pPlotArray[dIndex]);
-
-              switch(j) {
-                case 0: strcat(sRow, "`. .`"); break;
-                case 1: strcat(sRow, " ."); strcat(sRow, sProductCode); strcat(sRow, ". "); break;
-                case 2: strcat(sRow, "`___`"); break;
-              }
-            }
-          }
-
-        // If the plot is queued for an action.
-        } else if(this->bSelectionQueue[dIndex]) {
-          
-          // If there's no plant on the plot
-          if(this->pPlotArray[dIndex]->eState != PLOT_SOWN) {
-            switch(j) {
-              case 0: strcat(sRow, "     "); break;
-              case 1: strcat(sRow, " (0) "); break;
-              case 2: strcat(sRow, "_____"); break;
-            }
-
-          // There is a plant on the plot
-          } else {
-            char *sProductCode = Plot_getProductCode(this->pPlotArray[dIndex]);
-            int dProductState = Plot_getProductState(this->pPlotArray[dIndex]);  
-            
-            // Queueing for harvest
-            if(dProductState == 2) {
-              switch(j) {
-                case 0: strcat(sRow, sProductCode); 
-                        strcat(sRow,  "   $"); break;
-                case 1: strcat(sRow, " (0) "); break;
-                case 2: strcat(sRow, "____"); strcat(sRow, sProductCode); break;
-              }
-
-            // Queueing for watering
-            } else {
-              switch(j) {
-                case 0: strcat(sRow, sProductCode); 
-                        strcat(sRow,  "    "); break;
-                case 1: strcat(sRow, " (0) "); break;
-                case 2: strcat(sRow, "____"); strcat(sRow, sProductCode); break;
-              }
-            }
-          }
-
-        // If there's a plant on the plot
-        } else if(this->pPlotArray[dIndex]->eState == PLOT_SOWN) {
-
-          // Some variables to make life easier
-          char *sProductCode = Plot_getProductCode(this->pPlotArray[dIndex]);
-          int dProductState = Plot_getProductState(this->pPlotArray[dIndex]);
-          int dProductLastWatered = Plot_getProductLastWatered(this->pPlotArray[dIndex]);
-
-          // Print different stuff for different growth stages
-          switch(dProductState) {
-            
-            // The crop has yet to grow much
-            case 0:
-              switch(j) {
-                case 0: strcat(sRow, sProductCode); 
-                        strcat(sRow,  "   ");  strcat(sRow, dProductLastWatered < dTime ? " " : "!"); break;
-                case 1: strcat(sRow, " _._ "); break;
-                case 2: strcat(sRow, "____"); strcat(sRow, sProductCode); break;
-              }
-              break;
-
-            // The plant is halfway from being ready to harvest
-            case 1:
-              switch(j) {
-                case 0: strcat(sRow, sProductCode); 
-                        strcat(sRow,  " , ");  strcat(sRow, dProductLastWatered < dTime ? " " : "!"); break;
-                case 1: strcat(sRow, " _|_ "); break;
-                case 2: strcat(sRow, "____"); strcat(sRow, sProductCode); break;
-              }
-              break;
-
-            // The crop is halfway from being ready to harvest
-            case 2:
-              switch(j) {
-                case 0: strcat(sRow, sProductCode); 
-                        strcat(sRow,  " # $");  break;
-                case 1: strcat(sRow, " _|_ "); break;
-                case 2: strcat(sRow, "____"); strcat(sRow, sProductCode); break;
-              }
-              break;
-          }
-
-        // The plot is empty
-        } else {
-
-          // The plot is not tilled
-          if(this->pPlotArray[dIndex]->eState == PLOT_UNTILLED) {
-            switch(j) {
-              case 0: strcat(sRow, "     "); break;
-              case 1: strcat(sRow, "     "); break;
-              case 2: strcat(sRow, "____'"); break;
-            }
-
-          // The plot is tilled
-          } else if(this->pPlotArray[dIndex]->eState == PLOT_TILLED) {
-            switch(j) {
-              case 0: strcat(sRow, "'    "); break;
-              case 1: strcat(sRow, " ^^^ "); break;
-              case 2: strcat(sRow, "____'"); break;
-            }
-          }
-        }
+        UtilsString_append(pRow, this->sCellArray[i * dWidth + k][j]);
       }
 
-      strcat(sRow, "|   ");
-      UtilsText_addText(pOutput, sRow);
+      UtilsString_append(pRow, "|   ");
+      UtilsText_addText(pOutput, UtilsString_getText(pRow));
     }
   }
 
+  UtilsString_kill(pRow);
+  UtilsPanel_store(this->pGridPanel, pOutput, dStampArray, 3);
+
   return pOutput;
 }
 
@@ -919,6 +1201,8 @@ void Farm_UI(
   char *sCurrentIntInput, 
   char *sInputWarning) {
   
+  int dStart, dEnd;
+
   // The player is currently selecting an action to do on the farm
   if(this->eCurrentAction == FARM_NULL) {
     if(Player_getEnergy(pPlayer)) {
@@ -1092,26 +1376,39 @@ void Farm_UI(
     // Select a product to use on the farm when sowing
     } else {
 
-      // Reset the selector
-      UtilsSelector_setAllAvailability(pCatalogueSelector, 0);
-
       // Prompt and options
-      for(int i = 1; i < pCatalogue->dSize; i++) 
-        if(Stock_getAmount(Player_getSeedStock(pPlayer, i)))
-          UtilsSelector_setOptionAvailability(pCatalogueSelector, i, 1);
-      UtilsSelector_setOptionAvailability(pCatalogueSelector, pCatalogue->dSize, 1);
-      UtilsSelector_setFirstAvailable(pCatalogueSelector);
-
-      // Player can sow seeds
-      if(UtilsSelector_getAvailableCount(pCatalogueSelector) - 1 && Farm_canSow(this)) {
+      Farm_filterCatalogue(this, pPlayer, pCatalogueSelector, pCatalogue);
+
+      // Player can sow seeds (or is looking for some)
+      if((UtilsSelector_getAvailableCount(pCatalogueSelector) - 1 || UtilsSearch_isActive(this->pSearch)) && Farm_canSow(this)) {
         
         // For some reason you need an odd number of lines or else the UI glitches out.
         UtilsText_addText(pScreenText, "Choose a seed type to plant."); 
         UtilsText_addNewLines(pScreenText, 1);
 
-        // Print the options
-        for(int i = 1; i <= pCatalogue->dSize; i++) 
-          UtilsText_addText(pScreenText, UtilsSelector_getOptionFormatted(pCatalogueSelector, i));
+        // Print the options (or as many of them as fit)
+        if(!UtilsSearch_isActive(this->pSearch)) {
+          UtilsSelector_getWindow(pCatalogueSelector, 1, FARM_SOW_ROWS, &dStart, &dEnd);
+
+          for(int i = dStart; i < dEnd; i++) 
+            UtilsText_addText(pScreenText, UtilsSelector_getOptionFormatted(pCatalogueSelector, i));
+
+        // Only what the search found, and the way back
+        } else {
+          struct UtilsString *pLine = UtilsString_create();
+          char *sQuery = UtilsSearch_getQuery(this->pSearch);
+
+          UtilsString_appendFormat(pLine, "search: /%s%-*s", sQuery, 
+            UTILS_SEARCH_MAX_QUERY + 1 - (int) strlen(sQuery), UtilsSearch_isTyping(this->pSearch) ? "_" : "");
+          UtilsText_addText(pScreenText, UtilsString_getText(pLine));
+          UtilsString_kill(pLine);
+
+          UtilsSearch_getWindow(this->pSearch, UtilsSelector_getCurrentValue(pCatalogueSelector), FARM_SOW_ROWS - 1, &dStart, &dEnd);
+
+          for(int i = dStart; i < dEnd; i++) 
+            UtilsText_addText(pScreenText, UtilsSelector_getOptionFormatted(pCatalogueSelector, UtilsSearch_getResult(this->pSearch, i)));
+          UtilsText_addText(pScreenText, UtilsSelector_getOptionFormatted(pCatalogueSelector, pCatalogue->dSize));
+        }
 
       // Player cannot sow seeds
       } else {
@@ -1167,7 +1464,7 @@ void Farm_IO(
     // If player hits enter
     if(UtilsKey_isReturn(cInput, "")) {
       if(Player_getEnergy(pPlayer)) {
-        this->eCurrentAction = UtilsSelector_getCurrentValue(this->pFarmSelector);
+        Farm_setCurrentAction(this, UtilsSelector_getCurrentValue(this->pFarmSelector));
         
         // Return to main selection area
         if(UtilsSelector_getCurrentValue(this->pFarmSelector) == FARM_NULL)
@@ -1207,17 +1504,20 @@ void Farm_IO(
               Farm_startSelecting(this);
           } else {
             strcpy(this->sWarningText, "");
+            this->dVersion = UtilsPanel_nextVersion();
           }
         
         // Plots have been modified; go back to do another action
         } else {
-          this->eCurrentAction = FARM_NULL;
-          this->eCurrentCrop = PRODUCT_NULL;
+          Farm_setCurrentAction(this, FARM_NULL);
+          Farm_setCurrentCrop(this, PRODUCT_NULL);
         }
       }
     
-    // Select a product to use for sowing
+    // Select a product to use for sowing (typing into the search takes the keys first)
     } else {
+      if(UtilsSearch_type(this->pSearch, cInput)) cInput = 0;
+
       if(cInput == 'X') UtilsSelector_decrement(pCatalogueSelector);
       if(cInput == 'C') UtilsSelector_increment(pCatalogueSelector);
 
@@ -1225,11 +1525,11 @@ void Farm_IO(
       if(Farm_canSow(this)) {
         if(UtilsKey_isReturn(cInput, "")) {
           if(UtilsSelector_getCurrentValue(pCatalogueSelector) < pCatalogue->dSize)
-            this->eCurrentCrop = UtilsSelector_getCurrentValue(pCatalogueSelector);
-          else this->eCurrentAction = FARM_NULL;
+            Farm_setCurrentCrop(this, UtilsSelector_getCurrentValue(pCatalogueSelector));
+          else Farm_setCurrentAction(this, FARM_NULL);
         } 
       } else {
-        this->eCurrentAction = FARM_NULL;
+        Farm_setCurrentAction(this, FARM_NULL);
       }
     }
   }
@@ -1268,15 +1568,15 @@ void Farm_footer(
     char *sActionName = this->sPresentActionNameArray[UtilsSelector_getCurrentValue(this->pFarmSelector)];
 
     sprintf(sFooterString, sFooterFrontTemplate, sActionName, sFarmSelectText[UtilsSelector_getCurrentIndex(this->pFarmSelector) * 2]);
-    UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+    UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
     sprintf(sFooterString, sFooterBlankFrontTemplate, sFarmSelectText[UtilsSelector_getCurrentIndex(this->pFarmSelector) * 2 + 1]);
-    UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+    UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
     UtilsText_addNewLines(pFooterText, 1);
 
   // Select a seed to sow
   } else if (Farm_getCurrentAction(this) == FARM_SOW && Farm_getCurrentCrop(this) == PRODUCT_NULL) {
     enum ProductType eProductType = UtilsSelector_getCurrentValue(pCatalogueSelector);
-    char *sProductName = calloc(16, sizeof(char)); 
+    char *sProductName = UtilsMem_calloc(UTILS_MEM_FARM, 16, sizeof(char)); 
     char *sProductDesc = UtilsUI_createBuffer();
 
     if(eProductType < pCatalogue->dSize) {
@@ -1289,9 +1589,9 @@ void Farm_footer(
     }
 
     sprintf(sFooterString, sFooterFrontTemplate, sProductName, sProductDesc);
-    UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+    UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
     sprintf(sFooterString, sFooterBlankFrontTemplate, "");
-    UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+    UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
     UtilsText_addNewLines(pFooterText, 1);
 
   // Display info on currently selected plot
@@ -1299,9 +1599,9 @@ void Farm_footer(
 
     // Get the currently selected plot
     struct Plot *pSelectedPlot = Farm_getCurrentPlot(this);
-    char *sPlotName = calloc(16, sizeof(char));
+    char *sPlotName = UtilsMem_calloc(UTILS_MEM_FARM, 16, sizeof(char));
     char *sPlotState = UtilsUI_createBuffer();
-    char *sProductName = calloc(24, sizeof(char));
+    char *sProductName = UtilsMem_calloc(UTILS_MEM_FARM, 24, sizeof(char));
     char *sProductState = UtilsUI_createBuffer();
 
     // Coordinates and state of the current plot
@@ -1328,9 +1628,9 @@ void Farm_footer(
 
     // Display information about the currently selected plot
     sprintf(sFooterString, sFooterFrontTemplate, Farm_getCurrentQueueStatus(this) ? "selected" : "unselected", sPlotState);
-    UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+    UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
     sprintf(sFooterString, sFooterFrontTemplate, sPlotName, sProductState);
-    UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+    UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
     UtilsText_addNewLines(pFooterText, 1);
   }
 }
@@ -8,6 +8,8 @@
 #include <stdlib.h>
 
 #include "../game.catalogue.h"
+#include "../../utils/utils.mem.h"
+#include "../../utils/utils.panel.h"
 #include "../classes/game.class.stock.h"
 
 // 0: The player has the chance to continue if they get to eat breakfast at the start of the fourth day.
@@ -15,7 +17,7 @@
 #define PLAYER_STRICT_DEATH_MODE 1
 
 #define PLAYER_NAME_MAX_LEN 32
-#define PLAYER_BREAKFAST_COST 10
+#define PLAYER_BREAKFAST_COST 10    // The default; each player keeps its own copy so the simulator can play with it
 #define PLAYER_MAX_DAYS_STARVED 3
 
 /**
@@ -31,6 +33,10 @@ struct Player {
   int dGold;
   int dEnergy;
   int dDefaultEnergy;
+  int dBreakfastCost;
+
+  // Changes whenever anything above (or the stock below) does
+  int dVersion;
 
   // The stuff of the player
   struct Stock *pSeedStockArray[CATALOGUE_SIZE];
@@ -51,7 +57,7 @@ struct Player {
 struct Player *Player_new() {
   struct Player *pPlayer;
 
-  pPlayer = calloc(1, sizeof(*pPlayer));
+  pPlayer = UtilsMem_calloc(UTILS_MEM_PLAYER, 1, sizeof(*pPlayer));
 
   if(pPlayer == NULL)
     return NULL;
@@ -71,7 +77,7 @@ struct Player *Player_new() {
 void Player_init(struct Player *this, int dGold, int dEnergy, int dDefaultEnergy, struct GameCatalogue *pCatalogue) {
   
   // Player name is set using a writing function
-  this->sName = calloc(PLAYER_NAME_MAX_LEN, sizeof(char));
+  this->sName = UtilsMem_calloc(UTILS_MEM_PLAYER, PLAYER_NAME_MAX_LEN, sizeof(char));
 
   this->dTime = 0;
   this->dDaysStarved = 0;
@@ -80,6 +86,8 @@ void Player_init(struct Player *this, int dGold, int dEnergy, int dDefaultEnergy
   this->dGold = dGold;
   this->dEnergy = dEnergy;
   this->dDefaultEnergy = dDefaultEnergy;
+  this->dBreakfastCost = PLAYER_BREAKFAST_COST;
+  this->dVersion = UtilsPanel_nextVersion();
 
   // Initialize the stock array with all empty stock values
   for(int i = 0; i < pCatalogue->dSize; i++) {
@@ -105,12 +113,19 @@ struct Player *Player_create(int dGold, int dEnergy, int dDefaultEnergy, struct
 }
 
 /**
- * Destroys a player object.
+ * Destroys a player object along with its name and stock.
+ * Copy the name somewhere else first if you still need it.
  *  
  * @param  {struct Player *}  this  A pointer to the object.
 */
 void Player_kill(struct Player *this) {
-  free(this);
+  for(int i = 0; i < CATALOGUE_SIZE; i++) {
+    if(this->pSeedStockArray[i] != NULL) Stock_kill(this->pSeedStockArray[i]);
+    if(this->pCropStockArray[i] != NULL) Stock_kill(this->pCropStockArray[i]);
+  }
+
+  UtilsMem_free(this->sName);
+  UtilsMem_free(this);
 }
 
 /**
@@ -129,6 +144,8 @@ void Player_kill(struct Player *this) {
 void Player_setName(struct Player *this, char *sName) {
   if(strlen(sName) <= PLAYER_NAME_MAX_LEN) strcpy(this->sName, sName);
   else strcpy(this->sName, "your name is too long :p");
+
+  this->dVersion = UtilsPanel_nextVersion();
 }
 
 /**
@@ -171,6 +188,39 @@ int Player_getEnergy(struct Player *this) {
   return this->dEnergy;
 }
 
+/**
+ * Returns how much breakfast costs the player every morning.
+ * 
+ * @param   {struct Player *}   this    The object to be read.
+ * @return  {int}                       The price of breakfast.
+*/
+int Player_getBreakfastCost(struct Player *this) {
+  return this->dBreakfastCost;
+}
+
+/**
+ * Changes how much breakfast costs.
+ * The game never calls this, but the simulator does when it tries out different economies.
+ * 
+ * @param   {struct Player *}   this            The object to be modified.
+ * @param   {int}               dBreakfastCost  The new price of breakfast.
+*/
+void Player_setBreakfastCost(struct Player *this, int dBreakfastCost) {
+  this->dBreakfastCost = dBreakfastCost;
+  this->dVersion = UtilsPanel_nextVersion();
+}
+
+/**
+ * Returns the version of the player.
+ * It changes every time something about the player changes, so the UI knows when to redraw stuff.
+ * 
+ * @param   {struct Player *}   this    The object to be read.
+ * @return  {int}                       The current version of the player.
+*/
+int Player_getVersion(struct Player *this) {
+  return this->dVersion;
+}
+
 /**
  * Gets a piece of the inventory of the player.
  * 
@@ -190,8 +240,10 @@ struct Stock *Player_getSeedStock(struct Player *this, enum ProductType eProduct
  * @param   {int}               dChangeAmount   How much seed bags were acquired or used.
 */
 void Player_updateSeedStock(struct Player *this, enum ProductType eProductType, int dChangeAmount) {
-  if(this->pSeedStockArray[eProductType]->dAmount + dChangeAmount >= 0) 
+  if(this->pSeedStockArray[eProductType]->dAmount + dChangeAmount >= 0) {
     this->pSeedStockArray[eProductType]->dAmount += dChangeAmount;
+    this->dVersion = UtilsPanel_nextVersion();
+  }
 }
 
 /**
@@ -213,8 +265,10 @@ struct Stock *Player_getCropStock(struct Player *this, enum ProductType eProduct
  * @param   {int}               dChangeAmount   How much crops were acquired or sold.
 */
 void Player_updateCropStock(struct Player *this, enum ProductType eProductType, int dChangeAmount) {
-  if(this->pCropStockArray[eProductType]->dAmount + dChangeAmount >= 0) 
+  if(this->pCropStockArray[eProductType]->dAmount + dChangeAmount >= 0) {
     this->pCropStockArray[eProductType]->dAmount += dChangeAmount;
+    this->dVersion = UtilsPanel_nextVersion();
+  }
 }
 
 /**
@@ -228,6 +282,7 @@ void Player_updateCropStock(struct Player *this, enum ProductType eProductType,
 int Player_updateGold(struct Player *this, int dGoldChange) {
   if(this->dGold + dGoldChange >= 0) {
     this->dGold += dGoldChange;
+    this->dVersion = UtilsPanel_nextVersion();
     
     // Is not broke
     return 1;
@@ -249,6 +304,7 @@ int Player_updateGold(struct Player *this, int dGoldChange) {
 int Player_updateEnergy(struct Player *this, int dEnergyChange) {
   if(this->dEnergy + dEnergyChange >= 0) {
     this->dEnergy += dEnergyChange;
+    this->dVersion = UtilsPanel_nextVersion();
     
     // Is not tired
     return 1;
@@ -297,17 +353,18 @@ void Player_goHome(struct Player *this) {
   this->dTime++;
   this->dDaysStarved++;
   this->bIsStarving = 1;
+  this->dVersion = UtilsPanel_nextVersion();
   Player_updateEnergy(this, this->dDefaultEnergy - this->dEnergy);
 
   // If they get to eat, they don't starve; depends on the death mode strictness
   if(!PLAYER_STRICT_DEATH_MODE) {
-    if(Player_updateGold(this, -PLAYER_BREAKFAST_COST)) {
+    if(Player_updateGold(this, -this->dBreakfastCost)) {
       this->dDaysStarved = 0;
       this->bIsStarving = 0;
     }
   } else {
     if(!Player_isDead(this)) {
-      if(Player_updateGold(this, -PLAYER_BREAKFAST_COST)) {
+      if(Player_updateGold(this, -this->dBreakfastCost)) {
         this->dDaysStarved = 0;
         this->bIsStarving = 0;
       }
@@ -315,6 +372,40 @@ void Player_goHome(struct Player *this) {
   }
 }
 
+/**
+ * Makes the player go home a number of nights in a row, without doing anything in between.
+ * The result is exactly what calling Player_goHome() that many times would give, but it doesn't loop over the days:
+ * the player eats every morning until they run out of gold for breakfast, then starves every morning after that.
+ * 
+ * @param   {struct Player *}   this    The object who will perform the action.
+ * @param   {int}               dDays   How many nights to skip.
+*/
+void Player_fastForward(struct Player *this, int dDays) {
+  int dMeals = dDays;
+
+  if(dDays <= 0)
+    return;
+
+  // How many breakfasts we can pay for
+  if(this->dBreakfastCost > 0 && this->dGold / this->dBreakfastCost < dMeals)
+    dMeals = this->dGold / this->dBreakfastCost;
+
+  // In strict mode, someone who's already starved for too long dies before they get to eat
+  if(PLAYER_STRICT_DEATH_MODE && this->dDaysStarved >= PLAYER_MAX_DAYS_STARVED)
+    dMeals = 0;
+
+  // Each meal resets the counter, so only the nights after the last one count
+  if(dMeals)
+    this->dDaysStarved = 0;
+
+  this->dTime += dDays;
+  this->dDaysStarved += dDays - dMeals;
+  this->bIsStarving = dMeals < dDays;
+  this->dGold -= dMeals * this->dBreakfastCost;
+  this->dVersion = UtilsPanel_nextVersion();
+  Player_updateEnergy(this, this->dDefaultEnergy - this->dEnergy);
+}
+
 /**
  * Updates the player state after tilling the given number of plots.
  * 
@@ -337,6 +428,7 @@ int Player_tillPlots(struct Player *this, int dPlots) {
 int Player_sowSeeds(struct Player *this, enum ProductType eProductType, int dSeeds) {
   if(Stock_getAmount(this->pSeedStockArray[eProductType]) >= dSeeds) {
     if(Player_updateEnergy(this, -dSeeds)) {
+      this->dVersion = UtilsPanel_nextVersion();
       return Stock_updateAmount(this->pSeedStockArray[eProductType], -dSeeds);
     }
   }
@@ -374,6 +466,7 @@ int Player_harvestCrops(struct Player *this, int dCrops) {
 */
 void Player_harvestACrop(struct Player *this, enum ProductType eProductType) {
   Stock_updateAmount(this->pCropStockArray[eProductType], 1);
+  this->dVersion = UtilsPanel_nextVersion();
 }
 
 /**
@@ -407,6 +500,7 @@ int Player_buyCrop(struct Player *this, enum ProductType eProductType, int dAmou
 int Player_sellCrop(struct Player *this, enum ProductType eProductType, int dAmount, int dCost) {
   if(Stock_getAmount(Player_getCropStock(this, eProductType)) >= dAmount) {
     Stock_updateAmount(this->pCropStockArray[eProductType], -dAmount);
+    this->dVersion = UtilsPanel_nextVersion();
 
     return Player_updateGold(this, dCost);
   }
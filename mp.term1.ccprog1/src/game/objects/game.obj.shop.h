@@ -8,6 +8,10 @@
 #define GAME_OBJ_SHOP
 
 #include "../../utils/utils.selector.h"
+#include "../../utils/utils.mem.h"
+#include "../../utils/utils.panel.h"
+#include "../../utils/utils.search.h"
+#include "../../utils/utils.string.h"
 #include "../../utils/utils.key.h"
 #include "../../utils/utils.ui.h"
 
@@ -18,6 +22,9 @@
 #include "../enums/game.enum.shop.h"
 #include "../enums/game.enum.state.h"
 
+// The most products the list shows at once; longer catalogues scroll
+#define SHOP_LIST_ROWS 12
+
 /**
  * A struct for the shop singleton.
 */
@@ -36,6 +43,20 @@ struct Shop {
 
   // Helps do the selection 
   struct UtilsSelector *pShopSelector;
+
+  // Changes whenever the current action, crop or response changes
+  int dVersion;
+
+  // The last product list we drew
+  struct UtilsPanel *pListPanel;
+
+  // Type-ahead search over the product names and codes, and the version of it the selector was last filtered with
+  struct UtilsSearch *pSearch;
+  int dSearchVersion;
+
+  // Gets told about every purchase and sale (the journal needs this)
+  void (*fOnTrade)(void *pData, enum ShopAction eAction, enum ProductType eProductType, int dAmount);
+  void *pOnTradeData;
 };
 
 /**
@@ -52,7 +73,7 @@ struct Shop {
 struct Shop *Shop_new() {
   struct Shop *pShop;
 
-  pShop = calloc(1, sizeof(*pShop));
+  pShop = UtilsMem_calloc(UTILS_MEM_SHOP, 1, sizeof(*pShop));
 
   if(pShop == NULL)
     return NULL;
@@ -105,6 +126,22 @@ void Shop_init(struct Shop *this, struct GameCatalogue *pCatalogue) {
   UtilsSelector_addOption(pShopSelector, "do nothing    ", SHOP_NULL);
 
   this->pShopSelector = pShopSelector;
+
+  this->dVersion = UtilsPanel_nextVersion();
+  this->pListPanel = UtilsPanel_create();
+
+  // Index the products by name and by code (null product and the "go back" option excluded)
+  this->pSearch = UtilsSearch_create();
+  this->dSearchVersion = -1;
+
+  for(int i = 1; i < pCatalogue->dSize; i++) {
+    char sCode[2] = { pCatalogue->cProductCodeArray[i], 0 };
+
+    UtilsSearch_add(this->pSearch, pCatalogue->sProductNameArray[i], i);
+    UtilsSearch_add(this->pSearch, sCode, i);
+  }
+
+  UtilsSearch_build(this->pSearch);
 }
 
 /**
@@ -127,7 +164,14 @@ struct Shop *Shop_create(struct GameCatalogue *pCatalogue) {
  * @param   {struct Shop *}   A pointer to the object to be destroyed.
 */
 void Shop_kill(struct Shop *this) {
-  free(this);
+  for(int i = 0; i < this->dRepositorySize; i++)
+    Stock_kill(this->pStockArray[i]);
+
+  UtilsSelector_kill(this->pShopSelector);
+  UtilsMem_free(this->sActionResponse);
+  UtilsPanel_kill(this->pListPanel);
+  UtilsSearch_kill(this->pSearch);
+  UtilsMem_free(this);
 }
 
 /**
@@ -136,6 +180,17 @@ void Shop_kill(struct Shop *this) {
  * ##################################
 */
 
+/**
+ * Returns the version of the shop.
+ * It changes every time something the shop displays changes.
+ * 
+ * @param   {struct Shop *}     this  The shop object.
+ * @return  {int}                     The current version of the shop.
+*/
+int Shop_getVersion(struct Shop *this) {
+  return this->dVersion;
+}
+
 /**
  * Returns the current action selected for the shop.
  * 
@@ -154,6 +209,21 @@ enum ShopAction Shop_getCurrentAction(struct Shop *this) {
 */
 void Shop_setCurrentAction(struct Shop *this, enum ShopAction eShopAction) {
   this->eCurrentAction = eShopAction;
+  this->dVersion = UtilsPanel_nextVersion();
+
+  // Every visit to the list starts without a search, and the farm might have touched the selector in between
+  UtilsSearch_clear(this->pSearch);
+  this->dSearchVersion = -1;
+}
+
+/**
+ * Returns whether or not the keys are being typed into the product search.
+ * 
+ * @param   {struct Shop *}   this  The shop object.
+ * @return  {int}                   Whether or not the user is typing a search.
+*/
+int Shop_isSearching(struct Shop *this) {
+  return UtilsSearch_isTyping(this->pSearch);
 }
 
 /**
@@ -174,6 +244,7 @@ enum ProductType Shop_getCurrentCrop(struct Shop *this) {
 */
 void Shop_setCurrentCrop(struct Shop *this, enum ProductType eProductType) {
   this->eCurrentCrop = eProductType;
+  this->dVersion = UtilsPanel_nextVersion();
 }
 
 /**
@@ -182,6 +253,30 @@ void Shop_setCurrentCrop(struct Shop *this, enum ProductType eProductType) {
  * ######################
 */
 
+/**
+ * Sets the function that gets called for every purchase and sale.
+ * 
+ * @param   {struct Shop *}                                             this      The shop object.
+ * @param   {void (*)(void *, enum ShopAction, enum ProductType, int)}  fOnTrade  The function, or NULL for none.
+ * @param   {void *}                                                    pData     Passed to the function.
+*/
+void Shop_setListener(struct Shop *this, void (*fOnTrade)(void *pData, enum ShopAction eAction, enum ProductType eProductType, int dAmount), void *pData) {
+  this->fOnTrade = fOnTrade;
+  this->pOnTradeData = pData;
+}
+
+/**
+ * Lets the listener know that the current product was bought or sold.
+ * 
+ * @param   {struct Shop *}       this      The shop object.
+ * @param   {enum ShopAction}     eAction   Whether it was bought or sold.
+ * @param   {int}                 dAmount   How many.
+*/
+void Shop_notify(struct Shop *this, enum ShopAction eAction, int dAmount) {
+  if(this->fOnTrade != NULL)
+    (*this->fOnTrade)(this->pOnTradeData, eAction, this->eCurrentCrop, dAmount);
+}
+
 /**
  * A function that returns how much a certain number of items costs.
  * 
@@ -202,11 +297,17 @@ int Shop_getCurrentBuyCost(struct Shop *this, int dAmount) {
  * @return  {int}                             Indicates whether or not the purchase was successful.
 */
 int Shop_buyCurrentProduct(struct Shop *this, int dAmount) {
+  int bBought = 0;
+
   if(dAmount < this->pStockArray[this->eCurrentCrop]->dAmount) {
     this->pStockArray[this->eCurrentCrop]->dAmount -= dAmount;
-    return 1;
+    this->dVersion = UtilsPanel_nextVersion();
+    bBought = 1;
   }
-  return 0;
+
+  // The player paid either way, so the listener hears about it either way
+  Shop_notify(this, SHOP_BUY, dAmount);
+  return bBought;
 }
 
 /**
@@ -228,6 +329,52 @@ int Shop_getCurrentSellCost(struct Shop *this, int dAmount) {
 */
 void Shop_sellCurrentProduct(struct Shop *this, int dAmount) {
   this->pStockArray[this->eCurrentCrop]->dAmount += dAmount;
+  this->dVersion = UtilsPanel_nextVersion();
+
+  Shop_notify(this, SHOP_SELL, dAmount);
+}
+
+/**
+ * Clears the response to the last purchase or sale.
+ * 
+ * @param   {struct Shop *}     this  The shop object.
+*/
+void Shop_clearActionResponse(struct Shop *this) {
+  if(strlen(this->sActionResponse)) {
+    strcpy(this->sActionResponse, "");
+    this->dVersion = UtilsPanel_nextVersion();
+  }
+}
+
+/**
+ * Decides which products can be picked for the current action: the ones the search finds that the player can buy (or sell).
+ * Only the products the search finds are looked at. When the search changes, everything gets disabled once first;
+ * without a search, the search finds every product, so this does what looping over the whole catalogue did.
+ * 
+ * @param   {struct Shop *}           this                  The shop object.
+ * @param   {struct Player *}         pPlayer               The player whose gold and crops we're checking.
+ * @param   {struct UtilsSelector *}  pCatalogueSelector    A selector for all the game products.
+ * @param   {struct GameCatalogue *}  pCatalogue            A list of all the products available in the game.
+*/
+void Shop_filterCatalogue(struct Shop *this, struct Player *pPlayer, struct UtilsSelector *pCatalogueSelector, struct GameCatalogue *pCatalogue) {
+  
+  // Setting each option directly (instead of disabling everything first) keeps its version from changing every frame
+  if(this->dSearchVersion != UtilsSearch_getVersion(this->pSearch)) {
+    UtilsSelector_setAllAvailability(pCatalogueSelector, 0);
+    this->dSearchVersion = UtilsSearch_getVersion(this->pSearch);
+  }
+
+  for(int i = 0; i < UtilsSearch_getCount(this->pSearch); i++) {
+    int dProduct = UtilsSearch_getResult(this->pSearch, i);
+
+    UtilsSelector_setOptionAvailability(pCatalogueSelector, dProduct, this->eCurrentAction == SHOP_BUY ?
+      Player_getGold(pPlayer) >= pCatalogue->dProductCostToBuyArray[dProduct] :
+      Stock_getAmount(Player_getCropStock(pPlayer, dProduct)) > 0);
+  }
+
+  UtilsSelector_setOptionAvailability(pCatalogueSelector, 0, 0);
+  UtilsSelector_setOptionAvailability(pCatalogueSelector, pCatalogue->dSize, 1);
+  UtilsSelector_setFirstAvailable(pCatalogueSelector);
 }
 
 /**
@@ -236,6 +383,81 @@ void Shop_sellCurrentProduct(struct Shop *this, int dAmount) {
  * #######################
 */
 
+/**
+ * Creates the list of products with their prices for the current action.
+ * Like the farm grid, it's only drawn again when the shop or the selector changes.
+ * 
+ * @param   {struct Shop *}           this                  The shop object.
+ * @param   {struct UtilsSelector *}  pCatalogueSelector    A selector for all the game products.
+ * @param   {struct GameCatalogue *}  pCatalogue            A list of all the products available in the game.
+ * @return  {struct UtilsText *}                            The list (it belongs to the shop; don't free it).
+*/
+struct UtilsText *Shop_displayList(struct Shop *this, struct UtilsSelector *pCatalogueSelector, struct GameCatalogue *pCatalogue) {
+  int dStampArray[] = { 
+    this->dVersion, 
+    UtilsSelector_getVersion(pCatalogueSelector), 
+    UtilsSearch_getVersion(this->pSearch), 
+    UtilsIO_getWidth() 
+  };
+
+  if(UtilsPanel_isFresh(this->pListPanel, dStampArray, 4))
+    return UtilsPanel_getText(this->pListPanel);
+
+  struct UtilsText *pOutput = UtilsText_create();
+  struct UtilsString *pLine = UtilsString_create();
+  int dStart, dEnd, dShown = 0;
+  int dShownArray[SHOP_LIST_ROWS];
+  int *dPriceArray = this->eCurrentAction == SHOP_BUY ? 
+    pCatalogue->dProductCostToBuyArray : 
+    pCatalogue->dProductCostToSellArray;
+
+  // What's been typed into the search so far
+  if(UtilsSearch_isActive(this->pSearch)) {
+    char *sQuery = UtilsSearch_getQuery(this->pSearch);
+
+    UtilsString_appendFormat(pLine, "search: /%s%-*s", sQuery, 
+      UTILS_SEARCH_MAX_QUERY + 1 - (int) strlen(sQuery), UtilsSearch_isTyping(this->pSearch) ? "_" : "");
+    UtilsText_addText(pOutput, UtilsString_getText(pLine));
+  }
+
+  // Table header
+  if(this->eCurrentAction == SHOP_BUY)
+    UtilsText_addText(pOutput, "                                   | buying price    ");
+  else
+    UtilsText_addText(pOutput, "                                   | selling price   ");
+  UtilsText_addText(pOutput, "=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=|=-=-=-=-=-=-=-=-=");
+
+  // The options that fit; with a search, only what it found (and the way back)
+  if(!UtilsSearch_isActive(this->pSearch)) {
+    UtilsSelector_getWindow(pCatalogueSelector, 1, SHOP_LIST_ROWS, &dStart, &dEnd);
+
+    for(int i = dStart; i < dEnd; i++)
+      dShownArray[dShown++] = i;
+  } else {
+    UtilsSearch_getWindow(this->pSearch, UtilsSelector_getCurrentValue(pCatalogueSelector), SHOP_LIST_ROWS - 1, &dStart, &dEnd);
+
+    for(int i = dStart; i < dEnd; i++)
+      dShownArray[dShown++] = UtilsSearch_getResult(this->pSearch, i);
+    dShownArray[dShown++] = pCatalogue->dSize;
+  }
+
+  // The options and their prices
+  for(int j = 0; j < dShown; j++) { 
+    int i = dShownArray[j];
+    char *sOption = UtilsSelector_getOptionFormatted(pCatalogueSelector, i);
+
+    UtilsString_clear(pLine);
+    if(i != pCatalogue->dSize) UtilsString_appendFormat(pLine, "%24s | %-2d gold %7s", sOption, dPriceArray[i], " ");
+    else UtilsString_appendFormat(pLine, "%24s |                ", sOption);
+    UtilsText_addText(pOutput, UtilsString_getText(pLine));
+  }
+
+  UtilsString_kill(pLine);
+  UtilsPanel_store(this->pListPanel, pOutput, dStampArray, 4);
+
+  return pOutput;
+}
+
 /**
  * Displays the shop UI.
  * 
@@ -282,59 +504,51 @@ void Shop_UI(
   // There is already an action to be done
   } else {
 
+    // One builder for all the formatted lines below
+    struct UtilsString *pLine = UtilsString_create();
+
     // Configure and display the selector
-    UtilsSelector_setAllAvailability(pCatalogueSelector, 0);
+    Shop_filterCatalogue(this, pPlayer, pCatalogueSelector, pCatalogue);
+
     switch(this->eCurrentAction) {
       
       // User is gonna buy some seeds
       case SHOP_BUY: 
-        for(int i = 1; i < pCatalogue->dSize; i++)
-          if(Player_getGold(pPlayer) >= pCatalogue->dProductCostToBuyArray[i])
-            UtilsSelector_setOptionAvailability(pCatalogueSelector, i, 1);
-        UtilsSelector_setOptionAvailability(pCatalogueSelector, pCatalogue->dSize, 1);
-        UtilsSelector_setFirstAvailable(pCatalogueSelector);
-
-        // User can purchase seed bags
-        if(UtilsSelector_getAvailableCount(pCatalogueSelector) - 1 || strlen(this->sActionResponse)) {
+
+        // User can purchase seed bags (or is looking for some)
+        if(UtilsSelector_getAvailableCount(pCatalogueSelector) - 1 || strlen(this->sActionResponse) || 
+          UtilsSearch_isActive(this->pSearch)) {
           UtilsText_addText(pScreenText, "You are now choosing a seed type to (BUY).");
           UtilsText_addNewLines(pScreenText, 1);
 
           // Print the options
-          UtilsText_addText(pScreenText, "                                   | buying price    ");
-          UtilsText_addText(pScreenText, "=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=|=-=-=-=-=-=-=-=-=");
-          
-          for(int i = 1; i <= pCatalogue->dSize; i++) { 
-            char *sCatalogueLine = UtilsUI_createBuffer();
-            if(i != pCatalogue->dSize) sprintf(sCatalogueLine, "%24s | %-2d gold %7s",
-                UtilsSelector_getOptionFormatted(pCatalogueSelector, i), pCatalogue->dProductCostToBuyArray[i], " ");
-            else sprintf(sCatalogueLine, "%24s |                ", 
-                UtilsSelector_getOptionFormatted(pCatalogueSelector, i));
-            UtilsText_addText(pScreenText, sCatalogueLine);
-          }
+          UtilsText_mergeText(pScreenText, Shop_displayList(this, pCatalogueSelector, pCatalogue));
 
           // The user has chosen a product to buy
           if(this->eCurrentCrop != PRODUCT_NULL) {
-            char *sProductName = UtilsUI_createBuffer();
-            char *sPromptLine = UtilsUI_createBuffer();
-            char *sInfoLine = UtilsUI_createBuffer();
+            char *sProductName;
             
             // Define the different strings to print
             sProductName = UtilsUI_toUpper(pCatalogue->sProductNameArray[this->eCurrentCrop]);
 
             // Where the user input is gonna appear
-            sprintf(sPromptLine, "No. of (%s) seeds to (BUY); (0) to cancel: %-16s", sProductName,
+            UtilsString_clear(pLine);
+            UtilsString_appendFormat(pLine, "No. of (%s) seeds to (BUY); (0) to cancel: %-16s", sProductName,
               strlen(sCurrentIntInput) ? sCurrentIntInput : "________________");
             
             // Show how much gold the amount of seeds costs
+            UtilsText_addNewLines(pScreenText, 2);
+            UtilsText_addText(pScreenText, UtilsString_getText(pLine));
+            UtilsString_clear(pLine);
+
             if(UtilsKey_stringToInt(sCurrentIntInput) >= 0)
-              sprintf(sInfoLine, "%*s                          (GOLD) needed: %-16d", 
+              UtilsString_appendFormat(pLine, "%*s                          (GOLD) needed: %-16d", 
                 (int) strlen(sProductName), " ",
                 Shop_getCurrentBuyCost(this, UtilsKey_stringToInt(sCurrentIntInput)));
 
             // Display the dormatted strings
-            UtilsText_addNewLines(pScreenText, 2);
-            UtilsText_addText(pScreenText, sPromptLine);
-            UtilsText_addText(pScreenText, sInfoLine);
+            UtilsText_addText(pScreenText, UtilsString_getText(pLine));
+            UtilsMem_free(sProductName);
 
             if(strlen(sInputWarning)) {
               UtilsText_addNewLines(pScreenText, 2);
@@ -364,54 +578,39 @@ void Shop_UI(
 
       case SHOP_SELL:
 
-        // Configure selection
-        for(int i = 1; i < pCatalogue->dSize; i++)
-          if(Stock_getAmount(Player_getCropStock(pPlayer, i)))
-            UtilsSelector_setOptionAvailability(pCatalogueSelector, i, 1);
-        UtilsSelector_setOptionAvailability(pCatalogueSelector, pCatalogue->dSize, 1);
-        UtilsSelector_setFirstAvailable(pCatalogueSelector);
-
-        if(UtilsSelector_getAvailableCount(pCatalogueSelector) - 1 || strlen(this->sActionResponse)) {
+        if(UtilsSelector_getAvailableCount(pCatalogueSelector) - 1 || strlen(this->sActionResponse) || 
+          UtilsSearch_isActive(this->pSearch)) {
           UtilsText_addText(pScreenText, "You are now choosing a crop to (SELL)."); 
           UtilsText_addNewLines(pScreenText, 1);
 
           // Print the options
-          UtilsText_addText(pScreenText, "                                   | selling price   ");
-          UtilsText_addText(pScreenText, "=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=|=-=-=-=-=-=-=-=-=");
-
-          for(int i = 1; i <= pCatalogue->dSize; i++) { 
-            char *sCatalogueLine = UtilsUI_createBuffer();
-            if(i != pCatalogue->dSize) sprintf(sCatalogueLine, "%24s | %-2d gold %7s",
-                UtilsSelector_getOptionFormatted(pCatalogueSelector, i),
-                pCatalogue->dProductCostToSellArray[i], " ");
-            else sprintf(sCatalogueLine, "%24s |                ", 
-                UtilsSelector_getOptionFormatted(pCatalogueSelector, i));
-            UtilsText_addText(pScreenText, sCatalogueLine);
-          }
+          UtilsText_mergeText(pScreenText, Shop_displayList(this, pCatalogueSelector, pCatalogue));
 
           // The user has chosen a product to sell
           if(this->eCurrentCrop != PRODUCT_NULL) {
-            char *sProductName = UtilsUI_createBuffer();
-            char *sPromptLine = UtilsUI_createBuffer();
-            char *sInfoLine = UtilsUI_createBuffer();
+            char *sProductName;
             
             // Define the different strings to print
             sProductName = UtilsUI_toUpper(pCatalogue->sProductNameArray[this->eCurrentCrop]);
 
             // Where the user input is gonna appear
-            sprintf(sPromptLine, "No. of (%s) crops to (SELL); (0) to cancel: %-16s", sProductName,
+            UtilsString_clear(pLine);
+            UtilsString_appendFormat(pLine, "No. of (%s) crops to (SELL); (0) to cancel: %-16s", sProductName,
               strlen(sCurrentIntInput) ? sCurrentIntInput : "________________");
             
             // Show how much gold the amount of crops will give
+            UtilsText_addNewLines(pScreenText, 2);
+            UtilsText_addText(pScreenText, UtilsString_getText(pLine));
+            UtilsString_clear(pLine);
+
             if(UtilsKey_stringToInt(sCurrentIntInput) >= 0)
-              sprintf(sInfoLine, "%*s                           (GOLD) profit: %-16d", 
+              UtilsString_appendFormat(pLine, "%*s                           (GOLD) profit: %-16d", 
                 (int) strlen(sProductName), " ",
                 Shop_getCurrentSellCost(this, UtilsKey_stringToInt(sCurrentIntInput)));
 
             // Display the dormatted strings
-            UtilsText_addNewLines(pScreenText, 2);
-            UtilsText_addText(pScreenText, sPromptLine);
-            UtilsText_addText(pScreenText, sInfoLine);
+            UtilsText_addText(pScreenText, UtilsString_getText(pLine));
+            UtilsMem_free(sProductName);
 
             if(strlen(sInputWarning)) {
               UtilsText_addNewLines(pScreenText, 2);
@@ -441,6 +640,8 @@ void Shop_UI(
 
       default: break;
     }
+
+    UtilsString_kill(pLine);
   }
 }
 
@@ -477,7 +678,7 @@ void Shop_IO(
 
     // If player hits enter
     if(UtilsKey_isReturn(cInput, "")) {
-      this->eCurrentAction = UtilsSelector_getCurrentValue(this->pShopSelector);
+      Shop_setCurrentAction(this, UtilsSelector_getCurrentValue(this->pShopSelector));
       
       // Return to main selection area
       if(UtilsSelector_getCurrentValue(this->pShopSelector) == SHOP_NULL)
@@ -490,8 +691,10 @@ void Shop_IO(
     // Clear the console warning and input response each time
     strcpy(sInputWarning, "");
 
-    // User is choosing a product
+    // User is choosing a product (typing into the search takes the keys first)
     if(this->eCurrentCrop == PRODUCT_NULL) {
+      if(UtilsSearch_type(this->pSearch, cInput)) cInput = 0;
+
       if(cInput == 'X') UtilsSelector_decrement(pCatalogueSelector);
       if(cInput == 'C') UtilsSelector_increment(pCatalogueSelector);
       
@@ -503,20 +706,20 @@ void Shop_IO(
           UtilsSelector_getCurrentValue(pCatalogueSelector) != pCatalogue->dSize) {
           
           strcpy(sCurrentIntInput, "");
-          this->eCurrentCrop = UtilsSelector_getCurrentValue(pCatalogueSelector);
+          Shop_setCurrentCrop(this, UtilsSelector_getCurrentValue(pCatalogueSelector));
         
         // If can't do anything, go back
         } else {
-          this->eCurrentAction = SHOP_NULL;
+          Shop_setCurrentAction(this, SHOP_NULL);
         }
       }
 
       // Reset sActionResponse
-      strcpy(this->sActionResponse, "");
+      Shop_clearActionResponse(this);
 
     // Product has been chosen; user is inputting how much they want
     } else {   
-      char *sInput = calloc(1, sizeof(char));
+      char *sInput = UtilsMem_calloc(UTILS_MEM_SHOP, 1, sizeof(char));
       sprintf(sInput, "%c", cInput);
 
       // If user is not done inputting
@@ -552,7 +755,7 @@ void Shop_IO(
                   sprintf(this->sActionResponse, "You just (BOUGHT) an amount of (%d) (%s) seeds.", 
                     dAmount, UtilsUI_toUpper(pCatalogue->sProductNameArray[this->eCurrentCrop]));
 
-                  this->eCurrentCrop = PRODUCT_NULL;
+                  Shop_setCurrentCrop(this, PRODUCT_NULL);
                 } else strcpy(sInputWarning, "You do not have enough gold to make that purchase.");
                 break;
                 
@@ -563,7 +766,7 @@ void Shop_IO(
                   sprintf(this->sActionResponse, "You just (SOLD) an amount of (%d) (%s) crops.", 
                     dAmount, UtilsUI_toUpper(pCatalogue->sProductNameArray[this->eCurrentCrop]));
 
-                  this->eCurrentCrop = PRODUCT_NULL;
+                  Shop_setCurrentCrop(this, PRODUCT_NULL);
                 } else strcpy(sInputWarning, "You do not have enough crops to sell that amount.");
                 break;
             }
@@ -611,15 +814,15 @@ void Shop_footer(
     char *sActionName = this->sPresentActionNameArray[UtilsSelector_getCurrentValue(this->pShopSelector)];
 
     sprintf(sFooterString, sFooterFrontTemplate, sActionName, sShopSelectText[UtilsSelector_getCurrentIndex(this->pShopSelector) * 2]);
-    UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+    UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
     sprintf(sFooterString, sFooterBlankFrontTemplate, sShopSelectText[UtilsSelector_getCurrentIndex(this->pShopSelector) * 2 + 1]);
-    UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+    UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
     UtilsText_addNewLines(pFooterText, 1);
   
   // The user is selecting something to sell or buy
   } else {
     enum ProductType eProductType = UtilsSelector_getCurrentValue(pCatalogueSelector);
-    char *sProductName = calloc(16, sizeof(char)); 
+    char *sProductName = UtilsMem_calloc(UTILS_MEM_SHOP, 16, sizeof(char)); 
     char *sProductDesc = UtilsUI_createBuffer();
 
     if(eProductType < pCatalogue->dSize) {
@@ -630,22 +833,22 @@ void Shop_footer(
           sprintf(sProductDesc, "This crop needs to be watered (%d) times before being harvested.", 
             pCatalogue->dProductWaterReqArray[eProductType]);
           sprintf(sFooterString, sFooterFrontTemplate, sProductName, sProductDesc);
-          UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+          UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
           
           sprintf(sProductDesc, "It sells for (%d) gold; that's a profit of (%d) gold.", 
             pCatalogue->dProductCostToSellArray[eProductType],
             pCatalogue->dProductCostToSellArray[eProductType] - pCatalogue->dProductCostToBuyArray[eProductType]);
           sprintf(sFooterString, sFooterBlankFrontTemplate, sProductDesc);
-          UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+          UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
           break;
 
         case SHOP_SELL:
           sprintf(sProductDesc, "You currently have (%d) of this crop in your inventory.", 
             Stock_getAmount(Player_getCropStock(pPlayer, eProductType)));
           sprintf(sFooterString, sFooterFrontTemplate, sProductName, sProductDesc);
-          UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+          UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
           sprintf(sFooterString, sFooterBlankFrontTemplate, "");
-          UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+          UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
           break;
 
         default: break;
@@ -654,9 +857,9 @@ void Shop_footer(
       sProductName = "go back";
 
       sprintf(sFooterString, sFooterFrontTemplate, sProductName, "Return to the counter of the shop.");
-      UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+      UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
       sprintf(sFooterString, sFooterBlankFrontTemplate, "You get to choose another action to do in the shop.");
-      UtilsText_addText(pFooterText, UtilsText_paddedText(sFooterString, " ", UTILS_TEXT_LEFT_ALIGN));
+      UtilsText_addPaddedText(pFooterText, sFooterString, " ", UTILS_TEXT_LEFT_ALIGN);
     } 
 
     UtilsText_addNewLines(pFooterText, 1);
@@ -0,0 +1,354 @@
+/**
+ * The end-to-end latency benchmark for Harvest Sun.
+ * It starts the real game inside a pseudo-terminal (see latency/latency.pty.h), presses keys from a few scripts,
+ * and feeds everything the game writes back into a model of the screen (see latency/latency.screen.h).
+ * After every key, we wait until the screen stops changing; the time from the key to the last change is its latency.
+ * That includes everything: reading the key, updating the game, building the frame, the write(2) and the terminal itself.
+ *
+ * Build (main.c does this for you with "./main latency", but the game has to have been built first by plain "./main"):
+ *    gcc src/latency.c -o build/latency.unix.o -std=c99 -Wall -O2
+ *
+ * Usage:
+ *    build/latency.unix.o [-b game] [-s script] [-r runs] [-q quiet ms] [-t timeout ms] [-w width] [-h height] [-v 1]
+ *
+ *    -s picks one of the scripts below (they all run by default), -r plays each one that many times,
+ *    and -v 1 prints the final screen of every run to stderr.
+ *
+ * Keys that don't change the screen at all aren't counted in the percentiles, but their bytes still are.
+ * At the end of every run, the screen is checked for some text that should be there; a run that fails the check
+ * makes the whole thing return 1, since fast frames aren't worth much if they're wrong.
+*/
+
+// We need the pseudo-terminal functions from X/Open
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/utils.mem.h"
+
+#ifdef _WIN32
+int main(int argc, char *argv[]) {
+  fprintf(stderr, "Sorry, the latency benchmark needs a POSIX pseudo-terminal.\n");
+  return 1;
+}
+#else
+
+#include "latency/latency.pty.h"
+#include "latency/latency.screen.h"
+
+#define LATENCY_DEFAULT_GAME "build/game.unix.o"
+#define LATENCY_DEFAULT_RUNS 5
+#define LATENCY_DEFAULT_QUIET 30
+#define LATENCY_DEFAULT_TIMEOUT 2000
+#define LATENCY_DEFAULT_WIDTH 130
+#define LATENCY_DEFAULT_HEIGHT 40
+
+#define LATENCY_MAX_EXPECTS 4
+#define LATENCY_READ_SIZE (1 << 16)
+
+/**
+ * A list of keys to press and what the screen should say afterwards.
+ * Every character of sKeys is one key.
+*/
+struct LatencyScript {
+  char *sName;
+  char *sMode;                                    // The args the game gets (see Game_conf())
+  char *sScene;
+  char *sKeys;
+  char *sExpectArray[LATENCY_MAX_EXPECTS];        // Ends early with NULL
+};
+
+/**
+ * The numbers for one script, over all of its runs.
+*/
+struct LatencyResult {
+  double *fLatencyArray;    // In seconds, one per key that changed the screen
+  int dLatencies;
+  int dCapacity;
+
+  long dKeys;
+  long dSilent;             // Keys that didn't change anything
+  long dBytes;
+  long dUnknown;            // Sequences the screen model didn't understand
+  int dFailures;            // Runs whose final screen was wrong
+};
+
+/**
+ * The benchmark.
+*/
+struct Latency {
+  char *sGame;
+  int dRuns;
+  double fQuiet;            // How long the screen has to stay still to count as settled
+  double fTimeout;          // How long we wait for anything at all
+  int dWidth;
+  int dHeight;
+  int bVerbose;
+
+  char sBuffer[LATENCY_READ_SIZE];
+};
+
+/**
+ * The scripts.
+ * They start in debug mode so they don't have to go through the intro first.
+*/
+struct LatencyScript latencyScriptArray[] = {
+
+  // Up and down the home menu
+  { "menu", "debug", "play", "ccxxccxxc", { "-=> [x]  go to farm", NULL } },
+
+  // Moving around the farm, selecting plots and running an action on them
+  { "farm", "debug", "farm", "ddssaawwc\nededeasasd\n\ncc\ne\n\n", { "No plots are available for watering.", "@(2, 3)", NULL } },
+
+  // Buying seeds in the shop
+  { "shop", "debug", "shop", "s\n5\nss\n3\nw\n2\n", { "You just (BOUGHT) an amount of (2) (BANANA) seeds.", "Gold:   35 ]", NULL } },
+};
+
+/**
+ * Adds a latency to the result.
+ *
+ * @param   {struct LatencyResult *}  this      The result.
+ * @param   {double}                  fLatency  The latency in seconds.
+*/
+void LatencyResult_add(struct LatencyResult *this, double fLatency) {
+  if(this->dLatencies == this->dCapacity) {
+    this->dCapacity = this->dCapacity ? this->dCapacity * 2 : 64;
+    this->fLatencyArray = UtilsMem_realloc(UTILS_MEM_MISC, this->fLatencyArray, this->dCapacity * sizeof(double));
+  }
+
+  this->fLatencyArray[this->dLatencies++] = fLatency;
+}
+
+/**
+ * Compares two latencies for qsort().
+ *
+ * @param   {const void *}  pFirst    The first latency.
+ * @param   {const void *}  pSecond   The second latency.
+ * @return  {int}                     Which one comes first.
+*/
+int LatencyResult_compare(const void *pFirst, const void *pSecond) {
+  double fFirst = *(const double *) pFirst;
+  double fSecond = *(const double *) pSecond;
+
+  return (fFirst > fSecond) - (fFirst < fSecond);
+}
+
+/**
+ * Returns a percentile of the latencies, by nearest rank.
+ * The latencies have to have been sorted already.
+ *
+ * @param   {struct LatencyResult *}  this        The result.
+ * @param   {double}                  fFraction   Which percentile, from 0 to 1.
+ * @return  {double}                              The latency in seconds.
+*/
+double LatencyResult_getPercentile(struct LatencyResult *this, double fFraction) {
+  int dRank = (int) (fFraction * this->dLatencies + 0.999999);
+
+  if(!this->dLatencies)
+    return 0;
+
+  if(dRank < 1) dRank = 1;
+  if(dRank > this->dLatencies) dRank = this->dLatencies;
+
+  return this->fLatencyArray[dRank - 1];
+}
+
+/**
+ * Reads whatever the game writes until the screen has been still for a while.
+ *
+ * @param   {struct Latency *}        this      The benchmark.
+ * @param   {struct LatencyPty *}     pPty      The game.
+ * @param   {struct LatencyScreen *}  pScreen   The screen.
+ * @param   {double}                  fStart    When the key was pressed.
+ * @param   {long *}                  pBytes    Gets the number of bytes that were read.
+ * @return  {double}                            The time from fStart to the last change, or -1 if nothing changed.
+*/
+double Latency_settle(struct Latency *this, struct LatencyPty *pPty, struct LatencyScreen *pScreen, double fStart, long *pBytes) {
+  double fLastByte = -1;
+  double fLastChange = -1;
+  int dRead;
+
+  *pBytes = 0;
+
+  // Wait for the first byte for as long as we're allowed, then only for the quiet period after the last one
+  do {
+    double fWait = fLastByte < 0 ?
+      fStart + this->fTimeout - LatencyPty_getTime() :
+      fLastByte + this->fQuiet - LatencyPty_getTime();
+    long dChanges = LatencyScreen_getChanges(pScreen);
+
+    dRead = LatencyPty_read(pPty, this->sBuffer, sizeof(this->sBuffer), fWait);
+
+    if(dRead > 0) {
+      fLastByte = LatencyPty_getTime();
+      *pBytes += dRead;
+
+      LatencyScreen_feed(pScreen, this->sBuffer, dRead);
+
+      if(LatencyScreen_getChanges(pScreen) != dChanges)
+        fLastChange = fLastByte;
+    }
+  } while(dRead > 0);
+
+  return fLastChange < 0 ? -1 : fLastChange - fStart;
+}
+
+/**
+ * Prints the screen, with a border so trailing spaces can be seen.
+ *
+ * @param   {struct LatencyScreen *}  pScreen   The screen.
+*/
+void Latency_printScreen(struct LatencyScreen *pScreen) {
+  for(int i = 0; i < pScreen->dRows; i++)
+    fprintf(stderr, "|%.*s|\n", pScreen->dCols, LatencyScreen_getRow(pScreen, i));
+}
+
+/**
+ * Plays a script once.
+ *
+ * @param   {struct Latency *}        this      The benchmark.
+ * @param   {struct LatencyScript *}  pScript   The script.
+ * @param   {struct LatencyResult *}  pResult   Where the numbers go.
+ * @return  {int}                               Whether or not the game could be started.
+*/
+int Latency_play(struct Latency *this, struct LatencyScript *pScript, struct LatencyResult *pResult) {
+  char *argv[] = { this->sGame, pScript->sMode, pScript->sScene, "0", NULL };
+  struct LatencyPty pty;
+  struct LatencyScreen *pScreen;
+  int bIsCorrect = 1;
+  long dBytes;
+
+  if(!LatencyPty_spawn(&pty, argv, this->dHeight, this->dWidth)) {
+    LatencyPty_exit(&pty);
+    return 0;
+  }
+
+  pScreen = LatencyScreen_create(this->dHeight, this->dWidth);
+
+  // The first frame isn't a key, so it doesn't count
+  Latency_settle(this, &pty, pScreen, LatencyPty_getTime(), &dBytes);
+
+  for(char *pKey = pScript->sKeys; *pKey; pKey++) {
+    double fStart = LatencyPty_getTime();
+    double fLatency;
+
+    if(!LatencyPty_press(&pty, *pKey))
+      break;
+
+    fLatency = Latency_settle(this, &pty, pScreen, fStart, &dBytes);
+
+    pResult->dKeys++;
+    pResult->dBytes += dBytes;
+
+    if(fLatency < 0) pResult->dSilent++;
+    else LatencyResult_add(pResult, fLatency);
+  }
+
+  // Make sure the game ended up where it should have
+  for(int i = 0; i < LATENCY_MAX_EXPECTS && pScript->sExpectArray[i] != NULL; i++) {
+    if(!LatencyScreen_contains(pScreen, pScript->sExpectArray[i])) {
+      fprintf(stderr, "%s: the screen doesn't say \"%s\".\n", pScript->sName, pScript->sExpectArray[i]);
+      bIsCorrect = 0;
+    }
+  }
+
+  if(this->bVerbose || !bIsCorrect)
+    Latency_printScreen(pScreen);
+
+  pResult->dFailures += !bIsCorrect;
+  pResult->dUnknown += LatencyScreen_getUnknown(pScreen);
+
+  LatencyScreen_kill(pScreen);
+  LatencyPty_exit(&pty);
+
+  return 1;
+}
+
+/**
+ * Prints a line of the table.
+ *
+ * @param   {struct LatencyScript *}  pScript   The script.
+ * @param   {struct LatencyResult *}  pResult   Its numbers.
+*/
+void Latency_printResult(struct LatencyScript *pScript, struct LatencyResult *pResult) {
+  qsort(pResult->fLatencyArray, pResult->dLatencies, sizeof(double), LatencyResult_compare);
+
+  printf("%-8s %6ld %6ld %9.3f %9.3f %9.3f %9.3f %11.0f %8ld  %s\n", pScript->sName,
+    pResult->dKeys, pResult->dSilent,
+    LatencyResult_getPercentile(pResult, 0.50) * 1000,
+    LatencyResult_getPercentile(pResult, 0.95) * 1000,
+    LatencyResult_getPercentile(pResult, 0.99) * 1000,
+    LatencyResult_getPercentile(pResult, 1.00) * 1000,
+    pResult->dKeys ? (double) pResult->dBytes / pResult->dKeys : 0,
+    pResult->dUnknown, pResult->dFailures ? "FAIL" : "ok");
+}
+
+int main(int argc, char *argv[]) {
+  static struct Latency latency;
+  int dScripts = sizeof(latencyScriptArray) / sizeof(latencyScriptArray[0]);
+  char *sScript = NULL;
+  int bHasFailed = 0;
+
+  latency.sGame = LATENCY_DEFAULT_GAME;
+  latency.dRuns = LATENCY_DEFAULT_RUNS;
+  latency.fQuiet = LATENCY_DEFAULT_QUIET / 1000.0;
+  latency.fTimeout = LATENCY_DEFAULT_TIMEOUT / 1000.0;
+  latency.dWidth = LATENCY_DEFAULT_WIDTH;
+  latency.dHeight = LATENCY_DEFAULT_HEIGHT;
+
+  // Read the args
+  for(int i = 1; i + 1 < argc; i += 2) {
+    if(!strcmp(argv[i], "-b")) latency.sGame = argv[i + 1];
+    else if(!strcmp(argv[i], "-s")) sScript = argv[i + 1];
+    else if(!strcmp(argv[i], "-r")) latency.dRuns = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-q")) latency.fQuiet = atoi(argv[i + 1]) / 1000.0;
+    else if(!strcmp(argv[i], "-t")) latency.fTimeout = atoi(argv[i + 1]) / 1000.0;
+    else if(!strcmp(argv[i], "-w")) latency.dWidth = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-h")) latency.dHeight = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-v")) latency.bVerbose = atoi(argv[i + 1]);
+    else {
+      fprintf(stderr, "Unknown option %s.\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if(latency.dRuns < 1) latency.dRuns = 1;
+  if(latency.dWidth < 20) latency.dWidth = 20;
+  if(latency.dHeight < 10) latency.dHeight = 10;
+
+  if(access(latency.sGame, X_OK)) {
+    fprintf(stderr, "Couldn't find the game at %s; run ./main once to build it.\n", latency.sGame);
+    return 1;
+  }
+
+  UtilsMem_init();
+
+  printf("%-8s %6s %6s %9s %9s %9s %9s %11s %8s  %s\n",
+    "script", "keys", "silent", "p50 ms", "p95 ms", "p99 ms", "max ms", "bytes/key", "unknown", "check");
+
+  for(int i = 0; i < dScripts; i++) {
+    struct LatencyResult result = { 0 };
+
+    if(sScript != NULL && strcmp(sScript, latencyScriptArray[i].sName))
+      continue;
+
+    for(int j = 0; j < latency.dRuns; j++) {
+      if(!Latency_play(&latency, &latencyScriptArray[i], &result)) {
+        fprintf(stderr, "Couldn't start %s in a pseudo-terminal.\n", latency.sGame);
+        return 1;
+      }
+    }
+
+    Latency_printResult(&latencyScriptArray[i], &result);
+    bHasFailed |= result.dFailures > 0;
+
+    UtilsMem_free(result.fLatencyArray);
+  }
+
+  return bHasFailed;
+}
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * Runs a program inside a pseudo-terminal so it thinks a person is sitting in front of it.
+ * The game only draws properly when stdin is a terminal (it asks it for its size and turns echo off), so a pipe won't do.
+ * This is POSIX only; Windows has ConPTY, but I don't have a Windows machine to try it on.
+*/
+
+#ifndef LATENCY_PTY_
+#define LATENCY_PTY_
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * The program and our end of its terminal.
+*/
+struct LatencyPty {
+  int dMaster;        // What we read the program's output from and write its keys to
+  pid_t dPid;
+};
+
+/**
+ * Returns the time in seconds, for measuring latency.
+ *
+ * @return  {double}  A monotonic timestamp.
+*/
+double LatencyPty_getTime() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Starts a program inside a new terminal of the given size.
+ *
+ * @param   {struct LatencyPty *}   this    Where to keep track of the program.
+ * @param   {char **}               argv    The program and its args, ending with NULL.
+ * @param   {int}                   dRows   The height of the terminal.
+ * @param   {int}                   dCols   The width of the terminal.
+ * @return  {int}                           Whether or not the program could be started.
+*/
+int LatencyPty_spawn(struct LatencyPty *this, char **argv, int dRows, int dCols) {
+  struct winsize windowSize = { dRows, dCols, 0, 0 };
+  char *sSlave;
+
+  this->dMaster = posix_openpt(O_RDWR | O_NOCTTY);
+  this->dPid = -1;
+
+  if(this->dMaster < 0 || grantpt(this->dMaster) || unlockpt(this->dMaster) || (sSlave = ptsname(this->dMaster)) == NULL)
+    return 0;
+
+  // The size has to be there before the program asks for it
+  ioctl(this->dMaster, TIOCSWINSZ, &windowSize);
+
+  this->dPid = fork();
+
+  if(this->dPid < 0)
+    return 0;
+
+  // The child gets its own session, so the terminal it opens first becomes its controlling terminal
+  if(this->dPid == 0) {
+    int dSlave;
+
+    setsid();
+    dSlave = open(sSlave, O_RDWR);
+
+    if(dSlave < 0)
+      _exit(127);
+
+    dup2(dSlave, STDIN_FILENO);
+    dup2(dSlave, STDOUT_FILENO);
+    dup2(dSlave, STDERR_FILENO);
+    close(dSlave);
+    close(this->dMaster);
+
+    execv(argv[0], argv);
+    _exit(127);
+  }
+
+  return 1;
+}
+
+/**
+ * Presses a key.
+ *
+ * @param   {struct LatencyPty *}   this  The program.
+ * @param   {char}                  cKey  The key.
+ * @return  {int}                         Whether or not it went through.
+*/
+int LatencyPty_press(struct LatencyPty *this, char cKey) {
+  return write(this->dMaster, &cKey, 1) == 1;
+}
+
+/**
+ * Waits a while for the program to write something.
+ *
+ * @param   {struct LatencyPty *}   this      The program.
+ * @param   {char *}                sBuffer   Where to put what it wrote.
+ * @param   {int}                   dSize     How much fits in the buffer.
+ * @param   {double}                fWait     How long to wait in seconds.
+ * @return  {int}                             How much was read, 0 if the wait ran out, or -1 once the program is gone.
+*/
+int LatencyPty_read(struct LatencyPty *this, char *sBuffer, int dSize, double fWait) {
+  struct timeval timeout;
+  fd_set readSet;
+  int dRead;
+
+  if(fWait < 0)
+    fWait = 0;
+
+  timeout.tv_sec = (long) fWait;
+  timeout.tv_usec = (long) ((fWait - timeout.tv_sec) * 1e6);
+
+  FD_ZERO(&readSet);
+  FD_SET(this->dMaster, &readSet);
+
+  if(select(this->dMaster + 1, &readSet, NULL, NULL, &timeout) <= 0)
+    return 0;
+
+  // Linux says EIO instead of 0 once the other end of the terminal has been closed
+  dRead = read(this->dMaster, sBuffer, dSize);
+
+  return dRead > 0 ? dRead : -1;
+}
+
+/**
+ * Stops the program and closes the terminal.
+ *
+ * @param   {struct LatencyPty *}   this  The program.
+*/
+void LatencyPty_exit(struct LatencyPty *this) {
+  if(this->dPid > 0) {
+    kill(this->dPid, SIGTERM);
+    waitpid(this->dPid, NULL, 0);
+  }
+
+  if(this->dMaster >= 0)
+    close(this->dMaster);
+}
+
+#endif
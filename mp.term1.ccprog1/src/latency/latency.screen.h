@@ -0,0 +1,348 @@
+/**
+ * A tiny model of a VT100 screen, just big enough to follow what the game writes.
+ * Bytes can be fed in whatever chunks they arrive in; an escape sequence cut in half by a read just continues with the next one.
+ * It only knows printable ASCII, CR, LF, BS and the CSI sequences for moving the cursor, erasing and colors (which it skips).
+ * That's all UtilsIO and UtilsUI ever send, so anything else is counted so we notice when that changes.
+*/
+
+#ifndef LATENCY_SCREEN_
+#define LATENCY_SCREEN_
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../utils/utils.mem.h"
+
+#define LATENCY_SCREEN_MAX_PARAMS 16
+
+/**
+ * Where the parser is inside an escape sequence.
+*/
+enum LatencyScreenState {
+  LATENCY_SCREEN_TEXT,              // Plain text
+  LATENCY_SCREEN_ESCAPE,            // Right after ESC
+  LATENCY_SCREEN_CSI,               // Inside ESC [
+};
+
+/**
+ * The screen.
+*/
+struct LatencyScreen {
+  char *sCellArray;                 // dRows * dCols characters, row by row
+  int dRows;
+  int dCols;
+
+  int dRow;                         // The cursor
+  int dCol;
+  int bWrapPending;                 // Like xterm, writing the last column only wraps on the next character
+
+  enum LatencyScreenState eState;
+  int dParamArray[LATENCY_SCREEN_MAX_PARAMS];
+  int dParams;
+
+  long dChanges;                    // How many cells were actually changed so far
+  long dUnknown;                    // Sequences and control characters we didn't understand
+};
+
+/**
+ * Allocates memory for a screen.
+ *
+ * @return  {struct LatencyScreen *}  A pointer to the allocated memory.
+*/
+struct LatencyScreen *LatencyScreen_new() {
+  struct LatencyScreen *pLatencyScreen = UtilsMem_calloc(UTILS_MEM_MISC, 1, sizeof(*pLatencyScreen));
+  return pLatencyScreen;
+}
+
+/**
+ * Initializes a blank screen with the cursor at the top left.
+ *
+ * @param   {struct LatencyScreen *}  this    The screen.
+ * @param   {int}                     dRows   The number of lines.
+ * @param   {int}                     dCols   The number of characters per line.
+*/
+void LatencyScreen_init(struct LatencyScreen *this, int dRows, int dCols) {
+  this->dRows = dRows;
+  this->dCols = dCols;
+  this->sCellArray = UtilsMem_calloc(UTILS_MEM_MISC, dRows * dCols, sizeof(char));
+  memset(this->sCellArray, ' ', dRows * dCols);
+
+  this->dRow = 0;
+  this->dCol = 0;
+  this->bWrapPending = 0;
+
+  this->eState = LATENCY_SCREEN_TEXT;
+  this->dParams = 0;
+
+  this->dChanges = 0;
+  this->dUnknown = 0;
+}
+
+/**
+ * Creates an initialized screen.
+ *
+ * @param   {int}                     dRows   The number of lines.
+ * @param   {int}                     dCols   The number of characters per line.
+ * @return  {struct LatencyScreen *}          The screen.
+*/
+struct LatencyScreen *LatencyScreen_create(int dRows, int dCols) {
+  struct LatencyScreen *pLatencyScreen = LatencyScreen_new();
+  LatencyScreen_init(pLatencyScreen, dRows, dCols);
+
+  return pLatencyScreen;
+}
+
+/**
+ * Deallocates the memory of the screen.
+ *
+ * @param   {struct LatencyScreen *}  this  The screen to kill.
+*/
+void LatencyScreen_kill(struct LatencyScreen *this) {
+  UtilsMem_free(this->sCellArray);
+  UtilsMem_free(this);
+}
+
+/**
+ * Returns the number of cells that have changed since the screen was made.
+ * Comparing this before and after a read tells us whether the read did anything we could see.
+ *
+ * @param   {struct LatencyScreen *}  this  The screen.
+ * @return  {long}                          The number of changes.
+*/
+long LatencyScreen_getChanges(struct LatencyScreen *this) {
+  return this->dChanges;
+}
+
+/**
+ * Returns how many things we didn't understand.
+ *
+ * @param   {struct LatencyScreen *}  this  The screen.
+ * @return  {long}                          The number of unknown sequences.
+*/
+long LatencyScreen_getUnknown(struct LatencyScreen *this) {
+  return this->dUnknown;
+}
+
+/**
+ * Returns one line of the screen.
+ * Note that it isn't null terminated; it's always exactly dCols characters long.
+ *
+ * @param   {struct LatencyScreen *}  this  The screen.
+ * @param   {int}                     dRow  The line.
+ * @return  {char *}                        The characters of the line.
+*/
+char *LatencyScreen_getRow(struct LatencyScreen *this, int dRow) {
+  return this->sCellArray + dRow * this->dCols;
+}
+
+/**
+ * Returns whether or not some text shows up anywhere on the screen.
+ * Text can't span two lines, which is fine since nothing we look for ever does.
+ *
+ * @param   {struct LatencyScreen *}  this    The screen.
+ * @param   {char *}                  sText   What to look for.
+ * @return  {int}                             Whether or not it's there.
+*/
+int LatencyScreen_contains(struct LatencyScreen *this, char *sText) {
+  int dLength = strlen(sText);
+
+  for(int i = 0; i < this->dRows; i++) {
+    char *sRow = LatencyScreen_getRow(this, i);
+
+    for(int j = 0; j + dLength <= this->dCols; j++)
+      if(!memcmp(sRow + j, sText, dLength))
+        return 1;
+  }
+
+  return 0;
+}
+
+/**
+ * Blanks out part of the screen, counting the cells that weren't blank yet.
+ *
+ * @param   {struct LatencyScreen *}  this    The screen.
+ * @param   {int}                     dStart  The first cell (counted row by row).
+ * @param   {int}                     dEnd    One past the last cell.
+*/
+void LatencyScreen_erase(struct LatencyScreen *this, int dStart, int dEnd) {
+  for(int i = dStart; i < dEnd; i++) {
+    if(this->sCellArray[i] != ' ') {
+      this->sCellArray[i] = ' ';
+      this->dChanges++;
+    }
+  }
+}
+
+/**
+ * Moves the cursor down a line, scrolling everything up when it's already at the bottom.
+ *
+ * @param   {struct LatencyScreen *}  this  The screen.
+*/
+void LatencyScreen_lineFeed(struct LatencyScreen *this) {
+  int dSize = this->dRows * this->dCols;
+
+  if(this->dRow < this->dRows - 1) {
+    this->dRow++;
+    return;
+  }
+
+  // Scrolling changes the whole screen as far as we're concerned
+  memmove(this->sCellArray, this->sCellArray + this->dCols, dSize - this->dCols);
+  memset(this->sCellArray + dSize - this->dCols, ' ', this->dCols);
+  this->dChanges += dSize;
+}
+
+/**
+ * Writes a character where the cursor is and moves it along.
+ *
+ * @param   {struct LatencyScreen *}  this  The screen.
+ * @param   {char}                    c     The character.
+*/
+void LatencyScreen_put(struct LatencyScreen *this, char c) {
+  char *pCell;
+
+  if(this->bWrapPending) {
+    this->bWrapPending = 0;
+    this->dCol = 0;
+    LatencyScreen_lineFeed(this);
+  }
+
+  pCell = &this->sCellArray[this->dRow * this->dCols + this->dCol];
+
+  if(*pCell != c) {
+    *pCell = c;
+    this->dChanges++;
+  }
+
+  if(this->dCol < this->dCols - 1)
+    this->dCol++;
+  else
+    this->bWrapPending = 1;
+}
+
+/**
+ * Keeps the cursor inside the screen.
+ *
+ * @param   {struct LatencyScreen *}  this  The screen.
+*/
+void LatencyScreen_clampCursor(struct LatencyScreen *this) {
+  if(this->dRow < 0) this->dRow = 0;
+  if(this->dCol < 0) this->dCol = 0;
+  if(this->dRow >= this->dRows) this->dRow = this->dRows - 1;
+  if(this->dCol >= this->dCols) this->dCol = this->dCols - 1;
+
+  this->bWrapPending = 0;
+}
+
+/**
+ * Does whatever a finished CSI sequence asks for.
+ * Missing params count as 0, and the cursor functions treat 0 as 1 like a real terminal would.
+ *
+ * @param   {struct LatencyScreen *}  this    The screen.
+ * @param   {char}                    cFinal  The letter that ended the sequence.
+*/
+void LatencyScreen_runCSI(struct LatencyScreen *this, char cFinal) {
+  int dFirst = this->dParams ? this->dParamArray[0] : 0;
+  int dSecond = this->dParams > 1 ? this->dParamArray[1] : 0;
+  int dCount = dFirst ? dFirst : 1;
+  int dCursor = this->dRow * this->dCols + this->dCol;
+  int dSize = this->dRows * this->dCols;
+
+  switch(cFinal) {
+
+    // Cursor position (rows and columns start at 1)
+    case 'H': case 'f':
+      this->dRow = (dFirst ? dFirst : 1) - 1;
+      this->dCol = (dSecond ? dSecond : 1) - 1;
+      LatencyScreen_clampCursor(this);
+    break;
+
+    // Cursor up, down, forward, back
+    case 'A': this->dRow -= dCount; LatencyScreen_clampCursor(this); break;
+    case 'B': this->dRow += dCount; LatencyScreen_clampCursor(this); break;
+    case 'C': this->dCol += dCount; LatencyScreen_clampCursor(this); break;
+    case 'D': this->dCol -= dCount; LatencyScreen_clampCursor(this); break;
+
+    // Erase in display: 0 after the cursor, 1 before it, 2 everything, 3 the scrollback (which we don't have)
+    case 'J':
+      if(dFirst == 0) LatencyScreen_erase(this, dCursor, dSize);
+      else if(dFirst == 1) LatencyScreen_erase(this, 0, dCursor + 1);
+      else if(dFirst == 2) LatencyScreen_erase(this, 0, dSize);
+    break;
+
+    // Erase in line, same deal
+    case 'K':
+      if(dFirst == 0) LatencyScreen_erase(this, dCursor, dCursor - this->dCol + this->dCols);
+      else if(dFirst == 1) LatencyScreen_erase(this, dCursor - this->dCol, dCursor + 1);
+      else if(dFirst == 2) LatencyScreen_erase(this, dCursor - this->dCol, dCursor - this->dCol + this->dCols);
+    break;
+
+    // Colors don't change any characters
+    case 'm':
+    break;
+
+    default:
+      this->dUnknown++;
+    break;
+  }
+}
+
+/**
+ * Feeds bytes from the program into the screen.
+ *
+ * @param   {struct LatencyScreen *}  this      The screen.
+ * @param   {char *}                  sBytes    What the program wrote.
+ * @param   {int}                     dLength   How many bytes there are.
+*/
+void LatencyScreen_feed(struct LatencyScreen *this, char *sBytes, int dLength) {
+  for(int i = 0; i < dLength; i++) {
+    char c = sBytes[i];
+
+    switch(this->eState) {
+      case LATENCY_SCREEN_TEXT:
+        if(c == '\x1b') this->eState = LATENCY_SCREEN_ESCAPE;
+        else if(c == '\r') this->dCol = 0, this->bWrapPending = 0;
+        else if(c == '\n') this->bWrapPending = 0, LatencyScreen_lineFeed(this);
+        else if(c == '\b') this->dCol -= this->dCol > 0, this->bWrapPending = 0;
+        else if(c >= ' ' && c <= '~') LatencyScreen_put(this, c);
+        else this->dUnknown++;
+      break;
+
+      case LATENCY_SCREEN_ESCAPE:
+        if(c == '[') {
+          this->eState = LATENCY_SCREEN_CSI;
+          this->dParams = 0;
+        } else {
+          this->eState = LATENCY_SCREEN_TEXT;
+          this->dUnknown++;
+        }
+      break;
+
+      case LATENCY_SCREEN_CSI:
+
+        // The first digit starts a param; every ; starts another one
+        if(c >= '0' && c <= '9') {
+          if(!this->dParams)
+            this->dParamArray[this->dParams++] = 0;
+
+          this->dParamArray[this->dParams - 1] = this->dParamArray[this->dParams - 1] * 10 + c - '0';
+        } else if(c == ';') {
+          if(!this->dParams)
+            this->dParamArray[this->dParams++] = 0;
+
+          if(this->dParams < LATENCY_SCREEN_MAX_PARAMS)
+            this->dParamArray[this->dParams++] = 0;
+
+        // Private markers like ? don't matter to us
+        } else if(c >= '<' && c <= '?') {
+
+        } else {
+          LatencyScreen_runCSI(this, c);
+          this->eState = LATENCY_SCREEN_TEXT;
+        }
+      break;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,479 @@
+/**
+ * The exact planner for the economy of Harvest Sun.
+ * It finds the schedule of watering, harvesting, tilling and sowing that ends a fixed number of days with the most gold,
+ * by trying every day's options and remembering the best result of every state it has already seen (see plan/plan.model.h).
+ * Plots of the same crop at the same stage are lumped together, which is the only reason this is tractable at all;
+ * even so, the number of states grows fast with the size of the farm and the number of days, so keep them small.
+ *
+ * Build (main.c does this for you with "./main plan"):
+ *    gcc src/plan.c -o build/plan.unix.o -std=c99 -Wall -O2
+ *
+ * Usage:
+ *    build/plan.unix.o [-w width] [-h height] [-d days] [-g gold] [-e energy] [-b breakfast]
+ *
+ * The plan is printed day by day, followed by how long the solve took and how many states it went through.
+*/
+
+// We need clock_gettime() from POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "utils/utils.mem.h"
+
+#include "sim/sim.setting.h"
+
+#include "plan/plan.model.h"
+#include "plan/plan.table.h"
+
+#define PLAN_DEFAULT_WIDTH 3
+#define PLAN_DEFAULT_HEIGHT 2
+#define PLAN_DEFAULT_DAYS 10
+
+// Worse than any amount of gold
+#define PLAN_DEAD (-1000000000)
+
+/**
+ * The solver.
+*/
+struct Plan {
+  struct PlanModel model;
+  struct PlanTable *pTable;
+
+  long dDecisions;      // How many full days were tried
+  int bRoomy;           // Whether or not there's always enough energy to do everything
+};
+
+/**
+ * The options of a day that's being put together.
+ * The stage functions below fill in the decision one part at a time, keeping track of what's left to spend.
+*/
+struct PlanDay {
+  struct PlanState *pState;
+  struct PlanDecision decision;
+
+  int dCountArray[PLAN_MAX_STAGES];   // The plots as the day goes on
+  int dEnergy;
+  int dGold;
+  int dUntilled;
+  int dTilled;
+
+  int dBest;
+  struct PlanDecision best;
+};
+
+int Plan_solve(struct Plan *this, struct PlanState *pState);
+
+/**
+ * Tells whether or not a plot at a given stage can still be harvested before the plan ends.
+ * Watering or sowing anything that can't is a waste of energy (and gold), so the solver doesn't bother.
+ *
+ * @param   {struct Plan *}     this    The solver.
+ * @param   {struct PlanDay *}  pDay    The day.
+ * @param   {enum ProductType}  eCrop   The crop.
+ * @param   {int}               dWater  How much water the plot has had.
+ * @return  {int}                       Whether or not there's time.
+*/
+int Plan_canRipen(struct Plan *this, struct PlanDay *pDay, enum ProductType eCrop, int dWater) {
+  return pDay->pState->dDay + this->model.dWaterReqArray[eCrop] - dWater <= this->model.dDays;
+}
+
+/**
+ * Returns the fewest plots worth trying for one of the free actions.
+ * When the energy can't run out, watering and tilling everything we can is never worse than doing less,
+ * since a plot that's further along (or already tilled) can always just wait.
+ * Harvesting isn't like that: the gold is spent on breakfast whether we like it or not, and a few hungry nights are free,
+ * so sometimes it pays to leave ready crops in the ground. That one always gets the full search, and so does sowing.
+ *
+ * @param   {struct Plan *}   this    The solver.
+ * @param   {int}             dMost   The most plots that could be done.
+ * @return  {int}                     Where to start counting from.
+*/
+int Plan_getLeast(struct Plan *this, int dMost) {
+  return this->bRoomy ? dMost : 0;
+}
+
+/**
+ * #####################
+ * ###  DAY OPTIONS  ###
+ * #####################
+*/
+
+/**
+ * Tries the day that was put together and keeps it if it's the best so far.
+ *
+ * @param   {struct Plan *}     this  The solver.
+ * @param   {struct PlanDay *}  pDay  The day.
+*/
+void Plan_tryDay(struct Plan *this, struct PlanDay *pDay) {
+  struct PlanState next;
+  int dValue = PLAN_DEAD;
+
+  this->dDecisions++;
+
+  if(PlanModel_apply(&this->model, pDay->pState, &pDay->decision, &next))
+    dValue = Plan_solve(this, &next);
+
+  if(dValue > pDay->dBest) {
+    pDay->dBest = dValue;
+    pDay->best = pDay->decision;
+  }
+}
+
+/**
+ * Tries watering some of the freshly sown plots of each crop.
+ *
+ * @param   {struct Plan *}     this    The solver.
+ * @param   {struct PlanDay *}  pDay    The day.
+ * @param   {int}               dCrop   The crop to decide on.
+*/
+void Plan_tryFresh(struct Plan *this, struct PlanDay *pDay, int dCrop) {
+  int dMost;
+
+  if(dCrop >= this->model.pCatalogue->dSize) {
+    Plan_tryDay(this, pDay);
+    return;
+  }
+
+  dMost = pDay->decision.dSowArray[dCrop] < pDay->dEnergy ? pDay->decision.dSowArray[dCrop] : pDay->dEnergy;
+
+  for(int i = Plan_getLeast(this, dMost); i <= dMost; i++) {
+    pDay->decision.dFreshArray[dCrop] = i;
+    pDay->dEnergy -= i * PLAN_ENERGY_PER_PLOT;
+
+    Plan_tryFresh(this, pDay, dCrop + 1);
+
+    pDay->dEnergy += i * PLAN_ENERGY_PER_PLOT;
+  }
+
+  pDay->decision.dFreshArray[dCrop] = 0;
+}
+
+/**
+ * Tries sowing some of the tilled plots with each crop.
+ *
+ * @param   {struct Plan *}     this    The solver.
+ * @param   {struct PlanDay *}  pDay    The day.
+ * @param   {int}               dCrop   The crop to decide on.
+*/
+void Plan_trySow(struct Plan *this, struct PlanDay *pDay, int dCrop) {
+  int dMost;
+
+  if(dCrop >= this->model.pCatalogue->dSize) {
+    Plan_tryFresh(this, pDay, 1);
+    return;
+  }
+
+  // Seeds that can't grow in time are just thrown away gold
+  dMost = Plan_canRipen(this, pDay, dCrop, 0) ? pDay->dTilled : 0;
+  dMost = dMost < pDay->dEnergy ? dMost : pDay->dEnergy;
+
+  for(int i = 0; i <= dMost; i++) {
+    int dCost = PlanModel_getBuyPrice(&this->model, dCrop, i);
+
+    if(dCost > pDay->dGold)
+      break;
+
+    pDay->decision.dSowArray[dCrop] = i;
+    pDay->dTilled -= i;
+    pDay->dGold -= dCost;
+    pDay->dEnergy -= i * PLAN_ENERGY_PER_PLOT;
+
+    Plan_trySow(this, pDay, dCrop + 1);
+
+    pDay->dTilled += i;
+    pDay->dGold += dCost;
+    pDay->dEnergy += i * PLAN_ENERGY_PER_PLOT;
+  }
+
+  pDay->decision.dSowArray[dCrop] = 0;
+}
+
+/**
+ * Tries tilling some of the untilled plots.
+ *
+ * @param   {struct Plan *}     this  The solver.
+ * @param   {struct PlanDay *}  pDay  The day.
+*/
+void Plan_tryTill(struct Plan *this, struct PlanDay *pDay) {
+  int dMost = pDay->dUntilled < pDay->dEnergy ? pDay->dUntilled : pDay->dEnergy;
+  int bUseful = 0;
+
+  // Tilling only helps if something could still be sown and harvested
+  for(int i = 1; i < this->model.pCatalogue->dSize; i++)
+    bUseful |= Plan_canRipen(this, pDay, i, 0);
+
+  if(!bUseful)
+    dMost = 0;
+
+  for(int i = Plan_getLeast(this, dMost); i <= dMost; i++) {
+    pDay->decision.dTill = i;
+    pDay->dTilled += i;
+    pDay->dEnergy -= i * PLAN_ENERGY_PER_PLOT;
+
+    Plan_trySow(this, pDay, 1);
+
+    pDay->dTilled -= i;
+    pDay->dEnergy += i * PLAN_ENERGY_PER_PLOT;
+  }
+
+  pDay->decision.dTill = 0;
+}
+
+/**
+ * Tries harvesting (and selling) some of the ready plots of each crop.
+ *
+ * @param   {struct Plan *}     this    The solver.
+ * @param   {struct PlanDay *}  pDay    The day.
+ * @param   {int}               dCrop   The crop to decide on.
+*/
+void Plan_tryHarvest(struct Plan *this, struct PlanDay *pDay, int dCrop) {
+  int dReady, dMost;
+
+  if(dCrop >= this->model.pCatalogue->dSize) {
+    Plan_tryTill(this, pDay);
+    return;
+  }
+
+  dReady = this->model.dOffsetArray[dCrop] + this->model.dWaterReqArray[dCrop];
+  dMost = pDay->dCountArray[dReady] < pDay->dEnergy ? pDay->dCountArray[dReady] : pDay->dEnergy;
+
+  for(int i = 0; i <= dMost; i++) {
+    int dEarned = PlanModel_getSellPrice(&this->model, dCrop, i);
+
+    pDay->decision.dHarvestArray[dCrop] = i;
+    pDay->dCountArray[dReady] -= i;
+    pDay->dUntilled += i;
+    pDay->dGold += dEarned;
+    pDay->dEnergy -= i * PLAN_ENERGY_PER_PLOT;
+
+    Plan_tryHarvest(this, pDay, dCrop + 1);
+
+    pDay->dCountArray[dReady] += i;
+    pDay->dUntilled -= i;
+    pDay->dGold -= dEarned;
+    pDay->dEnergy += i * PLAN_ENERGY_PER_PLOT;
+  }
+
+  pDay->decision.dHarvestArray[dCrop] = 0;
+}
+
+/**
+ * Tries watering some of the plots that were already growing, one stage at a time.
+ * The limit comes from the counts at the start of the day, so a plot never gets watered twice.
+ *
+ * @param   {struct Plan *}     this    The solver.
+ * @param   {struct PlanDay *}  pDay    The day.
+ * @param   {int}               dCrop   The crop to decide on.
+ * @param   {int}               dWater  The stage of that crop to decide on.
+*/
+void Plan_tryWater(struct Plan *this, struct PlanDay *pDay, int dCrop, int dWater) {
+  struct PlanModel *pModel = &this->model;
+  int dStage, dMost;
+
+  if(dCrop >= pModel->pCatalogue->dSize) {
+    Plan_tryHarvest(this, pDay, 1);
+    return;
+  }
+
+  if(dWater > pModel->dWaterReqArray[dCrop]) {
+    Plan_tryWater(this, pDay, dCrop + 1, 0);
+    return;
+  }
+
+  dStage = pModel->dOffsetArray[dCrop] + dWater;
+  dMost = pDay->pState->dCountArray[dStage] < pDay->dEnergy ? pDay->pState->dCountArray[dStage] : pDay->dEnergy;
+
+  if(!pModel->bWaterableArray[dStage] || !Plan_canRipen(this, pDay, dCrop, dWater))
+    dMost = 0;
+
+  for(int i = Plan_getLeast(this, dMost); i <= dMost; i++) {
+    pDay->decision.dWaterArray[dStage] = i;
+    pDay->dCountArray[dStage] -= i;
+    pDay->dCountArray[pModel->dNextArray[dStage]] += i;
+    pDay->dEnergy -= i * PLAN_ENERGY_PER_PLOT;
+
+    Plan_tryWater(this, pDay, dCrop, dWater + 1);
+
+    pDay->dCountArray[dStage] += i;
+    pDay->dCountArray[pModel->dNextArray[dStage]] -= i;
+    pDay->dEnergy += i * PLAN_ENERGY_PER_PLOT;
+  }
+
+  pDay->decision.dWaterArray[dStage] = 0;
+}
+
+/**
+ * ####################
+ * ###  THE SOLVER  ###
+ * ####################
+*/
+
+/**
+ * Returns the most gold we can end the plan with from a given state.
+ * The best first day is kept in the memo so the plan can be read back out afterwards.
+ *
+ * @param   {struct Plan *}       this    The solver.
+ * @param   {struct PlanState *}  pState  The state at the start of a day.
+ * @return  {int}                         The most gold at the end, or PLAN_DEAD if every option starves.
+*/
+int Plan_solve(struct Plan *this, struct PlanState *pState) {
+  struct PlanModel *pModel = &this->model;
+  struct PlanDay day;
+  unsigned char keyArray[PLAN_MAX_STAGES + 8];
+  unsigned char bytesArray[PLAN_MAX_STAGES + 3 * CATALOGUE_SIZE + 1];
+  int dValue;
+
+  if(pState->dDay >= pModel->dDays)
+    return pState->dGold;
+
+  PlanModel_packState(pModel, pState, keyArray);
+
+  if(PlanTable_find(this->pTable, keyArray, &dValue) != NULL)
+    return dValue;
+
+  memset(&day, 0, sizeof(day));
+  memcpy(day.dCountArray, pState->dCountArray, sizeof(day.dCountArray));
+
+  day.pState = pState;
+  day.dEnergy = pModel->dEnergy;
+  day.dGold = pState->dGold;
+  day.dTilled = pState->dTilled;
+  day.dUntilled = pModel->dPlots - pState->dTilled - PlanModel_countSown(pModel, pState);
+  day.dBest = PLAN_DEAD - 1;
+
+  Plan_tryWater(this, &day, 1, 0);
+
+  PlanModel_packDecision(pModel, &day.best, bytesArray);
+  PlanTable_store(this->pTable, keyArray, day.dBest, bytesArray);
+
+  return day.dBest;
+}
+
+/**
+ * Prints the plan by following the best decisions from the start.
+ *
+ * @param   {struct Plan *}       this    The solver.
+ * @param   {struct PlanState *}  pStart  The state on the first day.
+*/
+void Plan_print(struct Plan *this, struct PlanState *pStart) {
+  struct PlanModel *pModel = &this->model;
+  struct PlanState state = *pStart;
+  struct PlanDecision decision;
+  unsigned char keyArray[PLAN_MAX_STAGES + 8];
+  unsigned char *pBytes;
+  int dValue;
+
+  while(state.dDay < pModel->dDays) {
+    struct PlanState next;
+    int bIsAlive;
+
+    PlanModel_packState(pModel, &state, keyArray);
+    pBytes = PlanTable_find(this->pTable, keyArray, &dValue);
+
+    if(pBytes == NULL || dValue <= PLAN_DEAD) {
+      printf("Day %d: there's no way to survive from here.\n", state.dDay + 1);
+      return;
+    }
+
+    PlanModel_unpackDecision(pModel, pBytes, &decision);
+
+    printf("Day %d (%d gold, %d sown, %d tilled)\n", state.dDay + 1,
+      state.dGold, PlanModel_countSown(pModel, &state), state.dTilled);
+    PlanModel_describe(pModel, &decision, stdout);
+
+    bIsAlive = PlanModel_apply(pModel, &state, &decision, &next);
+    printf("    go home: %d gold%s\n", next.dGold, next.dStarved ? ", hungry" : "");
+
+    if(!bIsAlive)
+      return;
+
+    state = next;
+  }
+
+  printf("Final gold: %d\n", state.dGold);
+}
+
+/**
+ * Returns the time in seconds, for timing the solve.
+ *
+ * @return  {double}  A monotonic timestamp.
+*/
+double Plan_getTime() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+  struct Plan plan;
+  struct SimSetting setting;
+  struct PlanState start;
+  int dDays = PLAN_DEFAULT_DAYS;
+  double fStart, fElapsed;
+  int dBest;
+
+  SimSetting_init(&setting, "default");
+  setting.dFarmWidth = PLAN_DEFAULT_WIDTH;
+  setting.dFarmHeight = PLAN_DEFAULT_HEIGHT;
+
+  // Read the args
+  for(int i = 1; i + 1 < argc; i += 2) {
+    if(!strcmp(argv[i], "-w")) setting.dFarmWidth = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-h")) setting.dFarmHeight = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-d")) dDays = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-g")) setting.dGold = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-e")) setting.dEnergy = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-b")) setting.dBreakfastCost = atoi(argv[i + 1]);
+    else {
+      fprintf(stderr, "Unknown option %s.\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if(setting.dFarmWidth < 1) setting.dFarmWidth = 1;
+  if(setting.dFarmHeight < 1) setting.dFarmHeight = 1;
+  if(dDays < 1) dDays = 1;
+  if(dDays > 255) dDays = 255;
+
+  if(!PlanModel_init(&plan.model, &setting.catalogue,
+    setting.dFarmWidth * setting.dFarmHeight, setting.dEnergy, setting.dBreakfastCost, dDays)) {
+    fprintf(stderr, "The farm is too big (or the crops too thirsty) to plan for.\n");
+    return 1;
+  }
+
+  plan.pTable = PlanTable_create(plan.model.dKeySize, plan.model.dDecisionSize);
+  plan.dDecisions = 0;
+
+  // Water, harvest, till and sow, plus watering the new ones, is the most a plot can take in a day
+  plan.bRoomy = setting.dEnergy >= 5 * PLAN_ENERGY_PER_PLOT * plan.model.dPlots;
+
+  PlanModel_start(&plan.model, &start, setting.dGold);
+
+  // Solve it
+  fStart = Plan_getTime();
+  dBest = Plan_solve(&plan, &start);
+  fElapsed = Plan_getTime() - fStart;
+
+  printf("%dx%d farm, %d days, %d gold, %d energy, breakfast for %d\n\n",
+    setting.dFarmWidth, setting.dFarmHeight, dDays, setting.dGold, setting.dEnergy, setting.dBreakfastCost);
+
+  if(dBest <= PLAN_DEAD)
+    printf("Every plan starves before day %d.\n", dDays);
+  else
+    Plan_print(&plan, &start);
+
+  fprintf(stderr, "\nSolved in %.3f s: %ld states explored, %ld days tried, %.0f states/s\n",
+    fElapsed, PlanTable_getCount(plan.pTable), plan.dDecisions, PlanTable_getCount(plan.pTable) / (fElapsed > 0 ? fElapsed : 1e-9));
+
+  // Garbage collection!
+  PlanTable_kill(plan.pTable);
+  PlanModel_exit(&plan.model);
+
+  return 0;
+}
@@ -0,0 +1,400 @@
+/**
+ * The rules of the farm economy, boiled down for the planner.
+ * Plots of the same crop with the same amount of water are interchangeable, so instead of remembering every plot,
+ * a state only remembers how many plots of each crop sit at each amount of water (plus the tilled ones, the gold,
+ * how long the player has gone hungry and what day it is). Energy isn't part of the state since it's refilled every night.
+ *
+ * A day is played in a fixed order, which doesn't lose anything:
+ *    1. water some of the crops that were already growing,
+ *    2. harvest some of the ready ones and sell them right away,
+ *    3. till some plots,
+ *    4. buy exactly the seeds we sow and sow them,
+ *    5. water some of the freshly sown ones,
+ *    6. go home.
+ * Prices never change, so selling later or buying earlier never helps; that's why there's no inventory in the state.
+ *
+ * None of the numbers are hard-coded here; watering goes through Product_water(), prices through the Stock_* functions
+ * and the night through Player_goHome(), so the planner plays by whatever the game does.
+*/
+
+#ifndef PLAN_MODEL
+#define PLAN_MODEL
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../utils/utils.mem.h"
+
+#include "../game/game.catalogue.h"
+#include "../game/classes/game.class.product.h"
+#include "../game/classes/game.class.stock.h"
+#include "../game/objects/game.obj.player.h"
+
+#define PLAN_MAX_STAGES 64
+#define PLAN_MAX_PLOTS 255        // Counts are stored in a byte
+#define PLAN_STOCK_AMOUNT (1 << 24)
+
+// Every farm action costs a point of energy per plot (see Player_tillPlots() and friends)
+#define PLAN_ENERGY_PER_PLOT 1
+
+/**
+ * The farm and the player at the start of a day.
+ * The stages of crop c are dCountArray[dOffsetArray[c]] (no water yet) up to dCountArray[dOffsetArray[c] + water needed] (ready).
+*/
+struct PlanState {
+  int dCountArray[PLAN_MAX_STAGES];
+  int dTilled;
+  int dStarved;
+  int dGold;
+  int dDay;
+};
+
+/**
+ * What to do on a single day.
+*/
+struct PlanDecision {
+  int dWaterArray[PLAN_MAX_STAGES];       // How many of the growing plots to water, per stage
+  int dHarvestArray[CATALOGUE_SIZE];      // How many ready plots to harvest (and sell), per crop
+  int dTill;
+  int dSowArray[CATALOGUE_SIZE];          // How many seeds to buy and sow, per crop
+  int dFreshArray[CATALOGUE_SIZE];        // How many of those to water right away, per crop
+};
+
+/**
+ * The rules, read off the game objects once so the solver doesn't have to.
+*/
+struct PlanModel {
+  struct GameCatalogue *pCatalogue;
+
+  int dPlots;
+  int dEnergy;
+  int dDays;
+
+  int dStages;
+  int dOffsetArray[CATALOGUE_SIZE];
+  int dWaterReqArray[CATALOGUE_SIZE];
+
+  int dNextArray[PLAN_MAX_STAGES];        // Where a plot goes when it's watered
+  int bWaterableArray[PLAN_MAX_STAGES];
+  int bReadyArray[PLAN_MAX_STAGES];
+
+  struct Stock *pSeedStockArray[CATALOGUE_SIZE];
+  struct Stock *pCropStockArray[CATALOGUE_SIZE];
+  struct Player *pPlayer;                 // A scratch player for the nights
+
+  int dKeySize;
+  int dDecisionSize;
+};
+
+/**
+ * ############################
+ * ###  MODEL CONSTRUCTION  ###
+ * ############################
+*/
+
+/**
+ * Reads the rules off the game objects.
+ *
+ * @param   {struct PlanModel *}      this            The model to initialize.
+ * @param   {struct GameCatalogue *}  pCatalogue      The crops.
+ * @param   {int}                     dPlots          How many plots the farm has.
+ * @param   {int}                     dEnergy         The energy the player wakes up with.
+ * @param   {int}                     dBreakfastCost  What breakfast costs.
+ * @param   {int}                     dDays           How many days to plan for.
+ * @return  {int}                                     Whether or not the model fits in a state.
+*/
+int PlanModel_init(struct PlanModel *this, struct GameCatalogue *pCatalogue, int dPlots, int dEnergy, int dBreakfastCost, int dDays) {
+  this->pCatalogue = pCatalogue;
+  this->dPlots = dPlots;
+  this->dEnergy = dEnergy;
+  this->dDays = dDays;
+  this->dStages = 0;
+
+  if(dPlots > PLAN_MAX_PLOTS)
+    return 0;
+
+  for(int i = 1; i < pCatalogue->dSize; i++) {
+    struct Product *pProduct = Product_create(i, pCatalogue, 0);
+    int dWaterReq = Product_getWaterReq(pProduct);
+
+    if(this->dStages + dWaterReq + 1 > PLAN_MAX_STAGES) {
+      Product_kill(pProduct);
+      return 0;
+    }
+
+    this->dOffsetArray[i] = this->dStages;
+    this->dWaterReqArray[i] = dWaterReq;
+
+    // Water a template crop from every stage and see where it ends up
+    for(int j = 0; j <= dWaterReq; j++) {
+      int dStage = this->dStages + j;
+
+      pProduct->dWaterAmt = j;
+      pProduct->dLastWatered = -1;
+
+      this->bReadyArray[dStage] = Product_getState(pProduct) == 2;
+      this->bWaterableArray[dStage] = Product_getState(pProduct) < 2 && Product_water(pProduct, 0);
+      this->dNextArray[dStage] = this->dStages + Product_getWaterAmt(pProduct);
+    }
+
+    this->dStages += dWaterReq + 1;
+
+    this->pSeedStockArray[i] = Stock_create(i, pCatalogue, PLAN_STOCK_AMOUNT);
+    this->pCropStockArray[i] = Stock_create(i, pCatalogue, PLAN_STOCK_AMOUNT);
+
+    Product_kill(pProduct);
+  }
+
+  this->pPlayer = Player_create(0, dEnergy, dEnergy, pCatalogue);
+  Player_setBreakfastCost(this->pPlayer, dBreakfastCost);
+
+  // Counts, tilled, starved and day take a byte each; the gold takes four
+  this->dKeySize = this->dStages + 3 + 4;
+  this->dDecisionSize = this->dStages + 3 * (pCatalogue->dSize - 1) + 1;
+
+  return 1;
+}
+
+/**
+ * Frees the objects of the model.
+ *
+ * @param   {struct PlanModel *}  this  The model to clean up.
+*/
+void PlanModel_exit(struct PlanModel *this) {
+  for(int i = 1; i < this->pCatalogue->dSize; i++) {
+    Stock_kill(this->pSeedStockArray[i]);
+    Stock_kill(this->pCropStockArray[i]);
+  }
+
+  Player_kill(this->pPlayer);
+}
+
+/**
+ * Sets up the state of a fresh game.
+ *
+ * @param   {struct PlanModel *}  this    The model.
+ * @param   {struct PlanState *}  pState  The state to fill in.
+ * @param   {int}                 dGold   The starting gold.
+*/
+void PlanModel_start(struct PlanModel *this, struct PlanState *pState, int dGold) {
+  memset(pState, 0, sizeof(*pState));
+  pState->dGold = dGold;
+}
+
+/**
+ * #######################
+ * ###  MODEL PACKING  ###
+ * #######################
+*/
+
+/**
+ * Squeezes a state into the bytes the memo uses as a key.
+ *
+ * @param   {struct PlanModel *}  this    The model.
+ * @param   {struct PlanState *}  pState  The state.
+ * @param   {unsigned char *}     pKey    Where to put the dKeySize bytes.
+*/
+void PlanModel_packState(struct PlanModel *this, struct PlanState *pState, unsigned char *pKey) {
+  int32_t dGold = pState->dGold;
+
+  for(int i = 0; i < this->dStages; i++)
+    *pKey++ = pState->dCountArray[i];
+
+  *pKey++ = pState->dTilled;
+  *pKey++ = pState->dStarved;
+  *pKey++ = pState->dDay;
+  memcpy(pKey, &dGold, sizeof(dGold));
+}
+
+/**
+ * Squeezes a decision into bytes.
+ *
+ * @param   {struct PlanModel *}      this        The model.
+ * @param   {struct PlanDecision *}   pDecision   The decision.
+ * @param   {unsigned char *}         pBytes      Where to put the dDecisionSize bytes.
+*/
+void PlanModel_packDecision(struct PlanModel *this, struct PlanDecision *pDecision, unsigned char *pBytes) {
+  for(int i = 0; i < this->dStages; i++)
+    *pBytes++ = pDecision->dWaterArray[i];
+
+  for(int i = 1; i < this->pCatalogue->dSize; i++) {
+    *pBytes++ = pDecision->dHarvestArray[i];
+    *pBytes++ = pDecision->dSowArray[i];
+    *pBytes++ = pDecision->dFreshArray[i];
+  }
+
+  *pBytes = pDecision->dTill;
+}
+
+/**
+ * Reads a decision back out of its bytes.
+ *
+ * @param   {struct PlanModel *}      this        The model.
+ * @param   {unsigned char *}         pBytes      The packed decision.
+ * @param   {struct PlanDecision *}   pDecision   The decision to fill in.
+*/
+void PlanModel_unpackDecision(struct PlanModel *this, unsigned char *pBytes, struct PlanDecision *pDecision) {
+  memset(pDecision, 0, sizeof(*pDecision));
+
+  for(int i = 0; i < this->dStages; i++)
+    pDecision->dWaterArray[i] = *pBytes++;
+
+  for(int i = 1; i < this->pCatalogue->dSize; i++) {
+    pDecision->dHarvestArray[i] = *pBytes++;
+    pDecision->dSowArray[i] = *pBytes++;
+    pDecision->dFreshArray[i] = *pBytes++;
+  }
+
+  pDecision->dTill = *pBytes;
+}
+
+/**
+ * #######################
+ * ###  MODEL METHODS  ###
+ * #######################
+*/
+
+/**
+ * Returns the gold a harvest sells for.
+ *
+ * @param   {struct PlanModel *}  this    The model.
+ * @param   {enum ProductType}    eCrop   The crop.
+ * @param   {int}                 dAmount How many to sell.
+ * @return  {int}                         The gold.
+*/
+int PlanModel_getSellPrice(struct PlanModel *this, enum ProductType eCrop, int dAmount) {
+  return Stock_getSellPrice(this->pCropStockArray[eCrop], dAmount);
+}
+
+/**
+ * Returns what the seeds cost.
+ *
+ * @param   {struct PlanModel *}  this    The model.
+ * @param   {enum ProductType}    eCrop   The crop.
+ * @param   {int}                 dAmount How many seeds to buy.
+ * @return  {int}                         The gold.
+*/
+int PlanModel_getBuyPrice(struct PlanModel *this, enum ProductType eCrop, int dAmount) {
+  return Stock_getBuyPrice(this->pSeedStockArray[eCrop], dAmount);
+}
+
+/**
+ * Plays a day.
+ * The decision is assumed to be legal; the solver only ever builds legal ones.
+ *
+ * @param   {struct PlanModel *}      this        The model.
+ * @param   {struct PlanState *}      pState      The state at the start of the day.
+ * @param   {struct PlanDecision *}   pDecision   What to do.
+ * @param   {struct PlanState *}      pNext       Where to put the state at the start of the next day.
+ * @return  {int}                                 Whether or not the player lived through the night.
+*/
+int PlanModel_apply(struct PlanModel *this, struct PlanState *pState, struct PlanDecision *pDecision, struct PlanState *pNext) {
+  struct Player *pPlayer = this->pPlayer;
+
+  *pNext = *pState;
+
+  // Water the crops that were already in the ground
+  for(int i = 0; i < this->dStages; i++) {
+    pNext->dCountArray[i] -= pDecision->dWaterArray[i];
+    pNext->dCountArray[this->dNextArray[i]] += pDecision->dWaterArray[i];
+  }
+
+  for(int i = 1; i < this->pCatalogue->dSize; i++) {
+    int dFirst = this->dOffsetArray[i];
+    int dReady = dFirst + this->dWaterReqArray[i];
+
+    // Harvest and sell; harvested plots go back to being untilled
+    pNext->dCountArray[dReady] -= pDecision->dHarvestArray[i];
+    pNext->dGold += PlanModel_getSellPrice(this, i, pDecision->dHarvestArray[i]);
+
+    // Buy and sow
+    pNext->dTilled -= pDecision->dSowArray[i];
+    pNext->dCountArray[dFirst] += pDecision->dSowArray[i];
+    pNext->dGold -= PlanModel_getBuyPrice(this, i, pDecision->dSowArray[i]);
+
+    // Water the new ones
+    pNext->dCountArray[dFirst] -= pDecision->dFreshArray[i];
+    pNext->dCountArray[this->dNextArray[dFirst]] += pDecision->dFreshArray[i];
+  }
+
+  pNext->dTilled += pDecision->dTill;
+
+  // The night is whatever the game says it is
+  pPlayer->dGold = pNext->dGold;
+  pPlayer->dDaysStarved = pNext->dStarved;
+  Player_goHome(pPlayer);
+
+  pNext->dGold = Player_getGold(pPlayer);
+  pNext->dStarved = pPlayer->dDaysStarved;
+  pNext->dDay++;
+
+  return !Player_isDead(pPlayer);
+}
+
+/**
+ * Returns how many plots are growing something.
+ *
+ * @param   {struct PlanModel *}  this    The model.
+ * @param   {struct PlanState *}  pState  The state.
+ * @return  {int}                         The number of sown plots.
+*/
+int PlanModel_countSown(struct PlanModel *this, struct PlanState *pState) {
+  int dSown = 0;
+
+  for(int i = 0; i < this->dStages; i++)
+    dSown += pState->dCountArray[i];
+
+  return dSown;
+}
+
+/**
+ * Writes a day's decision in words.
+ *
+ * @param   {struct PlanModel *}      this        The model.
+ * @param   {struct PlanDecision *}   pDecision   The decision.
+ * @param   {FILE *}                  pFile       Where to write it.
+*/
+void PlanModel_describe(struct PlanModel *this, struct PlanDecision *pDecision, FILE *pFile) {
+  struct GameCatalogue *pCatalogue = this->pCatalogue;
+  int bIdle = 1;
+
+  for(int i = 1; i < pCatalogue->dSize; i++) {
+    for(int j = 0; j < this->dWaterReqArray[i]; j++) {
+      if(pDecision->dWaterArray[this->dOffsetArray[i] + j]) {
+        fprintf(pFile, "    water %d %s at %d/%d\n", pDecision->dWaterArray[this->dOffsetArray[i] + j],
+          pCatalogue->sProductNameArray[i], j, this->dWaterReqArray[i]);
+        bIdle = 0;
+      }
+    }
+  }
+
+  for(int i = 1; i < pCatalogue->dSize; i++) {
+    if(pDecision->dHarvestArray[i]) {
+      fprintf(pFile, "    harvest and sell %d %s (+%d)\n", pDecision->dHarvestArray[i],
+        pCatalogue->sProductNameArray[i], PlanModel_getSellPrice(this, i, pDecision->dHarvestArray[i]));
+      bIdle = 0;
+    }
+  }
+
+  if(pDecision->dTill) {
+    fprintf(pFile, "    till %d\n", pDecision->dTill);
+    bIdle = 0;
+  }
+
+  for(int i = 1; i < pCatalogue->dSize; i++) {
+    if(pDecision->dSowArray[i]) {
+      fprintf(pFile, "    buy and sow %d %s (-%d)\n", pDecision->dSowArray[i],
+        pCatalogue->sProductNameArray[i], PlanModel_getBuyPrice(this, i, pDecision->dSowArray[i]));
+      bIdle = 0;
+    }
+
+    if(pDecision->dFreshArray[i])
+      fprintf(pFile, "    water %d new %s\n", pDecision->dFreshArray[i], pCatalogue->sProductNameArray[i]);
+  }
+
+  if(bIdle)
+    fprintf(pFile, "    rest\n");
+}
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * The memo of the planner.
+ * It maps packed states (see plan.model.h) to the best gold reachable from them, along with the decision that gets there.
+ * It's an open-addressed hash table with linear probing; the keys and values are stored inline in one block,
+ * so a lookup touches a single cache line most of the time.
+*/
+
+#ifndef PLAN_TABLE
+#define PLAN_TABLE
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../utils/utils.mem.h"
+#include "../utils/utils.random.h"
+
+#define PLAN_TABLE_MIN_CAPACITY (1 << 12)
+
+/**
+ * An instantiable for the memo.
+ * Every slot is [1 byte used flag][key][int32 value][decision].
+*/
+struct PlanTable {
+  int dKeySize;
+  int dDecisionSize;
+  int dSlotSize;
+
+  long dCapacity;     // Always a power of two
+  long dCount;
+
+  unsigned char *pSlots;
+};
+
+/**
+ * ############################
+ * ###  TABLE CONSTRUCTION  ###
+ * ############################
+*/
+
+/**
+ * Returns a new instance of the PlanTable class.
+ *
+ * @return  {struct PlanTable *}  A pointer to the created instance.
+*/
+struct PlanTable *PlanTable_new() {
+  struct PlanTable *pPlanTable;
+
+  pPlanTable = UtilsMem_calloc(UTILS_MEM_MISC, 1, sizeof(*pPlanTable));
+
+  if(pPlanTable == NULL)
+    return NULL;
+
+  return pPlanTable;
+}
+
+/**
+ * Initializes an empty table.
+ *
+ * @param   {struct PlanTable *}  this            The instance to be initialized.
+ * @param   {int}                 dKeySize        The size of a packed state in bytes.
+ * @param   {int}                 dDecisionSize   The size of a packed decision in bytes.
+*/
+void PlanTable_init(struct PlanTable *this, int dKeySize, int dDecisionSize) {
+  this->dKeySize = dKeySize;
+  this->dDecisionSize = dDecisionSize;
+  this->dSlotSize = 1 + dKeySize + sizeof(int32_t) + dDecisionSize;
+
+  this->dCapacity = PLAN_TABLE_MIN_CAPACITY;
+  this->dCount = 0;
+  this->pSlots = UtilsMem_calloc(UTILS_MEM_MISC, this->dCapacity, this->dSlotSize);
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @param   {int}                 dKeySize        The size of a packed state in bytes.
+ * @param   {int}                 dDecisionSize   The size of a packed decision in bytes.
+ * @return  {struct PlanTable *}                  The created instance.
+*/
+struct PlanTable *PlanTable_create(int dKeySize, int dDecisionSize) {
+  struct PlanTable *pPlanTable = PlanTable_new();
+  PlanTable_init(pPlanTable, dKeySize, dDecisionSize);
+
+  return pPlanTable;
+}
+
+/**
+ * Destroys a specified instance.
+ *
+ * @param   {struct PlanTable *}  this  The instance to be destroyed.
+*/
+void PlanTable_kill(struct PlanTable *this) {
+  UtilsMem_free(this->pSlots);
+  UtilsMem_free(this);
+}
+
+/**
+ * ###################################
+ * ###  TABLE READERS AND WRITERS  ###
+ * ###################################
+*/
+
+/**
+ * Hashes a packed state.
+ *
+ * @param   {struct PlanTable *}  this  The table.
+ * @param   {unsigned char *}     pKey  The packed state.
+ * @return  {uint64_t}                  The hash.
+*/
+uint64_t PlanTable_hash(struct PlanTable *this, unsigned char *pKey) {
+  uint64_t dHash = 0;
+
+  for(int i = 0; i < this->dKeySize; i++)
+    dHash = (dHash ^ pKey[i]) * 0x100000001B3ULL;
+
+  return UtilsRandom_mix(dHash);
+}
+
+/**
+ * Finds the slot of a state, or the empty slot where it would go.
+ *
+ * @param   {struct PlanTable *}  this  The table.
+ * @param   {unsigned char *}     pKey  The packed state.
+ * @return  {unsigned char *}           The slot.
+*/
+unsigned char *PlanTable_probe(struct PlanTable *this, unsigned char *pKey) {
+  long dIndex = PlanTable_hash(this, pKey) & (this->dCapacity - 1);
+
+  while(1) {
+    unsigned char *pSlot = this->pSlots + dIndex * this->dSlotSize;
+
+    if(!pSlot[0] || !memcmp(pSlot + 1, pKey, this->dKeySize))
+      return pSlot;
+
+    dIndex = (dIndex + 1) & (this->dCapacity - 1);
+  }
+}
+
+/**
+ * Doubles the capacity of the table and moves every entry over.
+ *
+ * @param   {struct PlanTable *}  this  The table.
+*/
+void PlanTable_grow(struct PlanTable *this) {
+  unsigned char *pOldSlots = this->pSlots;
+  long dOldCapacity = this->dCapacity;
+
+  this->dCapacity *= 2;
+  this->pSlots = UtilsMem_calloc(UTILS_MEM_MISC, this->dCapacity, this->dSlotSize);
+
+  for(long i = 0; i < dOldCapacity; i++) {
+    unsigned char *pOldSlot = pOldSlots + i * this->dSlotSize;
+
+    if(pOldSlot[0])
+      memcpy(PlanTable_probe(this, pOldSlot + 1), pOldSlot, this->dSlotSize);
+  }
+
+  UtilsMem_free(pOldSlots);
+}
+
+/**
+ * Looks up the value of a state.
+ *
+ * @param   {struct PlanTable *}  this      The table.
+ * @param   {unsigned char *}     pKey      The packed state.
+ * @param   {int *}               pValue    Where to put the value if the state is there.
+ * @return  {unsigned char *}               The stored decision, or NULL if the state isn't in the table.
+*/
+unsigned char *PlanTable_find(struct PlanTable *this, unsigned char *pKey, int *pValue) {
+  unsigned char *pSlot = PlanTable_probe(this, pKey);
+  int32_t dValue;
+
+  if(!pSlot[0])
+    return NULL;
+
+  memcpy(&dValue, pSlot + 1 + this->dKeySize, sizeof(dValue));
+  *pValue = dValue;
+
+  return pSlot + 1 + this->dKeySize + sizeof(dValue);
+}
+
+/**
+ * Stores the value of a state and the decision that got it.
+ * Pointers returned by PlanTable_find() may move after this.
+ *
+ * @param   {struct PlanTable *}  this        The table.
+ * @param   {unsigned char *}     pKey        The packed state.
+ * @param   {int}                 dValue      The best gold reachable from the state.
+ * @param   {unsigned char *}     pDecision   The decision that reaches it.
+*/
+void PlanTable_store(struct PlanTable *this, unsigned char *pKey, int dValue, unsigned char *pDecision) {
+  unsigned char *pSlot;
+  int32_t dStored = dValue;
+
+  // Keep it at most half full so probes stay short
+  if(2 * (this->dCount + 1) > this->dCapacity)
+    PlanTable_grow(this);
+
+  pSlot = PlanTable_probe(this, pKey);
+
+  if(!pSlot[0]) {
+    pSlot[0] = 1;
+    memcpy(pSlot + 1, pKey, this->dKeySize);
+    this->dCount++;
+  }
+
+  memcpy(pSlot + 1 + this->dKeySize, &dStored, sizeof(dStored));
+  memcpy(pSlot + 1 + this->dKeySize + sizeof(dStored), pDecision, this->dDecisionSize);
+}
+
+/**
+ * Returns how many states are in the table.
+ *
+ * @param   {struct PlanTable *}  this  The table.
+ * @return  {long}                      The number of stored states.
+*/
+long PlanTable_getCount(struct PlanTable *this) {
+  return this->dCount;
+}
+
+#endif
@@ -0,0 +1,250 @@
+/**
+ * The Monte Carlo simulator for the economy of Harvest Sun.
+ * It plays a lot of headless games for every pair of strategy and setting (see sim/sim.strategy.h and sim/sim.setting.h),
+ * spread over a work-stealing pool of threads, then writes out how long the players lasted and how their gold went.
+ *
+ * Build (main.c does this for you with "./main sim"):
+ *    gcc src/sim.c -o build/sim.unix.o -std=c99 -Wall -O2 -pthread -DUTILS_THREADS
+ *
+ * Usage:
+ *    build/sim.unix.o [-n games] [-d days] [-t threads] [-s seed] [-j games per job] [-f csv|bin] [-o prefix]
+ *                     [-c gold,energy,breakfast,buy shift,sell shift,water shift]
+ *
+ *    -c replaces the built-in settings with a single custom one, which is handy when tuning by hand.
+ *
+ * The games of a job are seeded from (seed, strategy, setting, job), never from the thread that runs them,
+ * so the output only depends on the arguments and not on how many threads there are.
+*/
+
+// We need clock_gettime() from POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "utils/utils.mem.h"
+#include "utils/utils.random.h"
+#include "utils/utils.workers.h"
+
+#include "sim/sim.game.h"
+#include "sim/sim.report.h"
+#include "sim/sim.setting.h"
+#include "sim/sim.strategy.h"
+
+#define SIM_DEFAULT_GAMES 20000
+#define SIM_DEFAULT_DAYS 60
+#define SIM_DEFAULT_CHUNK 250
+#define SIM_DEFAULT_PREFIX "build/logs/sim"
+
+/**
+ * Everything the jobs need to know.
+*/
+struct Sim {
+  struct SimStrategy strategyArray[SIM_MAX_STRATEGIES];
+  struct SimSetting settingArray[SIM_MAX_SETTINGS];
+  int dStrategies;
+  int dSettings;
+
+  int dGames;       // Per strategy and setting
+  int dDays;
+  int dChunk;       // Games per job
+  int dChunks;      // Jobs per strategy and setting
+  uint64_t dSeed;
+
+  struct SimReport *pReportArray;   // One per worker
+};
+
+/**
+ * Plays a single game to the end (or to the day limit) and tallies it.
+ *
+ * @param   {struct Sim *}          this        The simulator.
+ * @param   {struct SimStrategy *}  pStrategy   How to play.
+ * @param   {struct SimSetting *}   pSetting    The economy to play in.
+ * @param   {struct UtilsRandom *}  pRandom     The generator for the game.
+ * @param   {struct SimTally *}     pTally      Where the results go.
+*/
+void Sim_playGame(struct Sim *this, struct SimStrategy *pStrategy, struct SimSetting *pSetting, struct UtilsRandom *pRandom, struct SimTally *pTally) {
+  struct SimGame game;
+  int dDay = 0;
+  int bIsAlive = 1;
+
+  SimGame_init(&game, pSetting);
+
+  while(bIsAlive && dDay < this->dDays) {
+    bIsAlive = SimStrategy_playDay(pStrategy, &game, pRandom);
+
+    if(bIsAlive) {
+      pTally->dAliveArray[dDay]++;
+      pTally->dGoldArray[dDay] += Player_getGold(game.pPlayer);
+      dDay++;
+    }
+  }
+
+  pTally->dGames++;
+  pTally->dSurvivors += bIsAlive;
+  pTally->dDaysSum += dDay;
+  pTally->dFinalGoldSum += Player_getGold(game.pPlayer);
+
+  SimGame_exit(&game);
+}
+
+/**
+ * Runs one job: a chunk of games for one strategy in one setting.
+ * This is the callback handed to the worker pool.
+ *
+ * @param   {void *}  pContext  The simulator.
+ * @param   {int}     dJob      The job number.
+ * @param   {int}     dWorker   The worker running the job.
+*/
+void Sim_runJob(void *pContext, int dJob, int dWorker) {
+  struct Sim *this = pContext;
+  struct UtilsRandom random;
+
+  // Unpack the job number
+  int dChunk = dJob % this->dChunks;
+  int dPair = dJob / this->dChunks;
+  int dStrategy = dPair / this->dSettings;
+  int dSetting = dPair % this->dSettings;
+
+  int dFirst = dChunk * this->dChunk;
+  int dLast = dFirst + this->dChunk < this->dGames ? dFirst + this->dChunk : this->dGames;
+
+  struct SimTally *pTally = SimReport_getTally(&this->pReportArray[dWorker], dStrategy, dSetting);
+
+  UtilsRandom_init(&random, UtilsRandom_mix(this->dSeed ^ UtilsRandom_mix(((uint64_t) dPair << 32) | dChunk)));
+
+  for(int i = dFirst; i < dLast; i++)
+    Sim_playGame(this, &this->strategyArray[dStrategy], &this->settingArray[dSetting], &random, pTally);
+}
+
+/**
+ * Returns the time in seconds, for measuring throughput.
+ *
+ * @return  {double}  A monotonic timestamp.
+*/
+double Sim_getTime() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Reads a custom setting from a comma separated list.
+ *
+ * @param   {struct SimSetting *}   pSetting  The setting to fill in.
+ * @param   {char *}                sSpec     gold,energy,breakfast,buy shift,sell shift,water shift
+ * @return  {int}                             Whether or not the list made sense.
+*/
+int Sim_parseSetting(struct SimSetting *pSetting, char *sSpec) {
+  int dValueArray[6] = { SIM_DEFAULT_GOLD, SIM_DEFAULT_ENERGY, PLAYER_BREAKFAST_COST, 0, 0, 0 };
+  int dValues = sscanf(sSpec, "%d,%d,%d,%d,%d,%d",
+    &dValueArray[0], &dValueArray[1], &dValueArray[2], &dValueArray[3], &dValueArray[4], &dValueArray[5]);
+
+  if(dValues < 1)
+    return 0;
+
+  SimSetting_init(pSetting, "custom");
+  pSetting->dGold = dValueArray[0];
+  pSetting->dEnergy = dValueArray[1];
+  pSetting->dBreakfastCost = dValueArray[2];
+  SimSetting_shiftPrices(pSetting, dValueArray[3], dValueArray[4]);
+  SimSetting_shiftWater(pSetting, dValueArray[5]);
+
+  return 1;
+}
+
+int main(int argc, char *argv[]) {
+  struct Sim sim;
+  struct SimReport total;
+  struct UtilsWorkers *pWorkers;
+  char *sPrefix = SIM_DEFAULT_PREFIX;
+  char *sFormat = "csv";
+  int dWorkers = sysconf(_SC_NPROCESSORS_ONLN);
+  int bCustom = 0;
+  double fStart, fElapsed;
+  long dTotalGames;
+
+  sim.dGames = SIM_DEFAULT_GAMES;
+  sim.dDays = SIM_DEFAULT_DAYS;
+  sim.dChunk = SIM_DEFAULT_CHUNK;
+  sim.dSeed = 2023;
+
+  // Read the args
+  for(int i = 1; i + 1 < argc; i += 2) {
+    if(!strcmp(argv[i], "-n")) sim.dGames = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-d")) sim.dDays = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-t")) dWorkers = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-s")) sim.dSeed = strtoull(argv[i + 1], NULL, 10);
+    else if(!strcmp(argv[i], "-j")) sim.dChunk = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-f")) sFormat = argv[i + 1];
+    else if(!strcmp(argv[i], "-o")) sPrefix = argv[i + 1];
+    else if(!strcmp(argv[i], "-c")) bCustom = Sim_parseSetting(&sim.settingArray[0], argv[i + 1]);
+    else {
+      fprintf(stderr, "Unknown option %s.\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if(sim.dGames < 1) sim.dGames = 1;
+  if(sim.dDays < 1) sim.dDays = 1;
+  if(sim.dChunk < 1) sim.dChunk = 1;
+  if(dWorkers < 1) dWorkers = 1;
+  if(dWorkers > UTILS_WORKERS_MAX) dWorkers = UTILS_WORKERS_MAX;
+
+  // What to compare
+  sim.dStrategies = SimStrategy_initAll(sim.strategyArray);
+  sim.dSettings = bCustom ? 1 : SimSetting_initAll(sim.settingArray);
+  sim.dChunks = (sim.dGames + sim.dChunk - 1) / sim.dChunk;
+
+  // Every worker tallies into its own report
+  sim.pReportArray = UtilsMem_calloc(UTILS_MEM_MISC, dWorkers, sizeof(struct SimReport));
+  for(int i = 0; i < dWorkers; i++)
+    SimReport_init(&sim.pReportArray[i], sim.dStrategies, sim.dSettings, sim.dDays);
+
+  // Play!
+  pWorkers = UtilsWorkers_create(dWorkers, sim.dStrategies * sim.dSettings * sim.dChunks, Sim_runJob, &sim);
+
+  fStart = Sim_getTime();
+  UtilsWorkers_run(pWorkers);
+  fElapsed = Sim_getTime() - fStart;
+
+  // Add everything up
+  SimReport_init(&total, sim.dStrategies, sim.dSettings, sim.dDays);
+  for(int i = 0; i < dWorkers; i++)
+    SimReport_merge(&total, &sim.pReportArray[i]);
+
+  if(!strcmp(sFormat, "bin") ? !SimReport_writeBinary(&total, sPrefix) :
+    !SimReport_writeCSV(&total, sim.strategyArray, sim.settingArray, sPrefix)) {
+    fprintf(stderr, "Couldn't write the results to %s.*\n", sPrefix);
+    return 1;
+  }
+
+  // Some feedback on how fast that was
+  dTotalGames = (long) sim.dGames * sim.dStrategies * sim.dSettings;
+  fprintf(stderr, "%ld games (%d strategies x %d settings x %d) in %.3f s on %d threads: %.0f games/s\n",
+    dTotalGames, sim.dStrategies, sim.dSettings, sim.dGames, fElapsed, dWorkers, dTotalGames / fElapsed);
+
+  for(int i = 0; i < dWorkers; i++)
+    fprintf(stderr, "  worker %2d: %ld jobs (%ld stolen)\n", i,
+      UtilsWorkers_getDone(pWorkers, i), UtilsWorkers_getStolen(pWorkers, i));
+
+  // Garbage collection!
+  UtilsWorkers_kill(pWorkers);
+  SimReport_exit(&total);
+
+  for(int i = 0; i < dWorkers; i++)
+    SimReport_exit(&sim.pReportArray[i]);
+
+  UtilsMem_free(sim.pReportArray);
+
+  // The workers folded their counters into ours when they ended, so this covers the whole run
+  fprintf(stderr, "  memory: %ld allocs, %ld bytes at peak, %ld bytes still live\n",
+    UtilsMem_get()->total.dAllocs, UtilsMem_get()->total.dPeakBytes, UtilsMem_get()->total.dLiveBytes);
+
+  return 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * A game of Harvest Sun without the UI.
+ * It holds the same Player, Farm and Shop objects the game manager does, and every action goes through their methods,
+ * so the simulator plays by exactly the same rules as the real thing (energy, watering once a day, starving, etc.).
+ * The only shortcut is that the farm selector jumps straight to a plot instead of being walked there one key at a time.
+*/
+
+#ifndef SIM_GAME
+#define SIM_GAME
+
+#include "../utils/utils.mem.h"
+
+#include "../game/game.catalogue.h"
+#include "../game/classes/game.class.plot.h"
+#include "../game/classes/game.class.stock.h"
+#include "../game/objects/game.obj.player.h"
+#include "../game/objects/game.obj.farm.h"
+#include "../game/objects/game.obj.shop.h"
+
+#include "sim.setting.h"
+
+/**
+ * A struct for a headless game.
+*/
+struct SimGame {
+  struct SimSetting *pSetting;
+  struct GameCatalogue *pCatalogue;
+
+  struct Player *pPlayer;
+  struct Farm *pFarm;
+  struct Shop *pShop;
+};
+
+/**
+ * ###########################
+ * ###  GAME CONSTRUCTION  ###
+ * ###########################
+*/
+
+/**
+ * Sets up a fresh game with the numbers of the given setting.
+ *
+ * @param   {struct SimGame *}      this      The game to initialize.
+ * @param   {struct SimSetting *}   pSetting  The economy to play in.
+*/
+void SimGame_init(struct SimGame *this, struct SimSetting *pSetting) {
+  this->pSetting = pSetting;
+  this->pCatalogue = &pSetting->catalogue;
+
+  this->pPlayer = Player_create(pSetting->dGold, pSetting->dEnergy, pSetting->dEnergy, this->pCatalogue);
+  this->pFarm = Farm_create(pSetting->dFarmWidth, pSetting->dFarmHeight, this->pCatalogue);
+  this->pShop = Shop_create(this->pCatalogue);
+
+  Player_setBreakfastCost(this->pPlayer, pSetting->dBreakfastCost);
+}
+
+/**
+ * Frees everything the game allocated.
+ *
+ * @param   {struct SimGame *}  this  The game to clean up.
+*/
+void SimGame_exit(struct SimGame *this) {
+  Player_kill(this->pPlayer);
+  Farm_kill(this->pFarm);
+  Shop_kill(this->pShop);
+}
+
+/**
+ * ######################
+ * ###  GAME READERS  ###
+ * ######################
+*/
+
+/**
+ * Returns the current day.
+ *
+ * @param   {struct SimGame *}  this  The game.
+ * @return  {int}                     The day.
+*/
+int SimGame_getTime(struct SimGame *this) {
+  return Player_getTime(this->pPlayer);
+}
+
+/**
+ * Counts the plots in a given state.
+ *
+ * @param   {struct SimGame *}  this    The game.
+ * @param   {enum PlotState}    eState  The state to look for.
+ * @return  {int}                       How many plots are in that state.
+*/
+int SimGame_countPlots(struct SimGame *this, enum PlotState eState) {
+  int dCount = 0;
+
+  for(int i = 0; i < this->pFarm->dSize; i++)
+    if(Plot_getState(this->pFarm->pPlotArray[i]) == eState)
+      dCount++;
+
+  return dCount;
+}
+
+/**
+ * ######################
+ * ###  GAME ACTIONS  ###
+ * ######################
+*/
+
+/**
+ * Does a farm action on as many plots as the rules (and the limit) allow.
+ * This is what a player would do by selecting plots one by one then confirming.
+ * The plots are only queued if Farm_queueSelected() accepts them, and Farm_processQueue() charges the energy,
+ * so nothing here bends the rules; the limit just keeps us from queueing more than we can pay for.
+ *
+ * @param   {struct SimGame *}  this      The game.
+ * @param   {enum FarmAction}   eAction   What to do to the plots.
+ * @param   {enum ProductType}  eCrop     The crop to sow (only matters for FARM_SOW).
+ * @param   {int}               dLimit    The most plots to act on.
+ * @return  {int}                         How many plots were acted on.
+*/
+int SimGame_farm(struct SimGame *this, enum FarmAction eAction, enum ProductType eCrop, int dLimit) {
+  struct Farm *pFarm = this->pFarm;
+  int dTime = Player_getTime(this->pPlayer);
+  int dQueued;
+
+  // Can't do anything without energy
+  if(dLimit > Player_getEnergy(this->pPlayer))
+    dLimit = Player_getEnergy(this->pPlayer);
+
+  if(dLimit <= 0)
+    return 0;
+
+  Farm_setCurrentAction(pFarm, eAction);
+  Farm_setCurrentCrop(pFarm, eCrop);
+  Farm_startSelecting(pFarm);
+
+  // Walk the grid and queue what we can
+  for(int i = 0; i < pFarm->dSize && Farm_getQueueLength(pFarm) < dLimit; i++) {
+    Farm_moveSelector(pFarm, i % pFarm->dWidth, i / pFarm->dWidth);
+    Farm_queueSelected(pFarm, dTime);
+  }
+
+  dQueued = Farm_getQueueLength(pFarm);
+
+  // Nothing to do; just stop selecting like the player would
+  if(!dQueued) {
+    Farm_stopSelecting(pFarm);
+    return 0;
+  }
+
+  return Farm_processQueue(pFarm, this->pPlayer, this->pCatalogue, dTime) ? dQueued : 0;
+}
+
+/**
+ * Buys seeds through the shop.
+ *
+ * @param   {struct SimGame *}  this      The game.
+ * @param   {enum ProductType}  eCrop     The seeds to buy.
+ * @param   {int}               dAmount   How many to buy.
+ * @return  {int}                         Whether or not the purchase went through.
+*/
+int SimGame_buy(struct SimGame *this, enum ProductType eCrop, int dAmount) {
+  struct Shop *pShop = this->pShop;
+
+  if(dAmount <= 0)
+    return 0;
+
+  Shop_setCurrentCrop(pShop, eCrop);
+
+  if(Player_buyCrop(this->pPlayer, eCrop, dAmount, Shop_getCurrentBuyCost(pShop, dAmount))) {
+    Shop_buyCurrentProduct(pShop, dAmount);
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+ * Sells every harvested crop the player has.
+ *
+ * @param   {struct SimGame *}  this  The game.
+ * @return  {int}                     How much gold the crops made.
+*/
+int SimGame_sellAll(struct SimGame *this) {
+  struct Shop *pShop = this->pShop;
+  int dEarned = 0;
+
+  for(int i = 1; i < this->pCatalogue->dSize; i++) {
+    int dAmount = Stock_getAmount(Player_getCropStock(this->pPlayer, i));
+
+    if(dAmount > 0) {
+      Shop_setCurrentCrop(pShop, i);
+
+      if(Player_sellCrop(this->pPlayer, i, dAmount, Shop_getCurrentSellCost(pShop, dAmount))) {
+        Shop_sellCurrentProduct(pShop, dAmount);
+        dEarned += Shop_getCurrentSellCost(pShop, dAmount);
+      }
+    }
+  }
+
+  return dEarned;
+}
+
+/**
+ * Ends the day the same way Game_playHome() does.
+ *
+ * @param   {struct SimGame *}  this  The game.
+ * @return  {int}                     Whether or not the player is still alive.
+*/
+int SimGame_goHome(struct SimGame *this) {
+  Player_goHome(this->pPlayer);
+
+  return !Player_isDead(this->pPlayer);
+}
+
+/**
+ * Skips ahead a number of days, going home every night, optionally watering every crop every day.
+ * It uses Farm_fastForward() when it can, and only steps through the days one by one when the player can't water everything.
+ *
+ * @param   {struct SimGame *}  this    The game.
+ * @param   {int}               dDays   How many days to skip.
+ * @param   {int}               bWater  Whether or not to water everything every day.
+ * @return  {int}                       Whether or not the player is still alive.
+*/
+int SimGame_fastForward(struct SimGame *this, int dDays, int bWater) {
+  if(!Farm_fastForward(this->pFarm, this->pPlayer, dDays, bWater)) {
+    for(int i = 0; i < dDays; i++) {
+      SimGame_farm(this, FARM_WATER, PRODUCT_NULL, Player_getEnergy(this->pPlayer));
+      Player_goHome(this->pPlayer);
+    }
+  }
+
+  return !Player_isDead(this->pPlayer);
+}
+
+#endif
@@ -0,0 +1,226 @@
+/**
+ * Tallies the results of simulated games and writes them out.
+ * Every worker keeps its own tallies (one per strategy and setting), so nothing needs a lock while games are running;
+ * they get added together once all the workers are done.
+ *
+ * The CSV output is two files:
+ *    <prefix>.summary.csv    strategy,setting,games,survivors,survival_rate,mean_days,mean_final_gold
+ *    <prefix>.curves.csv     strategy,setting,day,alive,mean_gold
+ * (mean_gold in the curves is over the players still alive at the end of that day.)
+ *
+ * The binary output is <prefix>.bin, all in the byte order of the machine that wrote it:
+ *    char[4] "HSIM", int32 version, int32 strategies, int32 settings, int32 days
+ *    then for each strategy (outer) and setting (inner):
+ *      int64 games, int64 survivors, int64 sum of days survived, int64 sum of final gold,
+ *      then for each day: int64 alive, int64 sum of gold
+*/
+
+#ifndef SIM_REPORT
+#define SIM_REPORT
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "../utils/utils.mem.h"
+
+#include "sim.setting.h"
+#include "sim.strategy.h"
+
+#define SIM_REPORT_VERSION 1
+
+/**
+ * The running totals of one strategy in one setting.
+*/
+struct SimTally {
+  int64_t dGames;
+  int64_t dSurvivors;
+  int64_t dDaysSum;
+  int64_t dFinalGoldSum;
+
+  int64_t *dAliveArray;     // How many players made it through each day
+  int64_t *dGoldArray;      // The gold of those players, added up
+};
+
+/**
+ * All the tallies of one worker (or of everyone, once they've been merged).
+*/
+struct SimReport {
+  int dStrategies;
+  int dSettings;
+  int dDays;
+
+  struct SimTally *pTallyArray;   // dStrategies * dSettings of them, strategy-major
+};
+
+/**
+ * #############################
+ * ###  REPORT CONSTRUCTION  ###
+ * #############################
+*/
+
+/**
+ * Sets up an empty report.
+ *
+ * @param   {struct SimReport *}  this          The report to initialize.
+ * @param   {int}                 dStrategies   How many strategies are being compared.
+ * @param   {int}                 dSettings     How many settings are being compared.
+ * @param   {int}                 dDays         The longest a game can go.
+*/
+void SimReport_init(struct SimReport *this, int dStrategies, int dSettings, int dDays) {
+  this->dStrategies = dStrategies;
+  this->dSettings = dSettings;
+  this->dDays = dDays;
+
+  this->pTallyArray = UtilsMem_calloc(UTILS_MEM_MISC, dStrategies * dSettings, sizeof(struct SimTally));
+
+  for(int i = 0; i < dStrategies * dSettings; i++) {
+    this->pTallyArray[i].dAliveArray = UtilsMem_calloc(UTILS_MEM_MISC, dDays, sizeof(int64_t));
+    this->pTallyArray[i].dGoldArray = UtilsMem_calloc(UTILS_MEM_MISC, dDays, sizeof(int64_t));
+  }
+}
+
+/**
+ * Frees the tallies of the report.
+ *
+ * @param   {struct SimReport *}  this  The report to clean up.
+*/
+void SimReport_exit(struct SimReport *this) {
+  for(int i = 0; i < this->dStrategies * this->dSettings; i++) {
+    UtilsMem_free(this->pTallyArray[i].dAliveArray);
+    UtilsMem_free(this->pTallyArray[i].dGoldArray);
+  }
+
+  UtilsMem_free(this->pTallyArray);
+}
+
+/**
+ * ########################
+ * ###  REPORT METHODS  ###
+ * ########################
+*/
+
+/**
+ * Returns the tally of a strategy in a setting.
+ *
+ * @param   {struct SimReport *}  this        The report.
+ * @param   {int}                 dStrategy   The index of the strategy.
+ * @param   {int}                 dSetting    The index of the setting.
+ * @return  {struct SimTally *}               The tally.
+*/
+struct SimTally *SimReport_getTally(struct SimReport *this, int dStrategy, int dSetting) {
+  return &this->pTallyArray[dStrategy * this->dSettings + dSetting];
+}
+
+/**
+ * Adds another report into this one.
+ *
+ * @param   {struct SimReport *}  this    The report to add to.
+ * @param   {struct SimReport *}  pOther  The report to add; it has to have the same shape.
+*/
+void SimReport_merge(struct SimReport *this, struct SimReport *pOther) {
+  for(int i = 0; i < this->dStrategies * this->dSettings; i++) {
+    struct SimTally *pTally = &this->pTallyArray[i];
+    struct SimTally *pOtherTally = &pOther->pTallyArray[i];
+
+    pTally->dGames += pOtherTally->dGames;
+    pTally->dSurvivors += pOtherTally->dSurvivors;
+    pTally->dDaysSum += pOtherTally->dDaysSum;
+    pTally->dFinalGoldSum += pOtherTally->dFinalGoldSum;
+
+    for(int j = 0; j < this->dDays; j++) {
+      pTally->dAliveArray[j] += pOtherTally->dAliveArray[j];
+      pTally->dGoldArray[j] += pOtherTally->dGoldArray[j];
+    }
+  }
+}
+
+/**
+ * Writes the report as two CSV files.
+ *
+ * @param   {struct SimReport *}    this            The report.
+ * @param   {struct SimStrategy *}  pStrategyArray  The names of the strategies.
+ * @param   {struct SimSetting *}   pSettingArray   The names of the settings.
+ * @param   {char *}                sPrefix         Where to write the files (without the extension).
+ * @return  {int}                                   Whether or not both files were written.
+*/
+int SimReport_writeCSV(struct SimReport *this, struct SimStrategy *pStrategyArray, struct SimSetting *pSettingArray, char *sPrefix) {
+  char sPath[512];
+  FILE *pSummary, *pCurves;
+
+  snprintf(sPath, sizeof(sPath), "%s.summary.csv", sPrefix);
+  if((pSummary = fopen(sPath, "w")) == NULL)
+    return 0;
+
+  snprintf(sPath, sizeof(sPath), "%s.curves.csv", sPrefix);
+  if((pCurves = fopen(sPath, "w")) == NULL) {
+    fclose(pSummary);
+    return 0;
+  }
+
+  fprintf(pSummary, "strategy,setting,games,survivors,survival_rate,mean_days,mean_final_gold\n");
+  fprintf(pCurves, "strategy,setting,day,alive,mean_gold\n");
+
+  for(int i = 0; i < this->dStrategies; i++) {
+    for(int j = 0; j < this->dSettings; j++) {
+      struct SimTally *pTally = SimReport_getTally(this, i, j);
+      double fGames = pTally->dGames ? (double) pTally->dGames : 1.0;
+
+      fprintf(pSummary, "%s,%s,%lld,%lld,%.4f,%.3f,%.3f\n",
+        pStrategyArray[i].sName, pSettingArray[j].sName,
+        (long long) pTally->dGames, (long long) pTally->dSurvivors,
+        pTally->dSurvivors / fGames, pTally->dDaysSum / fGames, pTally->dFinalGoldSum / fGames);
+
+      for(int k = 0; k < this->dDays; k++) {
+        fprintf(pCurves, "%s,%s,%d,%lld,%.3f\n",
+          pStrategyArray[i].sName, pSettingArray[j].sName, k + 1,
+          (long long) pTally->dAliveArray[k],
+          pTally->dAliveArray[k] ? (double) pTally->dGoldArray[k] / pTally->dAliveArray[k] : 0.0);
+      }
+    }
+  }
+
+  fclose(pSummary);
+  fclose(pCurves);
+
+  return 1;
+}
+
+/**
+ * Writes the report as a single binary file (see the top of this file for the layout).
+ *
+ * @param   {struct SimReport *}  this      The report.
+ * @param   {char *}              sPrefix   Where to write the file (without the extension).
+ * @return  {int}                           Whether or not the file was written.
+*/
+int SimReport_writeBinary(struct SimReport *this, char *sPrefix) {
+  char sPath[512];
+  int32_t dHeaderArray[4] = { SIM_REPORT_VERSION, this->dStrategies, this->dSettings, this->dDays };
+  FILE *pFile;
+
+  snprintf(sPath, sizeof(sPath), "%s.bin", sPrefix);
+  if((pFile = fopen(sPath, "wb")) == NULL)
+    return 0;
+
+  fwrite("HSIM", 1, 4, pFile);
+  fwrite(dHeaderArray, sizeof(int32_t), 4, pFile);
+
+  for(int i = 0; i < this->dStrategies * this->dSettings; i++) {
+    struct SimTally *pTally = &this->pTallyArray[i];
+
+    fwrite(&pTally->dGames, sizeof(int64_t), 1, pFile);
+    fwrite(&pTally->dSurvivors, sizeof(int64_t), 1, pFile);
+    fwrite(&pTally->dDaysSum, sizeof(int64_t), 1, pFile);
+    fwrite(&pTally->dFinalGoldSum, sizeof(int64_t), 1, pFile);
+
+    for(int j = 0; j < this->dDays; j++) {
+      fwrite(&pTally->dAliveArray[j], sizeof(int64_t), 1, pFile);
+      fwrite(&pTally->dGoldArray[j], sizeof(int64_t), 1, pFile);
+    }
+  }
+
+  fclose(pFile);
+
+  return 1;
+}
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * The economies the simulator tries out.
+ * A setting is a full copy of the catalogue plus the starting numbers the game manager would normally hard-code,
+ * so we can see what happens to every strategy when, say, seeds get cheaper or breakfast gets pricier.
+*/
+
+#ifndef SIM_SETTING
+#define SIM_SETTING
+
+#include "../game/game.catalogue.h"
+#include "../game/objects/game.obj.player.h"
+
+// These mirror the defaults in game.manager.h
+// (we can't include the manager here since it drags the whole UI in with it)
+#define SIM_DEFAULT_GOLD 50
+#define SIM_DEFAULT_ENERGY 30
+#define SIM_DEFAULT_FARM_WIDTH 10
+#define SIM_DEFAULT_FARM_HEIGHT 3
+
+#define SIM_MAX_SETTINGS 32
+
+/**
+ * A single economy.
+*/
+struct SimSetting {
+  char *sName;
+
+  struct GameCatalogue catalogue;
+
+  int dGold;
+  int dEnergy;
+  int dBreakfastCost;
+  int dFarmWidth;
+  int dFarmHeight;
+};
+
+/**
+ * Sets up a setting with the same numbers as the actual game.
+ *
+ * @param   {struct SimSetting *}   this    The setting to initialize.
+ * @param   {char *}                sName   What to call it in the output.
+*/
+void SimSetting_init(struct SimSetting *this, char *sName) {
+  this->sName = sName;
+
+  GameCatalogue_init(&this->catalogue);
+
+  this->dGold = SIM_DEFAULT_GOLD;
+  this->dEnergy = SIM_DEFAULT_ENERGY;
+  this->dBreakfastCost = PLAYER_BREAKFAST_COST;
+  this->dFarmWidth = SIM_DEFAULT_FARM_WIDTH;
+  this->dFarmHeight = SIM_DEFAULT_FARM_HEIGHT;
+}
+
+/**
+ * Adds the same amount to the price of every seed (or the selling price of every crop).
+ * Prices never go below 1.
+ *
+ * @param   {struct SimSetting *}   this        The setting to modify.
+ * @param   {int}                   dBuyChange  How much to add to the buying prices.
+ * @param   {int}                   dSellChange How much to add to the selling prices.
+*/
+void SimSetting_shiftPrices(struct SimSetting *this, int dBuyChange, int dSellChange) {
+  for(int i = 1; i < this->catalogue.dSize; i++) {
+    this->catalogue.dProductCostToBuyArray[i] += dBuyChange;
+    this->catalogue.dProductCostToSellArray[i] += dSellChange;
+
+    if(this->catalogue.dProductCostToBuyArray[i] < 1) this->catalogue.dProductCostToBuyArray[i] = 1;
+    if(this->catalogue.dProductCostToSellArray[i] < 1) this->catalogue.dProductCostToSellArray[i] = 1;
+  }
+}
+
+/**
+ * Adds the same amount to the water every crop needs.
+ * Crops always need at least one watering.
+ *
+ * @param   {struct SimSetting *}   this          The setting to modify.
+ * @param   {int}                   dWaterChange  How much to add to the water requirements.
+*/
+void SimSetting_shiftWater(struct SimSetting *this, int dWaterChange) {
+  for(int i = 1; i < this->catalogue.dSize; i++) {
+    this->catalogue.dProductWaterReqArray[i] += dWaterChange;
+
+    if(this->catalogue.dProductWaterReqArray[i] < 1) this->catalogue.dProductWaterReqArray[i] = 1;
+  }
+}
+
+/**
+ * Fills an array with the settings we compare.
+ * The first one is always the game as it ships.
+ *
+ * @param   {struct SimSetting *}   pSettingArray   Where to put the settings; needs room for SIM_MAX_SETTINGS.
+ * @return  {int}                                   How many settings there are.
+*/
+int SimSetting_initAll(struct SimSetting *pSettingArray) {
+  int dSettings = 0;
+
+  // The actual game
+  SimSetting_init(&pSettingArray[dSettings++], "default");
+
+  // Everything is a bit cheaper to plant
+  SimSetting_init(&pSettingArray[dSettings], "cheap-seeds");
+  SimSetting_shiftPrices(&pSettingArray[dSettings++], -1, 0);
+
+  // Crops sell for a bit more
+  SimSetting_init(&pSettingArray[dSettings], "rich-market");
+  SimSetting_shiftPrices(&pSettingArray[dSettings++], 0, 2);
+
+  // Crops take longer to grow
+  SimSetting_init(&pSettingArray[dSettings], "thirsty");
+  SimSetting_shiftWater(&pSettingArray[dSettings++], 2);
+
+  // Crops grow faster
+  SimSetting_init(&pSettingArray[dSettings], "quick-growth");
+  SimSetting_shiftWater(&pSettingArray[dSettings++], -2);
+
+  // More energy every day
+  SimSetting_init(&pSettingArray[dSettings], "energetic");
+  pSettingArray[dSettings++].dEnergy = 45;
+
+  // Less money to start with
+  SimSetting_init(&pSettingArray[dSettings], "poor");
+  pSettingArray[dSettings++].dGold = 30;
+
+  // Breakfast costs less
+  SimSetting_init(&pSettingArray[dSettings], "cheap-breakfast");
+  pSettingArray[dSettings++].dBreakfastCost = 5;
+
+  return dSettings;
+}
+
+#endif
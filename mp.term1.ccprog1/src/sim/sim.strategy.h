@@ -0,0 +1,220 @@
+/**
+ * The strategies the simulator plays with.
+ * A strategy is a handful of knobs (which crops to like, how much gold to keep for breakfast, how sloppy to be)
+ * and one function that turns those knobs into the actions of a single day.
+ * The random bits (which crop to plant today, whether to skip watering) come from the generator the caller hands us,
+ * so the same seed always plays out the same way.
+*/
+
+#ifndef SIM_STRATEGY
+#define SIM_STRATEGY
+
+#include "../utils/utils.random.h"
+
+#include "sim.game.h"
+
+#define SIM_MAX_STRATEGIES 32
+
+/**
+ * A parameterized way of playing.
+*/
+struct SimStrategy {
+  char *sName;
+
+  int dCropWeightArray[CATALOGUE_SIZE];   // How likely each crop is to be picked on a given day (ignored when greedy)
+  int bGreedy;                            // Always pick the crop with the best profit per energy spent
+
+  int dPlotLimit;                         // The most plots to keep busy at once
+  int dBreakfastDays;                     // How many breakfasts worth of gold to keep when buying seeds
+  int dSkipWaterChance;                   // The chance (in percent) of forgetting to water on a given day
+};
+
+/**
+ * Sets up a strategy that likes every crop equally and never slacks off.
+ *
+ * @param   {struct SimStrategy *}  this    The strategy to initialize.
+ * @param   {char *}                sName   What to call it in the output.
+*/
+void SimStrategy_init(struct SimStrategy *this, char *sName) {
+  this->sName = sName;
+
+  for(int i = 0; i < CATALOGUE_SIZE; i++)
+    this->dCropWeightArray[i] = i != PRODUCT_NULL;
+
+  this->bGreedy = 0;
+  this->dPlotLimit = FARM_MAX_WIDTH * FARM_MAX_HEIGHT;
+  this->dBreakfastDays = 1;
+  this->dSkipWaterChance = 0;
+}
+
+/**
+ * Makes the strategy only ever plant one crop.
+ *
+ * @param   {struct SimStrategy *}  this    The strategy to modify.
+ * @param   {enum ProductType}      eCrop   The crop to stick to.
+*/
+void SimStrategy_only(struct SimStrategy *this, enum ProductType eCrop) {
+  for(int i = 0; i < CATALOGUE_SIZE; i++)
+    this->dCropWeightArray[i] = i == eCrop;
+}
+
+/**
+ * Fills an array with the strategies we compare.
+ *
+ * @param   {struct SimStrategy *}  pStrategyArray  Where to put the strategies; needs room for SIM_MAX_STRATEGIES.
+ * @return  {int}                                   How many strategies there are.
+*/
+int SimStrategy_initAll(struct SimStrategy *pStrategyArray) {
+  int dStrategies = 0;
+
+  SimStrategy_init(&pStrategyArray[dStrategies], "banana-only");
+  SimStrategy_only(&pStrategyArray[dStrategies++], PRODUCT_BANANA);
+
+  SimStrategy_init(&pStrategyArray[dStrategies], "corn-only");
+  SimStrategy_only(&pStrategyArray[dStrategies++], PRODUCT_CORN);
+
+  SimStrategy_init(&pStrategyArray[dStrategies], "mango-only");
+  SimStrategy_only(&pStrategyArray[dStrategies++], PRODUCT_MANGO);
+
+  SimStrategy_init(&pStrategyArray[dStrategies++], "mixed");
+
+  SimStrategy_init(&pStrategyArray[dStrategies], "greedy");
+  pStrategyArray[dStrategies++].bGreedy = 1;
+
+  // Keeps a few more days of breakfast money around
+  SimStrategy_init(&pStrategyArray[dStrategies], "greedy-saver");
+  pStrategyArray[dStrategies].bGreedy = 1;
+  pStrategyArray[dStrategies++].dBreakfastDays = 3;
+
+  // Only ever works a few plots
+  SimStrategy_init(&pStrategyArray[dStrategies], "small-farm");
+  pStrategyArray[dStrategies++].dPlotLimit = 8;
+
+  // Forgets to water now and then
+  SimStrategy_init(&pStrategyArray[dStrategies], "forgetful");
+  pStrategyArray[dStrategies++].dSkipWaterChance = 30;
+
+  return dStrategies;
+}
+
+/**
+ * ##########################
+ * ###  STRATEGY METHODS  ###
+ * ##########################
+*/
+
+/**
+ * Picks the crop to plant today.
+ *
+ * @param   {struct SimStrategy *}  this        The strategy.
+ * @param   {struct SimGame *}      pGame       The game being played.
+ * @param   {struct UtilsRandom *}  pRandom     The generator of the game.
+ * @return  {enum ProductType}                  The crop to plant.
+*/
+enum ProductType SimStrategy_pickCrop(struct SimStrategy *this, struct SimGame *pGame, struct UtilsRandom *pRandom) {
+  struct GameCatalogue *pCatalogue = pGame->pCatalogue;
+  int dTotal = 0;
+
+  // Profit per unit of energy: one to till, one to sow, one per watering and one to harvest
+  if(this->bGreedy) {
+    enum ProductType eBest = PRODUCT_BANANA;
+    double fBest = -1e9;
+
+    for(int i = 1; i < pCatalogue->dSize; i++) {
+      double fValue = (double) (pCatalogue->dProductCostToSellArray[i] - pCatalogue->dProductCostToBuyArray[i]) /
+        (pCatalogue->dProductWaterReqArray[i] + 3);
+
+      if(fValue > fBest) {
+        fBest = fValue;
+        eBest = i;
+      }
+    }
+
+    return eBest;
+  }
+
+  for(int i = 1; i < pCatalogue->dSize; i++)
+    dTotal += this->dCropWeightArray[i];
+
+  // Roll for it
+  int dRoll = UtilsRandom_below(pRandom, dTotal);
+
+  for(int i = 1; i < pCatalogue->dSize; i++) {
+    if(dRoll < this->dCropWeightArray[i])
+      return i;
+
+    dRoll -= this->dCropWeightArray[i];
+  }
+
+  return PRODUCT_BANANA;
+}
+
+/**
+ * Plays out a single day, then goes home.
+ * The order is: harvest what's ready, sell everything, water, then buy, till, sow and water the new plots with whatever energy is left.
+ *
+ * @param   {struct SimStrategy *}  this        The strategy.
+ * @param   {struct SimGame *}      pGame       The game being played.
+ * @param   {struct UtilsRandom *}  pRandom     The generator of the game.
+ * @return  {int}                               Whether or not the player survived the night.
+*/
+int SimStrategy_playDay(struct SimStrategy *this, struct SimGame *pGame, struct UtilsRandom *pRandom) {
+  struct Player *pPlayer = pGame->pPlayer;
+  enum ProductType eCrop = SimStrategy_pickCrop(this, pGame, pRandom);
+  int dBusy, dFree, dTilled, dEnergy, dPlots, dSeeds, dAffordable, dReserve;
+
+  // Money in the bank first
+  SimGame_farm(pGame, FARM_HARVEST, PRODUCT_NULL, Player_getEnergy(pPlayer));
+  SimGame_sellAll(pGame);
+
+  // Keep the crops alive
+  if(!UtilsRandom_chance(pRandom, this->dSkipWaterChance))
+    SimGame_farm(pGame, FARM_WATER, PRODUCT_NULL, Player_getEnergy(pPlayer));
+
+  // How many more plots we're willing to work on
+  dBusy = SimGame_countPlots(pGame, PLOT_SOWN);
+  dFree = this->dPlotLimit - dBusy;
+
+  if(dFree <= 0)
+    return SimGame_goHome(pGame);
+
+  // Tilled plots need sowing and watering; each new plot also needs tilling first
+  dTilled = SimGame_countPlots(pGame, PLOT_TILLED);
+  dEnergy = Player_getEnergy(pPlayer);
+  dSeeds = dEnergy <= 2 * dTilled ? dEnergy / 2 : dTilled + (dEnergy - 2 * dTilled) / 3;
+
+  if(dSeeds > dFree)
+    dSeeds = dFree;
+
+  dPlots = dSeeds;
+
+  // Don't spend the breakfast money
+  dReserve = this->dBreakfastDays * Player_getBreakfastCost(pPlayer);
+  dAffordable = (Player_getGold(pPlayer) - dReserve) / pGame->pCatalogue->dProductCostToBuyArray[eCrop];
+
+  if(dSeeds > dAffordable)
+    dSeeds = dAffordable;
+
+  // Use the seeds we already have before buying new ones
+  dSeeds -= Stock_getAmount(Player_getSeedStock(pPlayer, eCrop));
+
+  if(dSeeds > 0)
+    SimGame_buy(pGame, eCrop, dSeeds);
+
+  // Plant them (but only as many as we have the energy and room for)
+  dSeeds = Stock_getAmount(Player_getSeedStock(pPlayer, eCrop));
+
+  if(dSeeds > dPlots)
+    dSeeds = dPlots;
+
+  SimGame_farm(pGame, FARM_TILL, PRODUCT_NULL, dSeeds - dTilled);
+  SimGame_farm(pGame, FARM_SOW, eCrop, dSeeds);
+
+  // Freshly sown plots can already be watered today
+  if(!UtilsRandom_chance(pRandom, this->dSkipWaterChance))
+    SimGame_farm(pGame, FARM_WATER, PRODUCT_NULL, Player_getEnergy(pPlayer));
+
+  return SimGame_goHome(pGame);
+}
+
+#endif
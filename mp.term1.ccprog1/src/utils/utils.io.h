@@ -11,6 +11,8 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include "utils.mem.h"
+
 // Some useful constants
 #define UTILS_IO_BS 8       // Backspace
 #define UTILS_IO_LF 10      // Line feed
@@ -20,6 +22,42 @@
 
 #define UTILS_IO_MAX_INPUT 1024
 
+// What we say the console is when we can't ask it (like when stdin isn't a terminal)
+#define UTILS_IO_FALLBACK_WIDTH 130
+#define UTILS_IO_FALLBACK_HEIGHT 40
+
+/**
+ * The size the console has been pinned to, if it has been.
+ * The benchmarks pin it so their numbers don't depend on the terminal they were started from.
+*/
+struct UtilsIOSize {
+  int dWidth;
+  int dHeight;
+};
+
+/**
+ * Returns the one instance of the struct above.
+ * 
+ * @return  {struct UtilsIOSize *}  The pinned size; zeroes when nothing was pinned.
+*/
+struct UtilsIOSize *UtilsIO_getFixedSize() {
+  static struct UtilsIOSize size;
+
+  return &size;
+}
+
+/**
+ * Makes UtilsIO_getWidth() and UtilsIO_getHeight() return the given size instead of asking the console.
+ * Passing zeroes goes back to asking the console.
+ * 
+ * @param   {int}   dWidth    The width to report.
+ * @param   {int}   dHeight   The height to report.
+*/
+void UtilsIO_fixSize(int dWidth, int dHeight) {
+  UtilsIO_getFixedSize()->dWidth = dWidth;
+  UtilsIO_getFixedSize()->dHeight = dHeight;
+}
+
 // It's funny how these things had to be machine-specific
 // These are just some workarounds I decided to implement for a better UI
 // If you're asking why I had to do this, it's because I use Ubuntu and you probably use Windows D;
@@ -61,15 +99,17 @@ int UtilsIO_getWidth() {
 
   // I must say this is a painfully long name for a data type
   CONSOLE_SCREEN_BUFFER_INFO consoleScreenBufferInfo;
+
+  if(UtilsIO_getFixedSize()->dWidth)
+    return UtilsIO_getFixedSize()->dWidth;
   
   // Some library functions from windows.h that return the dimensions of the console
-  GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &consoleScreenBufferInfo);
+  // This fails when stdout isn't a console, in which case the struct would just be garbage
+  if(!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &consoleScreenBufferInfo))
+    return UTILS_IO_FALLBACK_WIDTH;
 
-  // While we're at it, let's change the buffering behaviour in case the console was resized
-  // _IOFBF means data is written to the output stream once the buffer is full
-  // _IOLBF (the default) writes data once a newline is encountered
-  // char cBufferArray[dWidth];
-  setvbuf(stdout, NULL, _IOFBF, consoleScreenBufferInfo.srWindow.Right - consoleScreenBufferInfo.srWindow.Left + 1);
+  // This used to change the buffering behaviour here too, but that's now done once per frame size by UtilsIO_setBuffer()
+  // Calling setvbuf() on every width query was resetting the buffer mid-frame anyway
 
   // Note the plus one is needed to get the inclusive value of the difference
   return consoleScreenBufferInfo.srWindow.Right - consoleScreenBufferInfo.srWindow.Left + 1;
@@ -85,9 +125,13 @@ int UtilsIO_getHeight() {
   
   // I must say this is a painfully long name for a struct
   CONSOLE_SCREEN_BUFFER_INFO consoleScreenBufferInfo;
+
+  if(UtilsIO_getFixedSize()->dHeight)
+    return UtilsIO_getFixedSize()->dHeight;
   
   // Some library functions from windows.h that return the dimensions of the console
-  GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &consoleScreenBufferInfo);
+  if(!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &consoleScreenBufferInfo))
+    return UTILS_IO_FALLBACK_HEIGHT;
 
   // Note the plus one is needed to get the inclusive value of the difference
   return consoleScreenBufferInfo.srWindow.Bottom - consoleScreenBufferInfo.srWindow.Top + 1;
@@ -126,15 +170,7 @@ int UtilsIO_setSize(int dWidth, int dHeight) {
     SMALL_RECT const newWindowSize = { 0, 0, dWidth - 1, dHeight - 1 };
     SetConsoleWindowInfo(GetStdHandle(STD_OUTPUT_HANDLE), TRUE, &newWindowSize);
 
-    // This is another thing I found elsewhere which speeds printf up
-    // Console output by default is buffered per line, which means everytime we counter a \n things slow down
-    // In other words, in only prints in chunks of lines
-    // In order to circumvent that hindrance, we set the buffer size ourselves
-    
-    // _IOFBF means data is written to the output stream once the buffer is full
-    // _IOLBF (the default) writes data once a newline is encountered
-    // We don't need to do this for Unix anymore cuz it's already quite fast for some reason.
-    setvbuf(stdout, NULL, _IOFBF, dWidth);
+    // The output buffer used to be resized here, but UtilsUI_print() now sizes it to the whole frame (see UtilsIO_setBuffer())
 
     // The screen size was changed
     // Note that the unix version of the function returns 0 since it does nothing
@@ -150,6 +186,33 @@ void UtilsIO_clear() {
   system("cls");
 }
 
+/**
+ * Sets the size of the output buffer of stdout.
+ * This is another thing I found elsewhere which speeds printf up.
+ * Console output by default is buffered per line, which means everytime we counter a \n things slow down.
+ * By making the buffer as big as a whole frame, the frame gets written out in one go.
+ * 
+ * _IOFBF means data is written to the output stream once the buffer is full
+ * _IOLBF (the default) writes data once a newline is encountered
+ * 
+ * @param   {int}   dSize   The new size of the buffer.
+*/
+void UtilsIO_setBuffer(int dSize) {
+  fflush(stdout);
+  setvbuf(stdout, NULL, _IOFBF, dSize);
+}
+
+/**
+ * Writes a whole frame to the console and flushes it.
+ * 
+ * @param   {char *}  sFrame    The frame to be written.
+ * @param   {int}     dLength   The number of characters in the frame.
+*/
+void UtilsIO_writeFrame(char *sFrame, int dLength) {
+  fwrite(sFrame, sizeof(char), dLength, stdout);
+  fflush(stdout);
+}
+
 /**
  * Helper function that gets a single character without return key.
  * 
@@ -159,6 +222,27 @@ char UtilsIO_readChar() {
   return getch();
 }
 
+/**
+ * Helper function that waits a while for a single character, but gives up if nothing is pressed.
+ * There's no select() for the console here, so we just check every few milliseconds.
+ * 
+ * @param   {int}   dMillis   How long to wait in milliseconds.
+ * @return  {char}            The character read from the console, or 0 if nothing was pressed.
+*/
+char UtilsIO_readCharTimeout(int dMillis) {
+  for(int i = 0; i < dMillis && !_kbhit(); i += 10)
+    Sleep(10);
+
+  return _kbhit() ? getch() : 0;
+}
+
+/**
+ * getch() doesn't go through stdio, so there's nothing to unbuffer here.
+*/
+void UtilsIO_setUnbuffered() {
+
+}
+
 /**
  * This only exists mainly because I need to do some housekeeping for Unix-based OS's.
  * 
@@ -184,6 +268,7 @@ void UtilsIO_exit(struct UtilsIO *this) {
 */
 #else
 #include <sys/ioctl.h>
+#include <sys/select.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -230,7 +315,13 @@ int UtilsIO_getWidth() {
   
   // A library function from ioctl.h that gets the current terminal size
   struct winsize windowSize;
-  ioctl(0, TIOCGWINSZ, &windowSize);
+
+  if(UtilsIO_getFixedSize()->dWidth)
+    return UtilsIO_getFixedSize()->dWidth;
+
+  // It fails when stdin isn't a terminal, and then the struct is just whatever was on the stack
+  if(ioctl(0, TIOCGWINSZ, &windowSize) || !windowSize.ws_col)
+    return UTILS_IO_FALLBACK_WIDTH;
 
   return windowSize.ws_col;
 }
@@ -245,7 +336,12 @@ int UtilsIO_getHeight() {
   
   // A library function from ioctl.h that gets the current terminal size
   struct winsize windowSize;
-  ioctl(0, TIOCGWINSZ, &windowSize);
+
+  if(UtilsIO_getFixedSize()->dHeight)
+    return UtilsIO_getFixedSize()->dHeight;
+
+  if(ioctl(0, TIOCGWINSZ, &windowSize) || !windowSize.ws_row)
+    return UTILS_IO_FALLBACK_HEIGHT;
 
   return windowSize.ws_row;
 }
@@ -275,6 +371,39 @@ void UtilsIO_clear() {
   printf("\e[H\e[2J\e[3J");
 }
 
+/**
+ * Sets the size of the output buffer of stdout.
+ * Unix terminals are line buffered by default, which means a frame used to go out in many small writes.
+ * By making the buffer as big as a whole frame, the clear sequence and the frame after it end up in a single write(2).
+ * Note that glibc ignores the size when we don't hand it a buffer, so we have to keep one around ourselves.
+ * 
+ * @param   {int}   dSize   The new size of the buffer.
+*/
+void UtilsIO_setBuffer(int dSize) {
+  static char *sBuffer = NULL;
+  char *sOldBuffer = sBuffer;
+
+  // Anything still in the old buffer has to go out before we swap it
+  fflush(stdout);
+
+  sBuffer = UtilsMem_calloc(UTILS_MEM_IO, dSize, sizeof(char));
+  setvbuf(stdout, sBuffer, _IOFBF, dSize);
+
+  UtilsMem_free(sOldBuffer);
+}
+
+/**
+ * Writes a whole frame to the console and flushes it.
+ * As long as the buffer was sized with UtilsIO_setBuffer(), the frame goes out in one write(2).
+ * 
+ * @param   {char *}  sFrame    The frame to be written.
+ * @param   {int}     dLength   The number of characters in the frame.
+*/
+void UtilsIO_writeFrame(char *sFrame, int dLength) {
+  fwrite(sFrame, sizeof(char), dLength, stdout);
+  fflush(stdout);
+}
+
 /**
  * Helper function that gets a single character without return key.
  * 
@@ -284,6 +413,35 @@ char UtilsIO_readChar() {
   return getchar();
 }
 
+/**
+ * Helper function that waits a while for a single character, but gives up if nothing is pressed.
+ * select() only knows about what the terminal hasn't handed over yet, so stdin has to be unbuffered for this (see below);
+ * otherwise keys that stdio already read in would just sit there until the next key.
+ * 
+ * @param   {int}   dMillis   How long to wait in milliseconds.
+ * @return  {char}            The character read from the console, or 0 if nothing was pressed.
+*/
+char UtilsIO_readCharTimeout(int dMillis) {
+  struct timeval timeout = { dMillis / 1000, (dMillis % 1000) * 1000 };
+  fd_set readSet;
+
+  FD_ZERO(&readSet);
+  FD_SET(STDIN_FILENO, &readSet);
+
+  if(select(STDIN_FILENO + 1, &readSet, NULL, NULL, &timeout) <= 0)
+    return 0;
+
+  return getchar();
+}
+
+/**
+ * Makes stdin hand over one character at a time so UtilsIO_readCharTimeout() can tell when something was pressed.
+ * It has to be called before anything is read.
+*/
+void UtilsIO_setUnbuffered() {
+  setvbuf(stdin, NULL, _IONBF, 0);
+}
+
 /**
  * Clean up the stuff I used.
  * 
@@ -344,7 +502,7 @@ int UtilsIO_isBackspace(char cChar) {
  * @return  {char *}  A pointer to memory that can hold a string of up to UTILS_IO_MAX_INPUT characters.
 */
 char *UtilsIO_newInputStr() {
-  char *sOutput = calloc(UTILS_IO_MAX_INPUT, sizeof(char));
+  char *sOutput = UtilsMem_calloc(UTILS_MEM_IO, UTILS_IO_MAX_INPUT, sizeof(char));
   return sOutput;
 }
 
@@ -354,7 +512,7 @@ char *UtilsIO_newInputStr() {
  * @param   {char *}  sOutput   The string to free from memory.
 */
 void UtilsIO_killInputStr(char *sOutput) {
-  free(sOutput);
+  UtilsMem_free(sOutput);
 }
 
 /**
@@ -378,21 +536,20 @@ char UtilsIO_inputChar() {
  * @return  {char *}  Returns the character string from the console.
 */
 char *UtilsIO_inputStr() {
-  char *sOutput = calloc(UTILS_IO_MAX_INPUT, sizeof(char));
-  char *sInput = calloc(1, sizeof(char));
+  char *sOutput = UtilsMem_calloc(UTILS_MEM_IO, UTILS_IO_MAX_INPUT, sizeof(char));
   char cInput;
   int dLength = 0;
 
   do {
     cInput = UtilsIO_readChar();
-    sprintf(sInput, "%c", cInput);
 
     // If user is not done inputting
     if(!UtilsIO_isReturn(cInput)) {
 
       // Backspace handling condition
+      // We keep track of the length ourselves so we don't have to strcat() every character
       if(!UtilsIO_isBackspace(cInput)) {
-        strcat(sOutput, sInput);
+        sOutput[dLength] = cInput;
         printf("%c", cInput);
       } else {
         sOutput[dLength--] = 0;
@@ -401,7 +558,6 @@ char *UtilsIO_inputStr() {
     }
   } while(!UtilsIO_isReturn(cInput) && ++dLength < UTILS_IO_MAX_INPUT);
 
-  free(sInput);
   return sOutput;
 }
 
@@ -414,31 +570,31 @@ char *UtilsIO_inputStr() {
  * @return  {int}               A boolean that returns false when a return key has been pressed.
 */
 int UtilsIO_inputStrOut(char *sOutput) {
-  char *sInput = calloc(1, sizeof(char));
-  char cInput;
+  int dLength = strlen(sOutput);
+  char cInput = 0;
 
-  if(strlen(sOutput) < UTILS_IO_MAX_INPUT) {
+  if(dLength < UTILS_IO_MAX_INPUT) {
     cInput = UtilsIO_readChar();
-    sprintf(sInput, "%c", cInput);  
     
     // If user is not done inputting
     if(!UtilsIO_isReturn(cInput)) {
 
       // Backspace handling condition
-      if(!UtilsIO_isBackspace(cInput)) 
-        strcat(sOutput, sInput);
+      if(!UtilsIO_isBackspace(cInput)) {
+        sOutput[dLength++] = cInput;
+        sOutput[dLength] = 0;
+      }
     } else {
       return 0;
     }
   } 
   
   // In case it's a backspace
-  if(strlen(sOutput)) {
+  if(dLength) {
     if(UtilsIO_isBackspace(cInput))
-      sOutput[strlen(sOutput) - 1] = 0;
+      sOutput[dLength - 1] = 0;
   }
 
-  free(sInput);
   return 1;
 }
 
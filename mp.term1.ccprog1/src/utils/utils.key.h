@@ -8,6 +8,7 @@
 #ifndef UTILS_KEY
 #define UTILS_KEY
 
+#include <ctype.h>
 #include <string.h>
 
 #include "utils.io.h"
@@ -24,6 +25,48 @@ struct UtilsKey {
   
 };
 
+/**
+ * Something that has to keep happening while we wait for a key (like crops growing in real-time mode).
+ * There's only ever one of these; see UtilsKey_getTicker().
+*/
+struct UtilsKeyTicker {
+  int (*fTick)(void *pData);    // Returns whether or not anything changed, i.e. whether the screen should be drawn again
+  void *pData;
+  int dMillis;                  // How often to tick
+};
+
+/**
+ * Returns the one ticker.
+ * Its function is NULL unless somebody set it.
+ *
+ * @return  {struct UtilsKeyTicker *}   The ticker.
+*/
+struct UtilsKeyTicker *UtilsKey_getTicker() {
+  static struct UtilsKeyTicker utilsKeyTicker;
+
+  return &utilsKeyTicker;
+}
+
+/**
+ * Sets what to do while waiting for a key.
+ * Passing NULL goes back to just waiting.
+ *
+ * @param   {int (*)(void *pData)}  fTick     Called every dMillis milliseconds; returns whether anything changed.
+ * @param   {void *}                pData     Passed to the function.
+ * @param   {int}                   dMillis   How often to call it.
+*/
+void UtilsKey_setTicker(int (*fTick)(void *pData), void *pData, int dMillis) {
+  struct UtilsKeyTicker *pTicker = UtilsKey_getTicker();
+
+  // Key presses need to be visible to select() one at a time from now on
+  if(fTick != NULL)
+    UtilsIO_setUnbuffered();
+
+  pTicker->fTick = fTick;
+  pTicker->pData = pData;
+  pTicker->dMillis = dMillis;
+}
+
 /**
  * ########################
  * ###  INPUT HANDLING  ###
@@ -33,13 +76,27 @@ struct UtilsKey {
 /**
  * Enables some basic interaction with the game by returning the uppercase version of a character.
  * I don't know why I didn't realize until after the entire ordeal of coding this project that toupper() exists.
+ * If there's a ticker, it might also return 0 without a key being pressed (the input loops just redraw on that).
  * 
  * @return  {char}  Returns the uppercase alphabet character of the input.
 */
 char UtilsKey_uppercaseChar() {
 
+  struct UtilsKeyTicker *pTicker = UtilsKey_getTicker();
+  char cInput;
+
   // Read input
-  char cInput = UtilsIO_readChar();
+  if(pTicker->fTick == NULL) {
+    cInput = UtilsIO_readChar();
+
+  // Keep ticking until a key comes in; if something changed in the meantime we return 0 so the screen gets redrawn
+  // We tick before waiting too, so mashing keys doesn't keep the clock from running
+  } else {
+    do {
+      if((*pTicker->fTick)(pTicker->pData))
+        return 0;
+    } while(!(cInput = UtilsIO_readCharTimeout(pTicker->dMillis)));
+  }
 
   // If it's already uppercase
   if(64 < cInput && cInput < 91)
@@ -0,0 +1,217 @@
+/**
+ * A cache for screens that barely change.
+ * The menu, guide, controls and author pages used to center every sprite line again on every keystroke.
+ * This class keeps the centered lines around until the console changes size, so drawing them again is just a copy.
+*/
+
+#ifndef UTILS_LAYOUT
+#define UTILS_LAYOUT
+
+#include <string.h>
+
+#include "utils.io.h"
+#include "utils.mem.h"
+#include "utils.string.h"
+#include "utils.text.h"
+#include "utils.ui.h"
+
+/**
+ * An instantiable that stores a screen that has already been centered.
+ * All the lines live in one block of memory, each line taking (dWidth + 1) characters.
+ * A few lines (the slot) can be replaced after the layout has been built; this is where selectors go.
+*/
+struct UtilsLayout {
+  struct UtilsText *pText;    // The centered lines; they point into sBlock
+  char *sBlock;               // The memory of all the lines
+  struct UtilsString *pLine;  // Reused when centering a slot line
+
+  int dWidth;                 // The console size the layout was built for (0 means it hasn't been built)
+  int dHeight;
+  int dOffset;                // How far down the content was moved when it was centered
+  int dSlot;                  // Where the replaceable lines start (in the uncentered content)
+};
+
+/**
+ * #############################
+ * ###  LAYOUT CONSTRUCTION  ###
+ * #############################
+*/
+
+/**
+ * Returns a new instance of the UtilsLayout class.
+ *
+ * @return  {struct UtilsLayout *}  A pointer to the created instance.
+*/
+struct UtilsLayout *UtilsLayout_new() {
+  struct UtilsLayout *pUtilsLayout;
+
+  pUtilsLayout = UtilsMem_calloc(UTILS_MEM_UI, 1, sizeof(*pUtilsLayout));
+
+  if(pUtilsLayout == NULL)
+    return NULL;
+
+  return pUtilsLayout;
+}
+
+/**
+ * Initializes the object.
+ * The layout starts out empty, so the first frame always builds it.
+ *
+ * @param   {struct UtilsLayout *}  this  The instance to be initialized.
+*/
+void UtilsLayout_init(struct UtilsLayout *this) {
+  this->pText = UtilsText_create();
+  this->sBlock = NULL;
+  this->pLine = UtilsString_create();
+
+  this->dWidth = 0;
+  this->dHeight = 0;
+  this->dOffset = 0;
+  this->dSlot = 0;
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @return  {struct UtilsLayout *}  The created instance.
+*/
+struct UtilsLayout *UtilsLayout_create() {
+  struct UtilsLayout *pUtilsLayout = UtilsLayout_new();
+  UtilsLayout_init(pUtilsLayout);
+
+  return pUtilsLayout;
+}
+
+/**
+ * Destroys a specified instance along with its lines.
+ *
+ * @param   {struct UtilsLayout *}  this  The instance to be destroyed.
+*/
+void UtilsLayout_kill(struct UtilsLayout *this) {
+  UtilsMem_free(this->sBlock);
+  UtilsText_kill(this->pText);
+  UtilsString_kill(this->pLine);
+  UtilsMem_free(this);
+}
+
+/**
+ * ####################################
+ * ###  LAYOUT READERS AND WRITERS  ###
+ * ####################################
+*/
+
+/**
+ * Checks whether or not the layout was built for the current console size.
+ *
+ * @param   {struct UtilsLayout *}  this  The instance to be read.
+ * @return  {int}                         Whether or not the layout can be reused.
+*/
+int UtilsLayout_isFresh(struct UtilsLayout *this) {
+  return this->dWidth &&
+    this->dWidth == UtilsIO_getWidth() &&
+    this->dHeight == UtilsIO_getHeight();
+}
+
+/**
+ * Forgets the stored layout, so the next frame has to build it again.
+ *
+ * @param   {struct UtilsLayout *}  this  The instance to be modified.
+*/
+void UtilsLayout_invalidate(struct UtilsLayout *this) {
+  this->dWidth = 0;
+  this->dHeight = 0;
+}
+
+/**
+ * Marks the next line of the content as the start of the replaceable lines.
+ * Call this while putting together the content, right before adding the selector.
+ *
+ * @param   {struct UtilsLayout *}  this      The instance to be modified.
+ * @param   {struct UtilsText *}    pContent  The content being put together.
+*/
+void UtilsLayout_markSlot(struct UtilsLayout *this, struct UtilsText *pContent) {
+  this->dSlot = UtilsText_getLines(pContent);
+}
+
+/**
+ * Centers the content on the console and stores a copy of it.
+ * The content is modified in the process (just like with UtilsUI_centerXY()), so it shouldn't be used after.
+ *
+ * @param   {struct UtilsLayout *}  this      The instance to be modified.
+ * @param   {struct UtilsText *}    pContent  The content to be centered and stored.
+ * @param   {struct UtilsText *}    pFooter   A footer to be placed on the content, or NULL if there isn't any.
+*/
+void UtilsLayout_build(struct UtilsLayout *this, struct UtilsText *pContent, struct UtilsText *pFooter) {
+  int dLines = UtilsText_getLines(pContent);
+  int dWidth = UtilsIO_getWidth();
+  int dLength;
+
+  // Formatting
+  pContent = UtilsUI_centerXY(pContent);
+  dLength = UtilsText_getLines(pContent);
+
+  if(pFooter != NULL)
+    UtilsUI_footer(pContent, pFooter);
+
+  // Just in case the console reports something silly
+  if(dWidth < 1)
+    dWidth = 1;
+
+  // UtilsUI_centerXY() pads the same amount above and below
+  this->dOffset = dLength > dLines ? (dLength - dLines) / 2 : 0;
+
+  // One block for everything
+  UtilsMem_free(this->sBlock);
+  this->sBlock = UtilsMem_calloc(UTILS_MEM_UI, dLength * (dWidth + 1) + 1, sizeof(char));
+
+  for(int i = 0; i < dLength; i++) {
+    char *sLine = this->sBlock + i * (dWidth + 1);
+    int dLineLength = strlen(pContent->sTextArray[i]);
+
+    // Anything past the width gets cut off by UtilsUI_print() anyway
+    if(dLineLength > dWidth)
+      dLineLength = dWidth;
+
+    memcpy(sLine, pContent->sTextArray[i], dLineLength);
+    this->pText->sTextArray[i] = sLine;
+  }
+
+  this->pText->dLength = dLength;
+  this->dWidth = dWidth;
+  this->dHeight = UtilsIO_getHeight();
+}
+
+/**
+ * Replaces one of the lines in the slot with new text, centered the same way UtilsUI_centerXY() would.
+ *
+ * @param   {struct UtilsLayout *}  this    The instance to be modified.
+ * @param   {int}                   dIndex  Which line of the slot to replace.
+ * @param   {char *}                sText   The new text.
+*/
+void UtilsLayout_setSlotLine(struct UtilsLayout *this, int dIndex, char *sText) {
+  int dLine = this->dOffset + this->dSlot + dIndex;
+  char *sLine;
+
+  if(dLine < 0 || dLine >= this->pText->dLength)
+    return;
+
+  // Center the text then copy it over the old line
+  UtilsString_clear(this->pLine);
+  UtilsText_paddedTextOut(this->pLine, sText, " ", UTILS_TEXT_CENTER_ALIGN);
+  UtilsString_truncate(this->pLine, this->dWidth);
+
+  sLine = this->sBlock + dLine * (this->dWidth + 1);
+  memcpy(sLine, UtilsString_getText(this->pLine), UtilsString_getLength(this->pLine) + 1);
+}
+
+/**
+ * Returns the stored lines so they can be printed.
+ *
+ * @param   {struct UtilsLayout *}  this  The instance to be read.
+ * @return  {struct UtilsText *}          The centered lines.
+*/
+struct UtilsText *UtilsLayout_getText(struct UtilsLayout *this) {
+  return this->pText;
+}
+
+#endif
@@ -0,0 +1,759 @@
+/**
+ * A file containing an accounting layer for everything we allocate on the heap.
+ * Every calloc() in the game now goes through here, tagged with the subsystem that asked for it.
+ * Each tag keeps track of its live bytes, peak bytes and allocation counts, so at exit (or when poked with a signal) we can dump a report
+ * that tells us which parts of the game leak and which ones just churn through memory every frame.
+ *
+ * Compiling with -DUTILS_MEM_DEBUG also records the call site (file and line) of each allocation, so the report can point at the exact line.
+ * Compiling with -DUTILS_THREADS gives every thread its own counters; the batch tools need that since they run a game on each thread.
+ * The object pools (see utils.pool.h) get their own section in the report, since their slabs hide the objects from the tags.
+*/
+
+#ifndef UTILS_MEM
+#define UTILS_MEM
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Where the report gets written
+// The game is always run from the project folder (see main.c), so this ends up beside the compile logs
+#ifndef UTILS_MEM_REPORT_PATH
+#define UTILS_MEM_REPORT_PATH "build/logs/.mem.txt"
+#endif
+
+#define UTILS_MEM_MAX_SITES 1024          // Number of call sites we can track in debug mode; must be a power of two
+#define UTILS_MEM_MAX_REPORT (1 << 16)     // Size of the buffer the report is formatted into
+#define UTILS_MEM_REPORT_SITES 24         // Number of sites listed per section of the report
+
+// A tag or site is said to churn when it has made this many allocations...
+// ... and the number of allocations is this many times its peak number of live blocks
+#define UTILS_MEM_CHURN_MIN 256
+#define UTILS_MEM_CHURN_RATIO 16
+
+// Storage class for state that has to be per-thread when the tools are running games in parallel
+// The game itself only ever has one thread, so this is empty there
+#ifdef UTILS_THREADS
+#define UTILS_THREAD_LOCAL __thread
+#else
+#define UTILS_THREAD_LOCAL
+#endif
+
+/**
+ * The subsystems an allocation can be charged to.
+*/
+enum UtilsMem_Tag {
+  UTILS_MEM_MISC,
+  UTILS_MEM_IO,
+  UTILS_MEM_TEXT,
+  UTILS_MEM_STRING,
+  UTILS_MEM_UI,
+  UTILS_MEM_SELECTOR,
+  UTILS_MEM_PRODUCT,
+  UTILS_MEM_STOCK,
+  UTILS_MEM_PLOT,
+  UTILS_MEM_PLAYER,
+  UTILS_MEM_FARM,
+  UTILS_MEM_SHOP,
+  UTILS_MEM_GAME,
+  UTILS_MEM_TAGS
+};
+
+/**
+ * The counters we keep for every tag (and every call site in debug mode).
+*/
+struct UtilsMemStats {
+  long dAllocs;         // Number of allocations made
+  long dFrees;          // Number of frees made
+  long dLiveBlocks;     // Number of blocks that haven't been freed yet
+  long dPeakBlocks;     // Most blocks that were alive at the same time
+  long dLiveBytes;      // Number of bytes that haven't been freed yet
+  long dPeakBytes;      // Most bytes that were alive at the same time
+  long dTotalBytes;     // Total number of bytes ever requested
+};
+
+/**
+ * A call site, only used in debug mode.
+*/
+struct UtilsMemSite {
+  const char *sFile;
+  int dLine;
+  enum UtilsMem_Tag eTag;
+
+  struct UtilsMemStats stats;
+};
+
+/**
+ * The bookkeeping prepended to every block we hand out.
+ * The union makes sure the memory after the header is still aligned for any type.
+*/
+union UtilsMemHeader {
+  struct {
+    size_t dSize;
+    int eTag;
+    int dSite;
+  } info;
+
+  long double ldAlign;
+  long long llAlign;
+  void *pAlign;
+};
+
+/**
+ * The occupancy counters of an object pool (see utils.pool.h).
+ * Every pool registers one of these the first time it's used, and they're kept in a linked list for the report.
+*/
+struct UtilsMemPool {
+  char *sName;
+  enum UtilsMem_Tag eTag;
+
+  long dSlabs;          // Number of slabs the pool has grabbed
+  long dSlots;          // Number of objects those slabs can hold
+  long dLive;           // Number of objects handed out and not given back yet
+  long dPeak;           // Most objects handed out at the same time
+  long dAllocs;         // Number of objects ever handed out
+  long dFrees;          // Number of objects ever given back
+
+  void (*fTrim)();      // Gives the slabs back if the pool is empty
+  struct UtilsMemPool *pNext;
+};
+
+/**
+ * A struct to hold the state of the accounting layer so we don't pollute the global namespace.
+ * There's only ever one of these (one per thread with -DUTILS_THREADS); see UtilsMem_get().
+*/
+struct UtilsMem {
+  int bIsReady;
+  struct UtilsMemStats tagArray[UTILS_MEM_TAGS];
+  struct UtilsMemStats total;
+
+  int dSites;
+  struct UtilsMemSite siteArray[UTILS_MEM_MAX_SITES];
+
+  struct UtilsMemPool *pPoolList;
+};
+
+// These macros are what the rest of the code calls
+// They're macros so that the call site can be captured by __FILE__ and __LINE__
+#define UtilsMem_calloc(eTag, dCount, dSize) UtilsMem_callocAt(eTag, dCount, dSize, __FILE__, __LINE__)
+#define UtilsMem_realloc(eTag, pBlock, dSize) UtilsMem_reallocAt(eTag, pBlock, dSize, __FILE__, __LINE__)
+
+/**
+ * ############################
+ * ###  ACCOUNTING HELPERS  ###
+ * ############################
+*/
+
+/**
+ * Returns the one instance of the accounting layer.
+ *
+ * @return  {struct UtilsMem *}   The accounting state.
+*/
+struct UtilsMem *UtilsMem_get() {
+  static UTILS_THREAD_LOCAL struct UtilsMem utilsMem;
+
+  return &utilsMem;
+}
+
+/**
+ * Returns the printable name of a tag.
+ *
+ * @param   {enum UtilsMem_Tag}   eTag  The tag to name.
+ * @return  {char *}                    The name of the tag.
+*/
+char *UtilsMem_getTagName(enum UtilsMem_Tag eTag) {
+  switch(eTag) {
+    case UTILS_MEM_MISC:      return "misc";
+    case UTILS_MEM_IO:        return "io";
+    case UTILS_MEM_TEXT:      return "text";
+    case UTILS_MEM_STRING:    return "string";
+    case UTILS_MEM_UI:        return "ui";
+    case UTILS_MEM_SELECTOR:  return "selector";
+    case UTILS_MEM_PRODUCT:   return "product";
+    case UTILS_MEM_STOCK:     return "stock";
+    case UTILS_MEM_PLOT:      return "plot";
+    case UTILS_MEM_PLAYER:    return "player";
+    case UTILS_MEM_FARM:      return "farm";
+    case UTILS_MEM_SHOP:      return "shop";
+    case UTILS_MEM_GAME:      return "game";
+    default:                  return "?";
+  }
+}
+
+/**
+ * Charges an allocation (or a free, if dBytes is negative) to a set of counters.
+ *
+ * @param   {struct UtilsMemStats *}  pStats  The counters to update.
+ * @param   {long}                    dBytes  The number of bytes allocated; negative when freeing.
+*/
+void UtilsMem_charge(struct UtilsMemStats *pStats, long dBytes) {
+  if(dBytes >= 0) {
+    pStats->dAllocs++;
+    pStats->dLiveBlocks++;
+    pStats->dTotalBytes += dBytes;
+  } else {
+    pStats->dFrees++;
+    pStats->dLiveBlocks--;
+  }
+
+  pStats->dLiveBytes += dBytes;
+
+  if(pStats->dLiveBlocks > pStats->dPeakBlocks) pStats->dPeakBlocks = pStats->dLiveBlocks;
+  if(pStats->dLiveBytes > pStats->dPeakBytes) pStats->dPeakBytes = pStats->dLiveBytes;
+}
+
+/**
+ * Returns the index of the record of a call site, creating one if it doesn't exist yet.
+ * Only does something in debug mode; otherwise it just returns -1.
+ * The sites are stored in an open-addressed hash table keyed by the file and line.
+ *
+ * @param   {enum UtilsMem_Tag}   eTag    The tag of the allocation.
+ * @param   {const char *}        sFile   The file of the call site.
+ * @param   {int}                 dLine   The line of the call site.
+ * @return  {int}                         The index of the site, or -1 if we aren't tracking sites.
+*/
+int UtilsMem_getSite(enum UtilsMem_Tag eTag, const char *sFile, int dLine) {
+  #ifdef UTILS_MEM_DEBUG
+    struct UtilsMem *this = UtilsMem_get();
+
+    // __FILE__ literals are pooled by the compiler, so hashing the pointer is good enough
+    size_t dHash = ((size_t) sFile >> 4) * 31 + dLine;
+    int dIndex = dHash & (UTILS_MEM_MAX_SITES - 1);
+
+    // Linear probing until we find the site or an empty slot
+    for(int i = 0; i < UTILS_MEM_MAX_SITES; i++) {
+      struct UtilsMemSite *pSite = &this->siteArray[dIndex];
+
+      if(pSite->sFile == NULL) {
+        pSite->sFile = sFile;
+        pSite->dLine = dLine;
+        pSite->eTag = eTag;
+        this->dSites++;
+
+        return dIndex;
+      }
+
+      if(pSite->dLine == dLine && !strcmp(pSite->sFile, sFile))
+        return dIndex;
+
+      dIndex = (dIndex + 1) & (UTILS_MEM_MAX_SITES - 1);
+    }
+  #endif
+
+  return -1;
+}
+
+/**
+ * Adds a pool to the list of pools in the report.
+ *
+ * @param   {struct UtilsMemPool *}   pPool   The counters of the pool.
+*/
+void UtilsMem_addPool(struct UtilsMemPool *pPool) {
+  struct UtilsMem *this = UtilsMem_get();
+
+  pPool->pNext = this->pPoolList;
+  this->pPoolList = pPool;
+}
+
+/**
+ * Charges an object handed out by a pool (or given back, if dCount is negative) to its counters.
+ *
+ * @param   {struct UtilsMemPool *}   pPool   The counters of the pool.
+ * @param   {int}                     dCount  1 when handing out an object, -1 when getting one back.
+*/
+void UtilsMem_chargePool(struct UtilsMemPool *pPool, int dCount) {
+  if(dCount > 0) pPool->dAllocs++;
+  else pPool->dFrees++;
+
+  pPool->dLive += dCount;
+
+  if(pPool->dLive > pPool->dPeak) pPool->dPeak = pPool->dLive;
+}
+
+/**
+ * Gives back the slabs of every pool of this thread that's empty.
+ * With -DUTILS_THREADS, every thread that used a pool has to call this before it ends, since nobody else can reach its slabs.
+*/
+void UtilsMem_trimPools() {
+  for(struct UtilsMemPool *pPool = UtilsMem_get()->pPoolList; pPool != NULL; pPool = pPool->pNext)
+    pPool->fTrim();
+}
+
+/**
+ * Adds one set of counters to another.
+ * The peaks get added too, so the result is the most the two could have reached at the same time.
+ *
+ * @param   {struct UtilsMemStats *}  pInto   The counters to add to.
+ * @param   {struct UtilsMemStats *}  pFrom   The counters to add.
+*/
+void UtilsMem_addStats(struct UtilsMemStats *pInto, struct UtilsMemStats *pFrom) {
+  pInto->dAllocs += pFrom->dAllocs;
+  pInto->dFrees += pFrom->dFrees;
+  pInto->dLiveBlocks += pFrom->dLiveBlocks;
+  pInto->dPeakBlocks += pFrom->dPeakBlocks;
+  pInto->dLiveBytes += pFrom->dLiveBytes;
+  pInto->dPeakBytes += pFrom->dPeakBytes;
+  pInto->dTotalBytes += pFrom->dTotalBytes;
+}
+
+/**
+ * Folds the counters of this thread into those of another one (usually the thread that started it), so they show up in its report.
+ * The pools get folded into the pools of the same name; the ones the other thread never used only keep their slabs in the tags.
+ * The call sites of debug mode stay behind.
+ * The caller has to make sure nobody else is touching pInto at the same time.
+ *
+ * @param   {struct UtilsMem *}   pInto   The accounting state to add to.
+*/
+void UtilsMem_merge(struct UtilsMem *pInto) {
+  struct UtilsMem *this = UtilsMem_get();
+
+  if(pInto == this)
+    return;
+
+  for(int i = 0; i < UTILS_MEM_TAGS; i++)
+    UtilsMem_addStats(&pInto->tagArray[i], &this->tagArray[i]);
+
+  UtilsMem_addStats(&pInto->total, &this->total);
+
+  for(struct UtilsMemPool *pPool = this->pPoolList; pPool != NULL; pPool = pPool->pNext) {
+    for(struct UtilsMemPool *pIntoPool = pInto->pPoolList; pIntoPool != NULL; pIntoPool = pIntoPool->pNext) {
+      if(strcmp(pIntoPool->sName, pPool->sName))
+        continue;
+
+      pIntoPool->dSlabs += pPool->dSlabs;
+      pIntoPool->dSlots += pPool->dSlots;
+      pIntoPool->dLive += pPool->dLive;
+      pIntoPool->dPeak += pPool->dPeak;
+      pIntoPool->dAllocs += pPool->dAllocs;
+      pIntoPool->dFrees += pPool->dFrees;
+    }
+  }
+}
+
+/**
+ * #####################################
+ * ###  ALLOCATORS AND DEALLOCATORS  ###
+ * #####################################
+*/
+
+/**
+ * Allocates a zeroed block of memory and charges it to the given tag.
+ * Don't call this directly; use the UtilsMem_calloc() macro so the call site gets recorded.
+ *
+ * @param   {enum UtilsMem_Tag}   eTag    The subsystem the block belongs to.
+ * @param   {size_t}              dCount  The number of elements.
+ * @param   {size_t}              dSize   The size of each element.
+ * @param   {const char *}        sFile   The file of the call site.
+ * @param   {int}                 dLine   The line of the call site.
+ * @return  {void *}                      A pointer to the block, or NULL if the allocation failed.
+*/
+void *UtilsMem_callocAt(enum UtilsMem_Tag eTag, size_t dCount, size_t dSize, const char *sFile, int dLine) {
+  struct UtilsMem *this = UtilsMem_get();
+  union UtilsMemHeader *pHeader;
+  size_t dBytes = dCount * dSize;
+
+  pHeader = calloc(1, sizeof(*pHeader) + dBytes);
+
+  if(pHeader == NULL)
+    return NULL;
+
+  pHeader->info.dSize = dBytes;
+  pHeader->info.eTag = eTag;
+  pHeader->info.dSite = UtilsMem_getSite(eTag, sFile, dLine);
+
+  // Charge everything
+  UtilsMem_charge(&this->tagArray[eTag], dBytes);
+  UtilsMem_charge(&this->total, dBytes);
+
+  if(pHeader->info.dSite >= 0)
+    UtilsMem_charge(&this->siteArray[pHeader->info.dSite].stats, dBytes);
+
+  return pHeader + 1;
+}
+
+/**
+ * Frees a block that was allocated by UtilsMem_calloc() or UtilsMem_realloc().
+ * Passing NULL does nothing, just like free().
+ *
+ * @param   {void *}  pBlock  The block to free.
+*/
+void UtilsMem_free(void *pBlock) {
+  struct UtilsMem *this = UtilsMem_get();
+  union UtilsMemHeader *pHeader;
+  long dBytes;
+
+  if(pBlock == NULL)
+    return;
+
+  pHeader = (union UtilsMemHeader *) pBlock - 1;
+  dBytes = pHeader->info.dSize;
+
+  // Refund everything
+  UtilsMem_charge(&this->tagArray[pHeader->info.eTag], -dBytes);
+  UtilsMem_charge(&this->total, -dBytes);
+
+  if(pHeader->info.dSite >= 0)
+    UtilsMem_charge(&this->siteArray[pHeader->info.dSite].stats, -dBytes);
+
+  free(pHeader);
+}
+
+/**
+ * Resizes a block allocated by the accounting layer.
+ * Any bytes added to the end of the block are zeroed, so it behaves a lot like calloc().
+ * Don't call this directly; use the UtilsMem_realloc() macro so the call site gets recorded.
+ *
+ * @param   {enum UtilsMem_Tag}   eTag    The subsystem the block belongs to.
+ * @param   {void *}              pBlock  The block to resize; may be NULL.
+ * @param   {size_t}              dSize   The new size of the block.
+ * @param   {const char *}        sFile   The file of the call site.
+ * @param   {int}                 dLine   The line of the call site.
+ * @return  {void *}                      A pointer to the resized block, or NULL if it couldn't be resized.
+*/
+void *UtilsMem_reallocAt(enum UtilsMem_Tag eTag, void *pBlock, size_t dSize, const char *sFile, int dLine) {
+  void *pNewBlock;
+  size_t dOldSize;
+
+  if(pBlock == NULL)
+    return UtilsMem_callocAt(eTag, 1, dSize, sFile, dLine);
+
+  // Honestly it's simpler to just make a new block
+  // None of the blocks in this game are big enough for this to matter
+  dOldSize = ((union UtilsMemHeader *) pBlock - 1)->info.dSize;
+  pNewBlock = UtilsMem_callocAt(eTag, 1, dSize, sFile, dLine);
+
+  if(pNewBlock == NULL)
+    return NULL;
+
+  memcpy(pNewBlock, pBlock, dOldSize < dSize ? dOldSize : dSize);
+  UtilsMem_free(pBlock);
+
+  return pNewBlock;
+}
+
+/**
+ * #################
+ * ###  REPORTS  ###
+ * #################
+*/
+
+/**
+ * Returns whether or not a set of counters looks like it's churning.
+ *
+ * @param   {struct UtilsMemStats *}  pStats  The counters to check.
+ * @return  {int}                             Whether or not the counters churn.
+*/
+int UtilsMem_isChurning(struct UtilsMemStats *pStats) {
+  return
+    pStats->dAllocs >= UTILS_MEM_CHURN_MIN &&
+    pStats->dAllocs >= pStats->dPeakBlocks * UTILS_MEM_CHURN_RATIO;
+}
+
+/**
+ * Appends some text to the report, padded to the width of its column the way printf() would.
+ * The report also gets written from the signal handler, and snprintf() isn't safe to call there,
+ * so I put the whole thing together with this and UtilsMem_addNumber() instead.
+ *
+ * @param   {char *}  sOutput   The report.
+ * @param   {int}     dLength   How much of the report has been written so far.
+ * @param   {int}     dSize     The size of the report.
+ * @param   {char *}  sText     The text to add.
+ * @param   {int}     dWidth    The width of the column; negative to align the text to the left.
+ * @return  {int}               The new length of the report.
+*/
+int UtilsMem_addText(char *sOutput, int dLength, int dSize, const char *sText, int dWidth) {
+  int dText = 0, dPad;
+
+  if(dLength >= dSize)
+    return dLength;
+
+  while(sText[dText])
+    dText++;
+
+  dPad = (dWidth < 0 ? -dWidth : dWidth) - dText;
+
+  for(; dWidth > 0 && dPad > 0 && dLength < dSize - 1; dPad--)
+    sOutput[dLength++] = ' ';
+
+  for(int i = 0; i < dText && dLength < dSize - 1; i++)
+    sOutput[dLength++] = sText[i];
+
+  for(; dPad > 0 && dLength < dSize - 1; dPad--)
+    sOutput[dLength++] = ' ';
+
+  sOutput[dLength] = 0;
+
+  return dLength;
+}
+
+/**
+ * Appends a number to the report.
+ *
+ * @param   {char *}  sOutput   The report.
+ * @param   {int}     dLength   How much of the report has been written so far.
+ * @param   {int}     dSize     The size of the report.
+ * @param   {long}    dValue    The number to add.
+ * @param   {int}     dWidth    The width of the column; negative to align the number to the left.
+ * @return  {int}               The new length of the report.
+*/
+int UtilsMem_addNumber(char *sOutput, int dLength, int dSize, long dValue, int dWidth) {
+  char sDigits[24];
+  unsigned long dLeft = dValue < 0 ? -(unsigned long) dValue : (unsigned long) dValue;
+  int i = sizeof(sDigits) - 1;
+
+  sDigits[i] = 0;
+
+  // The digits come out backwards, so we fill the buffer from the end
+  do sDigits[--i] = '0' + dLeft % 10;
+  while(dLeft /= 10);
+
+  if(dValue < 0)
+    sDigits[--i] = '-';
+
+  return UtilsMem_addText(sOutput, dLength, dSize, sDigits + i, dWidth);
+}
+
+/**
+ * Formats a line of the report describing a set of counters.
+ *
+ * @param   {char *}                  sOutput   The report.
+ * @param   {int}                     dLength   How much of the report has been written so far.
+ * @param   {int}                     dSize     The size of the report.
+ * @param   {char *}                  sLabel    What the counters belong to.
+ * @param   {struct UtilsMemStats *}  pStats    The counters to write.
+ * @return  {int}                               The new length of the report.
+*/
+int UtilsMem_formatStats(char *sOutput, int dLength, int dSize, char *sLabel, struct UtilsMemStats *pStats) {
+  dLength = UtilsMem_addText(sOutput, dLength, dSize, "  ", 0);
+  dLength = UtilsMem_addText(sOutput, dLength, dSize, sLabel, -36);
+  dLength = UtilsMem_addNumber(sOutput, dLength, dSize, pStats->dAllocs, 11);
+  dLength = UtilsMem_addNumber(sOutput, dLength, dSize, pStats->dFrees, 11);
+  dLength = UtilsMem_addNumber(sOutput, dLength, dSize, pStats->dLiveBlocks, 11);
+  dLength = UtilsMem_addNumber(sOutput, dLength, dSize, pStats->dLiveBytes, 13);
+  dLength = UtilsMem_addNumber(sOutput, dLength, dSize, pStats->dPeakBytes, 13);
+  dLength = UtilsMem_addNumber(sOutput, dLength, dSize, pStats->dTotalBytes, 15);
+  dLength = UtilsMem_addText(sOutput, dLength, dSize, "  ", 0);
+  dLength = UtilsMem_addText(sOutput, dLength, dSize, pStats->dLiveBlocks > 0 ? "LEAK " : "", 0);
+  dLength = UtilsMem_addText(sOutput, dLength, dSize, UtilsMem_isChurning(pStats) ? "CHURN" : "", 0);
+
+  return UtilsMem_addText(sOutput, dLength, dSize, "\n", 0);
+}
+
+/**
+ * Formats the whole report into a static buffer.
+ * I avoided malloc() and stdio here on purpose: this gets called from the signal handler as well.
+ *
+ * @param   {char *}  sReason   Why the report was made.
+ * @return  {char *}            The formatted report.
+*/
+char *UtilsMem_formatReport(char *sReason) {
+  static char sReport[UTILS_MEM_MAX_REPORT];
+  char *sHeaderArray[] = { "allocs", "frees", "live", "live bytes", "peak bytes", "total bytes" };
+  char *sPoolHeaderArray[] = { "slabs", "slots", "live", "peak", "allocs", "frees", "occupancy" };
+  int dWidthArray[] = { 11, 11, 11, 13, 13, 15 };
+  int dPoolWidthArray[] = { 11, 11, 11, 11, 13, 13, 11 };
+  struct UtilsMem *this = UtilsMem_get();
+  int dLength = 0, dSize = sizeof(sReport);
+
+  dLength = UtilsMem_addText(sReport, dLength, dSize, "Memory report (", 0);
+  dLength = UtilsMem_addText(sReport, dLength, dSize, sReason, 0);
+  dLength = UtilsMem_addText(sReport, dLength, dSize, ")\n\n  ", 0);
+  dLength = UtilsMem_addText(sReport, dLength, dSize, "tag", -36);
+
+  for(int i = 0; i < 6; i++)
+    dLength = UtilsMem_addText(sReport, dLength, dSize, sHeaderArray[i], dWidthArray[i]);
+
+  dLength = UtilsMem_addText(sReport, dLength, dSize, "\n", 0);
+
+  for(int i = 0; i < UTILS_MEM_TAGS; i++)
+    if(this->tagArray[i].dAllocs)
+      dLength = UtilsMem_formatStats(sReport, dLength, dSize, UtilsMem_getTagName(i), &this->tagArray[i]);
+
+  dLength = UtilsMem_formatStats(sReport, dLength, dSize, "(all)", &this->total);
+
+  // The pools, if any were used
+  if(this->pPoolList != NULL) {
+    dLength = UtilsMem_addText(sReport, dLength, dSize, "\nPools\n  ", 0);
+    dLength = UtilsMem_addText(sReport, dLength, dSize, "pool", -36);
+
+    for(int i = 0; i < 7; i++)
+      dLength = UtilsMem_addText(sReport, dLength, dSize, sPoolHeaderArray[i], dPoolWidthArray[i]);
+
+    dLength = UtilsMem_addText(sReport, dLength, dSize, "\n", 0);
+
+    for(struct UtilsMemPool *pPool = this->pPoolList; pPool != NULL; pPool = pPool->pNext) {
+      long dValueArray[] = { pPool->dSlabs, pPool->dSlots, pPool->dLive, pPool->dPeak, pPool->dAllocs, pPool->dFrees };
+      long dTenths = pPool->dSlots ? pPool->dLive * 1000 / pPool->dSlots : 0;
+      char sOccupancy[32];
+      int dOccupancy = 0;
+
+      // Floats are off limits here too, so the occupancy is worked out in tenths of a percent
+      dOccupancy = UtilsMem_addNumber(sOccupancy, dOccupancy, sizeof(sOccupancy), dTenths / 10, 0);
+      dOccupancy = UtilsMem_addText(sOccupancy, dOccupancy, sizeof(sOccupancy), ".", 0);
+      dOccupancy = UtilsMem_addNumber(sOccupancy, dOccupancy, sizeof(sOccupancy), dTenths % 10, 0);
+      dOccupancy = UtilsMem_addText(sOccupancy, dOccupancy, sizeof(sOccupancy), "%", 0);
+
+      dLength = UtilsMem_addText(sReport, dLength, dSize, "  ", 0);
+      dLength = UtilsMem_addText(sReport, dLength, dSize, pPool->sName, -36);
+
+      for(int i = 0; i < 6; i++)
+        dLength = UtilsMem_addNumber(sReport, dLength, dSize, dValueArray[i], dPoolWidthArray[i]);
+
+      dLength = UtilsMem_addText(sReport, dLength, dSize, sOccupancy, dPoolWidthArray[6]);
+      dLength = UtilsMem_addText(sReport, dLength, dSize, pPool->dLive > 0 ? "  LEAK\n" : "\n", 0);
+    }
+  }
+
+  #ifdef UTILS_MEM_DEBUG
+    int dPickedArray[UTILS_MEM_REPORT_SITES];
+
+    // Two passes: first the sites with the most bytes still alive, then the ones with the most allocations
+    for(int dPass = 0; dPass < 2; dPass++) {
+      int dPicked = 0;
+
+      dLength = UtilsMem_addText(sReport, dLength, dSize, dPass ?
+        "\nSites by allocation count (churn)\n" :
+        "\nSites by live bytes (leaks)\n", 0);
+
+      // A selection sort; there aren't that many sites and we can't allocate here
+      while(dPicked < UTILS_MEM_REPORT_SITES) {
+        struct UtilsMemSite *pBest;
+        const char *sFile;
+        char sLabel[64];
+        int dBest = -1, dLabel = 0;
+
+        for(int i = 0; i < UTILS_MEM_MAX_SITES; i++) {
+          struct UtilsMemSite *pSite = &this->siteArray[i];
+          int bTaken = 0;
+
+          if(pSite->sFile == NULL || (!dPass && pSite->stats.dLiveBytes <= 0))
+            continue;
+
+          for(int j = 0; j < dPicked; j++)
+            bTaken |= dPickedArray[j] == i;
+
+          if(bTaken)
+            continue;
+
+          if(dBest < 0 || (dPass ?
+            pSite->stats.dAllocs > this->siteArray[dBest].stats.dAllocs :
+            pSite->stats.dLiveBytes > this->siteArray[dBest].stats.dLiveBytes))
+            dBest = i;
+        }
+
+        if(dBest < 0)
+          break;
+
+        dPickedArray[dPicked++] = dBest;
+        pBest = &this->siteArray[dBest];
+
+        // Just the name of the file, without the folders it's in
+        sFile = pBest->sFile;
+
+        for(const char *sChar = pBest->sFile; *sChar; sChar++)
+          if(*sChar == '/')
+            sFile = sChar + 1;
+
+        dLabel = UtilsMem_addText(sLabel, dLabel, sizeof(sLabel), sFile, 0);
+        dLabel = UtilsMem_addText(sLabel, dLabel, sizeof(sLabel), ":", 0);
+        dLabel = UtilsMem_addNumber(sLabel, dLabel, sizeof(sLabel), pBest->dLine, 0);
+        dLabel = UtilsMem_addText(sLabel, dLabel, sizeof(sLabel), " [", 0);
+        dLabel = UtilsMem_addText(sLabel, dLabel, sizeof(sLabel), UtilsMem_getTagName(pBest->eTag), 0);
+        dLabel = UtilsMem_addText(sLabel, dLabel, sizeof(sLabel), "]", 0);
+
+        dLength = UtilsMem_formatStats(sReport, dLength, dSize, sLabel, &pBest->stats);
+      }
+    }
+  #else
+    dLength = UtilsMem_addText(sReport, dLength, dSize, "\nCompile with -DUTILS_MEM_DEBUG to list the call sites.\n", 0);
+  #endif
+
+  return sReport;
+}
+
+/**
+ * Writes the report to UTILS_MEM_REPORT_PATH.
+ *
+ * @param   {char *}  sReason   Why the report was made.
+*/
+void UtilsMem_writeReport(char *sReason) {
+  FILE *pFile = fopen(UTILS_MEM_REPORT_PATH, "w");
+
+  if(pFile == NULL)
+    return;
+
+  fputs(UtilsMem_formatReport(sReason), pFile);
+  fclose(pFile);
+}
+
+/**
+ * Writes the report when the program exits normally.
+ * The pools that are empty give their slabs back first, so they don't show up as leaks.
+*/
+void UtilsMem_exitHandler() {
+  UtilsMem_trimPools();
+  UtilsMem_writeReport("exit");
+}
+
+/**
+ * Writes the report when we receive a signal.
+ * SIGINT and SIGTERM still kill the program afterwards; on Unix, SIGUSR1 just writes the report and lets the game carry on.
+ * On Unix we skip stdio here because fopen() isn't safe to call from a signal handler (the report itself doesn't use it).
+ *
+ * @param   {int}   dSignal   The signal we got.
+*/
+void UtilsMem_signalHandler(int dSignal) {
+  char *sReason = dSignal == SIGINT ? "SIGINT" : dSignal == SIGTERM ? "SIGTERM" : "signal";
+
+  #ifdef _WIN32
+    UtilsMem_writeReport(sReason);
+  #else
+    char *sReport = UtilsMem_formatReport(sReason);
+    int dFile = open(UTILS_MEM_REPORT_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(dFile >= 0) {
+      if(write(dFile, sReport, strlen(sReport)) < 0) {}
+      close(dFile);
+    }
+  #endif
+
+  // Let the default handler do its thing
+  if(dSignal == SIGINT || dSignal == SIGTERM) {
+    signal(dSignal, SIG_DFL);
+    raise(dSignal);
+    return;
+  }
+
+  // Some systems reset the handler after it fires
+  signal(dSignal, UtilsMem_signalHandler);
+}
+
+/**
+ * Sets up the report hooks.
+ * Call this once at the start of the program.
+*/
+void UtilsMem_init() {
+  struct UtilsMem *this = UtilsMem_get();
+
+  if(this->bIsReady)
+    return;
+
+  this->bIsReady = 1;
+
+  atexit(UtilsMem_exitHandler);
+  signal(SIGINT, UtilsMem_signalHandler);
+  signal(SIGTERM, UtilsMem_signalHandler);
+
+  // Windows doesn't have this one
+  #ifdef SIGUSR1
+    signal(SIGUSR1, UtilsMem_signalHandler);
+  #endif
+}
+
+#endif
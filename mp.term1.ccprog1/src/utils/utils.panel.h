@@ -0,0 +1,166 @@
+/**
+ * A cache for parts of the screen that depend on some game state.
+ * Every object that shows up on the screen keeps a version number that changes whenever the object does.
+ * A panel remembers the versions it was built from; if none of them changed, the old lines can be shown again.
+*/
+
+#ifndef UTILS_PANEL
+#define UTILS_PANEL
+
+#include "utils.mem.h"
+#include "utils.text.h"
+
+// The most versions a panel can depend on
+#define UTILS_PANEL_MAX_STAMPS 16
+
+/**
+ * An instantiable that holds some rendered lines and the versions they were rendered from.
+*/
+struct UtilsPanel {
+  struct UtilsText *pText;                        // The lines; the panel owns them
+  int dStampArray[UTILS_PANEL_MAX_STAMPS];        // The versions used to build the lines
+  int dStamps;                                    // How many versions there are (-1 means nothing's been built)
+};
+
+/**
+ * Returns a new version number.
+ * All objects share the same counter, so an object that was destroyed and created again never ends up with an old version.
+ * (With -DUTILS_THREADS, it's one counter per thread; objects never move between threads anyway.)
+ *
+ * @return  {int}   A version number that hasn't been used yet.
+*/
+int UtilsPanel_nextVersion() {
+  static UTILS_THREAD_LOCAL int dVersion = 0;
+
+  return ++dVersion;
+}
+
+/**
+ * ############################
+ * ###  PANEL CONSTRUCTION  ###
+ * ############################
+*/
+
+/**
+ * Returns a new instance of the UtilsPanel class.
+ *
+ * @return  {struct UtilsPanel *}   A pointer to the created instance.
+*/
+struct UtilsPanel *UtilsPanel_new() {
+  struct UtilsPanel *pUtilsPanel;
+
+  pUtilsPanel = UtilsMem_calloc(UTILS_MEM_UI, 1, sizeof(*pUtilsPanel));
+
+  if(pUtilsPanel == NULL)
+    return NULL;
+
+  return pUtilsPanel;
+}
+
+/**
+ * Initializes the object.
+ *
+ * @param   {struct UtilsPanel *}   this  The instance to be initialized.
+*/
+void UtilsPanel_init(struct UtilsPanel *this) {
+  this->pText = UtilsText_create();
+  this->dStamps = -1;
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @return  {struct UtilsPanel *}   The created instance.
+*/
+struct UtilsPanel *UtilsPanel_create() {
+  struct UtilsPanel *pUtilsPanel = UtilsPanel_new();
+  UtilsPanel_init(pUtilsPanel);
+
+  return pUtilsPanel;
+}
+
+/**
+ * Frees the lines held by the panel.
+ *
+ * @param   {struct UtilsPanel *}   this  The instance to be modified.
+*/
+void UtilsPanel_clear(struct UtilsPanel *this) {
+  for(int i = 0; i < UtilsText_getLines(this->pText); i++)
+    UtilsMem_free(UtilsText_getTextLine(this->pText, i));
+
+  UtilsText_kill(this->pText);
+  this->pText = NULL;
+  this->dStamps = -1;
+}
+
+/**
+ * Destroys a specified instance along with its lines.
+ *
+ * @param   {struct UtilsPanel *}   this  The instance to be destroyed.
+*/
+void UtilsPanel_kill(struct UtilsPanel *this) {
+  UtilsPanel_clear(this);
+  UtilsMem_free(this);
+}
+
+/**
+ * ###################################
+ * ###  PANEL READERS AND WRITERS  ###
+ * ###################################
+*/
+
+/**
+ * Checks whether or not the panel was built from the given versions.
+ *
+ * @param   {struct UtilsPanel *}   this          The instance to be read.
+ * @param   {int *}                 dStampArray   The versions the panel depends on right now.
+ * @param   {int}                   dStamps       How many versions there are.
+ * @return  {int}                                 Whether or not the stored lines can be reused.
+*/
+int UtilsPanel_isFresh(struct UtilsPanel *this, int *dStampArray, int dStamps) {
+  if(this->dStamps != dStamps)
+    return 0;
+
+  for(int i = 0; i < dStamps; i++)
+    if(this->dStampArray[i] != dStampArray[i])
+      return 0;
+
+  return 1;
+}
+
+/**
+ * Replaces the lines of the panel.
+ * The panel takes the text object and its lines, so they shouldn't be freed by the caller.
+ * Every line in the text has to have been allocated (anything added with the UtilsText_add...() functions is).
+ *
+ * @param   {struct UtilsPanel *}   this          The instance to be modified.
+ * @param   {struct UtilsText *}    pText         The new lines.
+ * @param   {int *}                 dStampArray   The versions the lines were built from.
+ * @param   {int}                   dStamps       How many versions there are.
+*/
+void UtilsPanel_store(struct UtilsPanel *this, struct UtilsText *pText, int *dStampArray, int dStamps) {
+  if(dStamps > UTILS_PANEL_MAX_STAMPS)
+    dStamps = UTILS_PANEL_MAX_STAMPS;
+
+  if(this->pText != NULL)
+    UtilsPanel_clear(this);
+
+  this->pText = pText;
+  this->dStamps = dStamps;
+
+  for(int i = 0; i < dStamps; i++)
+    this->dStampArray[i] = dStampArray[i];
+}
+
+/**
+ * Returns the lines of the panel.
+ * These belong to the panel; don't free them.
+ *
+ * @param   {struct UtilsPanel *}   this  The instance to be read.
+ * @return  {struct UtilsText *}          The stored lines.
+*/
+struct UtilsText *UtilsPanel_getText(struct UtilsPanel *this) {
+  return this->pText;
+}
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * A file containing typed object pools for the classes that get made and destroyed all the time.
+ * Every sow makes a Product and every harvest kills one, so instead of going to the heap each time, a pool grabs
+ * a whole slab of objects at once and keeps the dead ones on a free list until somebody needs them again.
+ *
+ * UTILS_POOL_DEFINE(Product, struct Product, UTILS_MEM_PRODUCT, 64) writes these for you:
+ *
+ *    struct Product *Product_poolAlloc()       A zeroed object, just like UtilsMem_calloc() would give you.
+ *    void Product_poolFree(struct Product *)   Gives an object back (NULL does nothing, like free()).
+ *    void Product_poolTrim()                   Gives the slabs back to the heap if every object has been given back.
+ *
+ * The occupancy of every pool shows up in the memory report (see utils.mem.h); the slabs themselves are charged to the tag.
+ * Compiling with -DUTILS_POOL_DEBUG fills the objects that are given back with garbage and checks that it's still there
+ * when they're handed out again, so using an object after killing it (or killing it twice) stops the program right away.
+ * Compiling with -DUTILS_POOL_DISABLE skips the pools and calls UtilsMem_calloc() for every object, which is what you want
+ * when looking for leaks with valgrind or the sanitizers.
+*/
+
+#ifndef UTILS_POOL
+#define UTILS_POOL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.mem.h"
+
+// What the objects on the free list are filled with in debug mode
+#define UTILS_POOL_POISON 0xDD
+
+// These are plain constants so the macro below doesn't need any #ifdefs; the compiler throws the dead branches away
+#ifdef UTILS_POOL_DEBUG
+#define UTILS_POOL_CHECKS 1
+#else
+#define UTILS_POOL_CHECKS 0
+#endif
+
+#ifdef UTILS_POOL_DISABLE
+#define UTILS_POOL_BYPASS 1
+#else
+#define UTILS_POOL_BYPASS 0
+#endif
+
+/**
+ * ######################
+ * ###  POOL HELPERS  ###
+ * ######################
+*/
+
+/**
+ * Fills a slot with the poison, except for the link to the next free slot at the start.
+ *
+ * @param   {void *}  pSlot   The slot.
+ * @param   {size_t}  dSize   The size of the slot.
+*/
+void UtilsPool_poison(void *pSlot, size_t dSize) {
+  memset((char *) pSlot + sizeof(void *), UTILS_POOL_POISON, dSize - sizeof(void *));
+}
+
+/**
+ * Returns whether or not a slot still has all of its poison.
+ *
+ * @param   {void *}  pSlot   The slot.
+ * @param   {size_t}  dSize   The size of the slot.
+ * @return  {int}             Whether or not nothing has written to the slot since it was poisoned.
+*/
+int UtilsPool_isPoisoned(void *pSlot, size_t dSize) {
+  unsigned char *pByte = pSlot;
+
+  for(size_t i = sizeof(void *); i < dSize; i++)
+    if(pByte[i] != UTILS_POOL_POISON)
+      return 0;
+
+  return 1;
+}
+
+/**
+ * Says what went wrong with a pool and stops the program.
+ * Carrying on after memory got stomped on just makes the bug show up somewhere else.
+ *
+ * @param   {char *}  sName     The name of the pool.
+ * @param   {char *}  sProblem  What went wrong.
+ * @param   {void *}  pObject   The object it went wrong with.
+*/
+void UtilsPool_panic(char *sName, char *sProblem, void *pObject) {
+  fprintf(stderr, "Pool %s: %s (%p).\n", sName, sProblem, pObject);
+  abort();
+}
+
+/**
+ * #######################
+ * ###  POOL GENERATOR  ###
+ * #######################
+*/
+
+/**
+ * Writes a pool for a type (see the top of the file).
+ * The slots are unions, so a free slot uses the space of its object to point at the next free slot.
+ * The pool is per-thread with -DUTILS_THREADS, same as the counters in utils.mem.h, since the tools kill objects
+ * on the thread that made them.
+ *
+ * @param   Name            The prefix of the functions (the class name).
+ * @param   Type            The type of the objects.
+ * @param   eMemTag         The tag the slabs get charged to.
+ * @param   dSlabObjects    How many objects a slab holds.
+*/
+#define UTILS_POOL_DEFINE(Name, Type, eMemTag, dSlabObjects)                                                \
+                                                                                                            \
+  union Name##_PoolSlot {                                                                                   \
+    Type object;                                                                                            \
+    union Name##_PoolSlot *pNext;                                                                           \
+  };                                                                                                        \
+                                                                                                            \
+  struct Name##_PoolSlab {                                                                                  \
+    struct Name##_PoolSlab *pNext;                                                                          \
+    union Name##_PoolSlot slotArray[dSlabObjects];                                                          \
+  };                                                                                                        \
+                                                                                                            \
+  struct Name##_Pool {                                                                                      \
+    struct UtilsMemPool stats;                                                                              \
+    union Name##_PoolSlot *pFreeList;                                                                       \
+    struct Name##_PoolSlab *pSlabList;                                                                      \
+  };                                                                                                        \
+                                                                                                            \
+  void Name##_poolTrim();                                                                                   \
+                                                                                                            \
+  struct Name##_Pool *Name##_getPool() {                                                                    \
+    static UTILS_THREAD_LOCAL struct Name##_Pool pool;                                                      \
+                                                                                                            \
+    if(pool.stats.sName == NULL) {                                                                          \
+      pool.stats.sName = #Name;                                                                             \
+      pool.stats.eTag = eMemTag;                                                                            \
+      pool.stats.fTrim = Name##_poolTrim;                                                                   \
+      UtilsMem_addPool(&pool.stats);                                                                        \
+    }                                                                                                       \
+                                                                                                            \
+    return &pool;                                                                                           \
+  }                                                                                                         \
+                                                                                                            \
+  Type *Name##_poolAlloc() {                                                                                \
+    struct Name##_Pool *this = Name##_getPool();                                                            \
+    union Name##_PoolSlot *pSlot;                                                                           \
+                                                                                                            \
+    if(UTILS_POOL_BYPASS) {                                                                                 \
+      pSlot = UtilsMem_calloc(eMemTag, 1, sizeof(*pSlot));                                                  \
+                                                                                                            \
+      if(pSlot != NULL)                                                                                     \
+        UtilsMem_chargePool(&this->stats, 1);                                                               \
+                                                                                                            \
+      return (Type *) pSlot;                                                                                \
+    }                                                                                                       \
+                                                                                                            \
+    /* Out of slots, so grab another slab and put all of it on the free list */                             \
+    if(this->pFreeList == NULL) {                                                                           \
+      struct Name##_PoolSlab *pSlab = UtilsMem_calloc(eMemTag, 1, sizeof(*pSlab));                          \
+                                                                                                            \
+      if(pSlab == NULL)                                                                                     \
+        return NULL;                                                                                        \
+                                                                                                            \
+      pSlab->pNext = this->pSlabList;                                                                       \
+      this->pSlabList = pSlab;                                                                              \
+                                                                                                            \
+      for(int i = (dSlabObjects) - 1; i >= 0; i--) {                                                        \
+        if(UTILS_POOL_CHECKS)                                                                               \
+          UtilsPool_poison(&pSlab->slotArray[i], sizeof(union Name##_PoolSlot));                            \
+                                                                                                            \
+        pSlab->slotArray[i].pNext = this->pFreeList;                                                        \
+        this->pFreeList = &pSlab->slotArray[i];                                                             \
+      }                                                                                                     \
+                                                                                                            \
+      this->stats.dSlabs++;                                                                                 \
+      this->stats.dSlots += (dSlabObjects);                                                                 \
+    }                                                                                                       \
+                                                                                                            \
+    pSlot = this->pFreeList;                                                                                \
+                                                                                                            \
+    if(UTILS_POOL_CHECKS && !UtilsPool_isPoisoned(pSlot, sizeof(*pSlot)))                                   \
+      UtilsPool_panic(#Name, "an object was written to after it was given back", pSlot);                    \
+                                                                                                            \
+    this->pFreeList = pSlot->pNext;                                                                         \
+    memset(pSlot, 0, sizeof(*pSlot));                                                                       \
+    UtilsMem_chargePool(&this->stats, 1);                                                                   \
+                                                                                                            \
+    return &pSlot->object;                                                                                  \
+  }                                                                                                         \
+                                                                                                            \
+  void Name##_poolFree(Type *pObject) {                                                                     \
+    struct Name##_Pool *this = Name##_getPool();                                                            \
+    union Name##_PoolSlot *pSlot = (union Name##_PoolSlot *) pObject;                                       \
+                                                                                                            \
+    if(pObject == NULL)                                                                                     \
+      return;                                                                                               \
+                                                                                                            \
+    UtilsMem_chargePool(&this->stats, -1);                                                                  \
+                                                                                                            \
+    if(UTILS_POOL_BYPASS) {                                                                                 \
+      UtilsMem_free(pSlot);                                                                                 \
+      return;                                                                                               \
+    }                                                                                                       \
+                                                                                                            \
+    /* An object that's all poison has been given back already */                                           \
+    if(UTILS_POOL_CHECKS) {                                                                                 \
+      if(UtilsPool_isPoisoned(pSlot, sizeof(*pSlot)))                                                       \
+        UtilsPool_panic(#Name, "an object was given back twice", pSlot);                                    \
+                                                                                                            \
+      UtilsPool_poison(pSlot, sizeof(*pSlot));                                                              \
+    }                                                                                                       \
+                                                                                                            \
+    pSlot->pNext = this->pFreeList;                                                                         \
+    this->pFreeList = pSlot;                                                                                \
+  }                                                                                                         \
+                                                                                                            \
+  void Name##_poolTrim() {                                                                                  \
+    struct Name##_Pool *this = Name##_getPool();                                                            \
+                                                                                                            \
+    if(this->stats.dLive)                                                                                   \
+      return;                                                                                               \
+                                                                                                            \
+    while(this->pSlabList != NULL) {                                                                        \
+      struct Name##_PoolSlab *pSlab = this->pSlabList;                                                      \
+                                                                                                            \
+      this->pSlabList = pSlab->pNext;                                                                       \
+      UtilsMem_free(pSlab);                                                                                 \
+    }                                                                                                       \
+                                                                                                            \
+    this->pFreeList = NULL;                                                                                 \
+    this->stats.dSlabs = 0;                                                                                 \
+    this->stats.dSlots = 0;                                                                                 \
+  }
+
+#endif
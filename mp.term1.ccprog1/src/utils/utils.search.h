@@ -0,0 +1,470 @@
+/**
+ * A sorted index of names for type-ahead search.
+ * The keys are sorted once, so every key that starts with the query sits in one run of the array. Typing another
+ * character only has to look inside the run we already have, and since every key in it shares the query so far,
+ * we only compare the next character (two binary searches). The run for each length of the query is kept, so
+ * backspace is free. The same value can have more than one key (a product has a name and a code); the results
+ * only list it once, in order of value so they line up with the selector showing them.
+ * Listing the results still costs something per match: a short list gets sorted, and a long one (like the empty
+ * query's) is read off the marks in order instead, so a keystroke never costs more than a pass over the values.
+*/
+
+#ifndef UTILS_SEARCH
+#define UTILS_SEARCH
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.key.h"
+#include "utils.mem.h"
+#include "utils.panel.h"
+
+#define UTILS_SEARCH_MAX_QUERY 24
+#define UTILS_SEARCH_INITIAL_SIZE 16
+#define UTILS_SEARCH_SWEEP_RATIO 8     // The results are swept off the marks once they're more than 1/8 of the values
+
+/**
+ * A single key and the value it finds.
+*/
+struct UtilsSearchEntry {
+  char *sKey;
+  int dValue;
+};
+
+/**
+ * The index and the current query.
+*/
+struct UtilsSearch {
+  struct UtilsSearchEntry *pEntryArray;
+  int dEntries;
+  int dCapacity;
+
+  // The query and the run of entries that match each of its prefixes
+  char sQuery[UTILS_SEARCH_MAX_QUERY + 1];
+  int dQueryLength;
+  int dLowArray[UTILS_SEARCH_MAX_QUERY + 1];
+  int dHighArray[UTILS_SEARCH_MAX_QUERY + 1];
+
+  // The values the current query finds, without repeats
+  int *dResultArray;
+  int dResults;
+
+  // Marks the values we've already listed, so the array doesn't have to be cleared every time
+  int *dSeenArray;
+  int dSeen;
+  int dMaxValue;
+
+  int bTyping;
+  int dVersion;
+};
+
+/**
+ * #############################
+ * ###  SEARCH CONSTRUCTION  ###
+ * #############################
+*/
+
+/**
+ * Creates a new instance of the UtilsSearch class.
+ *
+ * @return  {struct UtilsSearch *}  The created instance.
+*/
+struct UtilsSearch *UtilsSearch_new() {
+  struct UtilsSearch *pUtilsSearch = UtilsMem_calloc(UTILS_MEM_MISC, 1, sizeof(*pUtilsSearch));
+
+  if(pUtilsSearch == NULL)
+    return NULL;
+
+  return pUtilsSearch;
+}
+
+/**
+ * Initializes an instance of the UtilsSearch class.
+ * The index starts out empty; add the keys then build it.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be initialized.
+*/
+void UtilsSearch_init(struct UtilsSearch *this) {
+  this->dEntries = 0;
+  this->dCapacity = UTILS_SEARCH_INITIAL_SIZE;
+  this->pEntryArray = UtilsMem_calloc(UTILS_MEM_MISC, this->dCapacity, sizeof(struct UtilsSearchEntry));
+
+  this->sQuery[0] = 0;
+  this->dQueryLength = 0;
+  this->dLowArray[0] = 0;
+  this->dHighArray[0] = 0;
+
+  this->dResultArray = NULL;
+  this->dResults = 0;
+  this->dSeenArray = NULL;
+  this->dSeen = 0;
+  this->dMaxValue = 0;
+
+  this->bTyping = 0;
+  this->dVersion = UtilsPanel_nextVersion();
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @return  {struct UtilsSearch *}  The initialized instance.
+*/
+struct UtilsSearch *UtilsSearch_create() {
+  struct UtilsSearch *pUtilsSearch = UtilsSearch_new();
+
+  UtilsSearch_init(pUtilsSearch);
+
+  return pUtilsSearch;
+}
+
+/**
+ * Destroys an instance of the class, along with its copies of the keys.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be destroyed.
+*/
+void UtilsSearch_kill(struct UtilsSearch *this) {
+  for(int i = 0; i < this->dEntries; i++)
+    UtilsMem_free(this->pEntryArray[i].sKey);
+
+  UtilsMem_free(this->pEntryArray);
+  UtilsMem_free(this->dResultArray);
+  UtilsMem_free(this->dSeenArray);
+  UtilsMem_free(this);
+}
+
+/**
+ * ############################
+ * ###  BUILDING THE INDEX  ###
+ * ############################
+*/
+
+/**
+ * Adds a key to the index.
+ * Searches are case-insensitive, so the key is stored in lowercase.
+ *
+ * @param   {struct UtilsSearch *}  this    The instance to be modified.
+ * @param   {char *}                sKey    What the user types to find the value.
+ * @param   {int}                   dValue  What the key finds (must not be negative).
+*/
+void UtilsSearch_add(struct UtilsSearch *this, char *sKey, int dValue) {
+  char *sCopy = UtilsMem_calloc(UTILS_MEM_MISC, strlen(sKey) + 1, sizeof(char));
+
+  for(int i = 0; sKey[i]; i++)
+    sCopy[i] = tolower(sKey[i]);
+
+  // Make room if we have to
+  if(this->dEntries == this->dCapacity) {
+    this->dCapacity *= 2;
+    this->pEntryArray = UtilsMem_realloc(UTILS_MEM_MISC, this->pEntryArray, this->dCapacity * sizeof(struct UtilsSearchEntry));
+  }
+
+  this->pEntryArray[this->dEntries].sKey = sCopy;
+  this->pEntryArray[this->dEntries].dValue = dValue;
+  this->dEntries++;
+
+  if(dValue > this->dMaxValue)
+    this->dMaxValue = dValue;
+}
+
+/**
+ * Compares two entries for qsort().
+ *
+ * @param   {const void *}  pFirst    The first entry.
+ * @param   {const void *}  pSecond   The second entry.
+ * @return  {int}                     Which one comes first.
+*/
+int UtilsSearch_compareEntries(const void *pFirst, const void *pSecond) {
+  return strcmp(((const struct UtilsSearchEntry *) pFirst)->sKey, ((const struct UtilsSearchEntry *) pSecond)->sKey);
+}
+
+/**
+ * Compares two values for qsort().
+ *
+ * @param   {const void *}  pFirst    The first value.
+ * @param   {const void *}  pSecond   The second value.
+ * @return  {int}                     Which one comes first.
+*/
+int UtilsSearch_compareValues(const void *pFirst, const void *pSecond) {
+  return *(const int *) pFirst - *(const int *) pSecond;
+}
+
+/**
+ * Lists the values of the entries that match the query, once each.
+ * Sorting the list costs more than a pass over every value once enough of them match, so we do that instead then.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be modified.
+*/
+void UtilsSearch_collect(struct UtilsSearch *this) {
+  int dLow = this->dLowArray[this->dQueryLength];
+  int dHigh = this->dHighArray[this->dQueryLength];
+
+  this->dResults = 0;
+  this->dSeen++;
+
+  for(int i = dLow; i < dHigh; i++) {
+    int dValue = this->pEntryArray[i].dValue;
+
+    if(this->dSeenArray[dValue] != this->dSeen) {
+      this->dSeenArray[dValue] = this->dSeen;
+      this->dResultArray[this->dResults++] = dValue;
+    }
+  }
+
+  if(this->dResults * UTILS_SEARCH_SWEEP_RATIO > this->dMaxValue + 1) {
+    this->dResults = 0;
+
+    for(int dValue = 0; dValue <= this->dMaxValue; dValue++)
+      if(this->dSeenArray[dValue] == this->dSeen)
+        this->dResultArray[this->dResults++] = dValue;
+
+  } else {
+    qsort(this->dResultArray, this->dResults, sizeof(int), UtilsSearch_compareValues);
+  }
+
+  this->dVersion = UtilsPanel_nextVersion();
+}
+
+/**
+ * Sorts the keys so the index can be searched.
+ * Call this once after adding all the keys.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be modified.
+*/
+void UtilsSearch_build(struct UtilsSearch *this) {
+  qsort(this->pEntryArray, this->dEntries, sizeof(struct UtilsSearchEntry), UtilsSearch_compareEntries);
+
+  UtilsMem_free(this->dResultArray);
+  UtilsMem_free(this->dSeenArray);
+  this->dResultArray = UtilsMem_calloc(UTILS_MEM_MISC, this->dEntries + 1, sizeof(int));
+  this->dSeenArray = UtilsMem_calloc(UTILS_MEM_MISC, this->dMaxValue + 1, sizeof(int));
+
+  // The empty query matches everything
+  this->sQuery[0] = 0;
+  this->dQueryLength = 0;
+  this->dLowArray[0] = 0;
+  this->dHighArray[0] = this->dEntries;
+
+  UtilsSearch_collect(this);
+}
+
+/**
+ * ########################
+ * ###  SEARCH READERS  ###
+ * ########################
+*/
+
+/**
+ * Returns the query typed so far.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be read.
+ * @return  {char *}                      The query.
+*/
+char *UtilsSearch_getQuery(struct UtilsSearch *this) {
+  return this->sQuery;
+}
+
+/**
+ * Returns how many values the query finds.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be read.
+ * @return  {int}                         The number of results.
+*/
+int UtilsSearch_getCount(struct UtilsSearch *this) {
+  return this->dResults;
+}
+
+/**
+ * Returns one of the values the query finds, in increasing order.
+ *
+ * @param   {struct UtilsSearch *}  this    The instance to be read.
+ * @param   {int}                   dIndex  Which result.
+ * @return  {int}                           The value.
+*/
+int UtilsSearch_getResult(struct UtilsSearch *this, int dIndex) {
+  return this->dResultArray[dIndex];
+}
+
+/**
+ * Returns whether or not the search is narrowing anything down (or about to).
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be read.
+ * @return  {int}                         Whether or not the user is typing or has typed something.
+*/
+int UtilsSearch_isActive(struct UtilsSearch *this) {
+  return this->bTyping || this->dQueryLength;
+}
+
+/**
+ * Returns whether or not the keys are going into the query right now.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be read.
+ * @return  {int}                         Whether or not the user is typing.
+*/
+int UtilsSearch_isTyping(struct UtilsSearch *this) {
+  return this->bTyping;
+}
+
+/**
+ * Gets the version of the search.
+ * It changes whenever the query (and so the results) change.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be read.
+ * @return  {int}                         The version of the search.
+*/
+int UtilsSearch_getVersion(struct UtilsSearch *this) {
+  return this->dVersion;
+}
+
+/**
+ * Gets the results to show when there's only room for some of them.
+ * The window is placed so the current value (or where it would go) is in it.
+ *
+ * @param   {struct UtilsSearch *}  this      The instance to be read.
+ * @param   {int}                   dCurrent  The value that has to be shown.
+ * @param   {int}                   dRows     How many results there's room for.
+ * @param   {int *}                 pStart    Gets the first result to show.
+ * @param   {int *}                 pEnd      Gets the result after the last one to show.
+*/
+void UtilsSearch_getWindow(struct UtilsSearch *this, int dCurrent, int dRows, int *pStart, int *pEnd) {
+  int dLow = 0, dHigh = this->dResults;
+
+  // Where the current value is, or would be; the results are sorted
+  while(dLow < dHigh) {
+    int dMid = (dLow + dHigh) / 2;
+
+    if(this->dResultArray[dMid] < dCurrent) dLow = dMid + 1;
+    else dHigh = dMid;
+  }
+
+  if(dLow >= this->dResults) dLow = this->dResults - 1;
+
+  *pStart = dLow < dRows ? 0 : dLow - dRows + 1;
+  *pEnd = *pStart + dRows < this->dResults ? *pStart + dRows : this->dResults;
+}
+
+/**
+ * ########################
+ * ###  SEARCH ACTIONS  ###
+ * ########################
+*/
+
+/**
+ * Adds a character to the query.
+ * Only the run of entries for the query so far is searched, and only by the new character.
+ *
+ * @param   {struct UtilsSearch *}  this    The instance to be modified.
+ * @param   {char}                  cChar   The character typed.
+*/
+void UtilsSearch_push(struct UtilsSearch *this, char cChar) {
+  int dDepth = this->dQueryLength;
+  int dLow = this->dLowArray[dDepth];
+  int dHigh = this->dHighArray[dDepth];
+  int dFirst, dLast;
+  unsigned char cNext = tolower(cChar);
+
+  if(dDepth >= UTILS_SEARCH_MAX_QUERY)
+    return;
+
+  // The first entry whose next character isn't smaller...
+  dFirst = dLow;
+  dLast = dHigh;
+  while(dFirst < dLast) {
+    int dMid = (dFirst + dLast) / 2;
+
+    if((unsigned char) this->pEntryArray[dMid].sKey[dDepth] < cNext) dFirst = dMid + 1;
+    else dLast = dMid;
+  }
+
+  this->dLowArray[dDepth + 1] = dFirst;
+
+  // ... and the first one whose next character is bigger
+  dLast = dHigh;
+  while(dFirst < dLast) {
+    int dMid = (dFirst + dLast) / 2;
+
+    if((unsigned char) this->pEntryArray[dMid].sKey[dDepth] <= cNext) dFirst = dMid + 1;
+    else dLast = dMid;
+  }
+
+  this->dHighArray[dDepth + 1] = dFirst;
+
+  this->sQuery[dDepth] = cNext;
+  this->sQuery[dDepth + 1] = 0;
+  this->dQueryLength++;
+
+  UtilsSearch_collect(this);
+}
+
+/**
+ * Removes the last character of the query.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be modified.
+*/
+void UtilsSearch_pop(struct UtilsSearch *this) {
+  if(!this->dQueryLength)
+    return;
+
+  this->sQuery[--this->dQueryLength] = 0;
+
+  UtilsSearch_collect(this);
+}
+
+/**
+ * Stops the search and empties the query.
+ *
+ * @param   {struct UtilsSearch *}  this  The instance to be modified.
+*/
+void UtilsSearch_clear(struct UtilsSearch *this) {
+  if(!UtilsSearch_isActive(this))
+    return;
+
+  this->bTyping = 0;
+  this->dQueryLength = 0;
+  this->sQuery[0] = 0;
+
+  UtilsSearch_collect(this);
+}
+
+/**
+ * Handles a keystroke meant for the search.
+ * [/] starts typing, letters and digits narrow the results down, backspace takes them back, and enter stops
+ * typing (the results stay). Backspace on an empty query (or after typing) ends the search.
+ * While typing, every key goes to the search so nothing else reacts to the letters.
+ *
+ * @param   {struct UtilsSearch *}  this    The instance to be modified.
+ * @param   {char}                  cInput  The key.
+ * @return  {int}                           Whether or not the key was used by the search.
+*/
+int UtilsSearch_type(struct UtilsSearch *this, char cInput) {
+  if(!this->bTyping) {
+    if(cInput == '/') {
+      this->bTyping = 1;
+      this->dVersion = UtilsPanel_nextVersion();
+      return 1;
+    }
+
+    if(this->dQueryLength && UtilsKey_isBackspace(cInput, "")) {
+      UtilsSearch_clear(this);
+      return 1;
+    }
+
+    return 0;
+  }
+
+  if(UtilsKey_isReturn(cInput, "")) {
+    this->bTyping = 0;
+    this->dVersion = UtilsPanel_nextVersion();
+
+  } else if(UtilsKey_isBackspace(cInput, "")) {
+    if(this->dQueryLength) UtilsSearch_pop(this);
+    else UtilsSearch_clear(this);
+
+  } else if(UtilsKey_isAlpha(cInput) || UtilsKey_isNum(cInput)) {
+    UtilsSearch_push(this, cInput);
+  }
+
+  return 1;
+}
+
+#endif
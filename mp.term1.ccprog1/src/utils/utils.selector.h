@@ -1,35 +1,56 @@
 /**
  * A helper class for selection functionality.
  * This is the primary way through which the user interacts with the game in full mode.
+ * The options grow as they're added, and which ones are available is kept as a bitset, so finding the next
+ * available option is a count of trailing (or leading) zeros instead of a walk through the unavailable ones.
+ * The formatted options are cached too, so drawing the same selector every frame doesn't allocate anything.
 */
 
 #ifndef UTILS_SELECTOR
 #define UTILS_SELECTOR
 
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
-#define MAX_SELECTION_SIZE 64
+#include "utils.mem.h"
+#include "utils.panel.h"
+
 #define MAX_WRAPPER_LENGTH 64
 
+#define UTILS_SELECTOR_INITIAL_SIZE 8   // How many options fit before the arrays have to grow
+#define UTILS_SELECTOR_WORD_BITS 64     // Options per word of the availability bitset
+
+// What a cached formatted option was formatted as
+#define UTILS_SELECTOR_UNFORMATTED 0
+#define UTILS_SELECTOR_DEFAULT 1
+#define UTILS_SELECTOR_SELECTED 2
+#define UTILS_SELECTOR_DISABLED 3
+
 /**
  * A instantiable that enables us to easily duplicate the functionality of a selector.
 */
 struct UtilsSelector {
   int dSelectionIndex;
   int dSelectionLimit;
+  int dSelectionCapacity;
   int dSelectionAvailable;
   int bSelectionLooped;
+  int dVersion;
+  int dWindowStart;       // The first option shown when the list is longer than the space it gets
 
   // Template strings for formatting
   char *sDefaultWrapper;
   char *sSelectedWrapper;
   char *sDisabledWrapper;
 
-  char *sSelectionArray[MAX_SELECTION_SIZE];
-  int dSelectionValueArray[MAX_SELECTION_SIZE];
-  int bSelectionAvailabilityArray[MAX_SELECTION_SIZE];
+  // These all grow together when an option doesn't fit
+  char **sSelectionArray;
+  int *dSelectionValueArray;
+  uint64_t *dAvailabilityBitset;
+  char **sFormattedArray;
+  char *cFormattedStateArray;
 };
 
 /**
@@ -46,7 +67,7 @@ struct UtilsSelector {
 struct UtilsSelector *UtilsSelector_new() {
   struct UtilsSelector *pUtilsSelector;
 
-  pUtilsSelector = calloc(1, sizeof(*pUtilsSelector));
+  pUtilsSelector = UtilsMem_calloc(UTILS_MEM_SELECTOR, 1, sizeof(*pUtilsSelector));
 
   if(pUtilsSelector == NULL)
     return NULL;
@@ -68,18 +89,26 @@ void UtilsSelector_init(struct UtilsSelector *this, int bIsLooped, char *sDefaul
   
   this->dSelectionIndex = 0;
   this->dSelectionLimit = 0;
+  this->dSelectionCapacity = UTILS_SELECTOR_INITIAL_SIZE;
   this->dSelectionAvailable = 0;
   this->bSelectionLooped = bIsLooped;
+  this->dVersion = UtilsPanel_nextVersion();
+  this->dWindowStart = 0;
 
-  this->sDefaultWrapper = calloc(MAX_WRAPPER_LENGTH, sizeof(char));
+  this->sSelectionArray = UtilsMem_calloc(UTILS_MEM_SELECTOR, this->dSelectionCapacity, sizeof(char *));
+  this->dSelectionValueArray = UtilsMem_calloc(UTILS_MEM_SELECTOR, this->dSelectionCapacity, sizeof(int));
+  this->dAvailabilityBitset = UtilsMem_calloc(UTILS_MEM_SELECTOR, 
+    (this->dSelectionCapacity + UTILS_SELECTOR_WORD_BITS - 1) / UTILS_SELECTOR_WORD_BITS, sizeof(uint64_t));
+  this->sFormattedArray = UtilsMem_calloc(UTILS_MEM_SELECTOR, this->dSelectionCapacity, sizeof(char *));
+  this->cFormattedStateArray = UtilsMem_calloc(UTILS_MEM_SELECTOR, this->dSelectionCapacity, sizeof(char));
+
+  // The templates are just pointed to, so nothing gets allocated for them
   if(strlen(sDefaultWrapper) < MAX_WRAPPER_LENGTH) this->sDefaultWrapper = sDefaultWrapper;
   else this->sDefaultWrapper = "%s";
 
-  this->sSelectedWrapper = calloc(MAX_WRAPPER_LENGTH, sizeof(char));
   if(strlen(sSelectedWrapper) < MAX_WRAPPER_LENGTH) this->sSelectedWrapper = sSelectedWrapper;
   else this->sSelectedWrapper = "%s";
 
-  this->sDisabledWrapper = calloc(MAX_WRAPPER_LENGTH, sizeof(char));
   if(strlen(sDisabledWrapper) < MAX_WRAPPER_LENGTH) this->sDisabledWrapper = sDisabledWrapper;
   else this->sDisabledWrapper = "%s";
 }
@@ -106,7 +135,114 @@ struct UtilsSelector *UtilsSelector_create(int bIsLooped, char *sDefaultWrapper,
  * @param   {struct UtilsSelector *}  this  The instance to be destroyed.
 */
 void UtilsSelector_kill(struct UtilsSelector *this) {
-  free(this);
+  for(int i = 0; i < this->dSelectionLimit; i++)
+    UtilsMem_free(this->sFormattedArray[i]);
+
+  UtilsMem_free(this->sSelectionArray);
+  UtilsMem_free(this->dSelectionValueArray);
+  UtilsMem_free(this->dAvailabilityBitset);
+  UtilsMem_free(this->sFormattedArray);
+  UtilsMem_free(this->cFormattedStateArray);
+  UtilsMem_free(this);
+}
+
+/**
+ * ###############################
+ * ###  SELECTOR AVAILABILITY  ###
+ * ###############################
+*/
+
+/**
+ * Returns whether or not an option can be selected.
+ * 
+ * @param   {struct UtilsSelector *}  this    The instance to be read.
+ * @param   {int}                     dIndex  The index of the option.
+ * @return  {int}                             Whether or not it's available.
+*/
+int UtilsSelector_isAvailable(struct UtilsSelector *this, int dIndex) {
+  return this->dAvailabilityBitset[dIndex / UTILS_SELECTOR_WORD_BITS] >> (dIndex % UTILS_SELECTOR_WORD_BITS) & 1;
+}
+
+/**
+ * Returns the first available option at or after an index.
+ * The bits past the last option are never set, so we don't have to check against the limit.
+ * 
+ * @param   {struct UtilsSelector *}  this    The instance to be read.
+ * @param   {int}                     dFrom   Where to start looking.
+ * @return  {int}                             The index of the option, or -1 if there's none.
+*/
+int UtilsSelector_findNext(struct UtilsSelector *this, int dFrom) {
+  int dWords = (this->dSelectionLimit + UTILS_SELECTOR_WORD_BITS - 1) / UTILS_SELECTOR_WORD_BITS;
+  int dWord = dFrom / UTILS_SELECTOR_WORD_BITS;
+  uint64_t dBits;
+
+  if(dFrom < 0 || dWord >= dWords)
+    return -1;
+
+  // Ignore the bits before dFrom in the first word
+  dBits = this->dAvailabilityBitset[dWord] & (~0ULL << (dFrom % UTILS_SELECTOR_WORD_BITS));
+
+  while(!dBits) {
+    if(++dWord >= dWords)
+      return -1;
+
+    dBits = this->dAvailabilityBitset[dWord];
+  }
+
+  return dWord * UTILS_SELECTOR_WORD_BITS + __builtin_ctzll(dBits);
+}
+
+/**
+ * Returns the last available option at or before an index.
+ * 
+ * @param   {struct UtilsSelector *}  this    The instance to be read.
+ * @param   {int}                     dFrom   Where to start looking (backwards).
+ * @return  {int}                             The index of the option, or -1 if there's none.
+*/
+int UtilsSelector_findPrev(struct UtilsSelector *this, int dFrom) {
+  int dWord = dFrom / UTILS_SELECTOR_WORD_BITS;
+  uint64_t dBits;
+
+  if(dFrom < 0 || dFrom >= this->dSelectionLimit)
+    return -1;
+
+  // Ignore the bits after dFrom in the first word
+  dBits = this->dAvailabilityBitset[dWord] & (~0ULL >> (UTILS_SELECTOR_WORD_BITS - 1 - dFrom % UTILS_SELECTOR_WORD_BITS));
+
+  while(!dBits) {
+    if(--dWord < 0)
+      return -1;
+
+    dBits = this->dAvailabilityBitset[dWord];
+  }
+
+  return dWord * UTILS_SELECTOR_WORD_BITS + UTILS_SELECTOR_WORD_BITS - 1 - __builtin_clzll(dBits);
+}
+
+/**
+ * Makes room for more options.
+ * Everything doubles in size, so adding a lot of options one at a time stays cheap.
+ * 
+ * @param   {struct UtilsSelector *}  this  The instance to be modified.
+*/
+void UtilsSelector_grow(struct UtilsSelector *this) {
+  int dOldCapacity = this->dSelectionCapacity;
+  int dOldWords = (dOldCapacity + UTILS_SELECTOR_WORD_BITS - 1) / UTILS_SELECTOR_WORD_BITS;
+  int dWords;
+
+  this->dSelectionCapacity *= 2;
+  dWords = (this->dSelectionCapacity + UTILS_SELECTOR_WORD_BITS - 1) / UTILS_SELECTOR_WORD_BITS;
+
+  this->sSelectionArray = UtilsMem_realloc(UTILS_MEM_SELECTOR, this->sSelectionArray, this->dSelectionCapacity * sizeof(char *));
+  this->dSelectionValueArray = UtilsMem_realloc(UTILS_MEM_SELECTOR, this->dSelectionValueArray, this->dSelectionCapacity * sizeof(int));
+  this->dAvailabilityBitset = UtilsMem_realloc(UTILS_MEM_SELECTOR, this->dAvailabilityBitset, dWords * sizeof(uint64_t));
+  this->sFormattedArray = UtilsMem_realloc(UTILS_MEM_SELECTOR, this->sFormattedArray, this->dSelectionCapacity * sizeof(char *));
+  this->cFormattedStateArray = UtilsMem_realloc(UTILS_MEM_SELECTOR, this->cFormattedStateArray, this->dSelectionCapacity * sizeof(char));
+
+  // Realloc doesn't clear the new parts for us
+  memset(this->dAvailabilityBitset + dOldWords, 0, (dWords - dOldWords) * sizeof(uint64_t));
+  memset(this->sFormattedArray + dOldCapacity, 0, (this->dSelectionCapacity - dOldCapacity) * sizeof(char *));
+  memset(this->cFormattedStateArray + dOldCapacity, 0, (this->dSelectionCapacity - dOldCapacity) * sizeof(char));
 }
 
 /**
@@ -123,14 +259,19 @@ void UtilsSelector_kill(struct UtilsSelector *this) {
  * @param   {int}                       dOptionValue          The value associated with the option.
 */
 void UtilsSelector_addOption(struct UtilsSelector *this, char *sOption, int dOptionValue) {
-  if(this->dSelectionLimit < MAX_SELECTION_SIZE) {
-    this->sSelectionArray[this->dSelectionLimit] = sOption;
-    this->dSelectionValueArray[this->dSelectionLimit] = dOptionValue;
-    this->bSelectionAvailabilityArray[this->dSelectionLimit] = 1;
+  int dIndex = this->dSelectionLimit;
 
-    this->dSelectionAvailable++;
-    this->dSelectionLimit++;
-  }
+  if(dIndex >= this->dSelectionCapacity)
+    UtilsSelector_grow(this);
+
+  this->sSelectionArray[dIndex] = sOption;
+  this->dSelectionValueArray[dIndex] = dOptionValue;
+  this->dAvailabilityBitset[dIndex / UTILS_SELECTOR_WORD_BITS] |= 1ULL << (dIndex % UTILS_SELECTOR_WORD_BITS);
+  this->cFormattedStateArray[dIndex] = UTILS_SELECTOR_UNFORMATTED;
+
+  this->dSelectionAvailable++;
+  this->dSelectionLimit++;
+  this->dVersion = UtilsPanel_nextVersion();
 }
 
 /**
@@ -156,14 +297,15 @@ char *UtilsSelector_getOption(struct UtilsSelector *this, int dIndex) {
  * @param   {int}                     bAvailability   Whether or not the option can be selected.
 */
 void UtilsSelector_setOptionAvailability(struct UtilsSelector *this, int dIndex, int bAvailability) {
-  this->bSelectionAvailabilityArray[dIndex] = bAvailability;
-  
-  // This implementation suffices cuz we only have a max of 128 options
-  this->dSelectionAvailable = 0;
-  for(int i = 0; i < this->dSelectionLimit; i++)
-    if(this->bSelectionAvailabilityArray[i])
-      this->dSelectionAvailable++;
+  bAvailability = bAvailability ? 1 : 0;
 
+  // Nothing to do (and the version stays the same)
+  if(UtilsSelector_isAvailable(this, dIndex) == bAvailability)
+    return;
+
+  this->dAvailabilityBitset[dIndex / UTILS_SELECTOR_WORD_BITS] ^= 1ULL << (dIndex % UTILS_SELECTOR_WORD_BITS);
+  this->dSelectionAvailable += bAvailability ? 1 : -1;
+  this->dVersion = UtilsPanel_nextVersion();
 }
 
 /**
@@ -173,9 +315,22 @@ void UtilsSelector_setOptionAvailability(struct UtilsSelector *this, int dIndex,
  * @param   {int}                     bAvailability   The availability boolean to assign to the options.
 */
 void UtilsSelector_setAllAvailability(struct UtilsSelector *this, int bAvailability) {
-  this->dSelectionAvailable = bAvailability ? this->dSelectionLimit : 0;
-  for(int i = 0; i < this->dSelectionLimit; i++)
-    this->bSelectionAvailabilityArray[i] = bAvailability;
+  int dCount = bAvailability ? this->dSelectionLimit : 0;
+  int dWords = (this->dSelectionLimit + UTILS_SELECTOR_WORD_BITS - 1) / UTILS_SELECTOR_WORD_BITS;
+
+  if(this->dSelectionAvailable == dCount)
+    return;
+
+  // Whole words at a time; only the bits of the options that exist get set
+  for(int i = 0; i < dWords; i++) {
+    int dBits = this->dSelectionLimit - i * UTILS_SELECTOR_WORD_BITS;
+
+    this->dAvailabilityBitset[i] = !bAvailability ? 0 : 
+      dBits >= UTILS_SELECTOR_WORD_BITS ? ~0ULL : (1ULL << dBits) - 1;
+  }
+
+  this->dSelectionAvailable = dCount;
+  this->dVersion = UtilsPanel_nextVersion();
 }
 
 /**
@@ -184,11 +339,9 @@ void UtilsSelector_setAllAvailability(struct UtilsSelector *this, int bAvailabil
  * @param   {struct UtilsSelector *}  this  The selector instance to be modified.
 */
 void UtilsSelector_setFirstAvailable(struct UtilsSelector *this) {
-  if(this->dSelectionAvailable && !this->bSelectionAvailabilityArray[this->dSelectionIndex]) {
-    this->dSelectionIndex = 0;
-
-    while(!this->bSelectionAvailabilityArray[this->dSelectionIndex] && this->dSelectionIndex + 1 < this->dSelectionLimit)
-      this->dSelectionIndex++;
+  if(this->dSelectionAvailable && !UtilsSelector_isAvailable(this, this->dSelectionIndex)) {
+    this->dSelectionIndex = UtilsSelector_findNext(this, 0);
+    this->dVersion = UtilsPanel_nextVersion();
   }
 }
 
@@ -227,6 +380,17 @@ int UtilsSelector_getCurrentIndex(struct UtilsSelector *this) {
   return this->dSelectionIndex;
 }
 
+/**
+ * Gets the version of the selector.
+ * It changes whenever the current option or the availability of an option changes.
+ * 
+ * @param   {struct UtilsSelector *}  this    The instance to be read.
+ * @return  {int}                             The version of the selector.
+*/
+int UtilsSelector_getVersion(struct UtilsSelector *this) {
+  return this->dVersion;
+}
+
 /**
  * Gets the option of the current selected index.
  * 
@@ -249,30 +413,77 @@ int UtilsSelector_getCurrentValue(struct UtilsSelector *this) {
 
 /**
  * Gets the formatted string for the option requested.
+ * Each option remembers what it was last formatted as (selected, disabled, etc.) and is only formatted again when that changes.
+ * The string belongs to the selector, so don't free it; it stays valid until the selector is killed.
  * 
  * @param   {struct UtilsSelector *}  this    The instance to be read.
  * @param   {int}                     dIndex  The index of the option requested.
  * @return  {char *}                          The formatted option string.
 */
 char *UtilsSelector_getOptionFormatted(struct UtilsSelector *this, int dIndex) {
-  
+  char cState;
+  char *sWrapper;
+
   // In case user does a dumb dumb
   dIndex %= this->dSelectionLimit;
 
-  // Create output buffer
-  char *sOutput = calloc(strlen(this->sSelectionArray[dIndex]) + MAX_WRAPPER_LENGTH, sizeof(char));
-
-  // Create the formatted string
-  if(!this->bSelectionAvailabilityArray[dIndex]) {
-    sprintf(sOutput, this->sDisabledWrapper, this->sSelectionArray[dIndex]);
+  // What the option should look like right now
+  if(!UtilsSelector_isAvailable(this, dIndex)) {
+    cState = UTILS_SELECTOR_DISABLED;
+    sWrapper = this->sDisabledWrapper;
+  } else if(dIndex == this->dSelectionIndex) {
+    cState = UTILS_SELECTOR_SELECTED;
+    sWrapper = this->sSelectedWrapper;
   } else {
-    if(dIndex == this->dSelectionIndex)
-      sprintf(sOutput, this->sSelectedWrapper, this->sSelectionArray[dIndex]);
-    else 
-      sprintf(sOutput, this->sDefaultWrapper, this->sSelectionArray[dIndex]);
+    cState = UTILS_SELECTOR_DEFAULT;
+    sWrapper = this->sDefaultWrapper;
   }
 
-  return sOutput;
+  if(this->cFormattedStateArray[dIndex] == cState)
+    return this->sFormattedArray[dIndex];
+
+  // The wrappers are shorter than MAX_WRAPPER_LENGTH, so this is big enough for any of them
+  if(this->sFormattedArray[dIndex] == NULL)
+    this->sFormattedArray[dIndex] = UtilsMem_calloc(UTILS_MEM_SELECTOR, 
+      strlen(this->sSelectionArray[dIndex]) + MAX_WRAPPER_LENGTH, sizeof(char));
+
+  sprintf(this->sFormattedArray[dIndex], sWrapper, this->sSelectionArray[dIndex]);
+  this->cFormattedStateArray[dIndex] = cState;
+
+  return this->sFormattedArray[dIndex];
+}
+
+/**
+ * Gets the options to show when there's only room for some of them (virtual scrolling).
+ * The window only scrolls once the current option would leave it, so it doesn't jump around on every keystroke.
+ * 
+ * @param   {struct UtilsSelector *}  this    The instance to be read.
+ * @param   {int}                     dFirst  The first option of the list (some lists skip the first few).
+ * @param   {int}                     dRows   How many options there's room for.
+ * @param   {int *}                   pStart  Gets the first option to show.
+ * @param   {int *}                   pEnd    Gets the option after the last one to show.
+*/
+void UtilsSelector_getWindow(struct UtilsSelector *this, int dFirst, int dRows, int *pStart, int *pEnd) {
+  int dLast = this->dSelectionLimit - dRows;
+
+  // Everything fits
+  if(dRows < 1 || dLast <= dFirst) {
+    *pStart = dFirst;
+    *pEnd = this->dSelectionLimit;
+    return;
+  }
+
+  // Follow the current option, then keep the window inside the list
+  if(this->dSelectionIndex < this->dWindowStart)
+    this->dWindowStart = this->dSelectionIndex;
+  if(this->dSelectionIndex >= this->dWindowStart + dRows)
+    this->dWindowStart = this->dSelectionIndex - dRows + 1;
+
+  if(this->dWindowStart < dFirst) this->dWindowStart = dFirst;
+  if(this->dWindowStart > dLast) this->dWindowStart = dLast;
+
+  *pStart = this->dWindowStart;
+  *pEnd = this->dWindowStart + dRows;
 }
 
 /**
@@ -299,23 +510,16 @@ int UtilsSelector_getLength(struct UtilsSelector *this) {
 void UtilsSelector_increment(struct UtilsSelector *this) {
   if(this->dSelectionAvailable) {
     int oldSelectionIndex = this->dSelectionIndex;
+    int dNext = UtilsSelector_findNext(this, this->dSelectionIndex + 1);
+
+    // Looped selectors go back to the start; the others stay put at the end
+    if(dNext < 0)
+      dNext = this->bSelectionLooped ? UtilsSelector_findNext(this, 0) : oldSelectionIndex;
 
-    do {
-
-      // Looped versus non-looped iteration
-      if(this->bSelectionLooped) 
-        this->dSelectionIndex = (this->dSelectionIndex + 1) % this->dSelectionLimit;
-      else if(this->dSelectionIndex - this->dSelectionLimit + 1) 
-        this->dSelectionIndex++;
-    
-    // Skip unavailable options until we reach the end (for not looped) or until we reach an available option (for looped)
-    } while(!this->bSelectionAvailabilityArray[this->dSelectionIndex] && 
-      (this->dSelectionIndex - this->dSelectionLimit + 1 || this->bSelectionLooped));
-
-    // In case it reached the end of the array and there were no available options (for not looped)
-    if(!this->bSelectionLooped)
-      if(!(this->dSelectionIndex - this->dSelectionLimit + 1) && !this->bSelectionAvailabilityArray[this->dSelectionIndex])
-        this->dSelectionIndex = oldSelectionIndex;
+    this->dSelectionIndex = dNext;
+
+    if(this->dSelectionIndex != oldSelectionIndex)
+      this->dVersion = UtilsPanel_nextVersion();
   }
 }
 
@@ -327,23 +531,16 @@ void UtilsSelector_increment(struct UtilsSelector *this) {
 void UtilsSelector_decrement(struct UtilsSelector *this) {
   if(this->dSelectionAvailable) {
     int oldSelectionIndex = this->dSelectionIndex;
+    int dPrev = UtilsSelector_findPrev(this, this->dSelectionIndex - 1);
 
-    do {
-
-      // Looped and not looped iteration
-      if(this->bSelectionLooped) 
-        this->dSelectionIndex = (this->dSelectionIndex + this->dSelectionLimit - 1) % this->dSelectionLimit;
-      else if(this->dSelectionIndex) 
-        this->dSelectionIndex--;
+    // Looped selectors go around to the end; the others stay put at the start
+    if(dPrev < 0)
+      dPrev = this->bSelectionLooped ? UtilsSelector_findPrev(this, this->dSelectionLimit - 1) : oldSelectionIndex;
 
-    // Skip unavailable options until we reach the end (for not looped) or until we reach an available option (for looped)
-    } while(!this->bSelectionAvailabilityArray[this->dSelectionIndex] && 
-      (this->dSelectionIndex || this->bSelectionLooped));
+    this->dSelectionIndex = dPrev;
 
-    // In case it reached the end of the array and there were no available options (for not looped)
-    if(!this->bSelectionLooped)
-      if(!this->dSelectionIndex && !this->bSelectionAvailabilityArray[this->dSelectionIndex])
-        this->dSelectionIndex = oldSelectionIndex;
+    if(this->dSelectionIndex != oldSelectionIndex)
+      this->dVersion = UtilsPanel_nextVersion();
   }
 }
 
@@ -0,0 +1,292 @@
+/**
+ * A small string builder class.
+ * Building lines with strcat() means rescanning the whole string every time we append something, so long lines get slow really quick.
+ * This class remembers its own length and grows its buffer in doubling steps, so appending stays linear.
+*/
+
+#ifndef UTILS_STRING
+#define UTILS_STRING
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "utils.mem.h"
+
+// The smallest capacity we allocate, so short strings don't keep regrowing
+#define UTILS_STRING_MIN_CAPACITY 64
+
+/**
+ * An instantiable that holds a growing string.
+ * The string is always null-terminated, so its text can be passed around like any other string.
+*/
+struct UtilsString {
+  char *sText;      // The string itself
+  int dLength;      // The number of characters in the string (excluding the null byte)
+  int dCapacity;    // The number of characters the buffer can hold (including the null byte)
+};
+
+/**
+ * #############################
+ * ###  STRING CONSTRUCTION  ###
+ * #############################
+*/
+
+/**
+ * Returns a new instance of the UtilsString class.
+ *
+ * @return  {struct UtilsString *}  A pointer to the created instance.
+*/
+struct UtilsString *UtilsString_new() {
+  struct UtilsString *pUtilsString;
+
+  pUtilsString = UtilsMem_calloc(UTILS_MEM_STRING, 1, sizeof(*pUtilsString));
+
+  if(pUtilsString == NULL)
+    return NULL;
+
+  return pUtilsString;
+}
+
+/**
+ * Initializes the object with an empty string.
+ *
+ * @param   {struct UtilsString *}  this  The instance to be initialized.
+*/
+void UtilsString_init(struct UtilsString *this) {
+  this->sText = UtilsMem_calloc(UTILS_MEM_STRING, UTILS_STRING_MIN_CAPACITY, sizeof(char));
+  this->dLength = 0;
+  this->dCapacity = UTILS_STRING_MIN_CAPACITY;
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @return  {struct UtilsString *}  The created instance.
+*/
+struct UtilsString *UtilsString_create() {
+  struct UtilsString *pUtilsString = UtilsString_new();
+  UtilsString_init(pUtilsString);
+
+  return pUtilsString;
+}
+
+/**
+ * Destroys a specified instance along with its string.
+ *
+ * @param   {struct UtilsString *}  this  The instance to be destroyed.
+*/
+void UtilsString_kill(struct UtilsString *this) {
+  UtilsMem_free(this->sText);
+  UtilsMem_free(this);
+}
+
+/**
+ * Destroys the instance but hands its string over to the caller.
+ * The returned string should be freed with UtilsMem_free() once it isn't needed anymore.
+ *
+ * @param   {struct UtilsString *}  this  The instance to be destroyed.
+ * @return  {char *}                      The string it was holding.
+*/
+char *UtilsString_release(struct UtilsString *this) {
+  char *sText = this->sText;
+
+  UtilsMem_free(this);
+
+  return sText;
+}
+
+/**
+ * ####################################
+ * ###  STRING READERS AND WRITERS  ###
+ * ####################################
+*/
+
+/**
+ * Returns the string stored by the instance.
+ *
+ * @param   {struct UtilsString *}  this  The instance to be read.
+ * @return  {char *}                      The string.
+*/
+char *UtilsString_getText(struct UtilsString *this) {
+  return this->sText;
+}
+
+/**
+ * Returns the length of the stored string without scanning it.
+ *
+ * @param   {struct UtilsString *}  this  The instance to be read.
+ * @return  {int}                         The length of the string.
+*/
+int UtilsString_getLength(struct UtilsString *this) {
+  return this->dLength;
+}
+
+/**
+ * Makes sure the buffer can hold a string of the given length.
+ * The buffer doubles in size whenever it has to grow, so the cost of growing averages out.
+ *
+ * @param   {struct UtilsString *}  this      The instance to be modified.
+ * @param   {int}                   dLength   The length of the string the buffer has to fit.
+*/
+void UtilsString_reserve(struct UtilsString *this, int dLength) {
+  int dCapacity = this->dCapacity;
+
+  if(dLength < dCapacity)
+    return;
+
+  while(dCapacity <= dLength)
+    dCapacity *= 2;
+
+  this->sText = UtilsMem_realloc(UTILS_MEM_STRING, this->sText, dCapacity);
+  this->dCapacity = dCapacity;
+}
+
+/**
+ * Empties the string but keeps the buffer, so the instance can be reused without allocating.
+ *
+ * @param   {struct UtilsString *}  this  The instance to be modified.
+*/
+void UtilsString_clear(struct UtilsString *this) {
+  this->dLength = 0;
+  this->sText[0] = 0;
+}
+
+/**
+ * Cuts the string down to the given length.
+ * Does nothing if the string is already shorter.
+ *
+ * @param   {struct UtilsString *}  this      The instance to be modified.
+ * @param   {int}                   dLength   The maximum length of the string.
+*/
+void UtilsString_truncate(struct UtilsString *this, int dLength) {
+  if(dLength < 0 || dLength >= this->dLength)
+    return;
+
+  this->dLength = dLength;
+  this->sText[dLength] = 0;
+}
+
+/**
+ * Appends the first few characters of a string.
+ *
+ * @param   {struct UtilsString *}  this      The instance to be modified.
+ * @param   {char *}                sText     The string to be appended.
+ * @param   {int}                   dLength   The number of characters to append.
+*/
+void UtilsString_appendLength(struct UtilsString *this, char *sText, int dLength) {
+  if(dLength <= 0)
+    return;
+
+  UtilsString_reserve(this, this->dLength + dLength);
+  memcpy(this->sText + this->dLength, sText, dLength);
+
+  this->dLength += dLength;
+  this->sText[this->dLength] = 0;
+}
+
+/**
+ * Appends a string.
+ *
+ * @param   {struct UtilsString *}  this    The instance to be modified.
+ * @param   {char *}                sText   The string to be appended.
+*/
+void UtilsString_append(struct UtilsString *this, char *sText) {
+  UtilsString_appendLength(this, sText, strlen(sText));
+}
+
+/**
+ * Appends a single character.
+ *
+ * @param   {struct UtilsString *}  this    The instance to be modified.
+ * @param   {char}                  cChar   The character to be appended.
+*/
+void UtilsString_appendChar(struct UtilsString *this, char cChar) {
+  UtilsString_reserve(this, this->dLength + 1);
+
+  this->sText[this->dLength++] = cChar;
+  this->sText[this->dLength] = 0;
+}
+
+/**
+ * Appends a character a number of times.
+ *
+ * @param   {struct UtilsString *}  this    The instance to be modified.
+ * @param   {char}                  cChar   The character to be repeated.
+ * @param   {int}                   dCount  How many times to repeat the character.
+*/
+void UtilsString_appendRepeat(struct UtilsString *this, char cChar, int dCount) {
+  if(dCount <= 0)
+    return;
+
+  UtilsString_reserve(this, this->dLength + dCount);
+  memset(this->sText + this->dLength, cChar, dCount);
+
+  this->dLength += dCount;
+  this->sText[this->dLength] = 0;
+}
+
+/**
+ * Appends a string pattern a number of times.
+ *
+ * @param   {struct UtilsString *}  this      The instance to be modified.
+ * @param   {char *}                sPattern  The pattern to be repeated.
+ * @param   {int}                   dCount    How many times to repeat the pattern.
+*/
+void UtilsString_appendPattern(struct UtilsString *this, char *sPattern, int dCount) {
+  int dPatternLength = strlen(sPattern);
+
+  // Single character patterns are just a memset
+  if(dPatternLength == 1) {
+    UtilsString_appendRepeat(this, sPattern[0], dCount);
+    return;
+  }
+
+  if(dCount <= 0 || !dPatternLength)
+    return;
+
+  UtilsString_reserve(this, this->dLength + dPatternLength * dCount);
+
+  while(dCount--) {
+    memcpy(this->sText + this->dLength, sPattern, dPatternLength);
+    this->dLength += dPatternLength;
+  }
+
+  this->sText[this->dLength] = 0;
+}
+
+/**
+ * Appends a formatted string, just like sprintf().
+ *
+ * @param   {struct UtilsString *}  this      The instance to be modified.
+ * @param   {char *}                sFormat   The format string.
+ * @param   {...}                   ...       The values to be formatted.
+*/
+void UtilsString_appendFormat(struct UtilsString *this, char *sFormat, ...) {
+  va_list args;
+  int dLength;
+
+  // Try to fit it into the space we already have
+  va_start(args, sFormat);
+  dLength = vsnprintf(this->sText + this->dLength, this->dCapacity - this->dLength, sFormat, args);
+  va_end(args);
+
+  if(dLength < 0) {
+    this->sText[this->dLength] = 0;
+    return;
+  }
+
+  // It didn't fit, so grow and do it again
+  if(this->dLength + dLength >= this->dCapacity) {
+    UtilsString_reserve(this, this->dLength + dLength);
+
+    va_start(args, sFormat);
+    vsnprintf(this->sText + this->dLength, this->dCapacity - this->dLength, sFormat, args);
+    va_end(args);
+  }
+
+  this->dLength += dLength;
+}
+
+#endif
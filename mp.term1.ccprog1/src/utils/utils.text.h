@@ -10,6 +10,8 @@
 #include <stdlib.h>
 
 #include "../utils/utils.io.h"
+#include "../utils/utils.mem.h"
+#include "../utils/utils.string.h"
 
 #define UTILS_TEXT_MAX_LINES 1024
 
@@ -45,7 +47,7 @@ enum UtilsText_Alignment {
 struct UtilsText *UtilsText_new() {
   struct UtilsText *pUtilsText;
 
-  pUtilsText = calloc(1, sizeof(*pUtilsText));
+  pUtilsText = UtilsMem_calloc(UTILS_MEM_TEXT, 1, sizeof(*pUtilsText));
 
   if(pUtilsText == NULL)
     return NULL;
@@ -80,7 +82,7 @@ struct UtilsText *UtilsText_create() {
  * @param   {struct UtilsText *}  this  The instance to be destroyed.
 */
 void UtilsText_kill(struct UtilsText *this) {
-  free(this);
+  UtilsMem_free(this);
 }
 
 /**
@@ -89,6 +91,21 @@ void UtilsText_kill(struct UtilsText *this) {
  * ##################################
 */
 
+/**
+ * Returns how many times the loop for(i = 0; i < dLimit; i += dStep) runs.
+ * The padding code used to be written with loops like that, so this keeps the output exactly the same.
+ * 
+ * @param   {int}   dLimit  The upper bound of the loop.
+ * @param   {int}   dStep   The increment of the loop.
+ * @return  {int}           The number of iterations.
+*/
+int UtilsText_countSteps(int dLimit, int dStep) {
+  if(dLimit <= 0 || dStep <= 0)
+    return 0;
+
+  return (dLimit + dStep - 1) / dStep;
+}
+
 /**
  * Adds a line of a repeated string pattern.
  * 
@@ -98,18 +115,15 @@ void UtilsText_kill(struct UtilsText *this) {
 */
 void UtilsText_addPatternLines(struct UtilsText *this, int dLines, char *sPattern) {
   int dWidth = UtilsIO_getWidth();
+  int dPatternLength = strlen(sPattern);
 
   while(dLines-- && this->dLength < UTILS_TEXT_MAX_LINES) {
-    int dLength = 0;
-    char *sLine = calloc(dWidth + 1, sizeof(char));
+    struct UtilsString *pLine = UtilsString_create();
 
-    while(dLength < dWidth - strlen(sPattern)) {
-      strcat(sLine, sPattern);
-      dLength += strlen(sPattern);
-    }
+    // Repeat the pattern for as long as another copy still fits
+    UtilsString_appendPattern(pLine, sPattern, UtilsText_countSteps(dWidth - dPatternLength, dPatternLength));
 
-    this->sTextArray[this->dLength] = calloc(dWidth + 1, sizeof(char));
-    this->sTextArray[this->dLength] = sLine;
+    this->sTextArray[this->dLength] = UtilsString_release(pLine);
     this->dLength++;
   }
 }
@@ -135,7 +149,7 @@ void UtilsText_addText(struct UtilsText *this, char *sText) {
   if(this->dLength < UTILS_TEXT_MAX_LINES) {
     int dWidth = UtilsIO_getWidth();
 
-    this->sTextArray[this->dLength] = calloc(dWidth + 1, sizeof(char));
+    this->sTextArray[this->dLength] = UtilsMem_calloc(UTILS_MEM_TEXT, dWidth + 1, sizeof(char));
     if(strlen(sText) > dWidth) sText[dWidth] = 0;
     strcpy(this->sTextArray[this->dLength], sText);
     
@@ -209,29 +223,30 @@ void UtilsText_mergeText(struct UtilsText *this, struct UtilsText *pSource) {
 */
 
 /**
- * A helper function to created a line of text padded with a certain character set.
+ * A helper function to create a line of text padded with a certain character set.
+ * This version appends the padded line to a string builder, so callers that already have one don't have to allocate.
  * 
+ * @param   {struct UtilsString *}      pOutput     Where the padded text will be appended.
  * @param   {char *}                    sText       The text to be padded.
  * @param   {char *}                    sPadText    The text to be used to pad the content.
  * @param   {enum UtilsText_Alignment}  eAlignment  Whether or not the padding will be applied to both sides.
- * @return  {char *}                                The generated padded text.
 */
-char *UtilsText_paddedText(char *sText, char *sPadText, enum UtilsText_Alignment eAlignment) {
+void UtilsText_paddedTextOut(struct UtilsString *pOutput, char *sText, char *sPadText, enum UtilsText_Alignment eAlignment) {
 
   // Width of console; length of text; length of pattern
   int dWidth = UtilsIO_getWidth() - 1;
   int dLength = strlen(sText);
   int dPadLength = strlen(sPadText);
 
-  // Iterator; amount of extra
-  int i = 0, dExtras = 0;
+  // Number of times the pattern is repeated; amount of extra
+  int dPatterns = 0, dExtras = 0;
   int dPadding = 0;
 
-  char *sOutput = calloc(dWidth + 1, sizeof(char));
+  UtilsString_reserve(pOutput, UtilsString_getLength(pOutput) + dWidth);
 
   // Conditional just to check if text overflows the console
   if(dLength > dWidth) {
-    strcat(sOutput, sText);
+    UtilsString_appendLength(pOutput, sText, dLength);
   } else {
     switch(eAlignment) {
 
@@ -240,27 +255,24 @@ char *UtilsText_paddedText(char *sText, char *sPadText, enum UtilsText_Alignment
         dPadding = (dWidth - dLength) / 2;
 
         // Pad the text along both sides
-        dExtras = 0;
-        for(i = 0; i < dPadding - dPadLength + 1; i += dPadLength) strcat(sOutput, sPadText);
-        for(     ; i < dPadding - 1; i++) {
-          strcat(sOutput, " ");
-          dExtras++; 
-        }
+        // Whatever the pattern can't fill is filled with spaces
+        dPatterns = UtilsText_countSteps(dPadding - dPadLength + 1, dPadLength);
+        dExtras = dPadding - 1 - dPatterns * dPadLength;
         
-        strcat(sOutput, sText);
-
-        for(i = 0; i < dExtras; i++) strcat(sOutput, " ");
-        for(i = 0; i < dPadding - 1; i += dPadLength) strcat(sOutput, sPadText);
+        UtilsString_appendPattern(pOutput, sPadText, dPatterns);
+        UtilsString_appendRepeat(pOutput, ' ', dExtras);
+        UtilsString_appendLength(pOutput, sText, dLength);
+        UtilsString_appendRepeat(pOutput, ' ', dExtras);
+        UtilsString_appendPattern(pOutput, sPadText, UtilsText_countSteps(dPadding - 1, dPadLength));
         break;
 
       // Left alignment
       case UTILS_TEXT_LEFT_ALIGN:
         dPadding = dWidth - dLength;
-        strcat(sOutput, sText);
 
         // Pad the text to the right
-        dExtras = 0;
-        for(i = 0; i < dPadding - dPadLength + 1; i += dPadLength) strcat(sOutput, sPadText);
+        UtilsString_appendLength(pOutput, sText, dLength);
+        UtilsString_appendPattern(pOutput, sPadText, UtilsText_countSteps(dPadding - dPadLength + 1, dPadLength));
         break;
 
       // Right alignment
@@ -268,18 +280,59 @@ char *UtilsText_paddedText(char *sText, char *sPadText, enum UtilsText_Alignment
         dPadding = dWidth - dLength;
 
         // Pad the text to the left
-        for(i = 0; i < dPadding - dPadLength + 1; i += dPadLength) strcat(sOutput, sPadText);
-        for(     ; i < dPadding; i++) strcat(sOutput, " ");
+        dPatterns = UtilsText_countSteps(dPadding - dPadLength + 1, dPadLength);
+        dExtras = dPadding - dPatterns * dPadLength;
 
-        strcat(sOutput, sText);
+        UtilsString_appendPattern(pOutput, sPadText, dPatterns);
+        UtilsString_appendRepeat(pOutput, ' ', dExtras);
+        UtilsString_appendLength(pOutput, sText, dLength);
         break;
 
       default:
         break;
     }
   }
+}
 
-  return sOutput;
+/**
+ * A helper function to created a line of text padded with a certain character set.
+ * 
+ * @param   {char *}                    sText       The text to be padded.
+ * @param   {char *}                    sPadText    The text to be used to pad the content.
+ * @param   {enum UtilsText_Alignment}  eAlignment  Whether or not the padding will be applied to both sides.
+ * @return  {char *}                                The generated padded text.
+*/
+char *UtilsText_paddedText(char *sText, char *sPadText, enum UtilsText_Alignment eAlignment) {
+  struct UtilsString *pOutput = UtilsString_create();
+
+  UtilsText_paddedTextOut(pOutput, sText, sPadText, eAlignment);
+
+  return UtilsString_release(pOutput);
+}
+
+/**
+ * Adds a line of padded text to the instance.
+ * Unlike passing the result of UtilsText_paddedText() to UtilsText_addText(), this doesn't leave a copy lying around.
+ * 
+ * @param   {struct UtilsText *}        this        The instance to be modified.
+ * @param   {char *}                    sText       The text to be padded.
+ * @param   {char *}                    sPadText    The text to be used to pad the content.
+ * @param   {enum UtilsText_Alignment}  eAlignment  Whether or not the padding will be applied to both sides.
+*/
+void UtilsText_addPaddedText(struct UtilsText *this, char *sText, char *sPadText, enum UtilsText_Alignment eAlignment) {
+  struct UtilsString *pLine;
+
+  if(this->dLength >= UTILS_TEXT_MAX_LINES)
+    return;
+
+  pLine = UtilsString_create();
+  UtilsText_paddedTextOut(pLine, sText, sPadText, eAlignment);
+
+  // Same truncation as UtilsText_addText()
+  UtilsString_truncate(pLine, UtilsIO_getWidth());
+  
+  this->sTextArray[this->dLength] = UtilsString_release(pLine);
+  this->dLength++;
 }
 
 /**
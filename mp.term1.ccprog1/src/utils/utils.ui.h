@@ -8,21 +8,39 @@
 #ifndef UTILS_UI
 #define UTILS_UI
 
+#include <ctype.h>
 #include <string.h>
 
 #include "utils.io.h"
+#include "utils.mem.h"
 #include "utils.text.h"
 
 #define UTILS_UI_MAX_LINE_LEN 1 << 10
 
+// Some extra room in the stdout buffer for the escape sequences printed before a frame (like the one in UtilsIO_clear())
+#define UTILS_UI_FRAME_SLACK 64
+
 /**
  * A struct to store some important info so we don't pollute the global namespace.
- * It's empty tho but I'll just keep it here in case I need to add something in the future.
+ * It used to be empty, but now it holds the output buffer that UtilsUI_print() reuses across frames.
+ * The buffer only ever grows (when the console gets bigger), so most frames don't allocate anything.
 */
 struct UtilsUI {
-
+  char *sFrame;       // The reusable output buffer
+  int dFrameSize;     // The capacity of the output buffer
 };
 
+/**
+ * Returns the one instance of the struct above.
+ * 
+ * @return  {struct UtilsUI *}  The UI state.
+*/
+struct UtilsUI *UtilsUI_get() {
+  static struct UtilsUI utilsUI;
+
+  return &utilsUI;
+}
+
 /**
  * #######################
  * ###  UI GENERATORS  ###
@@ -154,48 +172,82 @@ struct UtilsText *UtilsUI_footer(struct UtilsText *pUtilsText, struct UtilsText
  * ######################
 */
 
+/**
+ * Makes sure the reusable output buffer can hold a frame of the given size.
+ * Also resizes the stdout buffer so the whole frame can be flushed at once.
+ * 
+ * @param   {struct UtilsUI *}  this    The UI state.
+ * @param   {int}               dSize   The number of characters the frame needs.
+*/
+void UtilsUI_reserveFrame(struct UtilsUI *this, int dSize) {
+  if(dSize <= this->dFrameSize)
+    return;
+
+  UtilsMem_free(this->sFrame);
+
+  this->sFrame = UtilsMem_calloc(UTILS_MEM_UI, dSize, sizeof(char));
+  this->dFrameSize = dSize;
+
+  UtilsIO_setBuffer(dSize + UTILS_UI_FRAME_SLACK);
+}
+
 /**
  * A moderately useful helper function.
+ * Every line is padded to the width of the console and the rest of the screen is filled with blank lines.
  * 
  * @param   {UtilsText *}   pUtilsText  The strings to be displayed.
 */
 void UtilsUI_print(struct UtilsText *pUtilsText) {
+  struct UtilsUI *this = UtilsUI_get();
   int dWidth = UtilsIO_getWidth();
   int dHeight = UtilsIO_getHeight();
 
-  char *sOutput = calloc((dWidth + 1) * (dHeight + 2), sizeof(char));
   char **sTextArray = UtilsText_getText(pUtilsText);
   int dLength = UtilsText_getLines(pUtilsText);
+  int dLines = dLength > dHeight ? dLength : dHeight;
+  char *sCursor;
+
+  // Just in case the console reports something silly
+  if(dWidth < 1)
+    dWidth = 1;
 
-  // Combine into one string so we only make one call to printf
+  // Each line takes at most dWidth characters plus a newline
+  UtilsUI_reserveFrame(this, (dWidth + 1) * (dLines + 1));
+  sCursor = this->sFrame;
+
+  // Combine into one string so we only write once
   for(int i = 0; i < dLength; i++) {
-    strcat(sOutput, sTextArray[i]);
-    int dGap = dWidth - strlen(sTextArray[i]);
+    int dLineLength = strlen(sTextArray[i]);
+
+    if(dLineLength > dWidth)
+      dLineLength = dWidth;
+
+    memcpy(sCursor, sTextArray[i], dLineLength);
+    sCursor += dLineLength;
     
     // We have to fill each line buffer
-    while(--dGap > 0)
-      strcat(sOutput, " ");
-    strcat(sOutput, "\n");
+    if(dLineLength < dWidth - 1) {
+      memset(sCursor, ' ', dWidth - 1 - dLineLength);
+      sCursor += dWidth - 1 - dLineLength;
+    }
+
+    *sCursor++ = '\n';
   }
 
-  // Add extra lines to fill the buffer
+  // Add extra lines of space characters to fill the screen
+  // We don't want a new line on the last line
   int dExtra = dHeight - dLength;
   while(dExtra-- > 0) {
+    memset(sCursor, ' ', dWidth - 1);
+    sCursor += dWidth - 1;
 
-    // Create a new line of space characters
-    char sLine[dWidth];
-    memset(sLine, ' ', sizeof(sLine));
-
-    // We don't want a new line on the last line
     if(dExtra > 0)
-      sLine[dWidth - 1] = '\n';
-
-    strcat(sOutput, sLine);
+      *sCursor++ = '\n';
   }
-  strcat(sOutput, " ");
+  *sCursor++ = ' ';
   
-  // Calling it just once prevents a glitchy console output
-  printf("%s", sOutput);
+  // Writing it just once prevents a glitchy console output
+  UtilsIO_writeFrame(this->sFrame, sCursor - this->sFrame);
 }
 
 /**
@@ -205,15 +257,12 @@ void UtilsUI_print(struct UtilsText *pUtilsText) {
  * @return  {char *}            The capitalized version of the string.
 */
 char *UtilsUI_toUpper(char *sString) {
-  char *sCapitalizedString = calloc(strlen(sString), sizeof(char));
-  char *sCharacterAsString = calloc(1, sizeof(char));
-  strcpy(sCapitalizedString, "");
-
-  // So messy goddamit C
-  for(int i = 0; i < strlen(sString); i++) {
-    sprintf(sCharacterAsString, "%c", toupper(sString[i]));
-    strcat(sCapitalizedString, sCharacterAsString);
-  }
+  int dLength = strlen(sString);
+  char *sCapitalizedString = UtilsMem_calloc(UTILS_MEM_UI, dLength + 1, sizeof(char));
+
+  // Used to be a sprintf() + strcat() per character, which rescanned the string every time
+  for(int i = 0; i < dLength; i++)
+    sCapitalizedString[i] = toupper(sString[i]);
 
   return sCapitalizedString;
 }
@@ -224,7 +273,7 @@ char *UtilsUI_toUpper(char *sString) {
  * @return  A pointer to the buffer in memory.
 */
 char *UtilsUI_createBuffer() {
-  return calloc(UTILS_UI_MAX_LINE_LEN, sizeof(char));
+  return UtilsMem_calloc(UTILS_MEM_UI, UTILS_UI_MAX_LINE_LEN, sizeof(char));
 }
 
 #endif
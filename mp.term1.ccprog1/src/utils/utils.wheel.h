@@ -0,0 +1,356 @@
+/**
+ * A hierarchical timer wheel.
+ * It keeps a lot of timers (like one per plot) without having to look at all of them every tick:
+ * scheduling and cancelling are O(1), and advancing the clock only touches the timers that are actually due.
+ *
+ * The wheel has UTILS_WHEEL_LEVELS levels of UTILS_WHEEL_SLOTS slots each. Level 0 has one slot per tick,
+ * level 1 one slot per UTILS_WHEEL_SLOTS ticks, and so on. A timer goes in the level its deadline falls in,
+ * and whenever the lower level wraps around, the next slot of the level above gets spread out over the levels below it.
+ * That's the same trick the Linux kernel used for its timers for years.
+ *
+ * Timers live in one array and are referred to by their index (the "handle"), so there's no allocation per timer.
+ * Ticks are whatever unit the caller wants; the game uses seconds.
+*/
+
+#ifndef UTILS_WHEEL
+#define UTILS_WHEEL
+
+#include "utils.mem.h"
+
+#define UTILS_WHEEL_BITS 6
+#define UTILS_WHEEL_SLOTS (1 << UTILS_WHEEL_BITS)
+#define UTILS_WHEEL_MASK (UTILS_WHEEL_SLOTS - 1)
+#define UTILS_WHEEL_LEVELS 4
+
+// Anything further out than this just waits at the top level and gets put back when its slot comes up
+#define UTILS_WHEEL_RANGE (1L << (UTILS_WHEEL_BITS * UTILS_WHEEL_LEVELS))
+
+/**
+ * A single timer.
+ * The timers in a slot form a doubly linked list through dPrev and dNext.
+*/
+struct UtilsWheelTimer {
+  long dDue;          // The tick it goes off on
+  int dTarget;        // Whatever the caller wants to know when it goes off (like the index of a plot)
+  int dKind;          // Same here (like what kind of event it is)
+
+  int dSlot;          // The slot it's in, or -1 if it isn't scheduled
+  int dPrev;
+  int dNext;          // Also used for the list of free timers
+};
+
+/**
+ * The wheel itself.
+*/
+struct UtilsWheel {
+  long dNow;
+
+  int dHeadArray[UTILS_WHEEL_LEVELS * UTILS_WHEEL_SLOTS];
+
+  struct UtilsWheelTimer *pTimerArray;
+  int dCapacity;
+  int dFree;          // The first unused timer
+  int dCount;         // How many are scheduled
+};
+
+/**
+ * ############################
+ * ###  WHEEL CONSTRUCTION  ###
+ * ############################
+*/
+
+/**
+ * Allocates memory for an instance of the UtilsWheel class.
+ *
+ * @return  {struct UtilsWheel *}   A pointer to the created instance.
+*/
+struct UtilsWheel *UtilsWheel_new() {
+  struct UtilsWheel *pUtilsWheel;
+
+  pUtilsWheel = UtilsMem_calloc(UTILS_MEM_MISC, 1, sizeof(*pUtilsWheel));
+
+  if(pUtilsWheel == NULL)
+    return NULL;
+
+  return pUtilsWheel;
+}
+
+/**
+ * Puts every timer from a given index onwards on the free list.
+ *
+ * @param   {struct UtilsWheel *}   this    The wheel.
+ * @param   {int}                   dFirst  The first timer to free.
+*/
+void UtilsWheel_freeFrom(struct UtilsWheel *this, int dFirst) {
+  for(int i = this->dCapacity - 1; i >= dFirst; i--) {
+    this->pTimerArray[i].dSlot = -1;
+    this->pTimerArray[i].dNext = this->dFree;
+    this->dFree = i;
+  }
+}
+
+/**
+ * Initializes an empty wheel.
+ *
+ * @param   {struct UtilsWheel *}   this        The instance to be initialized.
+ * @param   {int}                   dCapacity   How many timers to make room for at first (the wheel grows if it needs to).
+*/
+void UtilsWheel_init(struct UtilsWheel *this, int dCapacity) {
+  this->dNow = 0;
+  this->dCount = 0;
+  this->dFree = -1;
+  this->dCapacity = dCapacity > 0 ? dCapacity : 1;
+  this->pTimerArray = UtilsMem_calloc(UTILS_MEM_MISC, this->dCapacity, sizeof(struct UtilsWheelTimer));
+
+  for(int i = 0; i < UTILS_WHEEL_LEVELS * UTILS_WHEEL_SLOTS; i++)
+    this->dHeadArray[i] = -1;
+
+  UtilsWheel_freeFrom(this, 0);
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @param   {int}                   dCapacity   How many timers to make room for at first.
+ * @return  {struct UtilsWheel *}               The created instance.
+*/
+struct UtilsWheel *UtilsWheel_create(int dCapacity) {
+  struct UtilsWheel *pUtilsWheel = UtilsWheel_new();
+  UtilsWheel_init(pUtilsWheel, dCapacity);
+
+  return pUtilsWheel;
+}
+
+/**
+ * Destroys a specified instance.
+ *
+ * @param   {struct UtilsWheel *}   this  The instance to be destroyed.
+*/
+void UtilsWheel_kill(struct UtilsWheel *this) {
+  UtilsMem_free(this->pTimerArray);
+  UtilsMem_free(this);
+}
+
+/**
+ * #########################
+ * ###  WHEEL INTERNALS  ###
+ * #########################
+*/
+
+/**
+ * Puts a timer in the slot its deadline falls in.
+ *
+ * @param   {struct UtilsWheel *}   this    The wheel.
+ * @param   {int}                   dTimer  The timer.
+*/
+void UtilsWheel_link(struct UtilsWheel *this, int dTimer) {
+  struct UtilsWheelTimer *pTimer = &this->pTimerArray[dTimer];
+  long dDelta = pTimer->dDue - this->dNow;
+  long dDue = pTimer->dDue;
+  int dLevel = 0;
+
+  // Overdue timers go off on the current tick; ones that are too far go as far as they can
+  if(dDelta < 0)
+    dDue = this->dNow;
+
+  if(dDelta >= UTILS_WHEEL_RANGE)
+    dDue = this->dNow + UTILS_WHEEL_RANGE - 1;
+
+  while(dLevel < UTILS_WHEEL_LEVELS - 1 && dDue - this->dNow >= (1L << (UTILS_WHEEL_BITS * (dLevel + 1))))
+    dLevel++;
+
+  pTimer->dSlot = dLevel * UTILS_WHEEL_SLOTS + ((dDue >> (UTILS_WHEEL_BITS * dLevel)) & UTILS_WHEEL_MASK);
+  pTimer->dPrev = -1;
+  pTimer->dNext = this->dHeadArray[pTimer->dSlot];
+
+  if(pTimer->dNext != -1)
+    this->pTimerArray[pTimer->dNext].dPrev = dTimer;
+
+  this->dHeadArray[pTimer->dSlot] = dTimer;
+}
+
+/**
+ * Takes a timer out of its slot.
+ *
+ * @param   {struct UtilsWheel *}   this    The wheel.
+ * @param   {int}                   dTimer  The timer.
+*/
+void UtilsWheel_unlink(struct UtilsWheel *this, int dTimer) {
+  struct UtilsWheelTimer *pTimer = &this->pTimerArray[dTimer];
+
+  if(pTimer->dPrev != -1)
+    this->pTimerArray[pTimer->dPrev].dNext = pTimer->dNext;
+  else
+    this->dHeadArray[pTimer->dSlot] = pTimer->dNext;
+
+  if(pTimer->dNext != -1)
+    this->pTimerArray[pTimer->dNext].dPrev = pTimer->dPrev;
+
+  pTimer->dSlot = -1;
+}
+
+/**
+ * Spreads the timers of a slot over the levels below it.
+ *
+ * @param   {struct UtilsWheel *}   this    The wheel.
+ * @param   {int}                   dLevel  The level of the slot.
+ * @param   {int}                   dIndex  The index of the slot in its level.
+*/
+void UtilsWheel_cascade(struct UtilsWheel *this, int dLevel, int dIndex) {
+  int dSlot = dLevel * UTILS_WHEEL_SLOTS + dIndex;
+  int dTimer;
+
+  while((dTimer = this->dHeadArray[dSlot]) != -1) {
+    UtilsWheel_unlink(this, dTimer);
+    UtilsWheel_link(this, dTimer);
+  }
+}
+
+/**
+ * #######################
+ * ###  WHEEL METHODS  ###
+ * #######################
+*/
+
+/**
+ * Returns the current tick of the wheel.
+ *
+ * @param   {struct UtilsWheel *}   this  The wheel.
+ * @return  {long}                        The tick.
+*/
+long UtilsWheel_getNow(struct UtilsWheel *this) {
+  return this->dNow;
+}
+
+/**
+ * Returns how many timers are waiting to go off.
+ *
+ * @param   {struct UtilsWheel *}   this  The wheel.
+ * @return  {int}                         The number of scheduled timers.
+*/
+int UtilsWheel_getCount(struct UtilsWheel *this) {
+  return this->dCount;
+}
+
+/**
+ * Schedules a timer.
+ *
+ * @param   {struct UtilsWheel *}   this      The wheel.
+ * @param   {long}                  dDelay    How many ticks from now it should go off (at least one).
+ * @param   {int}                   dTarget   Passed back when it goes off.
+ * @param   {int}                   dKind     Also passed back when it goes off.
+ * @return  {int}                             A handle for cancelling the timer.
+*/
+int UtilsWheel_schedule(struct UtilsWheel *this, long dDelay, int dTarget, int dKind) {
+  int dTimer;
+
+  // Make room if we have to; handles are indices so they stay valid
+  if(this->dFree == -1) {
+    int dOldCapacity = this->dCapacity;
+
+    this->dCapacity *= 2;
+    this->pTimerArray = UtilsMem_realloc(UTILS_MEM_MISC, this->pTimerArray, this->dCapacity * sizeof(struct UtilsWheelTimer));
+    UtilsWheel_freeFrom(this, dOldCapacity);
+  }
+
+  dTimer = this->dFree;
+  this->dFree = this->pTimerArray[dTimer].dNext;
+
+  this->pTimerArray[dTimer].dDue = this->dNow + (dDelay > 0 ? dDelay : 1);
+  this->pTimerArray[dTimer].dTarget = dTarget;
+  this->pTimerArray[dTimer].dKind = dKind;
+
+  UtilsWheel_link(this, dTimer);
+  this->dCount++;
+
+  return dTimer;
+}
+
+/**
+ * Cancels a timer.
+ * Does nothing if the handle is -1 or the timer isn't scheduled anymore.
+ *
+ * @param   {struct UtilsWheel *}   this    The wheel.
+ * @param   {int}                   dTimer  The handle of the timer.
+*/
+void UtilsWheel_cancel(struct UtilsWheel *this, int dTimer) {
+  if(dTimer < 0 || dTimer >= this->dCapacity || this->pTimerArray[dTimer].dSlot == -1)
+    return;
+
+  UtilsWheel_unlink(this, dTimer);
+
+  this->pTimerArray[dTimer].dNext = this->dFree;
+  this->dFree = dTimer;
+  this->dCount--;
+}
+
+/**
+ * Cancels every timer.
+ *
+ * @param   {struct UtilsWheel *}   this  The wheel.
+*/
+void UtilsWheel_clear(struct UtilsWheel *this) {
+  for(int i = 0; i < this->dCapacity; i++)
+    UtilsWheel_cancel(this, i);
+}
+
+/**
+ * Moves the clock forward, setting off every timer that comes due on the way (in order).
+ * Each timer is taken off the wheel before its callback runs, so the callback can schedule or cancel other timers
+ * (and its handle may be handed out again right away, so forget it once it has gone off).
+ *
+ * @param   {struct UtilsWheel *}                                     this      The wheel.
+ * @param   {long}                                                    dNow      The new time; the clock never goes back.
+ * @param   {void (*)(void *pData, int dTarget, int dKind)}           fFire     What to call for each timer.
+ * @param   {void *}                                                  pData     Passed to the callback.
+ * @return  {int}                                                             How many timers went off.
+*/
+int UtilsWheel_advance(struct UtilsWheel *this, long dNow, void (*fFire)(void *pData, int dTarget, int dKind), void *pData) {
+  int dFired = 0;
+
+  while(this->dNow < dNow) {
+
+    // Nothing to wait for, so we can just jump
+    if(!this->dCount) {
+      this->dNow = dNow;
+      break;
+    }
+
+    this->dNow++;
+
+    // When a level wraps around, bring down the next slot of the level above
+    for(int i = 1; i < UTILS_WHEEL_LEVELS; i++) {
+      int dIndex = (this->dNow >> (UTILS_WHEEL_BITS * i)) & UTILS_WHEEL_MASK;
+
+      if(this->dNow & ((1L << (UTILS_WHEEL_BITS * i)) - 1))
+        break;
+
+      UtilsWheel_cascade(this, i, dIndex);
+    }
+
+    // Everything in the current slot is due
+    int dSlot = this->dNow & UTILS_WHEEL_MASK;
+    int dTimer;
+
+    while((dTimer = this->dHeadArray[dSlot]) != -1) {
+      struct UtilsWheelTimer *pTimer = &this->pTimerArray[dTimer];
+      int dTarget = pTimer->dTarget;
+      int dKind = pTimer->dKind;
+
+      // Timers that were too far out to fit just go back on the wheel
+      if(pTimer->dDue > this->dNow) {
+        UtilsWheel_unlink(this, dTimer);
+        UtilsWheel_link(this, dTimer);
+        continue;
+      }
+
+      UtilsWheel_cancel(this, dTimer);
+      (*fFire)(pData, dTarget, dKind);
+      dFired++;
+    }
+  }
+
+  return dFired;
+}
+
+#endif
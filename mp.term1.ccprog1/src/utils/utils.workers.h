@@ -0,0 +1,284 @@
+/**
+ * A tiny work-stealing thread pool for the batch tools.
+ * The jobs are just numbers; the caller decides what job 42 means.
+ * Every worker gets its own deque of jobs and works from the back of it.
+ * When it runs out, it steals from the front of somebody else's deque, so a worker stuck on slow jobs doesn't hold everyone back.
+ *
+ * This needs pthreads, so only the tools (never the game itself) include it.
+*/
+
+#ifndef UTILS_WORKERS
+#define UTILS_WORKERS
+
+#include <pthread.h>
+
+#include "utils.mem.h"
+
+#define UTILS_WORKERS_MAX 256
+
+/**
+ * The deque of a single worker.
+ * Jobs sit in dJobArray[dHead] to dJobArray[dTail - 1].
+*/
+struct UtilsWorkersQueue {
+  pthread_mutex_t lock;
+
+  int *dJobArray;
+  int dHead;
+  int dTail;
+
+  long dDone;       // How many jobs this worker ran
+  long dStolen;     // How many of those it had to steal
+};
+
+/**
+ * An instantiable for the pool.
+ * The callback gets the context, the job number and the index of the worker running it,
+ * so the caller can keep one result buffer per worker and never lock anything.
+*/
+struct UtilsWorkers {
+  int dWorkers;
+  struct UtilsWorkersQueue queueArray[UTILS_WORKERS_MAX];
+
+  void (*fJob)(void *pContext, int dJob, int dWorker);
+  void *pContext;
+
+  pthread_mutex_t memLock;    // Guards pMem while the threads fold their counters into it
+  struct UtilsMem *pMem;      // The counters of the thread that called UtilsWorkers_run()
+};
+
+/**
+ * What each thread gets handed when it starts.
+*/
+struct UtilsWorkersThread {
+  struct UtilsWorkers *pWorkers;
+  int dWorker;
+};
+
+/**
+ * ##############################
+ * ###  WORKERS CONSTRUCTION  ###
+ * ##############################
+*/
+
+/**
+ * Returns a new instance of the UtilsWorkers class.
+ *
+ * @return  {struct UtilsWorkers *}   A pointer to the created instance.
+*/
+struct UtilsWorkers *UtilsWorkers_new() {
+  struct UtilsWorkers *pUtilsWorkers;
+
+  pUtilsWorkers = UtilsMem_calloc(UTILS_MEM_MISC, 1, sizeof(*pUtilsWorkers));
+
+  if(pUtilsWorkers == NULL)
+    return NULL;
+
+  return pUtilsWorkers;
+}
+
+/**
+ * Initializes the pool and deals out the jobs.
+ * Jobs are dealt in contiguous blocks, so neighbouring jobs (which are usually alike) start on the same worker.
+ *
+ * @param   {struct UtilsWorkers *}   this      The instance to be initialized.
+ * @param   {int}                     dWorkers  How many threads to run.
+ * @param   {int}                     dJobs     How many jobs there are; they get numbered 0 to dJobs - 1.
+ * @param   {void (*)()}              fJob      The function that runs a job.
+ * @param   {void *}                  pContext  Passed to every call of fJob.
+*/
+void UtilsWorkers_init(struct UtilsWorkers *this, int dWorkers, int dJobs, void (*fJob)(void *, int, int), void *pContext) {
+  if(dWorkers < 1) dWorkers = 1;
+  if(dWorkers > UTILS_WORKERS_MAX) dWorkers = UTILS_WORKERS_MAX;
+
+  this->dWorkers = dWorkers;
+  this->fJob = fJob;
+  this->pContext = pContext;
+
+  pthread_mutex_init(&this->memLock, NULL);
+
+  for(int i = 0; i < dWorkers; i++) {
+    struct UtilsWorkersQueue *pQueue = &this->queueArray[i];
+    int dFirst = (long) dJobs * i / dWorkers;
+    int dLast = (long) dJobs * (i + 1) / dWorkers;
+
+    pthread_mutex_init(&pQueue->lock, NULL);
+    pQueue->dJobArray = UtilsMem_calloc(UTILS_MEM_MISC, dLast - dFirst + 1, sizeof(int));
+    pQueue->dHead = 0;
+    pQueue->dTail = 0;
+    pQueue->dDone = 0;
+    pQueue->dStolen = 0;
+
+    // Pushed in reverse so the worker pops its block in order
+    for(int j = dLast - 1; j >= dFirst; j--)
+      pQueue->dJobArray[pQueue->dTail++] = j;
+  }
+}
+
+/**
+ * Creates an initialized instance of the class.
+ *
+ * @param   {int}                     dWorkers  How many threads to run.
+ * @param   {int}                     dJobs     How many jobs there are.
+ * @param   {void (*)()}              fJob      The function that runs a job.
+ * @param   {void *}                  pContext  Passed to every call of fJob.
+ * @return  {struct UtilsWorkers *}             The created instance.
+*/
+struct UtilsWorkers *UtilsWorkers_create(int dWorkers, int dJobs, void (*fJob)(void *, int, int), void *pContext) {
+  struct UtilsWorkers *pUtilsWorkers = UtilsWorkers_new();
+  UtilsWorkers_init(pUtilsWorkers, dWorkers, dJobs, fJob, pContext);
+
+  return pUtilsWorkers;
+}
+
+/**
+ * Destroys a specified instance.
+ *
+ * @param   {struct UtilsWorkers *}   this  The instance to be destroyed.
+*/
+void UtilsWorkers_kill(struct UtilsWorkers *this) {
+  for(int i = 0; i < this->dWorkers; i++) {
+    pthread_mutex_destroy(&this->queueArray[i].lock);
+    UtilsMem_free(this->queueArray[i].dJobArray);
+  }
+
+  pthread_mutex_destroy(&this->memLock);
+  UtilsMem_free(this);
+}
+
+/**
+ * ########################
+ * ###  WORKER METHODS  ###
+ * ########################
+*/
+
+/**
+ * Takes a job from the back of a worker's own deque.
+ *
+ * @param   {struct UtilsWorkersQueue *}  pQueue  The deque of the worker.
+ * @return  {int}                                 The job, or -1 if the deque is empty.
+*/
+int UtilsWorkers_pop(struct UtilsWorkersQueue *pQueue) {
+  int dJob = -1;
+
+  pthread_mutex_lock(&pQueue->lock);
+  if(pQueue->dTail > pQueue->dHead)
+    dJob = pQueue->dJobArray[--pQueue->dTail];
+  pthread_mutex_unlock(&pQueue->lock);
+
+  return dJob;
+}
+
+/**
+ * Takes a job from the front of another worker's deque.
+ * The front holds the jobs its owner would've gotten to last, so we bother it the least.
+ *
+ * @param   {struct UtilsWorkersQueue *}  pQueue  The deque to steal from.
+ * @return  {int}                                 The job, or -1 if there was nothing to steal.
+*/
+int UtilsWorkers_steal(struct UtilsWorkersQueue *pQueue) {
+  int dJob = -1;
+
+  pthread_mutex_lock(&pQueue->lock);
+  if(pQueue->dTail > pQueue->dHead)
+    dJob = pQueue->dJobArray[pQueue->dHead++];
+  pthread_mutex_unlock(&pQueue->lock);
+
+  return dJob;
+}
+
+/**
+ * The loop every thread runs.
+ * Jobs never create other jobs, so once every deque is empty we're done.
+ * Before a thread ends, it gives back the slabs of its pools (nobody else can reach them) and folds its counters into
+ * those of the thread that started it, so its report covers the whole run.
+ *
+ * @param   {void *}  pArg  The struct UtilsWorkersThread of the thread.
+ * @return  {void *}        Nothing.
+*/
+void *UtilsWorkers_loop(void *pArg) {
+  struct UtilsWorkersThread *pThread = pArg;
+  struct UtilsWorkers *this = pThread->pWorkers;
+  struct UtilsWorkersQueue *pOwn = &this->queueArray[pThread->dWorker];
+  int dJob;
+
+  while(1) {
+
+    // Our own stuff first
+    if((dJob = UtilsWorkers_pop(pOwn)) < 0) {
+
+      // Then everyone else's, starting from our neighbour
+      for(int i = 1; i < this->dWorkers && dJob < 0; i++)
+        dJob = UtilsWorkers_steal(&this->queueArray[(pThread->dWorker + i) % this->dWorkers]);
+
+      if(dJob < 0)
+        break;
+
+      pOwn->dStolen++;
+    }
+
+    this->fJob(this->pContext, dJob, pThread->dWorker);
+    pOwn->dDone++;
+  }
+
+  UtilsMem_trimPools();
+
+  pthread_mutex_lock(&this->memLock);
+  UtilsMem_merge(this->pMem);
+  pthread_mutex_unlock(&this->memLock);
+
+  return NULL;
+}
+
+/**
+ * Runs every job and waits for all of them to finish.
+ * With a single worker, everything runs on the calling thread.
+ *
+ * @param   {struct UtilsWorkers *}   this  The pool.
+*/
+void UtilsWorkers_run(struct UtilsWorkers *this) {
+  pthread_t threadArray[UTILS_WORKERS_MAX];
+  struct UtilsWorkersThread argArray[UTILS_WORKERS_MAX];
+
+  this->pMem = UtilsMem_get();
+
+  for(int i = 0; i < this->dWorkers; i++) {
+    argArray[i].pWorkers = this;
+    argArray[i].dWorker = i;
+  }
+
+  if(this->dWorkers == 1) {
+    UtilsWorkers_loop(&argArray[0]);
+    return;
+  }
+
+  for(int i = 0; i < this->dWorkers; i++)
+    pthread_create(&threadArray[i], NULL, UtilsWorkers_loop, &argArray[i]);
+
+  for(int i = 0; i < this->dWorkers; i++)
+    pthread_join(threadArray[i], NULL);
+}
+
+/**
+ * Returns how many jobs a worker ended up running.
+ *
+ * @param   {struct UtilsWorkers *}   this      The pool.
+ * @param   {int}                     dWorker   The index of the worker.
+ * @return  {long}                              The number of jobs it ran.
+*/
+long UtilsWorkers_getDone(struct UtilsWorkers *this, int dWorker) {
+  return this->queueArray[dWorker].dDone;
+}
+
+/**
+ * Returns how many jobs a worker had to steal.
+ *
+ * @param   {struct UtilsWorkers *}   this      The pool.
+ * @param   {int}                     dWorker   The index of the worker.
+ * @return  {long}                              The number of jobs it stole.
+*/
+long UtilsWorkers_getStolen(struct UtilsWorkers *this, int dWorker) {
+  return this->queueArray[dWorker].dStolen;
+}
+
+#endif
@@ -9,12 +9,37 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 // The reason I do this is so as to be able to build differently for Windows and Unix devices
 // Plus, specifying different terminal arguments becomes easier to handle and less of a clutter
 // Also, there are just so many other possible things I have to handle with regard to differences in execution environment
 int main(int argc, char *argv[]) {
 
+  // "./main bench" builds and runs the benchmark of the engine instead of the game
+  // Its results go to stdout, so they can be redirected into a file and diffed against another run
+  if(argc > 1 && !strcmp(argv[1], "bench")) {
+    char sCommand[2048];
+    size_t dLength;
+
+    #ifdef _WIN32
+      fprintf(stderr, "(1) Compiling the benchmark...\n");
+      system("gcc -std=c99 -Wall -O2 src\\bench.c -o build\\bench.win.exe -pthread -lm 2> build\\log.win.txt");
+      dLength = sprintf(sCommand, "build\\bench.win.exe");
+    #else
+      fprintf(stderr, "(1) Compiling the benchmark...\n");
+      system("gcc -std=c99 -Wall -O2 ./src/bench.c -o ./build/bench.unix.o -pthread -lm 2> ./build/log.unix.txt");
+      dLength = sprintf(sCommand, "./build/bench.unix.o");
+    #endif
+
+    // The rest of the args go to the benchmark (eg. "./main bench -d 6 -r rules/crosses.txt")
+    for(int i = 2; i < argc && dLength + strlen(argv[i]) + 4 < sizeof(sCommand); i++)
+      dLength += sprintf(sCommand + dLength, " \"%s\"", argv[i]);
+
+    fprintf(stderr, "(2) Running the benchmark...\n");
+    return system(sCommand) != 0;
+  }
+
   // Windows environments
   #ifdef _WIN32
     system("clear");
@@ -26,7 +51,7 @@ int main(int argc, char *argv[]) {
     //    not support window resizing and so I was forced to find a workaround to this. Hence, we have here a manual
     //    execution of conhost.exe (which, mind you, is actually what cmd.exe uses as a terminal anyway).
     printf("(1) Compiling the program...\n");
-    system("gcc -std=c99 -Wall src\\game.c -o build\\game.win.exe 2> build\\log.win.txt");
+    system("gcc -std=c99 -Wall src\\game.c -o build\\game.win.exe -pthread -lm 2> build\\log.win.txt");
     printf(" -  Compile success!\n(2) Running the program...\n");
     system("%windir%\\SysNative\\conhost.exe build\\game.win.exe");
     printf(" -  Program terminated."); 
@@ -34,7 +59,7 @@ int main(int argc, char *argv[]) {
   // Unix environments
   #else
     printf("(1) Compiling the program...\n");
-    system("gcc -std=c99 -Wall ./src/game.c -o ./build/game.unix.o 2> ./build/log.unix.txt");
+    system("gcc -std=c99 -Wall ./src/game.c -o ./build/game.unix.o -pthread -lm 2> ./build/log.unix.txt");
     printf(" -  Compile success!\n(2) Running the program...\n");
     system("./build/game.unix.o");
     printf(" -  Program terminated."); 
@@ -0,0 +1,86 @@
+/**
+ * @ Description:
+ *    The benchmark of the game engine: the world bit operations, random playouts, perft, the bot and the buffers.
+ *    The results are printed to stdout as tab-separated lines (see bench/bench.runner.h), so two runs can be diffed.
+ *    The program exits with 1 if any of the checks failed (a wrong perft count, a playout that ended badly, etc.).
+ * 
+ *    Build (main.c does this for you with "./main bench"):
+ *      gcc -std=c99 -Wall -O2 ./src/bench.c -o ./build/bench.unix.o -pthread -lm
+ *    Add -DGAME_PLAYERS=8 to bench rule files with more than 2 players (every position gets 4 times bigger).
+ * 
+ *    Usage:
+ *      ./build/bench.unix.o [-d perft depth] [-g playouts] [-s seed] [-t ms per round] [-r rule file] [-p ponder games]
+ */
+
+// We need clock_gettime() from POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include "game.system.h"
+#include "./bench/bench.cases.h"
+#include "./bench/bench.runner.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DEFAULT_DEPTH 5
+#define BENCH_DEFAULT_GAMES 200000
+#define BENCH_DEFAULT_SEED 2024
+#define BENCH_DEFAULT_TARGET 20
+#define BENCH_DEFAULT_PONDER 60
+
+int main(int argc, char *argv[]) {
+  BenchRunner runner;
+  BenchCases cases;
+  System system;
+
+  int dDepth = BENCH_DEFAULT_DEPTH;
+  long dGames = BENCH_DEFAULT_GAMES;
+  long dSeed = BENCH_DEFAULT_SEED;
+  int dTarget = BENCH_DEFAULT_TARGET;
+  int dPonder = BENCH_DEFAULT_PONDER;
+  char *sRules = NULL;
+  Rules rules;
+
+  // Read the args
+  for(int i = 1; i + 1 < argc; i += 2) {
+    if(!strcmp(argv[i], "-d")) dDepth = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-g")) dGames = atol(argv[i + 1]);
+    else if(!strcmp(argv[i], "-s")) dSeed = atol(argv[i + 1]);
+    else if(!strcmp(argv[i], "-t")) dTarget = atoi(argv[i + 1]);
+    else if(!strcmp(argv[i], "-r")) sRules = argv[i + 1];
+    else if(!strcmp(argv[i], "-p")) dPonder = atoi(argv[i + 1]);
+    else {
+      fprintf(stderr, "Unknown option %s.\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if(dDepth < 0) dDepth = 0;
+  if(dGames < 1) dGames = 1;
+  if(dTarget < 1) dTarget = 1;
+
+  // The rules of the machine project, unless we were given a variant
+  Rules_init(&rules);
+
+  if(sRules != NULL ? !Rules_load(&rules, sRules) : !Rules_parse(&rules, RULES_DEFAULT)) {
+    char *sName = sRules != NULL ? sRules : "the built-in rules";
+
+    if(rules.dErrorLine) fprintf(stderr, "Couldn't load %s: %s (line %d).\n", sName, rules.sError, rules.dErrorLine);
+    else fprintf(stderr, "Couldn't load %s: %s.\n", sName, rules.sError);
+    return 1;
+  }
+
+  System_initRules(&system, &rules);
+  BenchRunner_init(&runner, stdout, dTarget / 1000.0);
+  BenchCases_init(&cases, &runner, &system, (uint32_t) dSeed);
+
+  BenchCases_runWorld(&cases);
+  BenchCases_runPlayouts(&cases, dGames);
+  BenchCases_runPerft(&cases, dDepth);
+  BenchCases_runBot(&cases);
+  BenchCases_runPonder(&cases, dPonder);
+  BenchCases_runBuffer(&cases);
+
+  return runner.bFailed;
+}
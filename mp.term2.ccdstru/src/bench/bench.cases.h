@@ -0,0 +1,777 @@
+/**
+ * @ Description:
+ *    The cases of the benchmark: the world bit operations, the win check, random playouts, perft, the bot and the buffers.
+ *    Perft counts every line of play from the start down to a given depth; since no player can own a full winning
+ *    configuration before their fifth point (the ninth move), the counts up to depth 8 are just 36 * 35 * 34 * ...
+ *    Those counts only hold for the rules of the machine project; with any other rules, perft is just timed.
+ */
+
+#ifndef BENCH_CASES_
+#define BENCH_CASES_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../game.system.h"
+#include "../game.bot.h"
+#include "../utils/utils.buffer.h"
+#include "../utils/utils.graphics.h"
+
+#include "bench.runner.h"
+
+#define BENCH_WORLDS 64         // Random worlds to check against the winning configurations; must be a power of two
+#define BENCH_PERFT_KNOWN 9     // Depths we know the perft counts of
+#define BENCH_LINE_LENGTHS 4    // Line lengths to try the buffers with
+#define BENCH_ESCAPE_EVERY 32   // The lines get a color escape every this many characters
+#define BENCH_BOT_PLAYOUTS 20000 // Playouts the bot gets to find the point that wins (or has to be blocked)
+#define BENCH_WORKER_MS 20      // How long the worker gets to search before it's stopped
+#define BENCH_PONDER_THINK 1000 // Playouts the bot gets for each of its moves in the ponder match
+#define BENCH_PONDER_FIXED 1500 // Playouts its opponent gets for each move (and the bot gets to ponder with)
+
+// Keeps the compiler from throwing away the results of the ops we time
+volatile long BENCH_SINK;
+
+/**
+ * The perft counts from the start position, by depth.
+*/
+const long long BENCH_PERFT[BENCH_PERFT_KNOWN] = {
+  1LL, 36LL, 1260LL, 42840LL, 1413720LL, 45239040LL, 1402410240LL, 42072307200LL, 1220096908800LL
+};
+
+/**
+ * A game where X has 4 of the 5 points of the first winning configuration; the point left is (2, 2).
+ * O is to move after the first 7 moves (and has to block it), and X is to move after all 8 (and has to take it).
+*/
+const int BENCH_BOT_MOVES[8][2] = {
+  { 0, 0 }, { 3, 1 }, { 2, 0 }, { 4, 1 }, { 1, 1 }, { 5, 1 }, { 0, 2 }, { 1, 0 }
+};
+
+/**
+ * The rendered lengths of the lines the buffers are tried with.
+*/
+const int BENCH_LINES[BENCH_LINE_LENGTHS] = { 8, 32, 128, 512 };
+
+/**
+ * Everything the cases need.
+ * @class
+*/
+typedef struct BenchCases BenchCases;
+
+struct BenchCases {
+  BenchRunner *pRunner;
+  System *pSystem;
+
+  uint32_t dSeed;                 // The state of the random number generator
+  World worldArray[BENCH_WORLDS]; // Random worlds for World_contains()
+  World world;                    // A scratch world for World_setBit() to copy the random worlds into
+  World configArray[RULES_MAX_CONFIGS];   // The winning configurations as worlds, for World_contains()
+  Position positionArray[BENCH_WORLDS];   // Random positions (one random world per player), for System_getWinners()
+  int bKnownRules;                // Whether or not we're playing the rules we know the perft counts of
+
+  Bot *pBot;
+
+  Buffer *pBuffer;
+  char *sLine;                    // The line the buffer cases are currently using
+  int dLineBytes;
+};
+
+/**
+ * Constructors and destructors
+*/
+BenchCases *BenchCases_init(BenchCases *this, BenchRunner *pRunner, System *pSystem, uint32_t dSeed);
+
+/**
+ * Operations
+*/
+uint32_t BenchCases_random(BenchCases *this);
+
+long long BenchCases_perft(BenchCases *this, int dDepth);
+
+int BenchCases_playout(BenchCases *this);
+
+void BenchCases_runWorld(BenchCases *this);
+
+void BenchCases_runPlayouts(BenchCases *this, long dGames);
+
+void BenchCases_runPerft(BenchCases *this, int dDepth);
+
+void BenchCases_runBot(BenchCases *this);
+
+void BenchCases_runPonder(BenchCases *this, int dGames);
+
+void BenchCases_runBuffer(BenchCases *this);
+
+/**
+ * //
+ * ////
+ * //////    BenchCases constructors and destructors
+ * ////////
+ * //////////
+*/
+
+/**
+ * Initializes the cases.
+ *
+ * @param   { BenchCases * }  this      The cases to initialize.
+ * @param   { BenchRunner * } pRunner   The runner that times and reports them.
+ * @param   { System * }      pSystem   The system to play on.
+ * @param   { uint32_t }      dSeed     The seed of the random playouts and worlds (must not be 0).
+ * @return  { BenchCases * }            The initialized cases.
+*/
+BenchCases *BenchCases_init(BenchCases *this, BenchRunner *pRunner, System *pSystem, uint32_t dSeed) {
+  this->pRunner = pRunner;
+  this->pSystem = pSystem;
+  this->dSeed = dSeed ? dSeed : 1;
+
+  // Random worlds with about half of their points taken, the way they look mid-game
+  for(int i = 0; i < BENCH_WORLDS; i++) {
+    World_init(&this->worldArray[i]);
+
+    for(int y = 0; y < pSystem->WORLD_SIZE; y++)
+      this->worldArray[i].bits[y] = BenchCases_random(this) & ((1 << pSystem->WORLD_SIZE) - 1);
+  }
+
+  World_init(&this->world);
+
+  // Every player of a position gets a different one of the random worlds
+  for(int i = 0; i < BENCH_WORLDS; i++) {
+    this->positionArray[i] = (Position) { { 0 } };
+
+    for(int j = 0; j < pSystem->TURN_COUNT; j++)
+      this->positionArray[i].worlds[j] = World_getMask(&this->worldArray[(i + j) & (BENCH_WORLDS - 1)]);
+  }
+
+  // The configurations were compiled into masks, so we turn them back into worlds (one byte per row)
+  for(int i = 0; i < pSystem->RULES.CONFIG_COUNT; i++) {
+    World_init(&this->configArray[i]);
+
+    for(int y = 0; y < WORLD_MAX_SIZE; y++)
+      this->configArray[i].bits[y] = pSystem->RULES.CONFIG_MASKS[i] >> (y * WORLD_MAX_SIZE);
+  }
+
+  // The perft counts are only known for the rules of the machine project
+  {
+    Rules rules;
+
+    Rules_init(&rules);
+    Rules_parse(&rules, RULES_DEFAULT);
+    this->bKnownRules = Rules_equals(&rules, &pSystem->RULES);
+  }
+
+  // The bot gets its own copy of the system, so it can be made before anything is played
+  this->pBot = Bot_create(pSystem);
+
+  // The buffer can hold the longest line we try
+  this->pBuffer = Buffer_create(BUFFER_MAX_LENGTH);
+  this->sLine = Mem_calloc(MEM_BUFFER, BUFFER_MAX_LENGTH, sizeof(char));
+  this->dLineBytes = 0;
+
+  return this;
+}
+
+/**
+ * //
+ * ////
+ * //////    BenchCases operations
+ * ////////
+ * //////////
+*/
+
+/**
+ * Returns the next number of a xorshift generator.
+ * We don't use rand() since its quality (and speed) differs between the C libraries.
+ *
+ * @param   { BenchCases * }  this  The cases.
+ * @return  { uint32_t }            A random number.
+*/
+uint32_t BenchCases_random(BenchCases *this) {
+  this->dSeed ^= this->dSeed << 13;
+  this->dSeed ^= this->dSeed >> 17;
+  this->dSeed ^= this->dSeed << 5;
+
+  return this->dSeed;
+}
+
+/**
+ * Counts the lines of play from the current state of the system down to a given depth.
+ * Lines that end early (someone won) aren't counted, since they never reach the depth.
+ *
+ * @param   { BenchCases * }  this    The cases.
+ * @param   { int }           dDepth  How many more moves to look at.
+ * @return  { long long }             The number of lines.
+*/
+long long BenchCases_perft(BenchCases *this, int dDepth) {
+  System *pSystem = this->pSystem;
+  long long dNodes = 0;
+
+  if(!dDepth)
+    return 1;
+
+  for(int y = 0; y < pSystem->WORLD_SIZE; y++) {
+    for(int x = 0; x < pSystem->WORLD_SIZE; x++) {
+
+      // Every free point is a move as long as the game isn't over, so there's no need to make the last one
+      if(dDepth == 1) {
+        dNodes += !System_isOver(pSystem) && System_isFree(pSystem, x, y);
+        continue;
+      }
+
+      if(System_update(pSystem, x, y)) {
+        dNodes += BenchCases_perft(this, dDepth - 1);
+        System_undo(pSystem);
+      }
+    }
+  }
+
+  return dNodes;
+}
+
+/**
+ * Plays a whole game with random moves from the start.
+ *
+ * @param   { BenchCases * }  this  The cases.
+ * @return  { int }                 The number of moves, or -1 if the game ended in a state that makes no sense.
+*/
+int BenchCases_playout(BenchCases *this) {
+  System *pSystem = this->pSystem;
+  int dFreeArray[GAME_MAX_MOVES];
+  int dFree = pSystem->WORLD_SIZE * pSystem->WORLD_SIZE;
+  int dMoves = 0;
+
+  for(int i = 0; i < dFree; i++)
+    dFreeArray[i] = i;
+
+  System_reset(pSystem);
+
+  // Take a random free point and swap the last one into its place
+  while(!System_isOver(pSystem) && dFree) {
+    int dPick = BenchCases_random(this) % dFree;
+    int dPoint = dFreeArray[dPick];
+
+    dFreeArray[dPick] = dFreeArray[--dFree];
+
+    if(!System_update(pSystem, dPoint % pSystem->WORLD_SIZE, dPoint / pSystem->WORLD_SIZE))
+      return -1;
+
+    dMoves++;
+  }
+
+  // Whoever has the turn at the end must have won, unless the world got full, and nobody else can have won
+  if(!System_isOver(pSystem) || (!System_hasWon(pSystem, System_getTurn(pSystem)) && dFree))
+    return -1;
+
+  if(System_getWinners(pSystem) & ~(1 << System_getTurn(pSystem)))
+    return -1;
+
+  return dMoves;
+}
+
+/**
+ * Copies one of the random worlds into the scratch world point by point.
+ *
+ * @param   { void * }  pData   The cases.
+ * @param   { long }    dOps    How many worlds to copy.
+ * @return  { double }          How long it took in seconds.
+*/
+double BenchCases_setBit(void *pData, long dOps) {
+  BenchCases *this = pData;
+  double fStart = BenchRunner_getTime();
+
+  int dSize = this->pSystem->WORLD_SIZE;
+
+  for(long i = 0; i < dOps; i++) {
+    World *pWorld = &this->worldArray[i & (BENCH_WORLDS - 1)];
+
+    for(int y = 0; y < dSize; y++)
+      for(int x = 0; x < dSize; x++)
+        World_setBit(&this->world, x, y, pWorld->bits[y] >> x & 1);
+
+    BENCH_SINK += this->world.bits[i % dSize];
+  }
+
+  return BenchRunner_getTime() - fStart;
+}
+
+/**
+ * Reads every point of one of the random worlds.
+ *
+ * @param   { void * }  pData   The cases.
+ * @param   { long }    dOps    How many worlds to read.
+ * @return  { double }          How long it took in seconds.
+*/
+double BenchCases_getBit(void *pData, long dOps) {
+  BenchCases *this = pData;
+  double fStart = BenchRunner_getTime();
+  int dSize = this->pSystem->WORLD_SIZE;
+  long dSum = 0;
+
+  for(long i = 0; i < dOps; i++) {
+    World *pWorld = &this->worldArray[i & (BENCH_WORLDS - 1)];
+
+    for(int y = 0; y < dSize; y++)
+      for(int x = 0; x < dSize; x++)
+        dSum += World_getBit(pWorld, x, y);
+  }
+
+  BENCH_SINK += dSum;
+
+  return BenchRunner_getTime() - fStart;
+}
+
+/**
+ * Checks one of the random worlds against every winning configuration, the way System_hasWon() does.
+ *
+ * @param   { void * }  pData   The cases.
+ * @param   { long }    dOps    How many worlds to check.
+ * @return  { double }          How long it took in seconds.
+*/
+double BenchCases_contains(void *pData, long dOps) {
+  BenchCases *this = pData;
+  double fStart = BenchRunner_getTime();
+  long dSum = 0;
+
+  for(long i = 0; i < dOps; i++) {
+    World *pWorld = &this->worldArray[i & (BENCH_WORLDS - 1)];
+
+    for(int j = 0; j < this->pSystem->RULES.CONFIG_COUNT; j++)
+      dSum += World_contains(pWorld, &this->configArray[j]);
+  }
+
+  BENCH_SINK += dSum;
+
+  return BenchRunner_getTime() - fStart;
+}
+
+/**
+ * Checks every player of one of the random positions against every winning configuration at once.
+ *
+ * @param   { void * }  pData   The cases.
+ * @param   { long }    dOps    How many positions to check.
+ * @return  { double }          How long it took in seconds.
+*/
+double BenchCases_getWinners(void *pData, long dOps) {
+  BenchCases *this = pData;
+  Rules *pRules = &this->pSystem->RULES;
+  double fStart = BenchRunner_getTime();
+  long dSum = 0;
+
+  for(long i = 0; i < dOps; i++)
+    dSum += Position_getWinners(&this->positionArray[i & (BENCH_WORLDS - 1)], pRules->CONFIG_MASKS, pRules->CONFIG_COUNT);
+
+  BENCH_SINK += dSum;
+
+  return BenchRunner_getTime() - fStart;
+}
+
+/**
+ * Puts the current line into an empty buffer.
+ *
+ * @param   { void * }  pData   The cases.
+ * @param   { long }    dOps    How many times to do it.
+ * @return  { double }          How long it took in seconds.
+*/
+double BenchCases_addText(void *pData, long dOps) {
+  BenchCases *this = pData;
+  double fStart = BenchRunner_getTime();
+
+  // Buffer_resetText() and not Buffer_clearText(), since that would time the allocator too
+  for(long i = 0; i < dOps; i++) {
+    Buffer_resetText(this->pBuffer);
+    Buffer_addText(this->pBuffer, this->sLine);
+  }
+
+  BENCH_SINK += this->pBuffer->dWidth;
+
+  return BenchRunner_getTime() - fStart;
+}
+
+/**
+ * Recomputes the render width of the current line.
+ *
+ * @param   { void * }  pData   The cases.
+ * @param   { long }    dOps    How many times to do it.
+ * @return  { double }          How long it took in seconds.
+*/
+double BenchCases_updateRenderWidth(void *pData, long dOps) {
+  BenchCases *this = pData;
+  double fStart = BenchRunner_getTime();
+  long dSum = 0;
+
+  for(long i = 0; i < dOps; i++)
+    dSum += Buffer_updateRenderWidth(this->pBuffer);
+
+  BENCH_SINK += dSum;
+
+  return BenchRunner_getTime() - fStart;
+}
+
+/**
+ * Times the world bit operations.
+ *
+ * @param   { BenchCases * }  this  The cases.
+*/
+void BenchCases_runWorld(BenchCases *this) {
+  int dPoints = this->pSystem->WORLD_SIZE * this->pSystem->WORLD_SIZE;
+  char sParam[32];
+
+  BenchRunner_report(this->pRunner, "World_setBit", "-",
+    BenchRunner_measure(this->pRunner, BenchCases_setBit, this) / dPoints, "ns/op", "");
+  BenchRunner_report(this->pRunner, "World_getBit", "-",
+    BenchRunner_measure(this->pRunner, BenchCases_getBit, this) / dPoints, "ns/op", "");
+  BenchRunner_report(this->pRunner, "World_contains", "WIN_CONFIGS",
+    BenchRunner_measure(this->pRunner, BenchCases_contains, this), "ns/op", "");
+
+  snprintf(sParam, sizeof(sParam), "%d players", this->pSystem->TURN_COUNT);
+  BenchRunner_report(this->pRunner, "Position_getWinners", sParam,
+    BenchRunner_measure(this->pRunner, BenchCases_getWinners, this), "ns/op", "");
+}
+
+/**
+ * Plays random games and checks that each one ended properly.
+ *
+ * @param   { BenchCases * }  this    The cases.
+ * @param   { long }          dGames  How many games to play.
+*/
+void BenchCases_runPlayouts(BenchCases *this, long dGames) {
+  long dMoves = 0, dBroken = 0;
+  long dWinArray[GAME_PLAYERS] = { 0 };
+  char sParam[32];
+  double fStart, fTime;
+
+  fStart = BenchRunner_getTime();
+
+  for(long i = 0; i < dGames; i++) {
+    int dLength = BenchCases_playout(this);
+
+    if(dLength < 0) {
+      dBroken++;
+      continue;
+    }
+
+    dMoves += dLength;
+
+    if(System_hasWon(this->pSystem, System_getTurn(this->pSystem)))
+      dWinArray[System_getTurn(this->pSystem)]++;
+  }
+
+  fTime = BenchRunner_getTime() - fStart;
+
+  BenchRunner_report(this->pRunner, "playout", "-", dGames / fTime, "games/s", dBroken ? "FAIL" : "ok");
+  BenchRunner_report(this->pRunner, "playout_length", "-", dGames ? (double) dMoves / dGames : 0, "moves", "");
+
+  for(int i = 0; i < this->pSystem->TURN_COUNT; i++) {
+    snprintf(sParam, sizeof(sParam), "player%d", i);
+    BenchRunner_report(this->pRunner, "playout_wins", sParam, dGames ? dWinArray[i] * 100.0 / dGames : 0, "%", "");
+  }
+}
+
+/**
+ * Counts the lines of play to every depth up to the given one and checks them against the known counts.
+ *
+ * @param   { BenchCases * }  this    The cases.
+ * @param   { int }           dDepth  The deepest depth to count to.
+*/
+void BenchCases_runPerft(BenchCases *this, int dDepth) {
+  char sParam[32];
+
+  System_reset(this->pSystem);
+
+  for(int i = 1; i <= dDepth; i++) {
+    double fStart = BenchRunner_getTime();
+    long long dNodes = BenchCases_perft(this, i);
+    double fTime = BenchRunner_getTime() - fStart;
+
+    snprintf(sParam, sizeof(sParam), "%d", i);
+    BenchRunner_report(this->pRunner, "perft", sParam, dNodes, "nodes",
+      this->bKnownRules && i < BENCH_PERFT_KNOWN ? (dNodes == BENCH_PERFT[i] ? "ok" : "FAIL") : "");
+    BenchRunner_report(this->pRunner, "perft_time", sParam, fTime * 1e3, "ms", "");
+  }
+}
+
+/**
+ * Runs playouts of the bot from the start of the game.
+ *
+ * @param   { void * }  pData   The cases.
+ * @param   { long }    dOps    How many playouts to run.
+ * @return  { double }          How long it took in seconds.
+*/
+double BenchCases_iterate(void *pData, long dOps) {
+  BenchCases *this = pData;
+  double fStart = BenchRunner_getTime();
+
+  BENCH_SINK += Bot_search(this->pBot, dOps);
+
+  return BenchRunner_getTime() - fStart;
+}
+
+/**
+ * Plays some of the moves of BENCH_BOT_MOVES, and then checks that the bot takes (2, 2).
+ *
+ * @param   { BenchCases * }  this    The cases.
+ * @param   { int }           dMoves  How many of the moves to play.
+ * @return  { int }                   Whether or not the bot took the point.
+*/
+int BenchCases_findsPoint(BenchCases *this, int dMoves) {
+  int x = -1, y = -1;
+
+  System_reset(this->pSystem);
+
+  for(int i = 0; i < dMoves; i++)
+    System_update(this->pSystem, BENCH_BOT_MOVES[i][0], BENCH_BOT_MOVES[i][1]);
+
+  Bot_reset(this->pBot, this->pSystem);
+  Bot_search(this->pBot, BENCH_BOT_PLAYOUTS);
+  Bot_getMove(this->pBot, &x, &y);
+
+  return x == 2 && y == 2;
+}
+
+/**
+ * Counts the nodes of a subtree of the bot, checking that no node has fewer visits than its children put together.
+ *
+ * @param   { Bot * }   pBot    The bot.
+ * @param   { int }     dNode   The top of the subtree.
+ * @return  { int }             The number of nodes, or -1 if a node had fewer visits than its children.
+*/
+int BenchCases_countNodes(Bot *pBot, int dNode) {
+  int dCount = 1;
+  int dVisits = 0;
+
+  for(int i = pBot->pNodeArray[dNode].dChild; i >= 0; i = pBot->pNodeArray[i].dSibling) {
+    int dChildren = BenchCases_countNodes(pBot, i);
+
+    if(dChildren < 0)
+      return -1;
+
+    dCount += dChildren;
+    dVisits += pBot->pNodeArray[i].dVisits;
+  }
+
+  return dVisits <= pBot->pNodeArray[dNode].dVisits ? dCount : -1;
+}
+
+/**
+ * Searches from the start, plays the move the bot picked, and checks that Bot_sync() kept the subtree under it whole.
+ * With enough playouts, the tree ends up over half full and the subtree has to be copied (see Bot_collect()).
+ *
+ * @param   { BenchCases * }  this        The cases.
+ * @param   { long }          dPlayouts   How many playouts to search with.
+ * @param   { int }           bCollect    Whether or not the subtree has to have been copied.
+ * @return  { int }                       Whether or not the subtree was kept.
+*/
+int BenchCases_keepsSubtree(BenchCases *this, long dPlayouts, int bCollect) {
+  Bot *pBot = this->pBot;
+  int dChild, dNodes, dVisits;
+  int x, y;
+
+  System_reset(this->pSystem);
+  Bot_reset(pBot, this->pSystem);
+  Bot_search(pBot, dPlayouts);
+  Bot_getMove(pBot, &x, &y);
+
+  // A tree that couldn't grow past half (a small variant) never gets copied
+  if(bCollect && pBot->dNodes <= BOT_MAX_NODES / 2)
+    return 1;
+
+  dChild = pBot->pNodeArray[pBot->dRoot].dChild;
+
+  while(dChild >= 0 && pBot->pNodeArray[dChild].dPoint != y * WORLD_MAX_SIZE + x)
+    dChild = pBot->pNodeArray[dChild].dSibling;
+
+  if(dChild < 0)
+    return 0;
+
+  dNodes = BenchCases_countNodes(pBot, dChild);
+  dVisits = pBot->pNodeArray[dChild].dVisits;
+
+  System_update(this->pSystem, x, y);
+  Bot_sync(pBot, this->pSystem);
+
+  // Once it's copied, the subtree is all there is
+  if(bCollect && (pBot->dRoot != 0 || pBot->dNodes != dNodes))
+    return 0;
+
+  return dNodes > 0 &&
+    pBot->pNodeArray[pBot->dRoot].dVisits == dVisits &&
+    BenchCases_countNodes(pBot, pBot->dRoot) == dNodes;
+}
+
+/**
+ * Lets the worker search for a while, then checks that Bot_stop() got the tree back in one piece.
+ *
+ * @param   { BenchCases * }  this  The cases.
+ * @return  { int }                 Whether or not the worker searched and stopped.
+*/
+int BenchCases_stopsWorker(BenchCases *this) {
+  Bot *pBot = this->pBot;
+
+  System_reset(this->pSystem);
+  Bot_reset(pBot, this->pSystem);
+  Bot_think(pBot, BENCH_WORKER_MS);
+
+  return !pBot->bRunning &&
+    pBot->pNodeArray[pBot->dRoot].dVisits > 0 &&
+    BenchCases_countNodes(pBot, pBot->dRoot) == pBot->dNodes;
+}
+
+/**
+ * Plays games between the bot (with BENCH_PONDER_THINK playouts a move) and a fixed search (with BENCH_PONDER_FIXED).
+ * When the bot ponders, it searches as long as its opponent does on the opponent's turns, the way the game lets it
+ * while the human thinks; it's done in line here (instead of on the worker) so the games come out the same every run.
+ *
+ * @param   { BenchCases * }  this      The cases.
+ * @param   { Bot * }         pFixed    The opponent.
+ * @param   { int }           dGames    How many games to play; the bot moves first in every other one.
+ * @param   { int }           bPonder   Whether or not the bot ponders.
+ * @param   { long * }        pKept     Gets the average number of playouts the bot already had when its turns came.
+ * @return  { int }                     How many games the bot lost.
+*/
+int BenchCases_ponderMatch(BenchCases *this, Bot *pFixed, int dGames, int bPonder, long *pKept) {
+  System *pSystem = this->pSystem;
+  Bot *pBot = this->pBot;
+  long dKept = 0, dTurns = 0;
+  int dLosses = 0;
+  int x, y;
+
+  for(int i = 0; i < dGames; i++) {
+    int dPlayer = i & 1;
+
+    System_reset(pSystem);
+    Bot_reset(pBot, pSystem);
+    Bot_reset(pFixed, pSystem);
+    pBot->dSeed = i * 13 + 5;
+    pFixed->dSeed = i * 7 + 1;
+
+    while(!System_isOver(pSystem)) {
+      if(System_getTurn(pSystem) == dPlayer) {
+        Bot_sync(pBot, pSystem);
+        dKept += pBot->pNodeArray[pBot->dRoot].dVisits;
+        dTurns++;
+
+        Bot_search(pBot, BENCH_PONDER_THINK);
+        Bot_getMove(pBot, &x, &y);
+
+      } else {
+        if(bPonder) {
+          Bot_sync(pBot, pSystem);
+          Bot_search(pBot, BENCH_PONDER_FIXED);
+        }
+
+        Bot_sync(pFixed, pSystem);
+        Bot_search(pFixed, BENCH_PONDER_FIXED);
+        Bot_getMove(pFixed, &x, &y);
+      }
+
+      System_update(pSystem, x, y);
+    }
+
+    if(System_hasWon(pSystem, System_getTurn(pSystem)) && System_getTurn(pSystem) != dPlayer)
+      dLosses++;
+  }
+
+  *pKept = dTurns ? dKept / dTurns : 0;
+
+  return dLosses;
+}
+
+/**
+ * Times the playouts of the bot, and checks that it wins (and blocks wins) when it can.
+ * The checks only mean something with the rules of the machine project.
+ *
+ * @param   { BenchCases * }  this  The cases.
+*/
+void BenchCases_runBot(BenchCases *this) {
+  System_reset(this->pSystem);
+  Bot_reset(this->pBot, this->pSystem);
+
+  BenchRunner_report(this->pRunner, "Bot_iterate", "-",
+    BenchRunner_measure(this->pRunner, BenchCases_iterate, this), "ns/op", "");
+
+  BenchRunner_report(this->pRunner, "bot_reuse", "-", BENCH_BOT_PLAYOUTS, "playouts",
+    BenchCases_keepsSubtree(this, BENCH_BOT_PLAYOUTS, 0) ? "ok" : "FAIL");
+  BenchRunner_report(this->pRunner, "bot_collect", "-", BOT_MAX_NODES / 2 + BENCH_BOT_PLAYOUTS, "playouts",
+    BenchCases_keepsSubtree(this, BOT_MAX_NODES / 2 + BENCH_BOT_PLAYOUTS, 1) ? "ok" : "FAIL");
+  BenchRunner_report(this->pRunner, "bot_worker", "-", BENCH_WORKER_MS, "ms",
+    BenchCases_stopsWorker(this) ? "ok" : "FAIL");
+
+  if(!this->bKnownRules)
+    return;
+
+  BenchRunner_report(this->pRunner, "bot_block", "-", BENCH_BOT_PLAYOUTS, "playouts", 
+    BenchCases_findsPoint(this, 7) ? "ok" : "FAIL");
+  BenchRunner_report(this->pRunner, "bot_win", "-", BENCH_BOT_PLAYOUTS, "playouts", 
+    BenchCases_findsPoint(this, 8) ? "ok" : "FAIL");
+}
+
+/**
+ * Plays the bot against a fixed search with and without pondering, with the same playouts for each of its moves.
+ * Every game is played the same way every run, so the losses can be compared between builds (and with other rules).
+ *
+ * @param   { BenchCases * }  this    The cases.
+ * @param   { int }           dGames  How many games to play each way.
+*/
+void BenchCases_runPonder(BenchCases *this, int dGames) {
+  Bot *pFixed = Bot_create(this->pSystem);
+  long dKept;
+  int dLosses;
+
+  if(dGames <= 0) {
+    Bot_kill(pFixed);
+    return;
+  }
+
+  dLosses = BenchCases_ponderMatch(this, pFixed, dGames, 0, &dKept);
+  BenchRunner_report(this->pRunner, "bot_ponder_losses", "off", dLosses, "games", "");
+  BenchRunner_report(this->pRunner, "bot_ponder_kept", "off", dKept, "playouts", "");
+
+  dLosses = BenchCases_ponderMatch(this, pFixed, dGames, 1, &dKept);
+  BenchRunner_report(this->pRunner, "bot_ponder_losses", "on", dLosses, "games", "");
+  BenchRunner_report(this->pRunner, "bot_ponder_kept", "on", dKept, "playouts", "");
+
+  Bot_kill(pFixed);
+}
+
+/**
+ * Times the buffer operations with lines of different lengths.
+ * The lines look like what the UI puts in them: text with a color change every now and then.
+ *
+ * @param   { BenchCases * }  this  The cases.
+*/
+void BenchCases_runBuffer(BenchCases *this) {
+  char *sEscape = Graphics_getCodeFG(0x123456);
+  char sParam[32];
+
+  for(int i = 0; i < BENCH_LINE_LENGTHS; i++) {
+    double fTime;
+
+    // Make the line
+    this->sLine[0] = 0;
+    this->dLineBytes = 0;
+
+    for(int j = 0; j < BENCH_LINES[i]; j++) {
+      if(j % BENCH_ESCAPE_EVERY == 0)
+        this->dLineBytes += snprintf(this->sLine + this->dLineBytes, BUFFER_MAX_LENGTH - this->dLineBytes, "%s", sEscape);
+
+      this->sLine[this->dLineBytes++] = 'a' + j % 26;
+      this->sLine[this->dLineBytes] = 0;
+    }
+
+    snprintf(sParam, sizeof(sParam), "%d", BENCH_LINES[i]);
+
+    fTime = BenchRunner_measure(this->pRunner, BenchCases_addText, this);
+    BenchRunner_report(this->pRunner, "Buffer_addText", sParam, fTime, "ns/op",
+      this->pBuffer->dWidth == BENCH_LINES[i] ? "ok" : "FAIL");
+    BenchRunner_report(this->pRunner, "Buffer_addText", sParam, this->dLineBytes * 1e3 / fTime, "MB/s", "");
+
+    // The buffer still has the line from the last case
+    fTime = BenchRunner_measure(this->pRunner, BenchCases_updateRenderWidth, this);
+    BenchRunner_report(this->pRunner, "Buffer_updateRenderWidth", sParam, fTime, "ns/op",
+      this->pBuffer->dWidth == BENCH_LINES[i] ? "ok" : "FAIL");
+    BenchRunner_report(this->pRunner, "Buffer_updateRenderWidth", sParam, this->dLineBytes * 1e3 / fTime, "MB/s", "");
+  }
+
+  Mem_free(sEscape);
+}
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @ Description:
+ *    Times the cases of the benchmark and prints the results.
+ *    Every result is one tab-separated line (case, param, value, unit, check) so two runs can be diffed or fed to a script.
+ *    A case is run in rounds of ops, and the number of ops is doubled until a round takes long enough to be worth timing;
+ *    we then keep the median of a few rounds so one round that got interrupted by the OS doesn't skew things.
+ */
+
+#ifndef BENCH_RUNNER_
+#define BENCH_RUNNER_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ROUNDS 5
+
+/**
+ * Keeps track of where the results go and whether anything failed its check.
+ * @class
+*/
+typedef struct BenchRunner BenchRunner;
+
+struct BenchRunner {
+  FILE *pOutput;      // Where the results are printed
+  double fTarget;     // How long a round should take, in seconds
+  int bFailed;        // Whether or not any case failed its check
+};
+
+/**
+ * Constructors and destructors
+*/
+BenchRunner *BenchRunner_init(BenchRunner *this, FILE *pOutput, double fTarget);
+
+/**
+ * Operations
+*/
+double BenchRunner_getTime();
+
+double BenchRunner_measure(BenchRunner *this, double (*fRun)(void *pData, long dOps), void *pData);
+
+void BenchRunner_report(BenchRunner *this, char *sCase, char *sParam, double fValue, char *sUnit, char *sCheck);
+
+/**
+ * //
+ * ////
+ * //////    BenchRunner constructors and destructors
+ * ////////
+ * ////////// 
+*/
+
+/**
+ * Initializes the runner and prints the header of the results.
+ * 
+ * @param   { BenchRunner * }   this      The runner to initialize.
+ * @param   { FILE * }          pOutput   Where to print the results.
+ * @param   { double }          fTarget   How long a round should take, in seconds.
+ * @return  { BenchRunner * }             The initialized runner.
+*/
+BenchRunner *BenchRunner_init(BenchRunner *this, FILE *pOutput, double fTarget) {
+  this->pOutput = pOutput;
+  this->fTarget = fTarget;
+  this->bFailed = 0;
+
+  fprintf(this->pOutput, "case\tparam\tvalue\tunit\tcheck\n");
+
+  return this;
+}
+
+/**
+ * //
+ * ////
+ * //////    BenchRunner operations
+ * ////////
+ * ////////// 
+*/
+
+/**
+ * Returns the time in seconds.
+ * 
+ * @return  { double }  A monotonic timestamp.
+*/
+double BenchRunner_getTime() {
+  struct timespec time;
+
+  clock_gettime(CLOCK_MONOTONIC, &time);
+
+  return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * Compares two doubles for qsort().
+ * 
+ * @param   { const void * }  pFirst    The first double.
+ * @param   { const void * }  pSecond   The second double.
+ * @return  { int }                     Which one comes first.
+*/
+int BenchRunner_compare(const void *pFirst, const void *pSecond) {
+  double fFirst = *(const double *) pFirst;
+  double fSecond = *(const double *) pSecond;
+
+  return (fFirst > fSecond) - (fFirst < fSecond);
+}
+
+/**
+ * Times a case and returns how long one of its ops takes.
+ * fRun should do the op dOps times and return how many seconds that took.
+ * 
+ * @param   { BenchRunner * }   this    The runner.
+ * @param   { double (*)() }    fRun    Runs the op a number of times.
+ * @param   { void * }          pData   Whatever fRun needs.
+ * @return  { double }                  The median number of nanoseconds per op.
+*/
+double BenchRunner_measure(BenchRunner *this, double (*fRun)(void *pData, long dOps), void *pData) {
+  double fRoundArray[BENCH_ROUNDS];
+  long dOps = 1;
+
+  // Find out how many ops make a round long enough; this warms the caches up too
+  while(fRun(pData, dOps) < this->fTarget && dOps < (1L << 40))
+    dOps *= 2;
+
+  for(int i = 0; i < BENCH_ROUNDS; i++)
+    fRoundArray[i] = fRun(pData, dOps) * 1e9 / dOps;
+
+  qsort(fRoundArray, BENCH_ROUNDS, sizeof(double), BenchRunner_compare);
+
+  return fRoundArray[BENCH_ROUNDS / 2];
+}
+
+/**
+ * Prints a single result.
+ * A check of "FAIL" marks the whole run as failed; an empty check means there was nothing to check.
+ * 
+ * @param   { BenchRunner * }   this    The runner.
+ * @param   { char * }          sCase   What was measured.
+ * @param   { char * }          sParam  The parameter of the case (line length, depth, etc.), or "-" if there isn't one.
+ * @param   { double }          fValue  The result.
+ * @param   { char * }          sUnit   The unit of the result.
+ * @param   { char * }          sCheck  Whether the result matched what was expected.
+*/
+void BenchRunner_report(BenchRunner *this, char *sCase, char *sParam, double fValue, char *sUnit, char *sCheck) {
+  if(!strcmp(sCheck, "FAIL"))
+    this->bFailed = 1;
+
+  // Counts are printed as they are, so they can be compared exactly
+  fprintf(this->pOutput, "%s\t%s\t%.*f\t%s\t%s\n", 
+    sCase, sParam, fValue == (long long) fValue ? 0 : 3, fValue, sUnit, sCheck[0] ? sCheck : "-");
+  fflush(this->pOutput);
+}
+
+#endif
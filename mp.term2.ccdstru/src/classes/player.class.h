@@ -10,6 +10,7 @@
 #define GAME_PLAYER_CLASS_
 
 #include "world.class.h"
+#include "../utils/utils.mem.h"
 #include <stdlib.h>
 
 /**
@@ -57,7 +58,7 @@ void Player_addPoint(Player *this, int x, int y);
  * @return  { Player * }  A pointer to the created instance of the player class.
 */
 Player *Player_new() {
-  Player *pPlayer = calloc(1, sizeof(*pPlayer));
+  Player *pPlayer = Mem_calloc(MEM_PLAYER, 1, sizeof(*pPlayer));
 
   if(pPlayer == NULL)
     return NULL;
@@ -92,11 +93,13 @@ Player *Player_create() {
 
 /**
  * Deallocates the memory associated with an instance of the player class.
+ * The player's world goes with it.
  * 
  * @param   { Player * }  this  The instance of the player class to be deallocated.
 */
 void Player_kill(Player *this) {
-  free(this);
+  World_kill(this->pWorld);
+  Mem_free(this);
 }
 
 /**
@@ -12,6 +12,9 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "../utils/utils.mem.h"
+#include "../utils/utils.pool.h"
+
 #define WORLD_MAX_SIZE 8
 
 /**
@@ -27,6 +30,9 @@ struct World {
   uint8_t bits[WORLD_MAX_SIZE];
 };
 
+// Every player, win condition and benchmark case gets a world, so they come from a pool
+POOL_DEFINE(World, World, MEM_WORLD, 64)
+
 /**
  * Constructors and destructors
 */
@@ -50,6 +56,8 @@ void World_setBit(World *this, short x, short y, int n);
 */
 int World_contains(World *pWorldRef, World *pWorldSub);
 
+uint64_t World_getMask(World *this);
+
 /**
  * //
  * ////
@@ -64,7 +72,7 @@ int World_contains(World *pWorldRef, World *pWorldSub);
  * @return  { World * }   A pointer to the created instance of the world class.
 */
 World *World_new() {
-  World *pWorld = calloc(1, sizeof(*pWorld));
+  World *pWorld = World_poolAlloc();
 
   if(pWorld == NULL)
     return NULL;
@@ -106,7 +114,7 @@ World *World_create() {
  * @param   { World * }   this  The instance of the world class to be deallocated.
 */
 void World_kill(World *this) {
-  free(this);
+  World_poolFree(this);
 }
 
 /**
@@ -165,4 +173,20 @@ int World_contains(World *pWorldRef, World *pWorldSub) {
   return 1;
 }
 
+/**
+ * Returns the bits of a world as a single number, one byte per row.
+ * The bit of (x, y) ends up at y * WORLD_MAX_SIZE + x, whatever the byte order of the machine is.
+ * 
+ * @param   { World * }     this  The world instance to be read.
+ * @return  { uint64_t }          The bits of the world.
+*/
+uint64_t World_getMask(World *this) {
+  uint64_t dMask = 0;
+
+  for(int i = 0; i < WORLD_MAX_SIZE; i++)
+    dMask |= (uint64_t) this->bits[i] << (i * WORLD_MAX_SIZE);
+
+  return dMask;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,596 @@
+/**
+ * @ Description:
+ *    The bot: a Monte Carlo tree search over the positions of the game, for any number of players.
+ *    The tree is kept between moves. When a move is made, the subtree under it becomes the whole tree, so whatever
+ *    the bot worked out about that move while the others were thinking isn't thrown away.
+ *    The search can run on a worker thread (Bot_start() and Bot_stop()), which is how the bot ponders while the
+ *    main thread sits in IO_readChar(). The worker only ever touches the bot, and it never allocates.
+ *
+ *    Needs -pthread and -lm, and _POSIX_C_SOURCE for nanosleep() (see game.c).
+ */
+
+#ifndef GAME_BOT_
+#define GAME_BOT_
+
+#include "game.system.h"
+#include "./utils/utils.mem.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#define BOT_MAX_NODES (1 << 19)   // Nodes in each half of the tree (see Bot_collect())
+#define BOT_EXPLORE 1.0           // How much the search favors the moves it hasn't looked at much
+#define BOT_THINK_MS 500          // How long the bot takes for a move in the game
+#define BOT_SEED 2024
+
+/**
+ * //
+ * ////
+ * //////    Bot object infrastructure
+ * ////////
+ * //////////
+*/
+
+/**
+ * A node of the tree: a position, by way of the move that led to it.
+ * The children of a node are a list (dChild, then dSibling), and they only get made once a playout goes through them.
+*/
+typedef struct BotNode BotNode;
+
+struct BotNode {
+  uint64_t dUntried;    // The moves from here that don't have a node yet
+  int dChild;           // The first child (-1 if there isn't any)
+  int dSibling;         // The next child of the same parent (-1 if there isn't any)
+  int dVisits;          // How many playouts went through here
+  float fScore;         // What those playouts were worth to the player who made the move (1 a win, 1 / players a draw)
+  uint8_t dPoint;       // The move that led here (see Position_getBit())
+  uint8_t dPlayer;      // Who made it
+};
+
+/**
+ * The bot.
+ * The main thread can only touch it while the worker isn't running; Bot_stop() is what makes sure of that.
+ * @class
+*/
+typedef struct Bot Bot;
+
+struct Bot {
+
+  // The tree lives in one of these; the other one is where it gets copied to when it's time to clean up
+  BotNode *pNodeArray;
+  BotNode *pSpareArray;
+  int dNodes;
+  int dRoot;
+
+  // A copy of the game to search on, always back at the position of the root between playouts
+  System system;
+  int dRootMove;
+
+  // The state of the random number generator (xorshift, like the benchmark)
+  uint32_t dSeed;
+
+  // The worker and how to stop it; both threads use bStop, so it's only touched through Bot_setStop() and Bot_isStopping()
+  pthread_t worker;
+  int bStop;
+  int bRunning;
+};
+
+/**
+ * Constructors and destructors
+*/
+Bot *Bot_new();
+
+Bot *Bot_init(Bot *this, System *pSystem);
+
+Bot *Bot_create(System *pSystem);
+
+void Bot_kill(Bot *this);
+
+/**
+ * Operations
+*/
+void Bot_reset(Bot *this, System *pSystem);
+
+void Bot_advance(Bot *this, int dPoint);
+
+void Bot_sync(Bot *this, System *pSystem);
+
+void Bot_iterate(Bot *this);
+
+long Bot_search(Bot *this, long dIterations);
+
+void Bot_start(Bot *this);
+
+void Bot_stop(Bot *this);
+
+void Bot_think(Bot *this, int dMillis);
+
+int Bot_getMove(Bot *this, int *pX, int *pY);
+
+/**
+ * //
+ * ////
+ * //////    Bot constructors and destructors
+ * ////////
+ * //////////
+*/
+
+/**
+ * Creates a new instance of the bot class.
+ *
+ * @return  { Bot * }   A pointer to the created instance.
+*/
+Bot *Bot_new() {
+  Bot *pBot = Mem_calloc(MEM_BOT, 1, sizeof(*pBot));
+
+  if(pBot == NULL)
+    return NULL;
+
+  return pBot;
+}
+
+/**
+ * Initializes an instance of the bot class with the tree at the current position of a game.
+ * Both halves of the tree are made here, so nothing gets allocated once the bot starts searching.
+ *
+ * @param   { Bot * }     this      The bot to be initialized.
+ * @param   { System * }  pSystem   The game it plays.
+ * @return  { Bot * }               The initialized bot.
+*/
+Bot *Bot_init(Bot *this, System *pSystem) {
+  this->pNodeArray = Mem_calloc(MEM_BOT, BOT_MAX_NODES, sizeof(BotNode));
+  this->pSpareArray = Mem_calloc(MEM_BOT, BOT_MAX_NODES, sizeof(BotNode));
+  this->dSeed = BOT_SEED;
+  this->bStop = 0;
+  this->bRunning = 0;
+
+  Bot_reset(this, pSystem);
+
+  return this;
+}
+
+/**
+ * Creates an initialized instance of the bot class.
+ *
+ * @param   { System * }  pSystem   The game it plays.
+ * @return  { Bot * }               A pointer to the created instance.
+*/
+Bot *Bot_create(System *pSystem) {
+  Bot *pBot = Bot_new();
+
+  Bot_init(pBot, pSystem);
+
+  return pBot;
+}
+
+/**
+ * Stops the bot and deletes it along with its tree.
+ *
+ * @param   { Bot * }   this  The bot to be deleted.
+*/
+void Bot_kill(Bot *this) {
+  Bot_stop(this);
+
+  Mem_free(this->pNodeArray);
+  Mem_free(this->pSpareArray);
+  Mem_free(this);
+}
+
+/**
+ * //
+ * ////
+ * //////    Bot helpers
+ * ////////
+ * //////////
+*/
+
+/**
+ * Returns the next number of a xorshift generator.
+ *
+ * @param   { Bot * }       this  The bot.
+ * @return  { uint32_t }          A random number.
+*/
+uint32_t Bot_random(Bot *this) {
+  this->dSeed ^= this->dSeed << 13;
+  this->dSeed ^= this->dSeed >> 17;
+  this->dSeed ^= this->dSeed << 5;
+
+  return this->dSeed;
+}
+
+/**
+ * Returns whether or not the worker has been told to stop.
+ * The flag is read and written atomically, since the main thread sets it while the worker reads it.
+ *
+ * @param   { Bot * }   this  The bot.
+ * @return  { int }           Whether or not the search should stop.
+*/
+int Bot_isStopping(Bot *this) {
+  #ifdef __GNUC__
+    return __atomic_load_n(&this->bStop, __ATOMIC_ACQUIRE);
+  #else
+    return *(volatile int *) &this->bStop;
+  #endif
+}
+
+/**
+ * Tells the worker to stop (or lets it run again).
+ *
+ * @param   { Bot * }   this    The bot.
+ * @param   { int }     bStop   Whether or not the search should stop.
+*/
+void Bot_setStop(Bot *this, int bStop) {
+  #ifdef __GNUC__
+    __atomic_store_n(&this->bStop, bStop, __ATOMIC_RELEASE);
+  #else
+    *(volatile int *) &this->bStop = bStop;
+  #endif
+}
+
+/**
+ * Picks one of the points of a mask at random.
+ *
+ * @param   { Bot * }       this    The bot.
+ * @param   { uint64_t }    dMask   The points to pick from (there has to be at least one).
+ * @return  { int }                 The point (see Position_getBit()).
+*/
+int Bot_pickPoint(Bot *this, uint64_t dMask) {
+  int dCount = 0;
+
+  #ifdef __GNUC__
+    dCount = __builtin_popcountll(dMask);
+  #else
+    for(uint64_t dLeft = dMask; dLeft; dLeft &= dLeft - 1)
+      dCount++;
+  #endif
+
+  // Drop the lowest points until the one we picked is the lowest
+  for(int i = Bot_random(this) % dCount; i; i--)
+    dMask &= dMask - 1;
+
+  return Rules_nextPattern(&dMask);
+}
+
+/**
+ * Makes a node for the current position of the search, if the tree still has room.
+ *
+ * @param   { Bot * }   this      The bot.
+ * @param   { int }     dPoint    The move that led to the position.
+ * @param   { int }     dPlayer   Who made it.
+ * @return  { int }               The node, or -1 if the tree is full.
+*/
+int Bot_newNode(Bot *this, int dPoint, int dPlayer) {
+  System *pSystem = &this->system;
+  BotNode *pNode;
+
+  if(this->dNodes == BOT_MAX_NODES)
+    return -1;
+
+  pNode = &this->pNodeArray[this->dNodes];
+  pNode->dUntried = System_isOver(pSystem) ? 0 :
+    pSystem->RULES.WORLD_MASK & ~Position_getTaken(System_getPosition(pSystem));
+  pNode->dChild = -1;
+  pNode->dSibling = -1;
+  pNode->dVisits = 0;
+  pNode->fScore = 0;
+  pNode->dPoint = dPoint;
+  pNode->dPlayer = dPlayer;
+
+  return this->dNodes++;
+}
+
+/**
+ * Copies the subtree under a node into the spare half, leaving behind every node that can't be reached from it.
+ * The copy is breadth first, so the children of a node end up side by side and every index can be fixed up in one pass.
+ *
+ * @param   { Bot * }   this    The bot.
+ * @param   { int }     dNode   The node that becomes the root.
+ * @return  { int }             The new index of the root (always 0).
+*/
+int Bot_collect(Bot *this, int dNode) {
+  BotNode *pFrom = this->pNodeArray;
+  BotNode *pTo = this->pSpareArray;
+  int dCount = 1;
+
+  pTo[0] = pFrom[dNode];
+  pTo[0].dSibling = -1;
+
+  for(int i = 0; i < dCount; i++) {
+    int dChild = pTo[i].dChild;
+
+    if(dChild < 0)
+      continue;
+
+    pTo[i].dChild = dCount;
+
+    while(dChild >= 0) {
+      pTo[dCount] = pFrom[dChild];
+      dChild = pFrom[dChild].dSibling;
+      pTo[dCount].dSibling = dChild >= 0 ? dCount + 1 : -1;
+      dCount++;
+    }
+  }
+
+  this->pNodeArray = pTo;
+  this->pSpareArray = pFrom;
+  this->dNodes = dCount;
+
+  return 0;
+}
+
+/**
+ * Picks the child to go down to, by UCT: the score it has so far, plus a bonus for not having been looked at much.
+ *
+ * @param   { Bot * }   this    The bot.
+ * @param   { int }     dNode   The node (it has to have children).
+ * @return  { int }             The child.
+*/
+int Bot_select(Bot *this, int dNode) {
+  BotNode *pNode = &this->pNodeArray[dNode];
+  double fLog = log(pNode->dVisits);
+  double fBest = -1;
+  int dBest = pNode->dChild;
+
+  for(int i = pNode->dChild; i >= 0; i = this->pNodeArray[i].dSibling) {
+    BotNode *pChild = &this->pNodeArray[i];
+    double fValue = pChild->fScore / pChild->dVisits + BOT_EXPLORE * sqrt(fLog / pChild->dVisits);
+
+    if(fValue > fBest) {
+      fBest = fValue;
+      dBest = i;
+    }
+  }
+
+  return dBest;
+}
+
+/**
+ * //
+ * ////
+ * //////    Bot operations
+ * ////////
+ * //////////
+*/
+
+/**
+ * Throws the tree away and starts a new one at the current position of a game.
+ *
+ * @param   { Bot * }     this      The bot.
+ * @param   { System * }  pSystem   The game.
+*/
+void Bot_reset(Bot *this, System *pSystem) {
+  this->system = *pSystem;
+  this->dRootMove = System_getMoveIndex(pSystem);
+  this->dNodes = 0;
+  this->dRoot = Bot_newNode(this, 0, 0);
+}
+
+/**
+ * Makes a move at the root, keeping the subtree under it.
+ * The nodes above it stay where they are until the tree is over half full; then the subtree is copied to the
+ * other half, which gets rid of them (see Bot_collect()).
+ *
+ * @param   { Bot * }   this    The bot.
+ * @param   { int }     dPoint  The move (see Position_getBit()).
+*/
+void Bot_advance(Bot *this, int dPoint) {
+  int dChild = this->pNodeArray[this->dRoot].dChild;
+
+  while(dChild >= 0 && this->pNodeArray[dChild].dPoint != dPoint)
+    dChild = this->pNodeArray[dChild].dSibling;
+
+  System_update(&this->system, dPoint % WORLD_MAX_SIZE, dPoint / WORLD_MAX_SIZE);
+  this->dRootMove = System_getMoveIndex(&this->system);
+
+  // Nobody looked at the move, so there's nothing to keep
+  if(dChild < 0) {
+    this->dNodes = 0;
+    this->dRoot = Bot_newNode(this, dPoint, 0);
+    return;
+  }
+
+  this->dRoot = this->dNodes > BOT_MAX_NODES / 2 ? Bot_collect(this, dChild) : dChild;
+}
+
+/**
+ * Brings the tree to the current position of a game.
+ * If the game is one move past the root, that move's subtree is kept; anything else (an undo, a new game) starts over.
+ *
+ * @param   { Bot * }     this      The bot (it can't be running).
+ * @param   { System * }  pSystem   The game.
+*/
+void Bot_sync(Bot *this, System *pSystem) {
+  Position *pRoot = System_getPosition(&this->system);
+  int dMove = System_getMoveIndex(pSystem);
+  int x, y;
+
+  if(!memcmp(pRoot, System_getPosition(pSystem), sizeof(Position)))
+    return;
+
+  if(dMove == this->dRootMove + 1 && !memcmp(pRoot, &pSystem->positionHistory[dMove - 1], sizeof(Position))) {
+    System_getMove(pSystem, dMove - 1, &x, &y);
+    Bot_advance(this, y * WORLD_MAX_SIZE + x);
+    return;
+  }
+
+  Bot_reset(this, pSystem);
+}
+
+/**
+ * Runs a single playout: down the tree, one new node, random moves to the end of the game, and the result back up.
+ *
+ * @param   { Bot * }   this  The bot.
+*/
+void Bot_iterate(Bot *this) {
+  System *pSystem = &this->system;
+  int dPathArray[GAME_MAX_MOVES + 1];
+  int dDepth = 0;
+  int dNode = this->dRoot;
+  int dWinner = -1;
+  float fDraw = 1.0f / pSystem->TURN_COUNT;
+
+  dPathArray[dDepth++] = dNode;
+
+  // Down the tree, as long as every move from the node has a child
+  while(!this->pNodeArray[dNode].dUntried && this->pNodeArray[dNode].dChild >= 0) {
+    dNode = Bot_select(this, dNode);
+    System_update(pSystem, this->pNodeArray[dNode].dPoint % WORLD_MAX_SIZE, this->pNodeArray[dNode].dPoint / WORLD_MAX_SIZE);
+    dPathArray[dDepth++] = dNode;
+  }
+
+  // A node for one of the moves that doesn't have one yet
+  if(this->pNodeArray[dNode].dUntried && this->dNodes < BOT_MAX_NODES) {
+    int dPoint = Bot_pickPoint(this, this->pNodeArray[dNode].dUntried);
+    int dPlayer = System_getTurn(pSystem);
+    int dChild;
+
+    this->pNodeArray[dNode].dUntried &= ~(1ULL << dPoint);
+    System_update(pSystem, dPoint % WORLD_MAX_SIZE, dPoint / WORLD_MAX_SIZE);
+
+    dChild = Bot_newNode(this, dPoint, dPlayer);
+    this->pNodeArray[dChild].dSibling = this->pNodeArray[dNode].dChild;
+    this->pNodeArray[dNode].dChild = dChild;
+    dPathArray[dDepth++] = dChild;
+  }
+
+  // Random moves to the end of the game
+  while(!System_isOver(pSystem)) {
+    int dPoint = Bot_pickPoint(this, pSystem->RULES.WORLD_MASK & ~Position_getTaken(System_getPosition(pSystem)));
+
+    System_update(pSystem, dPoint % WORLD_MAX_SIZE, dPoint / WORLD_MAX_SIZE);
+  }
+
+  if(System_hasWon(pSystem, System_getTurn(pSystem)))
+    dWinner = System_getTurn(pSystem);
+
+  // The root doesn't have a player, but it needs the visits for Bot_select()
+  for(int i = 0; i < dDepth; i++) {
+    BotNode *pNode = &this->pNodeArray[dPathArray[i]];
+
+    pNode->dVisits++;
+    pNode->fScore += dWinner < 0 ? fDraw : pNode->dPlayer == dWinner;
+  }
+
+  System_seek(pSystem, this->dRootMove);
+}
+
+/**
+ * Runs playouts until there have been enough or the bot is told to stop.
+ *
+ * @param   { Bot * }   this          The bot.
+ * @param   { long }    dIterations   How many playouts to run.
+ * @return  { long }                  How many were run.
+*/
+long Bot_search(Bot *this, long dIterations) {
+  long i;
+
+  // There's nothing to look at once the game is over
+  if(System_isOver(&this->system))
+    return 0;
+
+  for(i = 0; i < dIterations && !Bot_isStopping(this); i++)
+    Bot_iterate(this);
+
+  return i;
+}
+
+/**
+ * What the worker runs: playouts, until Bot_stop().
+ *
+ * @param   { void * }  pData   The bot.
+ * @return  { void * }          Nothing.
+*/
+void *Bot_work(void *pData) {
+  Bot *this = pData;
+
+  while(!Bot_isStopping(this) && Bot_search(this, 1));
+
+  return NULL;
+}
+
+/**
+ * Starts searching on the worker, from the current root, until Bot_stop().
+ * This is what the bot does on the turns of the other players (pondering), and when it thinks about its own move.
+ *
+ * @param   { Bot * }   this  The bot.
+*/
+void Bot_start(Bot *this) {
+  if(this->bRunning)
+    return;
+
+  Bot_setStop(this, 0);
+  this->bRunning = !pthread_create(&this->worker, NULL, Bot_work, this);
+}
+
+/**
+ * Stops the worker and waits for it, which is never longer than a single playout.
+ * The tree is the main thread's again once this returns.
+ *
+ * @param   { Bot * }   this  The bot.
+*/
+void Bot_stop(Bot *this) {
+  if(!this->bRunning)
+    return;
+
+  Bot_setStop(this, 1);
+  pthread_join(this->worker, NULL);
+
+  Bot_setStop(this, 0);
+  this->bRunning = 0;
+}
+
+/**
+ * Searches for a fixed amount of time; whatever was searched before (while pondering) counts too.
+ *
+ * @param   { Bot * }   this      The bot.
+ * @param   { int }     dMillis   How long to search for.
+*/
+void Bot_think(Bot *this, int dMillis) {
+  Bot_start(this);
+
+  #ifdef _WIN32
+    Sleep(dMillis);
+  #else
+    struct timespec wait = { dMillis / 1000, dMillis % 1000 * 1000000L };
+    nanosleep(&wait, NULL);
+  #endif
+
+  Bot_stop(this);
+}
+
+/**
+ * Returns the move the bot would make at the root: the one the search went down the most.
+ *
+ * @param   { Bot * }   this  The bot (it can't be running).
+ * @param   { int * }   pX    Where the x-coordinate of the move goes.
+ * @param   { int * }   pY    Where the y-coordinate of the move goes.
+ * @return  { int }           Whether or not there was a move to make.
+*/
+int Bot_getMove(Bot *this, int *pX, int *pY) {
+  BotNode *pRoot = &this->pNodeArray[this->dRoot];
+  int dBest = -1, dPoint;
+
+  if(System_isOver(&this->system))
+    return 0;
+
+  for(int i = pRoot->dChild; i >= 0; i = this->pNodeArray[i].dSibling)
+    if(dBest < 0 || this->pNodeArray[i].dVisits > this->pNodeArray[dBest].dVisits)
+      dBest = i;
+
+  // Without a search, any free point will do
+  dPoint = dBest >= 0 ? this->pNodeArray[dBest].dPoint : Bot_pickPoint(this, pRoot->dUntried);
+
+  *pX = dPoint % WORLD_MAX_SIZE;
+  *pY = dPoint / WORLD_MAX_SIZE;
+
+  return 1;
+}
+
+#endif
@@ -6,41 +6,102 @@
  *    Contains the overarching logic of the game.
  */
 
+// We need nanosleep() from POSIX for the bot
+#define _POSIX_C_SOURCE 200809L
+
 #include "game.system.h"
+#include "game.bot.h"
+#include "game.ui.h"
 #include "./utils/utils.io.h"
-#include "./utils/utils.buffer.h"
-#include "./utils/utils.graphics.h"
+#include "./utils/utils.mem.h"
 
 #include <stdio.h>
 
 int main() {
 
+  // Allocation accounting; the report is written to build/mem.txt at exit
+  Mem_init();
+
   System system;
-  Buffer *buffer = Buffer_create(64);
+  UI ui;
+  IO io;
+  Bot *pBot = NULL;
+  int cKey = 0;
+  int bBot = 0, dHuman = 0;
+  int x, y;
 
   System_init(&system); 
+  UI_init(&ui);
+  IO_init(&io);
 
-  IO_clear();
   IO_setSize(64, 16);
 
-  Buffer_newText(buffer, "Hello world1");
-  Buffer_addText(buffer, Graphics_getCodeBG(0xffffff));
-  Buffer_addText(buffer, Graphics_getCodeFG(0x212121));
-  Buffer_addText(buffer, "Hello world2");
-  Buffer_addText(buffer, Graphics_getCodeBG(0x123456));
-  Buffer_addText(buffer, Graphics_getCodeFG(0x654321));
-  Buffer_addText(buffer, "Hello world3");
+  // Every key is handled, then the world is drawn again (until a quit, or until the input runs out)
+  while(cKey != 'q' && cKey != 'Q' && cKey != EOF) {
+
+    // The bot plays everybody but the human, with the same time for every move
+    while(bBot && !System_isOver(&system) && System_getTurn(&system) != dHuman) {
+      UI_render(&ui, &system);
+      Bot_sync(pBot, &system);
+      Bot_think(pBot, BOT_THINK_MS);
+
+      if(Bot_getMove(pBot, &x, &y))
+        System_update(&system, x, y);
+    }
+
+    // While the human thinks, so does the bot (on its worker, so reading the key isn't held up)
+    if(bBot && !System_isOver(&system)) {
+      Bot_sync(pBot, &system);
+      Bot_start(pBot);
+    }
+
+    UI_render(&ui, &system);
+    cKey = IO_readChar();
+
+    // Whatever the key does, the bot has to let go of its tree first
+    if(pBot != NULL)
+      Bot_stop(pBot);
+
+    switch(cKey) {
+      case 'w': case 'W': UI_moveCursor(&ui, &system, 0, -1); break;
+      case 'a': case 'A': UI_moveCursor(&ui, &system, -1, 0); break;
+      case 's': case 'S': UI_moveCursor(&ui, &system, 0, 1); break;
+      case 'd': case 'D': UI_moveCursor(&ui, &system, 1, 0); break;
+      case 'b': case 'B': 
+
+        // The tree takes a lot of memory, so the bot is only made the first time it's needed
+        if(pBot == NULL)
+          pBot = Bot_create(&system);
+
+        bBot = !bBot;
+        dHuman = System_getTurn(&system);
+        UI_toggleBot(&ui);
+      break;
+
+      // With the bot on, an undo goes all the way back to the human's last move
+      case 'u': case 'U': 
+        while(System_undo(&system) && bBot && System_getTurn(&system) != dHuman);
+      break;
+
+      case 'r': case 'R': System_redo(&system); break;
+
+      // The whole history can be gone through; a move made from the middle of it drops the moves after it
+      case '[': System_seek(&system, 0); break;
+      case ']': System_seek(&system, System_getMoveCount(&system)); break;
+
+      case 'h': case 'H': UI_toggleHints(&ui); break;
 
-  printf("%d\n", buffer->dWidth);
-  printf("%s", buffer->sText);
+      case UTILS_IO_SPACE: case UTILS_IO_LF: case UTILS_IO_CR:
+        System_update(&system, ui.dCursorX, ui.dCursorY);
+      break;
+    }
+  }
 
-  // for(int i = 0; i < 8; i++){
-  //   for(int j = 0; j < 8; j++)
-  //     printf("%d", World_getBit(system.WIN_CONFIGS[1], i, j));
-  //   printf("\n");
-  // }
+  if(pBot != NULL)
+    Bot_kill(pBot);
 
-  IO_readChar();
+  UI_exit(&ui);
+  IO_exit(&io);
 
   return 0;
-}
\ No newline at end of file
+}
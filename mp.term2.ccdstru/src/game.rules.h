@@ -0,0 +1,386 @@
+/**
+ * @ Description:
+ *    Loads the rules of the game from text and compiles them into the masks the system plays with.
+ *    The rules of the machine project are built in (see RULES_DEFAULT); a rule file describes a variant the same way:
+ *
+ *      # Anything after a hash is a comment
+ *      size 6                                      The world is 6 by 6 (at most POSITION_MAX_SIZE)
+ *      players 2                                   How many players take turns (at most GAME_PLAYERS)
+ *      quad (1, 1) (2, 2)                          A quadrant pattern
+ *      config (1, 1) (1, 3) (2, 2) (3, 1) (3, 3)   A winning configuration
+ *
+ *    Points are (x, y) and start from 1, just like the comments in the specs. The brackets and commas are optional.
+ *    Every pattern becomes a mask of the world (see World_getMask()), and every point gets a mask of which
+ *    configurations and quads it's part of, so a move only has to be checked against the ones it could complete.
+ */
+
+#ifndef GAME_RULES
+#define GAME_RULES
+
+#include "./classes/world.class.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// The most players a position can hold (see game.system.h); every position carries a world per player,
+// so the 2 the machine project needs keep them at 16 bytes. Variants with more players need -DGAME_PLAYERS=8
+// (the turn has 3 bits, so 8 is as far as it goes), which makes every position 64 bytes.
+#ifndef GAME_PLAYERS
+#define GAME_PLAYERS 2
+#endif
+
+// The built-in rules (RULES_DEFAULT) have 2 players, so there has to be room for at least that many
+#if GAME_PLAYERS < 2 || GAME_PLAYERS > 8
+#error "GAME_PLAYERS has to be from 2 to 8"
+#endif
+
+// The biggest world a position can hold; the last row of the first world holds the turn and the over-state instead
+#define POSITION_MAX_SIZE (WORLD_MAX_SIZE - 1)
+#define POSITION_POINTS_MAX (WORLD_MAX_SIZE * WORLD_MAX_SIZE)
+
+// The most patterns of each kind (the per-point lookups are one bit per pattern)
+#define RULES_MAX_QUADS 64
+#define RULES_MAX_CONFIGS 64
+
+// The biggest rule file we read
+#define RULES_MAX_TEXT (1 << 14)
+
+// No number in a rule file needs more digits than this, so a longer one is a mistake (and can't overflow)
+#define RULES_MAX_DIGITS 3
+
+/**
+ * The rules of the machine project.
+*/
+#define RULES_DEFAULT \
+  "size 6\n" \
+  "players 2\n" \
+  "\n" \
+  "# The quadrant patterns (the set P)\n" \
+  "quad (1, 1) (2, 2)\n" \
+  "quad (1, 2) (2, 1)\n" \
+  "\n" \
+  "# The winning configurations (the set S)\n" \
+  "config (1, 1) (1, 3) (2, 2) (3, 1) (3, 3)\n" \
+  "config (4, 4) (4, 6) (5, 5) (6, 4) (6, 6)\n" \
+  "config (1, 5) (2, 4) (2, 5) (2, 6) (3, 5)\n" \
+  "config (4, 1) (4, 3) (5, 1) (5, 3) (6, 1) (6, 3)\n"
+
+/**
+ * //
+ * ////
+ * //////    Rules object infrastructure
+ * ////////
+ * //////////
+*/
+
+/**
+ * The compiled rules.
+ * Everything the system needs sits in these arrays, so checking a move never leaves them.
+*/
+typedef struct Rules Rules;
+
+struct Rules {
+
+  // The size of the world and the number of players
+  int WORLD_SIZE;
+  int PLAYER_COUNT;
+
+  // The patterns, as masks of the world
+  int QUAD_COUNT;
+  int CONFIG_COUNT;
+  uint64_t QUAD_MASKS[RULES_MAX_QUADS];
+  uint64_t CONFIG_MASKS[RULES_MAX_CONFIGS];
+
+  // Every point of the world space
+  uint64_t WORLD_MASK;
+
+  // Which patterns each point is part of (bit i stands for pattern i)
+  uint64_t POINT_QUADS[POSITION_POINTS_MAX];
+  uint64_t POINT_CONFIGS[POSITION_POINTS_MAX];
+
+  // What was wrong with the last text that didn't load, and on which line (0 if it wasn't any line in particular)
+  char *sError;
+  int dErrorLine;
+};
+
+/**
+ * Initializes an empty set of rules.
+ *
+ * @param   { Rules * }   this  The rules to be initialized.
+ * @return  { Rules * }         The initialized rules.
+*/
+Rules *Rules_init(Rules *this) {
+  memset(this, 0, sizeof(*this));
+
+  return this;
+}
+
+/**
+ * //
+ * ////
+ * //////    Rules operations
+ * ////////
+ * //////////
+*/
+
+/**
+ * Reads the numbers on a line, skipping anything that isn't part of a number.
+ *
+ * @param   { char * }  sLine       The rest of the line.
+ * @param   { int * }   dNumArray   Where the numbers go.
+ * @param   { int }     dMax        How many numbers fit.
+ * @return  { int }                 How many numbers there were, -1 if there were too many or something else was there,
+ *                                  or -2 if a number had more digits than RULES_MAX_DIGITS.
+*/
+int Rules_readNumbers(char *sLine, int *dNumArray, int dMax) {
+  int dCount = 0;
+
+  while(*sLine) {
+    if(*sLine >= '0' && *sLine <= '9') {
+      int dNum = 0;
+
+      for(int dDigits = 0; *sLine >= '0' && *sLine <= '9'; dDigits++) {
+        if(dDigits == RULES_MAX_DIGITS)
+          return -2;
+
+        dNum = dNum * 10 + *sLine++ - '0';
+      }
+
+      if(dCount == dMax)
+        return -1;
+
+      dNumArray[dCount++] = dNum;
+      continue;
+    }
+
+    if(!strchr(" \t\r(),", *sLine))
+      return -1;
+
+    sLine++;
+  }
+
+  return dCount;
+}
+
+/**
+ * Takes the lowest pattern out of a mask of patterns (like the ones in POINT_CONFIGS).
+ *
+ * @param   { uint64_t * }  pPatterns   The patterns left; the one returned is taken out.
+ * @return  { int }                     The index of the pattern.
+*/
+int Rules_nextPattern(uint64_t *pPatterns) {
+  int i = 0;
+
+  #ifdef __GNUC__
+    i = __builtin_ctzll(*pPatterns);
+  #else
+    while(!(*pPatterns >> i & 1))
+      i++;
+  #endif
+
+  *pPatterns &= *pPatterns - 1;
+
+  return i;
+}
+
+/**
+ * Works out the per-point lookups once all the patterns are in.
+ *
+ * @param   { Rules * }   this  The rules to compile.
+*/
+void Rules_compile(Rules *this) {
+  this->WORLD_MASK = 0;
+
+  for(int x = 0; x < this->WORLD_SIZE; x++)
+    for(int y = 0; y < this->WORLD_SIZE; y++)
+      this->WORLD_MASK |= 1ULL << (y * WORLD_MAX_SIZE + x);
+
+  for(int i = 0; i < POSITION_POINTS_MAX; i++) {
+    this->POINT_QUADS[i] = 0;
+    this->POINT_CONFIGS[i] = 0;
+
+    for(int j = 0; j < this->QUAD_COUNT; j++)
+      this->POINT_QUADS[i] |= (uint64_t) (this->QUAD_MASKS[j] >> i & 1) << j;
+
+    for(int j = 0; j < this->CONFIG_COUNT; j++)
+      this->POINT_CONFIGS[i] |= (uint64_t) (this->CONFIG_MASKS[j] >> i & 1) << j;
+  }
+}
+
+/**
+ * Returns whether or not two sets of rules play the same game.
+ *
+ * @param   { Rules * }   this    The rules to compare.
+ * @param   { Rules * }   pOther  The rules to compare them to.
+ * @return  { int }               Whether or not they're the same (the patterns have to be in the same order).
+*/
+int Rules_equals(Rules *this, Rules *pOther) {
+  return 
+    this->WORLD_SIZE == pOther->WORLD_SIZE &&
+    this->PLAYER_COUNT == pOther->PLAYER_COUNT &&
+    this->QUAD_COUNT == pOther->QUAD_COUNT &&
+    this->CONFIG_COUNT == pOther->CONFIG_COUNT &&
+    !memcmp(this->QUAD_MASKS, pOther->QUAD_MASKS, this->QUAD_COUNT * sizeof(uint64_t)) &&
+    !memcmp(this->CONFIG_MASKS, pOther->CONFIG_MASKS, this->CONFIG_COUNT * sizeof(uint64_t));
+}
+
+/**
+ * Says what's wrong with the rules being loaded.
+ *
+ * @param   { Rules * }   this    The rules being loaded.
+ * @param   { char * }    sError  What's wrong.
+ * @param   { int }       dLine   The line it's wrong on (0 if it isn't any line in particular).
+ * @return  { int }               Always 0, so a parser can just return this.
+*/
+int Rules_fail(Rules *this, char *sError, int dLine) {
+  this->sError = sError;
+  this->dErrorLine = dLine;
+
+  return 0;
+}
+
+/**
+ * Loads the rules from text (see the top of the file).
+ * The rules are only changed if the whole text makes sense.
+ *
+ * @param   { Rules * }   this    The rules to load into.
+ * @param   { char * }    sText   The text of the rules.
+ * @return  { int }               Whether or not the rules were loaded (if not, sError says why).
+*/
+int Rules_parse(Rules *this, char *sText) {
+  Rules rules;
+  char sLine[256];
+  int dNumArray[2 * POSITION_POINTS_MAX];
+  int dLine = 0;
+  static char sSizeError[64];
+  static char sPlayersError[96];
+
+  snprintf(sSizeError, sizeof(sSizeError), "the size has to be a single number from 1 to %d", POSITION_MAX_SIZE);
+  snprintf(sPlayersError, sizeof(sPlayersError), "the players have to be a single number from 1 to %d (see GAME_PLAYERS)", GAME_PLAYERS);
+
+  Rules_init(&rules);
+
+  while(*sText) {
+    int dLength = strcspn(sText, "\n");
+    char *sArgs;
+    int dNums;
+
+    dLine++;
+
+    if(dLength >= sizeof(sLine))
+      return Rules_fail(this, "the line is too long", dLine);
+
+    memcpy(sLine, sText, dLength);
+    sLine[dLength] = 0;
+    sText += dLength + (sText[dLength] == '\n');
+
+    // Comments and blank lines
+    if(strchr(sLine, '#'))
+      *strchr(sLine, '#') = 0;
+
+    sArgs = sLine + strspn(sLine, " \t\r");
+
+    if(!*sArgs)
+      continue;
+
+    // The keyword, then its numbers
+    dLength = strcspn(sArgs, " \t\r(");
+    dNums = Rules_readNumbers(sArgs + dLength, dNumArray, 2 * POSITION_POINTS_MAX);
+
+    if(dNums == -2)
+      return Rules_fail(this, "a number is too long", dLine);
+
+    if(dNums < 0)
+      return Rules_fail(this, "only numbers can follow the keyword", dLine);
+
+    if(dLength == 4 && !strncmp(sArgs, "size", 4)) {
+      if(dNums != 1 || dNumArray[0] < 1 || dNumArray[0] > POSITION_MAX_SIZE)
+        return Rules_fail(this, sSizeError, dLine);
+
+      rules.WORLD_SIZE = dNumArray[0];
+
+    } else if(dLength == 7 && !strncmp(sArgs, "players", 7)) {
+      if(dNums != 1 || dNumArray[0] < 1 || dNumArray[0] > GAME_PLAYERS)
+        return Rules_fail(this, sPlayersError, dLine);
+
+      rules.PLAYER_COUNT = dNumArray[0];
+
+    } else if((dLength == 4 && !strncmp(sArgs, "quad", 4)) || (dLength == 6 && !strncmp(sArgs, "config", 6))) {
+      int bIsQuad = dLength == 4;
+      uint64_t dMask = 0;
+
+      if(!dNums || dNums % 2)
+        return Rules_fail(this, "a pattern needs at least one point, and every point needs two numbers", dLine);
+
+      for(int i = 0; i < dNums; i += 2) {
+        if(dNumArray[i] < 1 || dNumArray[i + 1] < 1 || dNumArray[i] > POSITION_MAX_SIZE || dNumArray[i + 1] > POSITION_MAX_SIZE)
+          return Rules_fail(this, "the point is outside of any world", dLine);
+
+        dMask |= 1ULL << ((dNumArray[i + 1] - 1) * WORLD_MAX_SIZE + dNumArray[i] - 1);
+      }
+
+      if(bIsQuad) {
+        if(rules.QUAD_COUNT == RULES_MAX_QUADS)
+          return Rules_fail(this, "there are too many quads", dLine);
+
+        rules.QUAD_MASKS[rules.QUAD_COUNT++] = dMask;
+      } else {
+        if(rules.CONFIG_COUNT == RULES_MAX_CONFIGS)
+          return Rules_fail(this, "there are too many configs", dLine);
+
+        rules.CONFIG_MASKS[rules.CONFIG_COUNT++] = dMask;
+      }
+
+    } else return Rules_fail(this, "the keyword isn't size, players, quad or config", dLine);
+  }
+
+  // The things that can only be checked once everything's in
+  if(!rules.WORLD_SIZE || !rules.PLAYER_COUNT)
+    return Rules_fail(this, "the size or the number of players is missing", 0);
+
+  if(!rules.CONFIG_COUNT)
+    return Rules_fail(this, "there has to be at least one config", 0);
+
+  Rules_compile(&rules);
+
+  for(int i = 0; i < rules.QUAD_COUNT; i++)
+    if(rules.QUAD_MASKS[i] & ~rules.WORLD_MASK)
+      return Rules_fail(this, "a quad has a point outside of the world", 0);
+
+  for(int i = 0; i < rules.CONFIG_COUNT; i++)
+    if(rules.CONFIG_MASKS[i] & ~rules.WORLD_MASK)
+      return Rules_fail(this, "a config has a point outside of the world", 0);
+
+  *this = rules;
+
+  return 1;
+}
+
+/**
+ * Loads the rules from a file (see the top of the file).
+ *
+ * @param   { Rules * }   this    The rules to load into.
+ * @param   { char * }    sPath   Where the rule file is.
+ * @return  { int }               Whether or not the rules were loaded (if not, sError says why).
+*/
+int Rules_load(Rules *this, char *sPath) {
+  static char sText[RULES_MAX_TEXT + 1];
+  FILE *pFile = fopen(sPath, "rb");
+  size_t dSize;
+
+  if(pFile == NULL)
+    return Rules_fail(this, "the rule file couldn't be opened", 0);
+
+  dSize = fread(sText, 1, RULES_MAX_TEXT + 1, pFile);
+  fclose(pFile);
+
+  if(dSize > RULES_MAX_TEXT)
+    return Rules_fail(this, "the rule file is too big", 0);
+
+  sText[dSize] = 0;
+
+  return Rules_parse(this, sText);
+}
+
+#endif
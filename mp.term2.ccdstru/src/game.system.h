@@ -12,14 +12,186 @@
 
 #include "./classes/player.class.h"
 #include "./classes/world.class.h"
+#include "game.rules.h"
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-#define GAME_PLAYERS 2
-#define GAME_WORLD_SIZE 6
+// The worlds of a position come in pairs (see Position_getWinners()), so an odd number of players gets an empty one at the end
+#define POSITION_WORLDS ((GAME_PLAYERS + 1) / 2 * 2)
 
-#define GAME_WIN_QUADS 2
-#define GAME_WIN_CONFIGS 4
+// The most moves a game can last
+#define GAME_MAX_MOVES (POSITION_MAX_SIZE * POSITION_MAX_SIZE)
+
+// The last row of the first world never holds any points (see POSITION_MAX_SIZE), so that's where the turn and the over-state go
+#define POSITION_STATE_SHIFT (WORLD_MAX_SIZE * POSITION_MAX_SIZE)
+#define POSITION_POINTS ((1ULL << POSITION_STATE_SHIFT) - 1)
+#define POSITION_TURN (0x7ULL << POSITION_STATE_SHIFT)
+#define POSITION_OVER (1ULL << 63)
+
+/**
+ * //
+ * ////
+ * //////    Position infrastructure
+ * ////////
+ * ////////// 
+*/
+
+/**
+ * A whole position of the game: the world of every player as a mask (see World_getMask()), side by side,
+ * with the turn and the over-state tucked into the first one. Players the rules don't have just keep an empty world.
+ * There's nothing to allocate or point to, so a position can be copied, compared or stored with a single assignment.
+*/
+typedef struct Position Position;
+
+struct Position {
+  uint64_t worlds[POSITION_WORLDS];
+};
+
+// Two worlds side by side, which is what a 128-bit register holds (SSE2 and NEON both have one)
+#ifdef __GNUC__
+typedef uint64_t PositionPair __attribute__ ((vector_size (2 * sizeof(uint64_t))));
+#endif
+
+/**
+ * Returns the bit of a point in the world masks.
+ * 
+ * @param   { int }       x   A x-coordinate in the world space.
+ * @param   { int }       y   A y-coordinate in the world space.
+ * @return  { uint64_t }      The bit of the point.
+*/
+uint64_t Position_getBit(int x, int y) {
+  return 1ULL << (y * WORLD_MAX_SIZE + x);
+}
+
+/**
+ * Returns the points a player has.
+ * 
+ * @param   { Position * }  this    The position to read.
+ * @param   { int }         dTurn   The player.
+ * @return  { uint64_t }            The points of the player.
+*/
+uint64_t Position_getWorld(Position *this, int dTurn) {
+  return this->worlds[dTurn] & POSITION_POINTS;
+}
+
+/**
+ * Returns the points any of the players have.
+ * The worlds of every player are OR-ed together, empty or not, so this takes the same time however many players there are.
+ * 
+ * @param   { Position * }  this  The position to read.
+ * @return  { uint64_t }          The points that have been taken.
+*/
+uint64_t Position_getTaken(Position *this) {
+  uint64_t dTaken = 0;
+
+  for(int i = 0; i < POSITION_WORLDS; i++)
+    dTaken |= this->worlds[i];
+
+  return dTaken & POSITION_POINTS;
+}
+
+/**
+ * Returns which players have any of the given patterns.
+ * The worlds are checked two at a time (with the vector extensions of GCC or clang), so 8 players only cost
+ * 4 passes over the patterns, and pairs of players with nothing yet are skipped outright.
+ * 
+ * @param   { Position * }  this          The position to read.
+ * @param   { uint64_t * }  dMaskArray    The patterns, as masks of the world.
+ * @param   { int }         dMasks        How many patterns there are.
+ * @return  { int }                       A mask of the players that have at least one of them (bit i is player i).
+*/
+int Position_getWinners(Position *this, uint64_t *dMaskArray, int dMasks) {
+  int dWinners = 0;
+
+  for(int i = 0; i < POSITION_WORLDS; i += 2) {
+
+    // Patterns are never empty, so an empty world can't have one
+    if(!(this->worlds[i] | this->worlds[i + 1]))
+      continue;
+
+    #ifdef __GNUC__
+      PositionPair worlds, misses, losers = { 1, 1 };
+      uint64_t dLoserArray[2];
+
+      memcpy(&worlds, &this->worlds[i], sizeof(worlds));
+
+      // A lane stays 1 as long as every pattern is missing a point of its world; (x | -x) >> 63 is 1 unless x is 0,
+      // which SSE2 can do even though it can't compare 64-bit lanes
+      for(int j = 0; j < dMasks; j++) {
+        misses = dMaskArray[j] & ~worlds;
+        losers &= (misses | -misses) >> 63;
+      }
+
+      memcpy(dLoserArray, &losers, sizeof(losers));
+      dWinners |= (int) (dLoserArray[0] ^ 1) << i | (int) (dLoserArray[1] ^ 1) << (i + 1);
+    #else
+      for(int j = 0; j < dMasks; j++)
+        for(int k = i; k < i + 2; k++)
+          if((this->worlds[k] & dMaskArray[j]) == dMaskArray[j])
+            dWinners |= 1 << k;
+    #endif
+  }
+
+  return dWinners;
+}
+
+/**
+ * Finds the free points that would complete a pattern for each player: the ones where a pattern is missing
+ * exactly one point of their world. A mask has a single bit when clearing its lowest bit leaves nothing.
+ * 
+ * @param   { Position * }  this          The position to read.
+ * @param   { int }         dPlayers      How many players to find the points of.
+ * @param   { uint64_t * }  dMaskArray    The patterns, as masks of the world.
+ * @param   { int }         dMasks        How many patterns there are.
+ * @param   { uint64_t * }  dHintArray    Where the points of each player are added (as a mask of the world).
+*/
+void Position_addHints(Position *this, int dPlayers, uint64_t *dMaskArray, int dMasks, uint64_t *dHintArray) {
+  uint64_t dFree = ~Position_getTaken(this);
+
+  for(int i = 0; i < dPlayers; i++) {
+    uint64_t dWorld = Position_getWorld(this, i);
+
+    for(int j = 0; j < dMasks; j++) {
+      uint64_t dMissing = dMaskArray[j] & ~dWorld;
+
+      if(dMissing && !(dMissing & (dMissing - 1)))
+        dHintArray[i] |= dMissing & dFree;
+    }
+  }
+}
+
+/**
+ * Returns whose turn it is.
+ * 
+ * @param   { Position * }  this  The position to read.
+ * @return  { int }               The player whose turn it is.
+*/
+int Position_getTurn(Position *this) {
+  return (this->worlds[0] & POSITION_TURN) >> POSITION_STATE_SHIFT;
+}
+
+/**
+ * Gives the turn to a player.
+ * 
+ * @param   { Position * }  this    The position to update.
+ * @param   { int }         dTurn   The player whose turn it is.
+*/
+void Position_setTurn(Position *this, int dTurn) {
+  this->worlds[0] = (this->worlds[0] & ~POSITION_TURN) | (uint64_t) dTurn << POSITION_STATE_SHIFT;
+}
+
+/**
+ * Returns whether or not the game is over.
+ * 
+ * @param   { Position * }  this  The position to read.
+ * @return  { int }               Whether or not the game is over.
+*/
+int Position_isOver(Position *this) {
+  return this->worlds[0] & POSITION_OVER ? 1 : 0;
+}
 
 /**
  * //
@@ -38,82 +210,73 @@ typedef struct System System;
 
 struct System {
 
-  // The winning configurations
-  World *WIN_QUADS[GAME_WIN_QUADS];
-  World *WIN_CONFIGS[GAME_WIN_CONFIGS];
-  
-  // The different players
-  Player *PLAYERS[GAME_PLAYERS];
+  // The rules being played, compiled into masks (see game.rules.h)
+  Rules RULES;
 
   // Game constants
   int WORLD_SIZE;
   int TURN_COUNT;
 
-  // Some other game states
-  int turnState;
-  int overState;
+  // The current position (it has whose turn it is and whether or not the game is over)
+  Position position;
+
+  // The position before each move and the point of each move, so a move can be taken back or made again;
+  // moveIndex is how many moves have been made, and moveCount is how many of them can be made again after taking some back
+  Position positionHistory[GAME_MAX_MOVES];
+  uint8_t moveHistory[GAME_MAX_MOVES];
+  int moveIndex;
+  int moveCount;
+
+  // The hints of the last position they were asked for (see System_getHints() and System_getQuadHints())
+  Position hintPosition;
+  uint64_t hintArray[GAME_PLAYERS];
+  uint64_t quadHintArray[GAME_PLAYERS];
+  int bHintsReady;
 };
 
 /**
- * Initializes the system variables
+ * Initializes the system variables with a set of rules.
+ * 
+ * @param   { System * }  this    The system to be initialized.
+ * @param   { Rules * }   pRules  The rules to play by (they're copied).
+ * @return  { System * }          The initialized system.
+*/
+System *System_initRules(System *this, Rules *pRules) {
+
+  // Defining some game constants
+  this->RULES = *pRules;
+  this->WORLD_SIZE = pRules->WORLD_SIZE;
+  this->TURN_COUNT = pRules->PLAYER_COUNT;
+
+  // Game variables (the first player goes first, and the game isn't over)
+  this->position = (Position) { { 0 } };
+  this->moveIndex = 0;
+  this->moveCount = 0;
+  this->bHintsReady = 0;
+
+  return this;
+}
+
+/**
+ * Initializes the system variables with the rules of the machine project.
  * 
  * @param   { System * }  this  The system to be initialized.
  * @return  { System * }        The initialized system.
 */
 System *System_init(System *this) {
+  Rules rules;
 
-  // Defining some game constants
-  this->WORLD_SIZE = GAME_WORLD_SIZE;
-  this->TURN_COUNT = GAME_PLAYERS;
-
-  // Game variables
-  this->turnState = 0;  // The first player
-  this->overState = 0;  // Initially false
-
-  // The players
-  for(int i = 0; i < GAME_PLAYERS; i++)
-    this->PLAYERS[i] = Player_create();
-
-  // The quadrant configurations
-  this->WIN_QUADS[0] = World_create();
-  World_setBit(this->WIN_QUADS[0], 0, 0, 1);  // (1, 1)
-  World_setBit(this->WIN_QUADS[0], 1, 1, 1);  // (2, 2)
-
-  this->WIN_QUADS[1] = World_create();
-  World_setBit(this->WIN_QUADS[1], 0, 1, 1);  // (1, 2)
-  World_setBit(this->WIN_QUADS[1], 1, 0, 1);  // (2, 1)
-  
-  // The winning configurations  
-  this->WIN_CONFIGS[0] = World_create();
-  World_setBit(this->WIN_CONFIGS[0], 0, 0, 1);  // (1, 1)
-  World_setBit(this->WIN_CONFIGS[0], 0, 2, 1);  // (1, 3)
-  World_setBit(this->WIN_CONFIGS[0], 1, 1, 1);  // (2, 2)
-  World_setBit(this->WIN_CONFIGS[0], 2, 0, 1);  // (3, 1)
-  World_setBit(this->WIN_CONFIGS[0], 2, 2, 1);  // (3, 3)
-
-  this->WIN_CONFIGS[1] = World_create();
-  World_setBit(this->WIN_CONFIGS[1], 3, 3, 1);  // (4, 4)
-  World_setBit(this->WIN_CONFIGS[1], 3, 5, 1);  // (4, 6)
-  World_setBit(this->WIN_CONFIGS[1], 4, 4, 1);  // (5, 5)
-  World_setBit(this->WIN_CONFIGS[1], 5, 3, 1);  // (6, 4)
-  World_setBit(this->WIN_CONFIGS[1], 5, 5, 1);  // (6, 6)
-
-  this->WIN_CONFIGS[2] = World_create();
-  World_setBit(this->WIN_CONFIGS[2], 0, 4, 1);  // (1, 5)
-  World_setBit(this->WIN_CONFIGS[2], 1, 3, 1);  // (2, 4)
-  World_setBit(this->WIN_CONFIGS[2], 1, 4, 1);  // (2, 5)
-  World_setBit(this->WIN_CONFIGS[2], 1, 5, 1);  // (2, 6)
-  World_setBit(this->WIN_CONFIGS[2], 2, 4, 1);  // (3, 5)
-
-  this->WIN_CONFIGS[3] = World_create();
-  World_setBit(this->WIN_CONFIGS[3], 3, 0, 1);  // (4, 1)
-  World_setBit(this->WIN_CONFIGS[3], 3, 2, 1);  // (4, 3)
-  World_setBit(this->WIN_CONFIGS[3], 4, 0, 1);  // (5, 1)
-  World_setBit(this->WIN_CONFIGS[3], 4, 2, 1);  // (5, 3)
-  World_setBit(this->WIN_CONFIGS[3], 5, 0, 1);  // (6, 1)
-  World_setBit(this->WIN_CONFIGS[3], 5, 2, 1);  // (6, 3)
+  // The built-in rules should always load; a world of size 0 would only break later, far from here
+  Rules_init(&rules);
 
-  return this;
+  if(!Rules_parse(&rules, RULES_DEFAULT)) {
+    if(rules.dErrorLine) fprintf(stderr, "Couldn't load the built-in rules: %s (line %d).\n", rules.sError, rules.dErrorLine);
+    else fprintf(stderr, "Couldn't load the built-in rules: %s.\n", rules.sError);
+
+    abort();
+  }
+
+  return System_initRules(this, &rules);
 }
 
 /**
@@ -132,8 +295,118 @@ System *System_init(System *this) {
 */
 int System_getState(System *this) { 
   return 
-    this->turnState << 1 & 
-    this->overState;
+    Position_getTurn(&this->position) << 1 & 
+    Position_isOver(&this->position);
+}
+
+/**
+ * Returns whose turn it is.
+ * 
+ * @param   { System * }  this  The system to read.
+ * @return  { int }             The player whose turn it is (or who ended the game).
+*/
+int System_getTurn(System *this) {
+  return Position_getTurn(&this->position);
+}
+
+/**
+ * Returns whether or not the game is over.
+ * 
+ * @param   { System * }  this  The system to read.
+ * @return  { int }             Whether or not the game is over.
+*/
+int System_isOver(System *this) {
+  return Position_isOver(&this->position);
+}
+
+/**
+ * Returns the current position.
+ * The position is only good until the next move; copy it to keep it.
+ * 
+ * @param   { System * }    this  The system to read.
+ * @return  { Position * }        The current position.
+*/
+Position *System_getPosition(System *this) {
+  return &this->position;
+}
+
+/**
+ * Returns how many moves have been made.
+ * 
+ * @param   { System * }  this  The system to read.
+ * @return  { int }             The number of moves.
+*/
+int System_getMoveIndex(System *this) {
+  return this->moveIndex;
+}
+
+/**
+ * Returns how many moves the game has, including the ones that were taken back and can be made again.
+ * 
+ * @param   { System * }  this  The system to read.
+ * @return  { int }             The number of moves.
+*/
+int System_getMoveCount(System *this) {
+  return this->moveCount;
+}
+
+/**
+ * Works out the hints again if the position changed since the last time, so asking every frame costs nothing.
+ * The configurations and the quads are kept apart, since only a configuration ends the game (see System_update()).
+ * 
+ * @param   { System * }  this  The system to read.
+*/
+void System_findHints(System *this) {
+  if(this->bHintsReady && !memcmp(&this->hintPosition, &this->position, sizeof(Position)))
+    return;
+
+  memset(this->hintArray, 0, sizeof(this->hintArray));
+  memset(this->quadHintArray, 0, sizeof(this->quadHintArray));
+
+  Position_addHints(&this->position, this->TURN_COUNT, 
+    this->RULES.CONFIG_MASKS, this->RULES.CONFIG_COUNT, this->hintArray);
+  Position_addHints(&this->position, this->TURN_COUNT, 
+    this->RULES.QUAD_MASKS, this->RULES.QUAD_COUNT, this->quadHintArray);
+
+  this->hintPosition = this->position;
+  this->bHintsReady = 1;
+}
+
+/**
+ * Returns the free points that would complete a winning configuration for each player.
+ * 
+ * @param   { System * }    this  The system to read.
+ * @return  { uint64_t * }        The points of each player, as masks of the world (players the rules don't have get 0).
+*/
+uint64_t *System_getHints(System *this) {
+  System_findHints(this);
+
+  return this->hintArray;
+}
+
+/**
+ * Returns the free points that would complete a quad for each player.
+ * 
+ * @param   { System * }    this  The system to read.
+ * @return  { uint64_t * }        The points of each player, as masks of the world (players the rules don't have get 0).
+*/
+uint64_t *System_getQuadHints(System *this) {
+  System_findHints(this);
+
+  return this->quadHintArray;
+}
+
+/**
+ * Returns the point of one of the moves.
+ * 
+ * @param   { System * }  this    The system to read.
+ * @param   { int }       dMove   Which move (from 0 to the move count).
+ * @param   { int * }     pX      Where the x-coordinate of the point goes.
+ * @param   { int * }     pY      Where the y-coordinate of the point goes.
+*/
+void System_getMove(System *this, int dMove, int *pX, int *pY) {
+  *pX = this->moveHistory[dMove] % WORLD_MAX_SIZE;
+  *pY = this->moveHistory[dMove] / WORLD_MAX_SIZE;
 }
 
 /**
@@ -144,30 +417,195 @@ int System_getState(System *this) {
  * ////////// 
 */
 
+/**
+ * Updates the current turn value stored by the system.
+ * 
+ * @param   { System * }  this  The system to be updated.
+*/
+void System_turn(System *this) {
+  int dTurn = Position_getTurn(&this->position) + 1;
+
+  Position_setTurn(&this->position, dTurn == this->TURN_COUNT ? 0 : dTurn);
+}
+
+/**
+ * Returns whether or not a point in the world space has been taken by any of the players yet.
+ * 
+ * @param   { System * }  this  The system to read.
+ * @param   { int }       x     A x-coordinate in the world space.
+ * @param   { int }       y     A y-coordinate in the world space.
+ * @return  { int }             Whether or not the point is still free (out of bounds points never are).
+*/
+int System_isFree(System *this, int x, int y) {
+  if(x < 0 || y < 0 || x >= this->WORLD_SIZE || y >= this->WORLD_SIZE)
+    return 0;
+
+  return !(Position_getTaken(&this->position) & Position_getBit(x, y));
+}
+
+/**
+ * Returns whether or not a player has any of the winning configurations.
+ * 
+ * @param   { System * }  this    The system to read.
+ * @param   { int }       dTurn   The player to check.
+ * @return  { int }               Whether or not the player has won.
+*/
+int System_hasWon(System *this, int dTurn) {
+  uint64_t dWorld = Position_getWorld(&this->position, dTurn);
+
+  for(int i = 0; i < this->RULES.CONFIG_COUNT; i++)
+    if((dWorld & this->RULES.CONFIG_MASKS[i]) == this->RULES.CONFIG_MASKS[i])
+      return 1;
+
+  return 0;
+}
+
+/**
+ * Returns which players have any of the winning configurations, all of them in one pass.
+ * 
+ * @param   { System * }  this  The system to read.
+ * @return  { int }             A mask of the players that have won (bit i is player i).
+*/
+int System_getWinners(System *this) {
+  return Position_getWinners(&this->position, this->RULES.CONFIG_MASKS, this->RULES.CONFIG_COUNT);
+}
+
+/**
+ * Returns whether or not a point just gave a player one of the winning configurations.
+ * Only the configurations the point is part of are checked, since the others were already checked before.
+ * 
+ * @param   { System * }  this    The system to read.
+ * @param   { int }       dTurn   The player to check.
+ * @param   { int }       dPoint  The point they just took (see Position_getBit()).
+ * @return  { int }               Whether or not the player has won.
+*/
+int System_hasWonAt(System *this, int dTurn, int dPoint) {
+  uint64_t dWorld = Position_getWorld(&this->position, dTurn);
+  uint64_t dConfigs = this->RULES.POINT_CONFIGS[dPoint];
+
+  while(dConfigs) {
+    int i = Rules_nextPattern(&dConfigs);
+
+    if((dWorld & this->RULES.CONFIG_MASKS[i]) == this->RULES.CONFIG_MASKS[i])
+      return 1;
+  }
+
+  return 0;
+}
+
+/**
+ * Returns whether or not every point in the world space has been taken.
+ * 
+ * @param   { System * }  this  The system to read.
+ * @return  { int }             Whether or not the world is full.
+*/
+int System_isFull(System *this) {
+  return Position_getTaken(&this->position) == this->RULES.WORLD_MASK;
+}
+
 /**
  * Updates the current state of the system.
  * Coordinates to a point within the world space are needed per update of the system.
+ * The point goes to the player whose turn it is; if that gives them a winning configuration (or fills up the world),
+ * the game is over and the turn stays with them. Otherwise, the turn passes to the next player.
+ * The position before the move is kept, so System_undo() only has to copy it back.
  * 
  * @param   { System * }  this  The system to update.
  * @param   { int }       x     A x-coordinate in the world space.
  * @param   { int }       y     A y-coordinate in the world space.
+ * @return  { int }             Whether or not the move was made (it isn't if the point was taken or the game is over).
 */
-void System_update(System *this, int x, int y) {
+int System_update(System *this, int x, int y) {
+  int dTurn = Position_getTurn(&this->position);
+  int dPoint = y * WORLD_MAX_SIZE + x;
+
+  // Check for the validity of the coordinates first
+  if(Position_isOver(&this->position) || !System_isFree(this, x, y))
+    return 0;
+
+  this->positionHistory[this->moveIndex] = this->position;
+  this->position.worlds[dTurn] |= Position_getBit(x, y);
 
-  // ! Check for the validity of the coordinates first
+  // Did that end the game?
+  if(System_hasWonAt(this, dTurn, dPoint) || System_isFull(this))
+    this->position.worlds[0] |= POSITION_OVER;
+  else
+    System_turn(this);
 
+  // A different move than the one that was taken back means the moves after it can't be made again
+  if(this->moveIndex == this->moveCount || this->moveHistory[this->moveIndex] != dPoint)
+    this->moveCount = this->moveIndex + 1;
 
-  // * Player_updateWorld(this->PLAYERS[this->turnState], x, y);
+  this->moveHistory[this->moveIndex++] = dPoint;
+
+  return 1;
 }
 
 /**
- * Updates the current turn value stored by the system.
+ * Takes back the last move made with System_update().
+ * This is what lets the search try a move and then go back, instead of copying the whole system every time.
  * 
- * @param   { System * }  this  The system to be updated.
+ * @param   { System * }  this  The system to update.
+ * @return  { int }             Whether or not there was a move to take back.
 */
-void System_turn(System *this) {
-  this->turnState += 1;
-  this->turnState %= this->TURN_COUNT;
+int System_undo(System *this) {
+  if(!this->moveIndex)
+    return 0;
+
+  this->position = this->positionHistory[--this->moveIndex];
+
+  return 1;
+}
+
+/**
+ * Makes the last move that was taken back again.
+ * 
+ * @param   { System * }  this  The system to update.
+ * @return  { int }             Whether or not there was a move to make again.
+*/
+int System_redo(System *this) {
+  int x, y;
+
+  if(this->moveIndex == this->moveCount)
+    return 0;
+
+  System_getMove(this, this->moveIndex, &x, &y);
+
+  return System_update(this, x, y);
+}
+
+/**
+ * Goes to the position after a given number of moves, taking moves back or making them again as needed.
+ * Going back is a single copy, since the position before every move is kept.
+ * 
+ * @param   { System * }  this    The system to update.
+ * @param   { int }       dMove   How many moves in (from 0 to the move count).
+ * @return  { int }               Whether or not there were that many moves.
+*/
+int System_seek(System *this, int dMove) {
+  if(dMove < 0 || dMove > this->moveCount)
+    return 0;
+
+  if(dMove < this->moveIndex) {
+    this->position = this->positionHistory[dMove];
+    this->moveIndex = dMove;
+  }
+
+  while(this->moveIndex < dMove)
+    System_redo(this);
+
+  return 1;
+}
+
+/**
+ * Clears the worlds of the players and gives the first turn back to the first player.
+ * 
+ * @param   { System * }  this  The system to reset.
+*/
+void System_reset(System *this) {
+  this->position = (Position) { { 0 } };
+  this->moveIndex = 0;
+  this->moveCount = 0;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,256 @@
+/**
+ * @ Description:
+ *    Draws the world of the game, with an overlay of hints when they're turned on.
+ *    Everything the UI draws every frame goes into buffers and color codes it made when it started,
+ *    so a frame never allocates anything and drawing never gets in the way of reading the next key.
+ */
+
+#ifndef GAME_UI_
+#define GAME_UI_
+
+#include "game.system.h"
+#include "./utils/utils.buffer.h"
+#include "./utils/utils.graphics.h"
+#include "./utils/utils.io.h"
+
+#include <stdio.h>
+
+// The colors of the world
+#define UI_COLOR_POINT 0x2c2c2c     // A free point
+#define UI_COLOR_CURSOR 0x5a5a5a    // The point under the cursor
+#define UI_COLOR_WIN 0x1f6f3a       // A free point that would complete a configuration (and win) for the player whose turn it is
+#define UI_COLOR_THREAT 0x8a2323    // A free point that would complete a configuration for somebody else
+#define UI_COLOR_QUAD 0x25507a      // A free point that would complete a quad (which doesn't end the game) for the player whose turn it is
+#define UI_COLOR_TEXT 0xdadada
+
+// What each player's points look like
+#define UI_PLAYER_GLYPHS "XOABCDEF"
+
+/**
+ * The colors of the players (as many as GAME_PLAYERS can go up to).
+*/
+const int UI_PLAYER_COLORS[] = {
+  0xf2c14e, 0x5fa8d3, 0xe76f51, 0x8ac926, 0xc77dff, 0xff70a6, 0x2ec4b6, 0xffffff
+};
+
+/**
+ * //
+ * ////
+ * //////    UI object infrastructure
+ * ////////
+ * //////////
+*/
+
+/**
+ * This singleton stores everything the UI draws with.
+*/
+typedef struct UI UI;
+
+struct UI {
+
+  // A buffer per row of the world
+  Buffer *pRowArray[POSITION_MAX_SIZE];
+
+  // The color codes, made once
+  char *sPointCode;
+  char *sCursorCode;
+  char *sWinCode;
+  char *sThreatCode;
+  char *sQuadCode;
+  char *sTextCode;
+  char *sPlayerCodeArray[GAME_PLAYERS];
+
+  // Where the cursor is, and whether or not the hints are shown (and the bot is on)
+  int dCursorX;
+  int dCursorY;
+  int bHints;
+  int bBot;
+};
+
+/**
+ * Initializes the UI, making all the buffers and color codes it will need.
+ *
+ * @param   { UI * }  this  The UI to be initialized.
+ * @return  { UI * }        The initialized UI.
+*/
+UI *UI_init(UI *this) {
+
+  // A cell is 3 characters wide
+  for(int i = 0; i < POSITION_MAX_SIZE; i++)
+    this->pRowArray[i] = Buffer_create(POSITION_MAX_SIZE * 3);
+
+  this->sPointCode = Graphics_getCodeBG(UI_COLOR_POINT);
+  this->sCursorCode = Graphics_getCodeBG(UI_COLOR_CURSOR);
+  this->sWinCode = Graphics_getCodeBG(UI_COLOR_WIN);
+  this->sThreatCode = Graphics_getCodeBG(UI_COLOR_THREAT);
+  this->sQuadCode = Graphics_getCodeBG(UI_COLOR_QUAD);
+  this->sTextCode = Graphics_getCodeFG(UI_COLOR_TEXT);
+
+  for(int i = 0; i < GAME_PLAYERS; i++)
+    this->sPlayerCodeArray[i] = Graphics_getCodeFG(UI_PLAYER_COLORS[i]);
+
+  this->dCursorX = 0;
+  this->dCursorY = 0;
+  this->bHints = 0;
+  this->bBot = 0;
+
+  return this;
+}
+
+/**
+ * Gives back everything the UI made.
+ *
+ * @param   { UI * }  this  The UI to clean up.
+*/
+void UI_exit(UI *this) {
+  for(int i = 0; i < POSITION_MAX_SIZE; i++)
+    Buffer_kill(this->pRowArray[i]);
+
+  Mem_free(this->sPointCode);
+  Mem_free(this->sCursorCode);
+  Mem_free(this->sWinCode);
+  Mem_free(this->sThreatCode);
+  Mem_free(this->sQuadCode);
+  Mem_free(this->sTextCode);
+
+  for(int i = 0; i < GAME_PLAYERS; i++)
+    Mem_free(this->sPlayerCodeArray[i]);
+}
+
+/**
+ * //
+ * ////
+ * //////    UI operations
+ * ////////
+ * //////////
+*/
+
+/**
+ * Turns the hints on or off.
+ *
+ * @param   { UI * }  this  The UI to update.
+*/
+void UI_toggleHints(UI *this) {
+  this->bHints = !this->bHints;
+}
+
+/**
+ * Shows the bot as on or off.
+ *
+ * @param   { UI * }  this  The UI to update.
+*/
+void UI_toggleBot(UI *this) {
+  this->bBot = !this->bBot;
+}
+
+/**
+ * Moves the cursor, keeping it inside the world.
+ *
+ * @param   { UI * }      this      The UI to update.
+ * @param   { System * }  pSystem   The system whose world the cursor is on.
+ * @param   { int }       dX        How far to move it along x.
+ * @param   { int }       dY        How far to move it along y.
+*/
+void UI_moveCursor(UI *this, System *pSystem, int dX, int dY) {
+  this->dCursorX = (this->dCursorX + dX + pSystem->WORLD_SIZE) % pSystem->WORLD_SIZE;
+  this->dCursorY = (this->dCursorY + dY + pSystem->WORLD_SIZE) % pSystem->WORLD_SIZE;
+}
+
+/**
+ * Draws one row of the world into its buffer.
+ * The hints come from System_getHints() and System_getQuadHints(), which only work them out again after a move.
+ *
+ * @param   { UI * }        this            The UI to draw with.
+ * @param   { System * }    pSystem         The system to draw.
+ * @param   { uint64_t * }  dHintArray      The configurations each player could complete (NULL if the hints are off).
+ * @param   { uint64_t * }  dQuadHintArray  The quads each player could complete (NULL if the hints are off).
+ * @param   { int }         y               The row to draw.
+ * @return  { Buffer * }                    The buffer of the row.
+*/
+Buffer *UI_renderRow(UI *this, System *pSystem, uint64_t *dHintArray, uint64_t *dQuadHintArray, int y) {
+  Buffer *pRow = this->pRowArray[y];
+  Position *pPosition = System_getPosition(pSystem);
+  int dTurn = System_getTurn(pSystem);
+  char sGlyph[4] = "   ";
+
+  Buffer_resetText(pRow);
+
+  for(int x = 0; x < pSystem->WORLD_SIZE; x++) {
+    uint64_t dBit = Position_getBit(x, y);
+    char *sBackground = this->sPointCode;
+    char *sForeground = this->sTextCode;
+
+    sGlyph[1] = '.';
+
+    // Whose point it is
+    for(int i = 0; i < pSystem->TURN_COUNT; i++) {
+      if(Position_getWorld(pPosition, i) & dBit) {
+        sGlyph[1] = UI_PLAYER_GLYPHS[i];
+        sForeground = this->sPlayerCodeArray[i];
+      }
+    }
+
+    // A win for the player whose turn it is matters more than one for somebody else, and both matter more than a quad
+    if(dHintArray != NULL) {
+      if(dQuadHintArray[dTurn] & dBit)
+        sBackground = this->sQuadCode;
+
+      for(int i = 0; i < pSystem->TURN_COUNT; i++)
+        if(i != dTurn && dHintArray[i] & dBit)
+          sBackground = this->sThreatCode;
+
+      if(dHintArray[dTurn] & dBit)
+        sBackground = this->sWinCode;
+    }
+
+    if(x == this->dCursorX && y == this->dCursorY)
+      sBackground = this->sCursorCode;
+
+    Buffer_addText(pRow, sBackground);
+    Buffer_addText(pRow, sForeground);
+    Buffer_addText(pRow, sGlyph);
+  }
+
+  return pRow;
+}
+
+/**
+ * Draws the whole world, then whose turn it is.
+ *
+ * @param   { UI * }      this      The UI to draw with.
+ * @param   { System * }  pSystem   The system to draw.
+*/
+void UI_render(UI *this, System *pSystem) {
+  int dTurn = System_getTurn(pSystem);
+  uint64_t *dHintArray = NULL;
+  uint64_t *dQuadHintArray = NULL;
+
+  // There's nothing left to hint at once the game is over
+  if(this->bHints && !System_isOver(pSystem)) {
+    dHintArray = System_getHints(pSystem);
+    dQuadHintArray = System_getQuadHints(pSystem);
+  }
+
+  IO_clear();
+
+  for(int y = 0; y < pSystem->WORLD_SIZE; y++)
+    printf("%s\x1b[0m\n", Buffer_getText(UI_renderRow(this, pSystem, dHintArray, dQuadHintArray, y)));
+
+  if(System_isOver(pSystem) && !System_hasWon(pSystem, dTurn))
+    printf("\n%sThe world is full; nobody won.\x1b[0m\n", this->sTextCode);
+  else
+    printf("\n%s%c%s %s\x1b[0m\n",
+      this->sPlayerCodeArray[dTurn], UI_PLAYER_GLYPHS[dTurn], this->sTextCode,
+      System_isOver(pSystem) ? "won." : "to move.");
+  printf("%s[WASD] move, [space] take, [H] hints %s, [B] bot %s, [Q] quit\x1b[0m\n",
+    this->sTextCode, this->bHints ? "off" : "on", this->bBot ? "off" : "on");
+  printf("%s[U]/[R] undo/redo, [[]/[]] first/last move (move %d of %d)\x1b[0m\n",
+    this->sTextCode, System_getMoveIndex(pSystem), System_getMoveCount(pSystem));
+
+  // What the colors of the hints mean
+  if(dHintArray != NULL)
+    printf("%s%s win \x1b[0m %s%s threat \x1b[0m %s%s quad \x1b[0m\n",
+      this->sWinCode, this->sTextCode, this->sThreatCode, this->sTextCode, this->sQuadCode, this->sTextCode);
+}
+
+#endif
@@ -13,6 +13,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "utils.mem.h"
+
 // Maximum length of a buffer 
 // Includes characters not rendered to the screen, such as:
 //    (1) ANSI Escape Sequences
@@ -58,6 +60,8 @@ int Buffer_updateRenderWidth(Buffer *this);
 
 void Buffer_clearText(Buffer *this);
 
+void Buffer_resetText(Buffer *this);
+
 void Buffer_newText(Buffer *this, char *sNewText);
 
 void Buffer_addText(Buffer *this, char *sAddText);
@@ -76,7 +80,7 @@ void Buffer_addText(Buffer *this, char *sAddText);
  * @return  { Buffer * }  A pointer to the created instance.
 */
 Buffer *Buffer_new() {
-  Buffer *pBuffer = calloc(1, sizeof(*pBuffer));
+  Buffer *pBuffer = Mem_calloc(MEM_BUFFER, 1, sizeof(*pBuffer));
 
   if(pBuffer == NULL)
     return NULL;
@@ -88,7 +92,7 @@ Buffer *Buffer_new() {
  * Initializes an instance of the buffer class.
 */
 Buffer *Buffer_init(Buffer *this, int dRenderWidth) {
-  this->sText = calloc(BUFFER_MAX_LENGTH, sizeof(char));
+  this->sText = Mem_calloc(MEM_BUFFER, BUFFER_MAX_LENGTH, sizeof(char));
 
   this->dWidth = 0;
   this->dRenderWidth = dRenderWidth;
@@ -111,12 +115,13 @@ Buffer *Buffer_create(int dRenderWidth) {
 }
 
 /**
- * Deletes an instance of the buffer class.
+ * Deletes an instance of the buffer class along with its text.
  * 
  * @param   { Buffer * }  A pointer to the instance.
 */
 void Buffer_kill(Buffer *this) {
-  free(this);
+  Mem_free(this->sText);
+  Mem_free(this);
 }
 
 /**
@@ -216,10 +221,21 @@ int Buffer_updateRenderWidth(Buffer *this) {
  * @param   { Buffer * }  this  The buffer instance to be modified.
 */
 void Buffer_clearText(Buffer *this) {
-  free(this->sText);
+  Mem_free(this->sText);
 
   this->dWidth = 0;
-  this->sText = calloc(BUFFER_MAX_LENGTH, sizeof(char));
+  this->sText = Mem_calloc(MEM_BUFFER, BUFFER_MAX_LENGTH, sizeof(char));
+}
+
+/**
+ * Empties a buffer instance without giving its string back, so it can be filled again with no allocation.
+ * This is what the UI uses for anything it draws every frame.
+ * 
+ * @param   { Buffer * }  this  The buffer instance to be modified.
+*/
+void Buffer_resetText(Buffer *this) {
+  this->sText[0] = 0;
+  this->dWidth = 0;
 }
 
 /**
@@ -243,7 +259,10 @@ void Buffer_newText(Buffer *this, char *sNewText) {
  * @param   { char * }    sAddText  The string to be appended.
 */
 void Buffer_addText(Buffer *this, char *sAddText) {
-  snprintf(this->sText, BUFFER_MAX_LENGTH, "%s%s", this->sText, sAddText);
+  int dLen = strlen(this->sText);
+
+  // Write after the current text; passing sText to snprintf() as both the output and an input is undefined
+  snprintf(this->sText + dLen, BUFFER_MAX_LENGTH - dLen, "%s", sAddText);
 
   // Recompute render width
   Buffer_updateRenderWidth(this);
@@ -13,6 +13,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "utils.mem.h"
+
 #define GRAPHICS_MAX_SEQ 32
 
 /**
@@ -37,7 +39,7 @@ char *Graphics_getCodeBG(int color);
  * @return  { char * }          A pointer to the string representing the escape sequence.
 */
 char *Graphics_getCodeFG(int color) {
-  char *sANSISequence = calloc(GRAPHICS_MAX_SEQ, sizeof(char));
+  char *sANSISequence = Mem_calloc(MEM_GRAPHICS, GRAPHICS_MAX_SEQ, sizeof(char));
 
   // Create the ANSI escape sequence and parse the RGB values from the int
   // Note that 
@@ -58,7 +60,7 @@ char *Graphics_getCodeFG(int color) {
  * @return  { char * }          A pointer to the string representing the escape sequence.
 */
 char *Graphics_getCodeBG(int color) {
-  char *sANSISequence = calloc(GRAPHICS_MAX_SEQ, sizeof(char));
+  char *sANSISequence = Mem_calloc(MEM_GRAPHICS, GRAPHICS_MAX_SEQ, sizeof(char));
 
   // Create the ANSI escape sequence and parse the RGB values from the int
   // Note that 
@@ -67,7 +67,7 @@ int IO_setSize(int dWidth, int dHeight);
 
 void IO_clear();
 
-char IO_readChar();
+int IO_readChar();
 
 /**
  * This only exists here because I need to set some stuff up for Unix-based OS's.
@@ -172,10 +172,11 @@ void IO_clear() {
 
 /**
  * Helper function that gets a single character without return key.
+ * It's an int so that EOF can't be mistaken for a key.
  * 
- * @return  { char }  Returns the character read from the conaole.
+ * @return  { int }   Returns the character read from the conaole (or EOF).
 */
-char IO_readChar() {
+int IO_readChar() {
   return getch();
 }
 
@@ -239,7 +240,7 @@ int IO_setSize(int dWidth, int dHeight);
 
 void IO_clear();
 
-char IO_readChar();
+int IO_readChar();
 
 /**
  * Sets up some stuff for IO handling.
@@ -325,10 +326,11 @@ void IO_clear() {
 
 /**
  * Helper function that gets a single character without return key.
+ * It's an int so that EOF can't be mistaken for a key.
  * 
- * @return  { char }  Returns the character read from the conaole.
+ * @return  { int }   Returns the character read from the conaole (or EOF).
 */
-char IO_readChar() {
+int IO_readChar() {
   return getchar();
 }
 
@@ -343,9 +345,11 @@ void IO_exit(IO *this) {
   printf("\x1b[38;5;255m");
   printf("\x1b[48;5;232m");
   
-  for(int i = IO_getHeight(); --i;) 
-    for(int j = IO_getWidth(); --j;) 
-      printf(" ");
+  // Without a terminal there's no size to fill (and the ioctl() leaves it as garbage)
+  if(isatty(0))
+    for(int i = IO_getHeight(); --i;) 
+      for(int j = IO_getWidth(); --j;) 
+        printf(" ");
 
   IO_clear();
 
@@ -0,0 +1,637 @@
+/**
+ * @ Description:
+ *    An accounting layer for heap allocations.
+ *    Every allocation is tagged with the subsystem that made it, and each tag tracks its live bytes, peak bytes and counts.
+ *    A report is written at exit (or when the program receives a signal) listing the tags that leak and the ones that churn.
+ *    Compiling with -DMEM_DEBUG also records the file and line of each call site so the report can point at them.
+ *    The object pools (see utils.pool.h) are listed in a section of their own.
+ */
+
+#ifndef UTILS_MEM_
+#define UTILS_MEM_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Where the report goes; sits beside the compile logs
+#ifndef MEM_REPORT_PATH
+#define MEM_REPORT_PATH "build/mem.txt"
+#endif
+
+#define MEM_MAX_SITES 256           // Call sites tracked in debug mode; must be a power of two
+#define MEM_MAX_REPORT (1 << 14)    // Size of the buffer the report is formatted into
+#define MEM_CHURN_MIN 256           // A tag churns if it has made at least this many allocations...
+#define MEM_CHURN_RATIO 16          // ... and this many times more allocations than its peak number of live blocks
+
+/**
+ * The subsystems an allocation can be charged to.
+*/
+typedef enum MemTag MemTag;
+
+enum MemTag {
+  MEM_MISC,
+  MEM_BUFFER,
+  MEM_GRAPHICS,
+  MEM_WORLD,
+  MEM_PLAYER,
+  MEM_SYSTEM,
+  MEM_BOT,
+  MEM_TAGS
+};
+
+/**
+ * The counters kept for every tag (and every call site in debug mode).
+ * @struct
+*/
+typedef struct MemStats MemStats;
+
+struct MemStats {
+  long dAllocs;       // Number of allocations
+  long dFrees;        // Number of frees
+  long dLiveBlocks;   // Blocks not yet freed
+  long dPeakBlocks;   // Most blocks alive at once
+  long dLiveBytes;    // Bytes not yet freed
+  long dPeakBytes;    // Most bytes alive at once
+  long dTotalBytes;   // Bytes ever requested
+};
+
+/**
+ * A call site; only used in debug mode.
+ * @struct
+*/
+typedef struct MemSite MemSite;
+
+struct MemSite {
+  const char *sFile;
+  int dLine;
+  MemTag eTag;
+
+  MemStats stats;
+};
+
+/**
+ * The bookkeeping placed right before every block.
+ * It's a union so the block after it stays aligned for any type.
+*/
+typedef union MemHeader MemHeader;
+
+union MemHeader {
+  struct {
+    size_t dSize;
+    int eTag;
+    int dSite;
+  } info;
+
+  long double ldAlign;
+  long long llAlign;
+  void *pAlign;
+};
+
+/**
+ * The occupancy counters of an object pool (see utils.pool.h).
+ * Pools register these when first used; they're chained together for the report.
+ * @struct
+*/
+typedef struct MemPool MemPool;
+
+struct MemPool {
+  char *sName;
+
+  long dSlabs;        // Slabs grabbed
+  long dSlots;        // Objects those slabs can hold
+  long dLive;         // Objects handed out and not yet given back
+  long dPeak;         // Most objects handed out at once
+  long dAllocs;       // Objects ever handed out
+  long dFrees;        // Objects ever given back
+
+  void (*fTrim)();    // Returns the slabs if the pool is empty
+  MemPool *pNext;
+};
+
+/**
+ * Stores the state of the accounting layer.
+ * There is only one of these; see Mem_get().
+ * @class
+*/
+typedef struct Mem Mem;
+
+struct Mem {
+  int bIsReady;
+
+  MemStats tags[MEM_TAGS];
+  MemStats total;
+  MemSite sites[MEM_MAX_SITES];
+
+  MemPool *pPools;
+};
+
+// Use these instead of the *At functions so the call site gets recorded
+#define Mem_calloc(eTag, dCount, dSize) Mem_callocAt(eTag, dCount, dSize, __FILE__, __LINE__)
+
+/**
+ * Helpers
+*/
+Mem *Mem_get();
+
+char *Mem_getTagName(MemTag eTag);
+
+void Mem_charge(MemStats *pStats, long dBytes);
+
+int Mem_getSite(MemTag eTag, const char *sFile, int dLine);
+
+void Mem_addPool(MemPool *pPool);
+
+void Mem_chargePool(MemPool *pPool, int dCount);
+
+/**
+ * Allocators
+*/
+void *Mem_callocAt(MemTag eTag, size_t dCount, size_t dSize, const char *sFile, int dLine);
+
+void Mem_free(void *pBlock);
+
+/**
+ * Reports
+*/
+char *Mem_formatReport(char *sReason);
+
+void Mem_writeReport(char *sReason);
+
+void Mem_exitHandler();
+
+void Mem_signalHandler(int dSignal);
+
+void Mem_init();
+
+/**
+ * //
+ * ////
+ * //////    Mem helpers
+ * ////////
+ * //////////
+*/
+
+/**
+ * Returns the single instance of the accounting state.
+ *
+ * @return  { Mem * }   The accounting state.
+*/
+Mem *Mem_get() {
+  static Mem mem;
+
+  return &mem;
+}
+
+/**
+ * Returns the printable name of a tag.
+ *
+ * @param   { MemTag }  eTag  The tag.
+ * @return  { char * }        Its name.
+*/
+char *Mem_getTagName(MemTag eTag) {
+  switch(eTag) {
+    case MEM_MISC:      return "misc";
+    case MEM_BUFFER:    return "buffer";
+    case MEM_GRAPHICS:  return "graphics";
+    case MEM_WORLD:     return "world";
+    case MEM_PLAYER:    return "player";
+    case MEM_SYSTEM:    return "system";
+    case MEM_BOT:       return "bot";
+    default:            return "?";
+  }
+}
+
+/**
+ * Charges an allocation to a set of counters.
+ * A negative byte count means the block is being freed.
+ *
+ * @param   { MemStats * }  pStats  The counters to update.
+ * @param   { long }        dBytes  The size of the block; negative when freeing.
+*/
+void Mem_charge(MemStats *pStats, long dBytes) {
+  if(dBytes >= 0) {
+    pStats->dAllocs++;
+    pStats->dLiveBlocks++;
+    pStats->dTotalBytes += dBytes;
+  } else {
+    pStats->dFrees++;
+    pStats->dLiveBlocks--;
+  }
+
+  pStats->dLiveBytes += dBytes;
+
+  if(pStats->dLiveBlocks > pStats->dPeakBlocks) pStats->dPeakBlocks = pStats->dLiveBlocks;
+  if(pStats->dLiveBytes > pStats->dPeakBytes) pStats->dPeakBytes = pStats->dLiveBytes;
+}
+
+/**
+ * Finds (or creates) the record of a call site in the open-addressed site table.
+ * Outside of debug mode this always returns -1.
+ *
+ * @param   { MemTag }        eTag    The tag of the allocation.
+ * @param   { const char * }  sFile   The file of the call site.
+ * @param   { int }           dLine   The line of the call site.
+ * @return  { int }                   The index of the site, or -1.
+*/
+int Mem_getSite(MemTag eTag, const char *sFile, int dLine) {
+  #ifdef MEM_DEBUG
+    Mem *this = Mem_get();
+    int dIndex = ((((size_t) sFile >> 4) * 31) + dLine) & (MEM_MAX_SITES - 1);
+
+    for(int i = 0; i < MEM_MAX_SITES; i++) {
+      MemSite *pSite = &this->sites[dIndex];
+
+      // New site
+      if(pSite->sFile == NULL) {
+        pSite->sFile = sFile;
+        pSite->dLine = dLine;
+        pSite->eTag = eTag;
+
+        return dIndex;
+      }
+
+      // Existing site
+      if(pSite->dLine == dLine && !strcmp(pSite->sFile, sFile))
+        return dIndex;
+
+      dIndex = (dIndex + 1) & (MEM_MAX_SITES - 1);
+    }
+  #endif
+
+  return -1;
+}
+
+/**
+ * Adds a pool to the ones listed in the report.
+ *
+ * @param   { MemPool * }   pPool   The counters of the pool.
+*/
+void Mem_addPool(MemPool *pPool) {
+  Mem *this = Mem_get();
+
+  pPool->pNext = this->pPools;
+  this->pPools = pPool;
+}
+
+/**
+ * Charges an object handed out by a pool to its counters.
+ * A negative count means the object is being given back.
+ *
+ * @param   { MemPool * }   pPool   The counters of the pool.
+ * @param   { int }         dCount  1 when handing out, -1 when giving back.
+*/
+void Mem_chargePool(MemPool *pPool, int dCount) {
+  if(dCount > 0) pPool->dAllocs++;
+  else pPool->dFrees++;
+
+  pPool->dLive += dCount;
+
+  if(pPool->dLive > pPool->dPeak) pPool->dPeak = pPool->dLive;
+}
+
+/**
+ * //
+ * ////
+ * //////    Mem allocators
+ * ////////
+ * //////////
+*/
+
+/**
+ * Allocates a zeroed block and charges it to a tag.
+ * Call this through the Mem_calloc() macro.
+ *
+ * @param   { MemTag }        eTag    The subsystem that owns the block.
+ * @param   { size_t }        dCount  The number of elements.
+ * @param   { size_t }        dSize   The size of an element.
+ * @param   { const char * }  sFile   The file of the call site.
+ * @param   { int }           dLine   The line of the call site.
+ * @return  { void * }                The block, or NULL on failure.
+*/
+void *Mem_callocAt(MemTag eTag, size_t dCount, size_t dSize, const char *sFile, int dLine) {
+  Mem *this = Mem_get();
+  size_t dBytes = dCount * dSize;
+  MemHeader *pHeader = calloc(1, sizeof(*pHeader) + dBytes);
+
+  if(pHeader == NULL)
+    return NULL;
+
+  pHeader->info.dSize = dBytes;
+  pHeader->info.eTag = eTag;
+  pHeader->info.dSite = Mem_getSite(eTag, sFile, dLine);
+
+  Mem_charge(&this->tags[eTag], dBytes);
+  Mem_charge(&this->total, dBytes);
+
+  if(pHeader->info.dSite >= 0)
+    Mem_charge(&this->sites[pHeader->info.dSite].stats, dBytes);
+
+  return pHeader + 1;
+}
+
+/**
+ * Frees a block made by Mem_calloc().
+ * Does nothing when given NULL.
+ *
+ * @param   { void * }  pBlock  The block to free.
+*/
+void Mem_free(void *pBlock) {
+  Mem *this = Mem_get();
+  MemHeader *pHeader;
+
+  if(pBlock == NULL)
+    return;
+
+  pHeader = (MemHeader *) pBlock - 1;
+
+  Mem_charge(&this->tags[pHeader->info.eTag], -(long) pHeader->info.dSize);
+  Mem_charge(&this->total, -(long) pHeader->info.dSize);
+
+  if(pHeader->info.dSite >= 0)
+    Mem_charge(&this->sites[pHeader->info.dSite].stats, -(long) pHeader->info.dSize);
+
+  free(pHeader);
+}
+
+/**
+ * //
+ * ////
+ * //////    Mem reports
+ * ////////
+ * //////////
+*/
+
+/**
+ * Appends text to the report, padded to the width of its column like printf() would.
+ * The report is also written from the signal handler, where snprintf() isn't safe to call,
+ * so the whole thing is put together with this and Mem_addNumber() instead.
+ *
+ * @param   { char * }  sOutput   The report.
+ * @param   { int }     dLength   How much of the report has been written.
+ * @param   { int }     dSize     The size of the report.
+ * @param   { char * }  sText     The text to add.
+ * @param   { int }     dWidth    The width of the column; negative to align the text to the left.
+ * @return  { int }               The new length of the report.
+*/
+int Mem_addText(char *sOutput, int dLength, int dSize, const char *sText, int dWidth) {
+  int dText = 0, dPad;
+
+  if(dLength >= dSize)
+    return dLength;
+
+  while(sText[dText])
+    dText++;
+
+  dPad = (dWidth < 0 ? -dWidth : dWidth) - dText;
+
+  for(; dWidth > 0 && dPad > 0 && dLength < dSize - 1; dPad--)
+    sOutput[dLength++] = ' ';
+
+  for(int i = 0; i < dText && dLength < dSize - 1; i++)
+    sOutput[dLength++] = sText[i];
+
+  for(; dPad > 0 && dLength < dSize - 1; dPad--)
+    sOutput[dLength++] = ' ';
+
+  sOutput[dLength] = 0;
+
+  return dLength;
+}
+
+/**
+ * Appends a number to the report.
+ *
+ * @param   { char * }  sOutput   The report.
+ * @param   { int }     dLength   How much of the report has been written.
+ * @param   { int }     dSize     The size of the report.
+ * @param   { long }    dValue    The number to add.
+ * @param   { int }     dWidth    The width of the column; negative to align the number to the left.
+ * @return  { int }               The new length of the report.
+*/
+int Mem_addNumber(char *sOutput, int dLength, int dSize, long dValue, int dWidth) {
+  char sDigits[24];
+  unsigned long dLeft = dValue < 0 ? -(unsigned long) dValue : (unsigned long) dValue;
+  int i = sizeof(sDigits) - 1;
+
+  sDigits[i] = 0;
+
+  do sDigits[--i] = '0' + dLeft % 10;
+  while(dLeft /= 10);
+
+  if(dValue < 0)
+    sDigits[--i] = '-';
+
+  return Mem_addText(sOutput, dLength, dSize, sDigits + i, dWidth);
+}
+
+/**
+ * Formats one row of the report.
+ *
+ * @param   { char * }      sOutput   The report.
+ * @param   { int }         dLength   How much of the report has been written.
+ * @param   { int }         dSize     The size of the report.
+ * @param   { char * }      sLabel    The name of the row.
+ * @param   { MemStats * }  pStats    The counters to print.
+ * @return  { int }                   The new length of the report.
+*/
+int Mem_formatStats(char *sOutput, int dLength, int dSize, char *sLabel, MemStats *pStats) {
+  int bChurns = pStats->dAllocs >= MEM_CHURN_MIN && pStats->dAllocs >= pStats->dPeakBlocks * MEM_CHURN_RATIO;
+
+  dLength = Mem_addText(sOutput, dLength, dSize, "  ", 0);
+  dLength = Mem_addText(sOutput, dLength, dSize, sLabel, -32);
+  dLength = Mem_addNumber(sOutput, dLength, dSize, pStats->dAllocs, 11);
+  dLength = Mem_addNumber(sOutput, dLength, dSize, pStats->dFrees, 11);
+  dLength = Mem_addNumber(sOutput, dLength, dSize, pStats->dLiveBlocks, 11);
+  dLength = Mem_addNumber(sOutput, dLength, dSize, pStats->dLiveBytes, 13);
+  dLength = Mem_addNumber(sOutput, dLength, dSize, pStats->dPeakBytes, 13);
+  dLength = Mem_addNumber(sOutput, dLength, dSize, pStats->dTotalBytes, 15);
+  dLength = Mem_addText(sOutput, dLength, dSize, "  ", 0);
+  dLength = Mem_addText(sOutput, dLength, dSize, pStats->dLiveBlocks > 0 ? "LEAK " : "", 0);
+  dLength = Mem_addText(sOutput, dLength, dSize, bChurns ? "CHURN" : "", 0);
+
+  return Mem_addText(sOutput, dLength, dSize, "\n", 0);
+}
+
+/**
+ * Formats the whole report into a static buffer.
+ * Doesn't allocate or touch stdio since it's also called from the signal handler.
+ *
+ * @param   { char * }  sReason   What triggered the report.
+ * @return  { char * }            The report.
+*/
+char *Mem_formatReport(char *sReason) {
+  static char sReport[MEM_MAX_REPORT];
+  char *sHeaders[] = { "allocs", "frees", "live", "live bytes", "peak bytes", "total bytes" };
+  char *sPoolHeaders[] = { "slabs", "slots", "live", "peak", "allocs", "frees", "occupancy" };
+  int dWidths[] = { 11, 11, 11, 13, 13, 15 };
+  int dPoolWidths[] = { 11, 11, 11, 11, 13, 13, 11 };
+  Mem *this = Mem_get();
+  int dLength = 0, dSize = sizeof(sReport);
+
+  dLength = Mem_addText(sReport, dLength, dSize, "Memory report (", 0);
+  dLength = Mem_addText(sReport, dLength, dSize, sReason, 0);
+  dLength = Mem_addText(sReport, dLength, dSize, ")\n\n  ", 0);
+  dLength = Mem_addText(sReport, dLength, dSize, "tag", -32);
+
+  for(int i = 0; i < 6; i++)
+    dLength = Mem_addText(sReport, dLength, dSize, sHeaders[i], dWidths[i]);
+
+  dLength = Mem_addText(sReport, dLength, dSize, "\n", 0);
+
+  for(int i = 0; i < MEM_TAGS; i++)
+    if(this->tags[i].dAllocs)
+      dLength = Mem_formatStats(sReport, dLength, dSize, Mem_getTagName(i), &this->tags[i]);
+
+  dLength = Mem_formatStats(sReport, dLength, dSize, "(all)", &this->total);
+
+  // Pool occupancy
+  if(this->pPools != NULL) {
+    dLength = Mem_addText(sReport, dLength, dSize, "\n  ", 0);
+    dLength = Mem_addText(sReport, dLength, dSize, "pool", -32);
+
+    for(int i = 0; i < 7; i++)
+      dLength = Mem_addText(sReport, dLength, dSize, sPoolHeaders[i], dPoolWidths[i]);
+
+    dLength = Mem_addText(sReport, dLength, dSize, "\n", 0);
+
+    for(MemPool *pPool = this->pPools; pPool != NULL; pPool = pPool->pNext) {
+      long dValues[] = { pPool->dSlabs, pPool->dSlots, pPool->dLive, pPool->dPeak, pPool->dAllocs, pPool->dFrees };
+      long dTenths = pPool->dSlots ? pPool->dLive * 1000 / pPool->dSlots : 0;
+      char sOccupancy[32];
+      int dOccupancy = 0;
+
+      // The occupancy in tenths of a percent, since we can't print floats here
+      dOccupancy = Mem_addNumber(sOccupancy, dOccupancy, sizeof(sOccupancy), dTenths / 10, 0);
+      dOccupancy = Mem_addText(sOccupancy, dOccupancy, sizeof(sOccupancy), ".", 0);
+      dOccupancy = Mem_addNumber(sOccupancy, dOccupancy, sizeof(sOccupancy), dTenths % 10, 0);
+      dOccupancy = Mem_addText(sOccupancy, dOccupancy, sizeof(sOccupancy), "%", 0);
+
+      dLength = Mem_addText(sReport, dLength, dSize, "  ", 0);
+      dLength = Mem_addText(sReport, dLength, dSize, pPool->sName, -32);
+
+      for(int i = 0; i < 6; i++)
+        dLength = Mem_addNumber(sReport, dLength, dSize, dValues[i], dPoolWidths[i]);
+
+      dLength = Mem_addText(sReport, dLength, dSize, sOccupancy, dPoolWidths[6]);
+      dLength = Mem_addText(sReport, dLength, dSize, pPool->dLive > 0 ? "  LEAK\n" : "\n", 0);
+    }
+  }
+
+  #ifdef MEM_DEBUG
+
+    // There are only a handful of sites here, so we just list all of them
+    dLength = Mem_addText(sReport, dLength, dSize, "\n  Sites\n", 0);
+
+    for(int i = 0; i < MEM_MAX_SITES; i++) {
+      const char *sFile = this->sites[i].sFile;
+      char sLabel[64];
+      int dLabel = 0;
+
+      if(sFile == NULL)
+        continue;
+
+      // Just the name of the file, without its directories
+      for(const char *sChar = sFile; *sChar; sChar++)
+        if(*sChar == '/')
+          sFile = sChar + 1;
+
+      dLabel = Mem_addText(sLabel, dLabel, sizeof(sLabel), sFile, 0);
+      dLabel = Mem_addText(sLabel, dLabel, sizeof(sLabel), ":", 0);
+      dLabel = Mem_addNumber(sLabel, dLabel, sizeof(sLabel), this->sites[i].dLine, 0);
+      dLabel = Mem_addText(sLabel, dLabel, sizeof(sLabel), " [", 0);
+      dLabel = Mem_addText(sLabel, dLabel, sizeof(sLabel), Mem_getTagName(this->sites[i].eTag), 0);
+      dLabel = Mem_addText(sLabel, dLabel, sizeof(sLabel), "]", 0);
+
+      dLength = Mem_formatStats(sReport, dLength, dSize, sLabel, &this->sites[i].stats);
+    }
+  #endif
+
+  return sReport;
+}
+
+/**
+ * Writes the report to MEM_REPORT_PATH.
+ *
+ * @param   { char * }  sReason   What triggered the report.
+*/
+void Mem_writeReport(char *sReason) {
+  FILE *pFile = fopen(MEM_REPORT_PATH, "w");
+
+  if(pFile == NULL)
+    return;
+
+  fputs(Mem_formatReport(sReason), pFile);
+  fclose(pFile);
+}
+
+/**
+ * Writes the report at exit.
+ * Empty pools hand their slabs back first so they don't look like leaks.
+*/
+void Mem_exitHandler() {
+  for(MemPool *pPool = Mem_get()->pPools; pPool != NULL; pPool = pPool->pNext)
+    pPool->fTrim();
+
+  Mem_writeReport("exit");
+}
+
+/**
+ * Writes the report when a signal arrives.
+ * SIGINT and SIGTERM go on to kill the program; SIGUSR1 (Unix only) just writes the report.
+ *
+ * @param   { int }   dSignal   The received signal.
+*/
+void Mem_signalHandler(int dSignal) {
+  char *sReason = dSignal == SIGINT ? "SIGINT" : dSignal == SIGTERM ? "SIGTERM" : "signal";
+
+  // fopen() isn't safe inside a signal handler, so Unix gets the raw syscalls
+  #ifdef _WIN32
+    Mem_writeReport(sReason);
+  #else
+    char *sReport = Mem_formatReport(sReason);
+    int dFile = open(MEM_REPORT_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(dFile >= 0) {
+      if(write(dFile, sReport, strlen(sReport)) < 0) {}
+      close(dFile);
+    }
+  #endif
+
+  if(dSignal == SIGINT || dSignal == SIGTERM) {
+    signal(dSignal, SIG_DFL);
+    raise(dSignal);
+    return;
+  }
+
+  signal(dSignal, Mem_signalHandler);
+}
+
+/**
+ * Hooks the report onto exit and the signals.
+ * Call once at the start of the program.
+*/
+void Mem_init() {
+  Mem *this = Mem_get();
+
+  if(this->bIsReady)
+    return;
+
+  this->bIsReady = 1;
+
+  atexit(Mem_exitHandler);
+  signal(SIGINT, Mem_signalHandler);
+  signal(SIGTERM, Mem_signalHandler);
+
+  #ifdef SIGUSR1
+    signal(SIGUSR1, Mem_signalHandler);
+  #endif
+}
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * @ Description:
+ *    Typed object pools for the classes that get made in bulk.
+ *    A pool grabs a slab of objects at a time and keeps the ones that were given back on a free list,
+ *    so making and killing objects doesn't go through the heap every time.
+ *
+ *    POOL_DEFINE(World, World, MEM_WORLD, 64) generates:
+ *        World *World_poolAlloc()          A zeroed object, like Mem_calloc().
+ *        void World_poolFree(World *)      Gives an object back (NULL does nothing).
+ *        void World_poolTrim()             Returns the slabs to the heap if every object was given back.
+ *
+ *    The occupancy of every pool is part of the memory report (see utils.mem.h).
+ *    Compiling with -DPOOL_DEBUG poisons the objects that are given back and checks the poison when they're handed out
+ *    again, so a use after free (or a double free) stops the program on the spot.
+ *    Compiling with -DPOOL_DISABLE sends every object to Mem_calloc() instead, for valgrind and the sanitizers.
+ */
+
+#ifndef UTILS_POOL_
+#define UTILS_POOL_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.mem.h"
+
+#define POOL_POISON 0xDD    // What given back objects are filled with in debug mode
+
+// Constants instead of #ifdefs, since those can't go inside the macro; the dead branches get compiled away
+#ifdef POOL_DEBUG
+#define POOL_CHECKS 1
+#else
+#define POOL_CHECKS 0
+#endif
+
+#ifdef POOL_DISABLE
+#define POOL_BYPASS 1
+#else
+#define POOL_BYPASS 0
+#endif
+
+/**
+ * Helpers
+*/
+int Pool_isPoisoned(void *pObject, size_t dSize);
+
+void Pool_panic(char *sName, char *sProblem, void *pObject);
+
+/**
+ * //
+ * ////
+ * //////    Pool helpers
+ * ////////
+ * //////////
+*/
+
+/**
+ * Returns whether or not an object is still nothing but poison.
+ *
+ * @param   { void * }  pObject   The object.
+ * @param   { size_t }  dSize     Its size.
+ * @return  { int }               Whether or not it hasn't been written to since it was poisoned.
+*/
+int Pool_isPoisoned(void *pObject, size_t dSize) {
+  unsigned char *pByte = pObject;
+
+  for(size_t i = 0; i < dSize; i++)
+    if(pByte[i] != POOL_POISON)
+      return 0;
+
+  return 1;
+}
+
+/**
+ * Reports a broken pool and stops the program.
+ *
+ * @param   { char * }  sName     The name of the pool.
+ * @param   { char * }  sProblem  What went wrong.
+ * @param   { void * }  pObject   The object involved.
+*/
+void Pool_panic(char *sName, char *sProblem, void *pObject) {
+  fprintf(stderr, "Pool %s: %s (%p).\n", sName, sProblem, pObject);
+  abort();
+}
+
+/**
+ * //
+ * ////
+ * //////    Pool generator
+ * ////////
+ * //////////
+*/
+
+/**
+ * Generates a pool for a type (see the top of the file).
+ * The link to the next free slot sits beside the object instead of on top of it: a World is only as big as a pointer,
+ * so overlapping them would leave nothing to poison.
+ *
+ * @param   Name            The prefix of the generated functions.
+ * @param   Type            The type of the objects.
+ * @param   eMemTag         The tag the slabs are charged to.
+ * @param   dSlabObjects    The number of objects per slab.
+*/
+#define POOL_DEFINE(Name, Type, eMemTag, dSlabObjects)                                                      \
+                                                                                                            \
+  typedef struct Name##PoolSlot Name##PoolSlot;                                                             \
+  typedef struct Name##PoolSlab Name##PoolSlab;                                                             \
+  typedef struct Name##Pool Name##Pool;                                                                     \
+                                                                                                            \
+  struct Name##PoolSlot {                                                                                   \
+    Type object;                                                                                            \
+    Name##PoolSlot *pNext;                                                                                  \
+  };                                                                                                        \
+                                                                                                            \
+  struct Name##PoolSlab {                                                                                   \
+    Name##PoolSlab *pNext;                                                                                  \
+    Name##PoolSlot slots[dSlabObjects];                                                                     \
+  };                                                                                                        \
+                                                                                                            \
+  struct Name##Pool {                                                                                       \
+    MemPool stats;                                                                                          \
+    Name##PoolSlot *pFree;                                                                                  \
+    Name##PoolSlab *pSlabs;                                                                                 \
+  };                                                                                                        \
+                                                                                                            \
+  void Name##_poolTrim();                                                                                   \
+                                                                                                            \
+  Name##Pool *Name##_getPool() {                                                                            \
+    static Name##Pool pool;                                                                                 \
+                                                                                                            \
+    if(pool.stats.sName == NULL) {                                                                          \
+      pool.stats.sName = #Name;                                                                             \
+      pool.stats.fTrim = Name##_poolTrim;                                                                   \
+      Mem_addPool(&pool.stats);                                                                             \
+    }                                                                                                       \
+                                                                                                            \
+    return &pool;                                                                                           \
+  }                                                                                                         \
+                                                                                                            \
+  Type *Name##_poolAlloc() {                                                                                \
+    Name##Pool *this = Name##_getPool();                                                                    \
+    Name##PoolSlot *pSlot;                                                                                  \
+                                                                                                            \
+    if(POOL_BYPASS) {                                                                                       \
+      Type *pObject = Mem_calloc(eMemTag, 1, sizeof(Type));                                                 \
+                                                                                                            \
+      if(pObject != NULL)                                                                                   \
+        Mem_chargePool(&this->stats, 1);                                                                    \
+                                                                                                            \
+      return pObject;                                                                                       \
+    }                                                                                                       \
+                                                                                                            \
+    /* Out of objects; the new slab goes on the free list in order */                                       \
+    if(this->pFree == NULL) {                                                                               \
+      Name##PoolSlab *pSlab = Mem_calloc(eMemTag, 1, sizeof(*pSlab));                                       \
+                                                                                                            \
+      if(pSlab == NULL)                                                                                     \
+        return NULL;                                                                                        \
+                                                                                                            \
+      pSlab->pNext = this->pSlabs;                                                                          \
+      this->pSlabs = pSlab;                                                                                 \
+                                                                                                            \
+      for(int i = (dSlabObjects) - 1; i >= 0; i--) {                                                        \
+        if(POOL_CHECKS)                                                                                     \
+          memset(&pSlab->slots[i].object, POOL_POISON, sizeof(Type));                                       \
+                                                                                                            \
+        pSlab->slots[i].pNext = this->pFree;                                                                \
+        this->pFree = &pSlab->slots[i];                                                                     \
+      }                                                                                                     \
+                                                                                                            \
+      this->stats.dSlabs++;                                                                                 \
+      this->stats.dSlots += (dSlabObjects);                                                                 \
+    }                                                                                                       \
+                                                                                                            \
+    pSlot = this->pFree;                                                                                    \
+                                                                                                            \
+    if(POOL_CHECKS && !Pool_isPoisoned(&pSlot->object, sizeof(Type)))                                       \
+      Pool_panic(#Name, "object written to after it was given back", pSlot);                                \
+                                                                                                            \
+    this->pFree = pSlot->pNext;                                                                             \
+    memset(&pSlot->object, 0, sizeof(Type));                                                                \
+    Mem_chargePool(&this->stats, 1);                                                                        \
+                                                                                                            \
+    return &pSlot->object;                                                                                  \
+  }                                                                                                         \
+                                                                                                            \
+  void Name##_poolFree(Type *pObject) {                                                                     \
+    Name##Pool *this = Name##_getPool();                                                                    \
+    Name##PoolSlot *pSlot = (Name##PoolSlot *) pObject;                                                     \
+                                                                                                            \
+    if(pObject == NULL)                                                                                     \
+      return;                                                                                               \
+                                                                                                            \
+    Mem_chargePool(&this->stats, -1);                                                                       \
+                                                                                                            \
+    if(POOL_BYPASS) {                                                                                       \
+      Mem_free(pObject);                                                                                    \
+      return;                                                                                               \
+    }                                                                                                       \
+                                                                                                            \
+    /* Still all poison means it was already given back */                                                  \
+    if(POOL_CHECKS) {                                                                                       \
+      if(Pool_isPoisoned(&pSlot->object, sizeof(Type)))                                                     \
+        Pool_panic(#Name, "object given back twice", pSlot);                                                \
+                                                                                                            \
+      memset(&pSlot->object, POOL_POISON, sizeof(Type));                                                    \
+    }                                                                                                       \
+                                                                                                            \
+    pSlot->pNext = this->pFree;                                                                             \
+    this->pFree = pSlot;                                                                                    \
+  }                                                                                                         \
+                                                                                                            \
+  void Name##_poolTrim() {                                                                                  \
+    Name##Pool *this = Name##_getPool();                                                                    \
+                                                                                                            \
+    if(this->stats.dLive)                                                                                   \
+      return;                                                                                               \
+                                                                                                            \
+    while(this->pSlabs != NULL) {                                                                           \
+      Name##PoolSlab *pSlab = this->pSlabs;                                                                 \
+                                                                                                            \
+      this->pSlabs = pSlab->pNext;                                                                          \
+      Mem_free(pSlab);                                                                                      \
+    }                                                                                                       \
+                                                                                                            \
+    this->pFree = NULL;                                                                                     \
+    this->stats.dSlabs = 0;                                                                                 \
+    this->stats.dSlots = 0;                                                                                 \
+  }
+
+#endif